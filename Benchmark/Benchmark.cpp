@@ -0,0 +1,1627 @@
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTAllocations.h"
+#include "../Catanalyst/KMTCapture.h"
+#include "../Catanalyst/KMTContexts.h"
+#include "../Catanalyst/KMTDedup.h"
+#include "../Catanalyst/KMTRing.h"
+#include "../CaptureTool/CaptureDiff.h"
+#include "../CaptureTool/CaptureIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Microbenchmarks of the offline decoding code.
+
+// The number of measured runs of every benchmark, set with --runs.
+static uint32_t bench_run_count = 9;
+// Raw PM4 dumps loaded with --pm4, for the recorded benchmark.
+static std::vector<std::vector<uint32_t>> bench_recorded_pm4;
+// Every rate printed, for comparing with a baseline.
+static std::vector<std::pair<std::string, double>> bench_rates;
+
+static uint32_t BENCH_Random(uint64_t & state) {
+   // xorshift64, deterministic so the runs are comparable.
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return uint32_t(state >> 32);
+}
+
+// Generates a command buffer with a mix of the packets that the printing and the analyses handle
+// specially and arbitrary ones.
+static std::vector<uint32_t> BENCH_GeneratePM4(uint32_t const packet_count, uint64_t random_state) {
+   std::vector<uint32_t> pm4;
+   auto const add_packet3 = [&pm4](uint32_t const opcode, uint32_t const count) {
+      pm4.push_back((uint32_t(3) << 30) | (count << 16) | (opcode << 8));
+   };
+   for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+      uint32_t const kind = BENCH_Random(random_state) % 100;
+      if (kind < 40) {
+         // SET_CONFIG_REG, SET_CONTEXT_REG or SET_CTL_CONST.
+         static uint32_t const opcodes[] = {0x68, 0x69, 0x6F};
+         static uint32_t const offset_ranges[] = {0xC00, 0x400, 8};
+         uint32_t const block = BENCH_Random(random_state) % 3;
+         uint32_t const register_count = 1 + BENCH_Random(random_state) % 6;
+         add_packet3(opcodes[block], register_count);
+         pm4.push_back(BENCH_Random(random_state) % offset_ranges[block]);
+         for (uint32_t register_index = 0; register_index < register_count; ++register_index) {
+            pm4.push_back(BENCH_Random(random_state));
+         }
+      } else if (kind < 50) {
+         // Filler, PKT2 or an empty NOP.
+         if (BENCH_Random(random_state) & 1) {
+            pm4.push_back(uint32_t(2) << 30);
+         } else {
+            // Not after a PKT2, where it would be a container.
+            pm4.push_back(uint32_t(1) << 30);
+            add_packet3(0x10, 0);
+            pm4.push_back(0);
+         }
+      } else {
+         // Opcodes without special handling other than the name.
+         static uint32_t const opcodes[] = {0x11, 0x2D, 0x2E, 0x3C, 0x46, 0x6A, 0x73};
+         uint32_t const opcode = opcodes[BENCH_Random(random_state) % 7];
+         uint32_t const count = BENCH_Random(random_state) % 8;
+         add_packet3(opcode, count);
+         for (uint32_t body_index = 0; body_index <= count; ++body_index) {
+            pm4.push_back(BENCH_Random(random_state));
+         }
+      }
+   }
+   return pm4;
+}
+
+// Generates a command buffer dominated by filler: long runs of PKT2 padding, NOP padding, and PKT2
+// followed by NOPs containing packets, like at the patch locations with slot 0x5400.
+static std::vector<uint32_t> BENCH_GenerateFillerPM4(uint32_t const sequence_count,
+                                                     uint64_t random_state) {
+   std::vector<uint32_t> pm4;
+   auto const add_packet3 = [&pm4](uint32_t const opcode, uint32_t const count) {
+      pm4.push_back((uint32_t(3) << 30) | (count << 16) | (opcode << 8));
+   };
+   for (uint32_t sequence_index = 0; sequence_index < sequence_count; ++sequence_index) {
+      uint32_t const kind = BENCH_Random(random_state) % 4;
+      if (kind == 0) {
+         // Padding to an alignment.
+         uint32_t const filler_count = 16 + BENCH_Random(random_state) % 496;
+         pm4.insert(pm4.end(), filler_count, uint32_t(2) << 30);
+      } else if (kind == 1) {
+         // A NOP with a long body, not after a PKT2.
+         uint32_t const count = BENCH_Random(random_state) % 256;
+         add_packet3(0x10, count);
+         pm4.insert(pm4.end(), count + 1, 0);
+      } else {
+         // Patch location of a resource.
+         pm4.push_back(uint32_t(2) << 30);
+         add_packet3(0x10, 9);
+         add_packet3(0x6D, 7);
+         for (uint32_t body_index = 0; body_index < 8; ++body_index) {
+            pm4.push_back(BENCH_Random(random_state));
+         }
+      }
+   }
+   return pm4;
+}
+
+// Generates a command buffer of resource and sampler definitions, with several slots per packet.
+static std::vector<uint32_t> BENCH_GenerateResourcePM4(uint32_t const packet_count,
+                                                       uint64_t random_state) {
+   std::vector<uint32_t> pm4;
+   for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+      bool const is_resource = BENCH_Random(random_state) % 4 != 0;
+      uint32_t const slot_size = is_resource ? 8 : 3;
+      uint32_t const slot_count = 1 + BENCH_Random(random_state) % 4;
+      // PKT3_SET_RESOURCE or PKT3_SET_SAMPLER.
+      pm4.push_back((uint32_t(3) << 30) | ((slot_size * slot_count) << 16) |
+                    ((is_resource ? 0x6D : 0x6E) << 8));
+      pm4.push_back(slot_size * (BENCH_Random(random_state) % 176));
+      for (uint32_t body_index = 0; body_index < slot_size * slot_count; ++body_index) {
+         pm4.push_back(BENCH_Random(random_state));
+      }
+   }
+   return pm4;
+}
+
+// Generates the command buffer of a frame of draws, each changing a few of a small set of registers
+// by small amounts or to previous values, binding textures at increasing addresses, and drawing,
+// as drivers do, unlike the arbitrary values of BENCH_GeneratePM4.
+static std::vector<uint32_t> BENCH_GenerateDrawPM4(uint32_t const draw_count,
+                                                   uint64_t random_state) {
+   std::vector<uint32_t> pm4;
+   auto const add_packet3 = [&pm4](uint32_t const opcode, uint32_t const count) {
+      pm4.push_back((uint32_t(3) << 30) | (count << 16) | (opcode << 8));
+   };
+   // The register blocks changed between draws, as SET_CONTEXT_REG offsets.
+   static uint32_t const block_offsets[] = {0x00, 0x0C, 0x28, 0x80, 0xA0, 0x100, 0x1A0, 0x200};
+   uint32_t block_values[8][4] = {};
+   uint32_t texture_address = 0x100000;
+   for (uint32_t draw_index = 0; draw_index < draw_count; ++draw_index) {
+      uint32_t const changed_block_count = 1 + BENCH_Random(random_state) % 3;
+      for (uint32_t change_index = 0; change_index < changed_block_count; ++change_index) {
+         uint32_t const block = BENCH_Random(random_state) % 8;
+         uint32_t const register_count = 1 + block % 4;
+         add_packet3(0x69, register_count);
+         pm4.push_back(block_offsets[block]);
+         for (uint32_t register_index = 0; register_index < register_count; ++register_index) {
+            uint32_t & value = block_values[block][register_index];
+            value += BENCH_Random(random_state) % 16;
+            pm4.push_back(value);
+         }
+      }
+      // SET_RESOURCE of a 2D texture.
+      add_packet3(0x6D, 7);
+      pm4.push_back(8 * (BENCH_Random(random_state) % 4));
+      pm4.push_back(texture_address >> 8);
+      pm4.insert(pm4.end(), {0x0FF003FF, 0x00000010, texture_address >> 8, 0, 0x00A00000,
+                             0x80000000});
+      texture_address += 0x4000 * (1 + BENCH_Random(random_state) % 4);
+      // DRAW_INDEX_AUTO.
+      add_packet3(0x2D, 1);
+      pm4.push_back(3 * (1 + BENCH_Random(random_state) % 1024));
+      pm4.push_back(2);
+   }
+   return pm4;
+}
+
+// Loads a raw dump of dwords, ignoring the incomplete dword at the end.
+static bool BENCH_LoadPM4(char const * const path, std::vector<uint32_t> & pm4) {
+   FILE * const file = std::fopen(path, "rb");
+   if (!file) {
+      std::fprintf(stderr, "Failed to open %s.\n", path);
+      return false;
+   }
+   pm4.clear();
+   uint32_t chunk[1 << 12];
+   std::size_t dword_count;
+   while ((dword_count = std::fread(chunk, sizeof(uint32_t), 1 << 12, file)) != 0) {
+      pm4.insert(pm4.end(), chunk, chunk + dword_count);
+   }
+   bool const succeeded = !std::ferror(file);
+   std::fclose(file);
+   if (!succeeded) {
+      std::fprintf(stderr, "Failed to read %s.\n", path);
+      return false;
+   }
+   if (pm4.size() > UINT32_MAX) {
+      std::fprintf(stderr, "%s is too large.\n", path);
+      return false;
+   }
+   return true;
+}
+
+static double BENCH_GetSeconds(std::chrono::steady_clock::time_point const start) {
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs the function once to warm up the caches, then bench_run_count times, and returns the median
+// duration in seconds. Unlike the mean, the median is barely affected by the runs interrupted by
+// other activity in the system, so the results are comparable between invocations.
+template <typename Function> static double BENCH_Measure(Function && function) {
+   function();
+   std::vector<double> durations(bench_run_count);
+   for (double & duration : durations) {
+      auto const start = std::chrono::steady_clock::now();
+      function();
+      duration = BENCH_GetSeconds(start);
+   }
+   std::sort(durations.begin(), durations.end());
+   return durations[durations.size() / 2];
+}
+
+// Prints the rate in millions of the units per second, with the name ending in _per_second.
+static void BENCH_PrintRate(std::string const & name, double const count, double const seconds) {
+   double const rate = count / seconds * 1.0e-6;
+   std::printf("%s: %.1f\n", name.c_str(), rate);
+   bench_rates.emplace_back(name, rate);
+}
+
+// Builds a table indexed directly by the register address, with a pointer for every dword up to
+// the last known register, like the register name tables used to be stored.
+static std::vector<char const *> BENCH_GetSparseRegisterNames(PM4P_Family const & family) {
+   std::vector<char const *> sparse_names(family.registers[family.register_count - 1]->index + 1);
+   for (uint32_t register_index = 0; register_index < family.register_count; ++register_index) {
+      PM4P_Register const & register_record = *family.registers[register_index];
+      sparse_names[register_record.index] = register_record.name;
+   }
+   return sparse_names;
+}
+
+// Register name lookup in the sorted tables of the families compared to sparse ones.
+static bool BENCH_RegisterNames() {
+   uint32_t const lookup_count = 1 << 22;
+   for (uint32_t family_id = 0; family_id < PM4P_FAMILY_COUNT; ++family_id) {
+      PM4P_Family const & family = *PM4P_GetFamily(PM4P_FamilyId(family_id));
+      for (uint32_t register_index = 1; register_index < family.register_count;
+           ++register_index) {
+         if (family.registers[register_index - 1]->index >=
+             family.registers[register_index]->index) {
+            std::fprintf(stderr, "Registers of %s are not sorted at %s.\n", family.name,
+                         family.registers[register_index]->name);
+            return false;
+         }
+      }
+      for (uint32_t register_index = 0; register_index < family.register_count; ++register_index) {
+         if (family.register_indices[register_index] != family.registers[register_index]->index) {
+            std::fprintf(stderr, "The index of %s in %s is not the index of the register.\n",
+                         family.registers[register_index]->name, family.name);
+            return false;
+         }
+      }
+      std::vector<char const *> const sparse_names = BENCH_GetSparseRegisterNames(family);
+      // Both the positions by the shadow index and the search, and the misses past the last one.
+      for (uint32_t index = 0; index <= uint32_t(sparse_names.size()); ++index) {
+         char const * const name = PM4P_GetRegisterName(index, &family);
+         if (name != (index < sparse_names.size() ? sparse_names[index] : nullptr)) {
+            std::fprintf(stderr, "Register 0x%" PRIX32 " of %s is %s.\n", index, family.name,
+                         name ? name : "not found");
+            return false;
+         }
+      }
+
+      // Half known registers, half random indices in the ranges of the register-setting packets.
+      std::vector<uint32_t> indices(1 << 16);
+      uint64_t random_state = 0x9E3779B97F4A7C15;
+      for (uint32_t & index : indices) {
+         uint32_t const random = BENCH_Random(random_state);
+         if (random & 1) {
+            index = family.registers[(random >> 1) % family.register_count]->index;
+         } else {
+            static uint32_t const block_bases[] = {0x8000 / 4, 0x28000 / 4, 0x3CFF0 / 4};
+            index = block_bases[(random >> 1) % 3] + (random >> 8) % 0x400;
+         }
+      }
+
+      // The checksums keep the lookups from being optimized out and must match.
+      std::size_t sparse_checksum = 0;
+      double const sparse_seconds = BENCH_Measure([&]() {
+         sparse_checksum = 0;
+         for (uint32_t lookup_index = 0; lookup_index < lookup_count; ++lookup_index) {
+            uint32_t const index = indices[lookup_index & (indices.size() - 1)];
+            char const * const name = index < sparse_names.size() ? sparse_names[index] : nullptr;
+            sparse_checksum += name ? std::size_t(name[0]) + index : 1;
+         }
+      });
+
+      std::size_t sorted_checksum = 0;
+      double const sorted_seconds = BENCH_Measure([&]() {
+         sorted_checksum = 0;
+         for (uint32_t lookup_index = 0; lookup_index < lookup_count; ++lookup_index) {
+            uint32_t const index = indices[lookup_index & (indices.size() - 1)];
+            char const * const name = PM4P_GetRegisterName(index, &family);
+            sorted_checksum += name ? std::size_t(name[0]) + index : 1;
+         }
+      });
+
+      if (sparse_checksum != sorted_checksum) {
+         std::fputs("Register name lookup results don't match.\n", stderr);
+         return false;
+      }
+
+      std::string const prefix = std::string("registers.") + family.name;
+      std::printf("%s.registers: %" PRIu32 "\n", prefix.c_str(), family.register_count);
+      std::printf("%s.sparse_bytes: %zu\n", prefix.c_str(),
+                  sizeof(char const *) * sparse_names.size());
+      // The pointers, the indices searched, and the positions by the shadow index.
+      std::printf("%s.sorted_bytes: %zu\n", prefix.c_str(),
+                  (sizeof(PM4P_Register const *) + sizeof(uint32_t)) * family.register_count +
+                     sizeof(uint16_t) * PM4S_REGISTER_COUNT);
+      BENCH_PrintRate(prefix + ".sparse_mlookups_per_second", lookup_count, sparse_seconds);
+      BENCH_PrintRate(prefix + ".sorted_mlookups_per_second", lookup_count, sorted_seconds);
+   }
+   return true;
+}
+
+// Decoding and formatting of the text of a buffer, without the output itself.
+static bool BENCH_PrintBuffer(std::string const & prefix, std::vector<uint32_t> const & pm4,
+                              PM4P_Family const * const family) {
+   TXTW_Writer text;
+   TXTW_InitGrowable(&text, nullptr, 0);
+   std::size_t text_size = 0;
+   double const seconds = BENCH_Measure([&]() {
+      text.size = 0;
+      PM4P_Write(&text, pm4.data(), uint32_t(pm4.size()), family);
+      text_size = text.size;
+   });
+   bool const succeeded = TXTW_Destroy(&text);
+   if (!succeeded) {
+      std::fputs("Failed to allocate the text.\n", stderr);
+      return false;
+   }
+   std::printf("%s.text_bytes: %zu\n", prefix.c_str(), text_size);
+   BENCH_PrintRate(prefix + ".mdwords_per_second", double(pm4.size()), seconds);
+   BENCH_PrintRate(prefix + ".mbytes_per_second", double(text_size), seconds);
+   return true;
+}
+
+// Printing with the fields of the selected register values decoded, from the initial state of the
+// field decoder every time.
+static bool BENCH_PrintBufferFields(std::string const & prefix, std::vector<uint32_t> const & pm4,
+                                    PM4P_Family const * const family,
+                                    PM4P_FieldDecoder const & field_decoder) {
+   auto const run_field_decoder = std::make_unique<PM4P_FieldDecoder>();
+   TXTW_Writer text;
+   TXTW_InitGrowable(&text, nullptr, 0);
+   std::size_t text_size = 0;
+   PM4P_Packet packets[256];
+   double const seconds = BENCH_Measure([&]() {
+      text.size = 0;
+      *run_field_decoder = field_decoder;
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, pm4.data(), uint32_t(pm4.size()));
+      uint32_t packet_count;
+      while ((packet_count =
+                 PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) != 0) {
+         PM4P_PrintPatchedPackets(&text, packets, packet_count, nullptr, family,
+                                  run_field_decoder.get());
+      }
+      text_size = text.size;
+   });
+   bool const succeeded = TXTW_Destroy(&text);
+   if (!succeeded) {
+      std::fputs("Failed to allocate the text.\n", stderr);
+      return false;
+   }
+   std::printf("%s.text_bytes: %zu\n", prefix.c_str(), text_size);
+   BENCH_PrintRate(prefix + ".mdwords_per_second", double(pm4.size()), seconds);
+   return true;
+}
+
+// Decoding without printing, finding only the boundaries of the packets, or describing them.
+static void BENCH_DecodeBuffer(std::string const & prefix, std::vector<uint32_t> const & pm4) {
+   uint32_t const pm4_dword_count = uint32_t(pm4.size());
+   uint32_t skipped_count = 0;
+   double const skip_seconds = BENCH_Measure([&]() {
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, pm4.data(), pm4_dword_count);
+      skipped_count = PM4P_Skip(&decoder, UINT32_MAX);
+   });
+   PM4P_Packet packets[256];
+   double const decode_seconds = BENCH_Measure([&]() {
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, pm4.data(), pm4_dword_count);
+      while (PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0])) != 0) {
+      }
+   });
+   std::printf("%s.packets: %" PRIu32 "\n", prefix.c_str(), skipped_count);
+   BENCH_PrintRate(prefix + ".skip_mdwords_per_second", pm4_dword_count, skip_seconds);
+   BENCH_PrintRate(prefix + ".decode_mdwords_per_second", pm4_dword_count, decode_seconds);
+}
+
+// Compression of a buffer on its own, and decompression checked against it.
+static bool BENCH_CodecBuffer(std::string const & prefix, std::vector<uint32_t> const & pm4) {
+   uint32_t const pm4_dword_count = uint32_t(pm4.size());
+   std::vector<uint8_t> encoded(PM4Z_GetMaxEncodedSize(pm4_dword_count));
+   auto const model = std::make_unique<PM4Z_Model>();
+   PM4Z_ModelInit(model.get());
+   std::size_t const encoded_size =
+      PM4Z_Encode(model.get(), pm4.data(), pm4_dword_count, encoded.data());
+   std::vector<uint32_t> decoded(pm4.size());
+   bool succeeded = true;
+   double const decode_seconds = BENCH_Measure([&]() {
+      PM4Z_ModelInit(model.get());
+      succeeded &=
+         PM4Z_Decode(model.get(), encoded.data(), encoded_size, decoded.data(), pm4_dword_count);
+   });
+   if (!succeeded || decoded != pm4) {
+      std::fprintf(stderr, "The decoded %s doesn't match.\n", prefix.c_str());
+      return false;
+   }
+   std::printf("%s.codec_ratio: %.2f\n", prefix.c_str(),
+               double(sizeof(uint32_t) * pm4.size()) / double(encoded_size));
+   BENCH_PrintRate(prefix + ".codec_decode_mbytes_per_second",
+                   double(sizeof(uint32_t) * pm4.size()), decode_seconds);
+   return true;
+}
+
+static bool BENCH_Print() {
+   std::vector<uint32_t> const pm4 = BENCH_GeneratePM4(1 << 18, 0x2545F4914F6CDD1D);
+   std::printf("print.dwords: %zu\n", pm4.size());
+   PM4P_Family const * const family = PM4P_GetFamily(PM4P_FAMILY_EVERGREEN);
+   if (!BENCH_PrintBuffer("print", pm4, family)) {
+      return false;
+   }
+   // A single register requested, with the rest filtered out, and every change decoded.
+   auto const field_decoder = std::make_unique<PM4P_FieldDecoder>();
+   PM4P_FieldDecoderInit(field_decoder.get(), false);
+   PM4P_FieldDecoderRequest(field_decoder.get(), 0x28C70 / sizeof(uint32_t));
+   if (!BENCH_PrintBufferFields("print.fields_requested", pm4, family, *field_decoder)) {
+      return false;
+   }
+   PM4P_FieldDecoderInit(field_decoder.get(), true);
+   return BENCH_PrintBufferFields("print.fields_changed", pm4, family, *field_decoder);
+}
+
+// The resource and sampler definitions, which are printed by slots rather than as plain dwords.
+static bool BENCH_Resources() {
+   std::vector<uint32_t> const pm4 = BENCH_GenerateResourcePM4(1 << 17, 0xA54FF53A5F1D36F1);
+   std::printf("resources.dwords: %zu\n", pm4.size());
+   BENCH_DecodeBuffer("resources", pm4);
+   return BENCH_PrintBuffer("resources", pm4, PM4P_GetFamily(PM4P_FAMILY_EVERGREEN));
+}
+
+// The dumps specified with --pm4, numbered in the order of the options.
+static bool BENCH_Recorded() {
+   for (std::size_t dump_index = 0; dump_index < bench_recorded_pm4.size(); ++dump_index) {
+      std::vector<uint32_t> const & pm4 = bench_recorded_pm4[dump_index];
+      std::string const prefix = "recorded." + std::to_string(dump_index);
+      std::printf("%s.dwords: %zu\n", prefix.c_str(), pm4.size());
+      if (pm4.empty()) {
+         continue;
+      }
+      BENCH_DecodeBuffer(prefix, pm4);
+      if (!BENCH_CodecBuffer(prefix, pm4) ||
+          !BENCH_PrintBuffer(prefix, pm4, PM4P_GetFamily(PM4P_FAMILY_EVERGREEN))) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// Finding the packet boundaries and decoding filler-heavy buffers with every instruction set.
+static bool BENCH_Filler() {
+   // Small enough to stay in the cache, for measuring the scanning rather than the memory.
+   std::vector<uint32_t> const pm4 = BENCH_GenerateFillerPM4(1 << 12, 0x6A09E667F3BCC908);
+   uint32_t const pm4_dword_count = uint32_t(pm4.size());
+   std::vector<PM4P_Packet> packets(256);
+   static char const * const simd_names[] = {"scalar", "sse2", "avx2"};
+   PM4P_SIMD const supported_simd = PM4P_GetSupportedSIMD();
+   // Passes over the buffer per measured run.
+   uint32_t const iteration_count = 64;
+   // The results must not depend on the instruction set.
+   uint32_t reference_skipped_count = 0;
+   uint64_t reference_checksum = 0;
+   for (uint32_t simd = PM4P_SIMD_SCALAR; simd <= uint32_t(supported_simd); ++simd) {
+      PM4P_SetSIMD(PM4P_SIMD(simd));
+
+      uint32_t skipped_count = 0;
+      double const skip_seconds = BENCH_Measure([&]() {
+         for (uint32_t iteration = 0; iteration < iteration_count; ++iteration) {
+            PM4P_Decoder decoder;
+            PM4P_DecoderInit(&decoder, pm4.data(), pm4_dword_count);
+            skipped_count = PM4P_Skip(&decoder, UINT32_MAX);
+         }
+      });
+
+      uint64_t checksum = 0;
+      uint32_t decoded_count = 0;
+      double const decode_seconds = BENCH_Measure([&]() {
+         for (uint32_t iteration = 0; iteration < iteration_count; ++iteration) {
+            PM4P_Decoder decoder;
+            PM4P_DecoderInit(&decoder, pm4.data(), pm4_dword_count);
+            checksum = 0;
+            decoded_count = 0;
+            uint32_t packet_count;
+            while ((packet_count =
+                       PM4P_Decode(&decoder, packets.data(), uint32_t(packets.size()))) != 0) {
+               for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+                  PM4P_Packet const & packet = packets[packet_index];
+                  checksum = checksum * 31 + packet.offset + packet.body_dword_count + packet.type;
+               }
+               decoded_count += packet_count;
+            }
+         }
+      });
+
+      if (simd == PM4P_SIMD_SCALAR) {
+         reference_skipped_count = skipped_count;
+         reference_checksum = checksum;
+      }
+      if (skipped_count != decoded_count || skipped_count != reference_skipped_count ||
+          checksum != reference_checksum) {
+         std::fprintf(stderr, "Filler scanning with %s doesn't match.\n", simd_names[simd]);
+         return false;
+      }
+      std::string const prefix = std::string("filler.") + simd_names[simd];
+      BENCH_PrintRate(prefix + ".skip_mdwords_per_second",
+                      double(pm4_dword_count) * iteration_count, skip_seconds);
+      BENCH_PrintRate(prefix + ".decode_mdwords_per_second",
+                      double(pm4_dword_count) * iteration_count, decode_seconds);
+   }
+   PM4P_SetSIMD(supported_simd);
+   std::printf("filler.dwords: %" PRIu32 "\n", pm4_dword_count);
+   std::printf("filler.packets: %" PRIu32 "\n", reference_skipped_count);
+   return true;
+}
+
+// Tracking of the register state with a snapshot at every draw and dispatch, and restoring the
+// state at them, checked against full copies of the state.
+static bool BENCH_Shadow() {
+   std::vector<uint32_t> const pm4 = BENCH_GeneratePM4(1 << 18, 0xBB67AE8584CAA73B);
+   std::vector<PM4P_Packet> packets(pm4.size());
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, pm4.data(), uint32_t(pm4.size()));
+   packets.resize(PM4P_Decode(&decoder, packets.data(), uint32_t(packets.size())));
+
+   // Every 97th snapshot is checked.
+   uint32_t const checked_snapshot_interval = 97;
+   auto const shadow = std::make_unique<PM4S_Shadow>();
+   PM4S_History history;
+   PM4S_HistoryInit(&history);
+   bool is_first_run = true;
+   bool succeeded = true;
+   std::vector<PM4S_State> checked_states;
+   double const seconds = BENCH_Measure([&]() {
+      PM4S_HistoryDestroy(&history);
+      PM4S_ShadowInit(shadow.get());
+      PM4S_HistoryInit(&history);
+      for (PM4P_Packet const & packet : packets) {
+         PM4S_ShadowApply(shadow.get(), &packet);
+         if (!PM4S_IsDrawOrDispatch(&packet)) {
+            continue;
+         }
+         if (is_first_run && history.snapshot_count % checked_snapshot_interval == 0) {
+            checked_states.push_back(shadow->state);
+         }
+         if (!PM4S_HistoryRecord(&history, shadow.get(), &packet, 0)) {
+            succeeded = false;
+            break;
+         }
+      }
+      is_first_run = false;
+   });
+   if (!succeeded) {
+      std::fputs("Failed to allocate the history.\n", stderr);
+      PM4S_HistoryDestroy(&history);
+      return false;
+   }
+
+   auto const state = std::make_unique<PM4S_State>();
+   auto const restore_start = std::chrono::steady_clock::now();
+   for (std::size_t checked_index = 0; checked_index < checked_states.size(); ++checked_index) {
+      PM4S_HistoryGetState(&history, checked_index * checked_snapshot_interval, state.get());
+      if (std::memcmp(state.get(), &checked_states[checked_index], sizeof(PM4S_State))) {
+         std::fprintf(stderr, "The restored state at snapshot %zu doesn't match.\n",
+                      checked_index * checked_snapshot_interval);
+         PM4S_HistoryDestroy(&history);
+         return false;
+      }
+   }
+   double const restore_seconds = BENCH_GetSeconds(restore_start);
+
+   std::size_t const keyframe_count =
+      (history.snapshot_count + PM4S_HISTORY_KEYFRAME_INTERVAL - 1) /
+      PM4S_HISTORY_KEYFRAME_INTERVAL;
+   std::size_t const history_bytes = sizeof(PM4S_HistorySnapshot) * history.snapshot_count +
+                                     sizeof(PM4S_RegisterWrite) * history.write_count +
+                                     sizeof(PM4S_State) * keyframe_count;
+   std::printf("shadow.dwords: %zu\n", pm4.size());
+   std::printf("shadow.snapshots: %zu\n", history.snapshot_count);
+   std::printf("shadow.writes_per_snapshot: %.1f\n",
+               double(history.write_count) / double(history.snapshot_count));
+   std::printf("shadow.history_bytes: %zu\n", history_bytes);
+   std::printf("shadow.full_copy_bytes: %zu\n", sizeof(PM4S_State) * history.snapshot_count);
+   BENCH_PrintRate("shadow.mdwords_per_second", double(pm4.size()), seconds);
+   std::printf("shadow.restore_microseconds: %.2f\n",
+               restore_seconds / double(checked_states.size()) * 1.0e6);
+   PM4S_HistoryDestroy(&history);
+   return true;
+}
+
+// Counting of the packets and the register writes, compared to copying the same amount of memory.
+static bool BENCH_Histogram() {
+   std::vector<uint32_t> const pm4 = BENCH_GeneratePM4(1 << 20, 0x3C6EF372FE94F82B);
+   auto const histogram = std::make_unique<PM4H_Histogram>();
+   double const seconds = BENCH_Measure([&]() {
+      PM4H_HistogramInit(histogram.get());
+      PM4H_HistogramAddBuffer(histogram.get(), pm4.data(), uint32_t(pm4.size()));
+   });
+
+   std::vector<uint32_t> copy(pm4.size());
+   double const copy_seconds = BENCH_Measure(
+      [&]() { std::memcpy(copy.data(), pm4.data(), sizeof(uint32_t) * pm4.size()); });
+
+   // The counts from the headers must be the same as from the decoded packets.
+   auto const reference = std::make_unique<PM4H_Histogram>();
+   PM4H_HistogramInit(reference.get());
+   std::vector<PM4P_Packet> packets(256);
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, pm4.data(), uint32_t(pm4.size()));
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets.data(), uint32_t(packets.size()))) != 0) {
+      PM4H_HistogramAdd(reference.get(), packets.data(), packet_count);
+   }
+   uint64_t dword_count = 0;
+   for (PM4H_PacketCounts const & counts : histogram->types) {
+      dword_count += counts.dword_count;
+   }
+   if (dword_count != pm4.size() || copy != pm4 ||
+       std::memcmp(histogram.get(), reference.get(), sizeof(PM4H_Histogram))) {
+      std::fputs("The histogram doesn't match the decoded packets.\n", stderr);
+      return false;
+   }
+   std::printf("histogram.dwords: %zu\n", pm4.size());
+   BENCH_PrintRate("histogram.mdwords_per_second", double(pm4.size()), seconds);
+   BENCH_PrintRate("histogram.copy_mdwords_per_second", double(pm4.size()), copy_seconds);
+   return true;
+}
+
+// Selecting packets by the opcode and by the register values, and printing only the matching ones,
+// compared to printing everything for searching the text.
+static bool BENCH_Query() {
+   std::vector<uint32_t> const pm4 = BENCH_GeneratePM4(1 << 18, 0x1F83D9ABFB41BD6B);
+   uint32_t const pm4_dword_count = uint32_t(pm4.size());
+   struct BENCH_QueryCase {
+      char const * name;
+      PM4Q_Query query;
+   };
+   BENCH_QueryCase cases[2];
+   cases[0].name = "opcode";
+   PM4Q_QueryInit(&cases[0].query);
+   PM4Q_QueryAddOpcode(&cases[0].query, 0x46);
+   cases[1].name = "value";
+   PM4Q_QueryInit(&cases[1].query);
+   cases[1].query.has_registers = true;
+   cases[1].query.register_first = 0x28000 / sizeof(uint32_t);
+   cases[1].query.register_last = 0x28FFC / sizeof(uint32_t);
+   cases[1].query.has_value = true;
+   cases[1].query.value_expected = 0x42;
+   cases[1].query.value_mask = 0xFF;
+
+   std::vector<PM4P_Packet> packets(pm4.size());
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, pm4.data(), pm4_dword_count);
+   packets.resize(PM4P_Decode(&decoder, packets.data(), uint32_t(packets.size())));
+
+   TXTW_Writer text;
+   TXTW_InitGrowable(&text, nullptr, 0);
+   double const print_seconds = BENCH_Measure([&]() {
+      text.size = 0;
+      PM4P_Write(&text, pm4.data(), pm4_dword_count, PM4P_GetFamily(PM4P_FAMILY_EVERGREEN));
+   });
+   BENCH_PrintRate("query.print_all_mdwords_per_second", pm4_dword_count, print_seconds);
+
+   for (BENCH_QueryCase const & query_case : cases) {
+      PM4Q_Query const & query = query_case.query;
+      // Checked against the conditions evaluated directly.
+      uint32_t reference_match_count = 0;
+      for (PM4P_Packet const & packet : packets) {
+         bool matches = !query.has_opcodes || (packet.type == 3 && packet.opcode == 0x46);
+         if (query.has_value) {
+            bool has_value = false;
+            for (uint32_t value_index = 2; value_index < 1 + packet.body_dword_count &&
+                                           packet.register_base == query.register_first;
+                 ++value_index) {
+               has_value |= packet.register_first + (value_index - 2) <= query.register_last &&
+                            (packet.dwords[value_index] & query.value_mask) ==
+                               query.value_expected;
+            }
+            matches = matches && has_value;
+         }
+         reference_match_count += matches;
+      }
+      uint32_t match_count = 0;
+      double const seconds = BENCH_Measure([&]() {
+         text.size = 0;
+         match_count = 0;
+         PM4P_Decoder query_decoder;
+         PM4P_DecoderInit(&query_decoder, pm4.data(), pm4_dword_count);
+         PM4P_Packet batch[256];
+         uint32_t match_indices[256];
+         uint32_t packet_count;
+         while ((packet_count = PM4P_Decode(&query_decoder, batch,
+                                            sizeof(batch) / sizeof(batch[0]))) != 0) {
+            uint32_t const batch_match_count =
+               PM4Q_Match(&query, batch, packet_count, match_indices);
+            for (uint32_t match_index = 0; match_index < batch_match_count; ++match_index) {
+               PM4P_PrintPackets(&text, &batch[match_indices[match_index]], 1,
+                                 PM4P_GetFamily(PM4P_FAMILY_EVERGREEN));
+            }
+            match_count += batch_match_count;
+         }
+      });
+      if (match_count != reference_match_count) {
+         std::fprintf(stderr, "The %s query matches %" PRIu32 " packets, not %" PRIu32 ".\n",
+                      query_case.name, match_count, reference_match_count);
+         TXTW_Destroy(&text);
+         return false;
+      }
+      BENCH_PrintRate(std::string("query.") + query_case.name + ".mdwords_per_second",
+                      pm4_dword_count, seconds);
+      std::printf("query.%s.matches: %" PRIu32 "\n", query_case.name, reference_match_count);
+   }
+   std::printf("query.packets: %zu\n", packets.size());
+   return TXTW_Destroy(&text);
+}
+
+// Deduplication of the command buffers of consecutive frames differing in a few register values,
+// compared to copying them to the ring, which is done anyway.
+static bool BENCH_Dedup() {
+   std::vector<uint32_t> const first_frame = BENCH_GeneratePM4(1 << 16, 0x510E527FADE682D1);
+   uint32_t const frame_count = 16;
+   std::vector<std::vector<uint32_t>> frames(frame_count, first_frame);
+   uint64_t random_state = 0x9B05688C2B3E6C1F;
+   for (uint32_t frame_index = 1; frame_index < frame_count; ++frame_index) {
+      for (uint32_t change_index = 0; change_index < 16; ++change_index) {
+         std::vector<uint32_t> & frame = frames[frame_index];
+         frame[BENCH_Random(random_state) % frame.size()] = BENCH_Random(random_state);
+      }
+   }
+   uint32_t const chunk_size = 4096;
+   uint32_t const frame_size = uint32_t(sizeof(uint32_t) * first_frame.size());
+   uint32_t const chunk_count = KMTC_GetChunkCount(frame_size, chunk_size);
+
+   uint64_t hash_checksum = 0;
+   double const hash_seconds = BENCH_Measure([&]() {
+      hash_checksum = 0;
+      for (std::vector<uint32_t> const & frame : frames) {
+         for (uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+            uint32_t const chunk_offset = chunk_size * chunk_index;
+            hash_checksum ^= KMTC_Hash(
+               reinterpret_cast<uint8_t const *>(frame.data()) + chunk_offset,
+               std::min(chunk_size, frame_size - chunk_offset));
+         }
+      }
+   });
+
+   uint64_t new_chunk_size = 0;
+   double const seconds = BENCH_Measure([&]() {
+      new_chunk_size = 0;
+      KMTD_Begin(chunk_size);
+      for (std::vector<uint32_t> const & frame : frames) {
+         for (uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+            uint32_t const chunk_offset = chunk_size * chunk_index;
+            uint32_t const size = std::min(chunk_size, frame_size - chunk_offset);
+            uint64_t const hash =
+               KMTC_Hash(reinterpret_cast<uint8_t const *>(frame.data()) + chunk_offset, size);
+            bool is_new;
+            KMTD_AddChunk(hash, size, is_new);
+            new_chunk_size += is_new ? size : 0;
+         }
+      }
+      KMTD_End();
+   });
+
+   std::vector<uint32_t> copy(first_frame.size());
+   double const copy_seconds = BENCH_Measure([&]() {
+      for (std::vector<uint32_t> const & frame : frames) {
+         std::memcpy(copy.data(), frame.data(), frame_size);
+      }
+   });
+
+   double const submitted_size = double(frame_size) * frame_count;
+   std::printf("dedup.submitted_bytes: %.0f\n", submitted_size);
+   std::printf("dedup.stored_bytes: %" PRIu64 "\n", new_chunk_size);
+   std::printf("dedup.hash_checksum: %016" PRIX64 "\n", hash_checksum);
+   BENCH_PrintRate("dedup.hash_mbytes_per_second", submitted_size, hash_seconds);
+   BENCH_PrintRate("dedup.mbytes_per_second", submitted_size, seconds);
+   BENCH_PrintRate("dedup.copy_mbytes_per_second", submitted_size, copy_seconds);
+   return true;
+}
+
+// Alignment of the packet shapes of two long command streams differing in scattered places, like
+// the captures of the same application with two driver versions.
+static bool BENCH_Diff() {
+   uint32_t const packet_count = 1 << 22;
+   // Few distinct shapes, as most packets of a capture are writes of the same register ranges.
+   uint32_t const shape_count = 64;
+   uint64_t random_state = 0x1F83D9ABFB41BD6B;
+   std::vector<uint64_t> a(packet_count);
+   for (uint64_t & shape : a) {
+      shape = BENCH_Random(random_state) % shape_count;
+   }
+   // Removing, inserting or replacing a few packets in every edited place.
+   std::vector<uint64_t> b;
+   b.reserve(packet_count + packet_count / 64);
+   uint32_t const edit_count = 4096;
+   uint64_t applied_edit_count = 0;
+   uint32_t a_index = 0;
+   for (uint32_t edit_index = 0; edit_index < edit_count; ++edit_index) {
+      uint32_t const edit_end = uint32_t(uint64_t(packet_count) * (edit_index + 1) / edit_count);
+      uint32_t const edit_begin = edit_end - 1 - BENCH_Random(random_state) % 256;
+      b.insert(b.end(), a.begin() + a_index, a.begin() + edit_begin);
+      uint32_t const removed_count = BENCH_Random(random_state) % 4;
+      uint32_t const inserted_count = BENCH_Random(random_state) % 4;
+      for (uint32_t inserted_index = 0; inserted_index < inserted_count; ++inserted_index) {
+         b.push_back(shape_count + BENCH_Random(random_state) % shape_count);
+      }
+      applied_edit_count += removed_count + inserted_count;
+      a_index = edit_begin + removed_count;
+   }
+   b.insert(b.end(), a.begin() + a_index, a.end());
+
+   uint32_t const max_cost = 1024;
+   std::vector<CAPT_DiffRun> runs;
+   double const seconds = BENCH_Measure([&]() {
+      runs.clear();
+      CAPT_Diff(a.data(), uint32_t(a.size()), b.data(), uint32_t(b.size()), max_cost, runs);
+   });
+
+   // The runs must transform the first sequence into the second.
+   uint64_t found_edit_count = 0;
+   uint32_t a_position = 0, b_position = 0;
+   for (CAPT_DiffRun const & run : runs) {
+      if (run.a_begin != a_position || run.b_begin != b_position) {
+         std::fputs("diff: The runs are not contiguous.\n", stderr);
+         return false;
+      }
+      if (run.operation == CAPT_DIFF_EQUAL) {
+         if (!std::equal(a.begin() + a_position, a.begin() + a_position + run.count,
+                         b.begin() + b_position)) {
+            std::fputs("diff: An equal run has different elements.\n", stderr);
+            return false;
+         }
+         a_position += run.count;
+         b_position += run.count;
+      } else {
+         found_edit_count += run.count;
+         (run.operation == CAPT_DIFF_REMOVED ? a_position : b_position) += run.count;
+      }
+   }
+   if (a_position != a.size() || b_position != b.size()) {
+      std::fputs("diff: The runs don't cover the sequences.\n", stderr);
+      return false;
+   }
+
+   std::printf("diff.applied_edits: %" PRIu64 "\n", applied_edit_count);
+   std::printf("diff.found_edits: %" PRIu64 "\n", found_edit_count);
+   BENCH_PrintRate("diff.mpackets_per_second", double(a.size() + b.size()), seconds);
+   return true;
+}
+
+// Starts a capture in memory with the file header of the current version.
+static void BENCH_InitCapture(std::vector<uint64_t> & capture) {
+   capture.assign(sizeof(KMTC_FileHeader) / sizeof(uint64_t), 0);
+   KMTC_FileHeader file_header = {};
+   file_header.magic = KMTC_MAGIC;
+   file_header.version = KMTC_VERSION;
+   file_header.header_size = sizeof(file_header);
+   std::memcpy(capture.data(), &file_header, sizeof(file_header));
+}
+
+// Appends a graphics submission with the command buffer and without the lists.
+static void BENCH_AppendRender(std::vector<uint64_t> & capture, uint32_t const context,
+                               uint64_t const timestamp,
+                               std::vector<uint32_t> const & command_buffer) {
+   KMTC_Render render = {};
+   render.context = context;
+   render.command_length = uint32_t(sizeof(uint32_t) * command_buffer.size());
+   KMTC_Blob const blobs[] = {
+      {command_buffer.data(), render.command_length}, {nullptr, 0}, {nullptr, 0},
+      {nullptr, 0}, {nullptr, 0},
+   };
+   uint32_t const blob_count = uint32_t(sizeof(blobs) / sizeof(blobs[0]));
+   uint32_t const event_size = KMTC_GetEventSize(uint32_t(sizeof(render)), blobs, blob_count);
+   std::size_t const event_offset = capture.size();
+   capture.resize(event_offset + event_size / sizeof(uint64_t));
+   KMTC_EventHeader header = {};
+   header.type = KMTC_EVENT_RENDER;
+   header.timestamp = timestamp;
+   KMTC_SerializeEvent(capture.data() + event_offset, &header, &render, uint32_t(sizeof(render)),
+                       blobs, blob_count);
+}
+
+// Reads the events of the capture, returning whether it has been read completely.
+static bool BENCH_ReadCapture(void const * const capture, std::size_t const capture_size,
+                              uint32_t & render_count) {
+   KMTC_Reader reader;
+   if (!KMTC_ReaderInit(&reader, capture, capture_size)) {
+      return false;
+   }
+   render_count = 0;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      KMTC_RenderView view;
+      render_count += KMTC_ParseRender(event, &view);
+   }
+   return KMTC_ReaderIsAtEnd(&reader);
+}
+
+// Reading the events of a capture. Checks that the capture cut anywhere, or with the size of an
+// event corrupted, is not considered read completely, as the commands would accept it otherwise.
+static bool BENCH_Reader() {
+   uint32_t const submission_count = 1 << 10;
+   uint64_t random_state = 0x3C6EF372FE94F82B;
+   std::vector<uint64_t> capture;
+   BENCH_InitCapture(capture);
+   for (uint32_t submission_index = 0; submission_index < submission_count; ++submission_index) {
+      BENCH_AppendRender(capture, 0x40000100, submission_index,
+                         BENCH_GeneratePM4(1 << 8, random_state));
+      random_state = random_state * 0x5851F42D4C957F2D + 1;
+   }
+   std::size_t const capture_size = sizeof(uint64_t) * capture.size();
+   uint32_t render_count = 0;
+   bool read = true;
+   double const seconds = BENCH_Measure(
+      [&]() { read &= BENCH_ReadCapture(capture.data(), capture_size, render_count); });
+   if (!read || render_count != submission_count) {
+      std::fputs("The capture is not read completely.\n", stderr);
+      return false;
+   }
+
+   // Cut in the middle of events and of their headers, and right after the file header.
+   for (uint32_t cut_index = 0; cut_index < 256; ++cut_index) {
+      std::size_t const cut_size =
+         cut_index == 0 ? sizeof(KMTC_FileHeader) + sizeof(uint64_t)
+                        : sizeof(KMTC_FileHeader) +
+                             (BENCH_Random(random_state) % (capture_size - sizeof(KMTC_FileHeader)));
+      // Cuts at event boundaries leave a well-formed capture.
+      KMTC_Reader reader;
+      KMTC_ReaderInit(&reader, capture.data(), capture_size);
+      bool is_boundary = false;
+      while (!is_boundary && reader.offset <= cut_size && KMTC_ReaderNext(&reader)) {
+         is_boundary = reader.offset == cut_size;
+      }
+      if (is_boundary) {
+         continue;
+      }
+      if (BENCH_ReadCapture(capture.data(), cut_size, render_count)) {
+         std::fprintf(stderr, "The capture cut to %zu bytes is read completely.\n", cut_size);
+         return false;
+      }
+   }
+   std::vector<uint64_t> corrupt = capture;
+   KMTC_EventHeader * const first_event = reinterpret_cast<KMTC_EventHeader *>(
+      reinterpret_cast<uint8_t *>(corrupt.data()) + sizeof(KMTC_FileHeader));
+   first_event->size += KMTC_ALIGNMENT / 2;
+   if (BENCH_ReadCapture(corrupt.data(), capture_size, render_count)) {
+      std::fputs("The capture with a misaligned event size is read completely.\n", stderr);
+      return false;
+   }
+
+   std::printf("reader.capture_bytes: %zu\n", capture_size);
+   BENCH_PrintRate("reader.mevents_per_second", double(submission_count), seconds);
+   return true;
+}
+
+// Indexing a capture of many submissions, with a few of them containing a rare opcode, and the
+// share of the chunks of submissions that a query for it can skip. Checks that no chunk containing
+// the opcode is skipped.
+static bool BENCH_Index() {
+   uint32_t const submission_count = 1 << 12;
+   uint32_t const rare_opcode = 0x47;
+   uint64_t random_state = 0x5BE0CD19137E2179;
+   std::vector<uint64_t> capture;
+   BENCH_InitCapture(capture);
+   std::vector<bool> rare_submissions(submission_count);
+   for (uint32_t submission_index = 0; submission_index < submission_count; ++submission_index) {
+      std::vector<uint32_t> command_buffer = BENCH_GeneratePM4(1 << 10, random_state);
+      random_state = random_state * 0x5851F42D4C957F2D + 1;
+      if (BENCH_Random(random_state) % 256 == 0) {
+         rare_submissions[submission_index] = true;
+         command_buffer.push_back((uint32_t(3) << 30) | (uint32_t(0) << 16) | (rare_opcode << 8));
+         command_buffer.push_back(0);
+      }
+      BENCH_AppendRender(capture, 0x40000100 + submission_index % 4 * 0x40, submission_index,
+                         command_buffer);
+   }
+   std::size_t const capture_size = sizeof(uint64_t) * capture.size();
+
+   std::FILE * const file = std::tmpfile();
+   if (!file) {
+      std::fputs("Failed to create a temporary file.\n", stderr);
+      return false;
+   }
+   bool written = true;
+   double const seconds = BENCH_Measure([&]() {
+      std::rewind(file);
+      KMTC_Reader reader;
+      KMTC_ReaderInit(&reader, capture.data(), capture_size);
+      CAPT_CommandBuffers commands;
+      CAPT_CommandBuffersInit(commands, reader, nullptr);
+      written &= CAPT_WriteIndex(reader, commands, file);
+   });
+   // The index is a multiple of 8 bytes.
+   std::size_t index_size = 0;
+   std::vector<uint64_t> index;
+   if (written && !std::fseek(file, 0, SEEK_END)) {
+      index_size = std::size_t(std::ftell(file));
+      index.resize(index_size / sizeof(uint64_t));
+      std::rewind(file);
+      written = std::fread(index.data(), 1, index_size, file) == index_size;
+   }
+   std::fclose(file);
+   uint32_t chunk_count = 0;
+   CAPT_IndexChunk const * const chunks =
+      written ? CAPT_GetIndexChunks(index.data(), index_size, capture_size, chunk_count) : nullptr;
+   if (!chunks) {
+      std::fputs("Failed to index the capture.\n", stderr);
+      return false;
+   }
+
+   PM4Q_Query query;
+   PM4Q_QueryInit(&query);
+   PM4Q_QueryAddOpcode(&query, rare_opcode);
+   uint32_t matching_chunk_count = 0;
+   uint32_t entry_count = 0;
+   for (uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+      CAPT_IndexChunk const & chunk = chunks[chunk_index];
+      bool const may_match = CAPT_IndexChunkMayMatch(chunk, query);
+      matching_chunk_count += may_match;
+      for (uint32_t entry_index = 0; entry_index < chunk.entry_count; ++entry_index) {
+         if (rare_submissions[entry_count++] && !may_match) {
+            std::fprintf(stderr, "Chunk %" PRIu32 " with the opcode is skipped.\n", chunk_index);
+            return false;
+         }
+      }
+   }
+   if (entry_count != submission_count) {
+      std::fputs("The index doesn't have all the submissions.\n", stderr);
+      return false;
+   }
+   std::printf("index.capture_bytes: %zu\n", capture_size);
+   std::printf("index.index_bytes: %zu\n", index_size);
+   std::printf("index.read_chunk_fraction: %.3f\n", double(matching_chunk_count) / chunk_count);
+   BENCH_PrintRate("index.mbytes_per_second", double(capture_size), seconds);
+   return true;
+}
+
+// Compression of the command buffers of consecutive frames with one model, like the submissions of
+// a context in a capture, and decompression with a new one, compared to copying.
+static bool BENCH_Codec() {
+   uint32_t const frame_count = 16;
+   std::vector<std::vector<uint32_t>> frames;
+   for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+      frames.push_back(BENCH_GenerateDrawPM4(1 << 12, 0x1F83D9ABFB41BD6B + frame_index));
+   }
+   std::vector<std::vector<uint8_t>> encoded_frames(frame_count);
+   std::vector<std::size_t> encoded_sizes(frame_count);
+   auto const model = std::make_unique<PM4Z_Model>();
+   double const encode_seconds = BENCH_Measure([&]() {
+      PM4Z_ModelInit(model.get());
+      for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+         std::vector<uint32_t> const & frame = frames[frame_index];
+         std::vector<uint8_t> & encoded = encoded_frames[frame_index];
+         encoded.resize(PM4Z_GetMaxEncodedSize(uint32_t(frame.size())));
+         encoded_sizes[frame_index] =
+            PM4Z_Encode(model.get(), frame.data(), uint32_t(frame.size()), encoded.data());
+      }
+   });
+
+   std::vector<std::vector<uint32_t>> decoded_frames(frame_count);
+   for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+      decoded_frames[frame_index].resize(frames[frame_index].size());
+   }
+   bool succeeded = true;
+   double const decode_seconds = BENCH_Measure([&]() {
+      PM4Z_ModelInit(model.get());
+      for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+         std::vector<uint32_t> & decoded = decoded_frames[frame_index];
+         succeeded &= PM4Z_Decode(model.get(), encoded_frames[frame_index].data(),
+                                  encoded_sizes[frame_index], decoded.data(),
+                                  uint32_t(decoded.size()));
+      }
+   });
+   if (!succeeded || decoded_frames != frames) {
+      std::fputs("The decoded command buffers don't match.\n", stderr);
+      return false;
+   }
+
+   std::vector<uint32_t> copy;
+   double const copy_seconds = BENCH_Measure([&]() {
+      for (std::vector<uint32_t> const & frame : frames) {
+         copy.assign(frame.begin(), frame.end());
+      }
+   });
+
+   double raw_size = 0;
+   double encoded_size = 0;
+   for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+      raw_size += double(sizeof(uint32_t) * frames[frame_index].size());
+      encoded_size += double(encoded_sizes[frame_index]);
+   }
+   std::printf("codec.raw_bytes: %.0f\n", raw_size);
+   std::printf("codec.encoded_bytes: %.0f\n", encoded_size);
+   std::printf("codec.ratio: %.2f\n", raw_size / encoded_size);
+   BENCH_PrintRate("codec.encode_mbytes_per_second", raw_size, encode_seconds);
+   BENCH_PrintRate("codec.decode_mbytes_per_second", raw_size, decode_seconds);
+   BENCH_PrintRate("codec.copy_mbytes_per_second", raw_size, copy_seconds);
+   return true;
+}
+
+// Resolution of the allocation lists of submissions in the allocation registry by concurrent
+// submitting threads while another thread keeps creating and locking allocations.
+static bool BENCH_Allocations() {
+   uint32_t const allocation_count = 1 << 14;
+   uint32_t const list_size = 256;
+   uint32_t const list_count = 1 << 10;
+   // Like the kernel handles, with the index in the table above a few constant bits.
+   auto const get_handle = [](uint32_t const index) { return 0x40000000 | (index << 6) | 0x2; };
+   uint8_t private_driver_data[96] = {};
+   uint64_t random_state = 0x1F83D9ABFB41BD6B;
+   auto const create_allocations = [&]() {
+      for (uint32_t allocation_index = 0; allocation_index < allocation_count; ++allocation_index) {
+         KMTA_AddAllocation(get_handle(allocation_index), 1, 0, 0, 0, private_driver_data,
+                            uint32_t(sizeof(private_driver_data)), 1 + allocation_index);
+         if (allocation_index & 1) {
+            KMTA_SetLocked(get_handle(allocation_index), private_driver_data,
+                           sizeof(private_driver_data), uint64_t(allocation_index) << 16);
+         }
+      }
+   };
+   std::vector<uint32_t> lists(list_size * list_count);
+   uint32_t expected_locked_count = 0;
+   for (uint32_t & allocation : lists) {
+      uint32_t const allocation_index = BENCH_Random(random_state) % allocation_count;
+      allocation = get_handle(allocation_index);
+      expected_locked_count += allocation_index & 1;
+   }
+
+   double const create_seconds = BENCH_Measure([&]() {
+      create_allocations();
+      KMTA_End();
+   });
+   BENCH_PrintRate("allocations.creations_per_second", allocation_count, create_seconds);
+
+   uint32_t const hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+   for (uint32_t thread_count = 1; thread_count <= hardware_thread_count; thread_count *= 2) {
+      create_allocations();
+      std::vector<uint32_t> locked_counts(thread_count);
+      double const seconds = BENCH_Measure([&]() {
+         std::vector<std::thread> threads;
+         threads.reserve(thread_count);
+         for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+            threads.emplace_back([&, thread_index]() {
+               uint32_t locked_count = 0;
+               for (uint32_t const allocation : lists) {
+                  KMTA_Allocation record;
+                  locked_count += KMTA_FindAllocation(allocation, record) && record.locked_data;
+               }
+               locked_counts[thread_index] = locked_count;
+            });
+         }
+         // Relocking existing allocations, as the submitters' allocations are being mapped.
+         for (uint32_t allocation_index = 1; allocation_index < allocation_count;
+              allocation_index += 2) {
+            KMTA_SetLocked(get_handle(allocation_index), private_driver_data,
+                           sizeof(private_driver_data), uint64_t(allocation_index) << 16);
+         }
+         for (std::thread & thread : threads) {
+            thread.join();
+         }
+      });
+      KMTA_End();
+      if (std::count(locked_counts.begin(), locked_counts.end(), expected_locked_count) !=
+          std::ptrdiff_t(thread_count)) {
+         std::fprintf(stderr, "The allocation lookups are inconsistent.\n");
+         return false;
+      }
+      BENCH_PrintRate("allocations.threads_" + std::to_string(thread_count) +
+                         ".lookups_per_second",
+                      double(lists.size()) * thread_count, seconds);
+   }
+   return true;
+}
+
+// Buffers that the stand-in of D3DKMTRender alternates between for a context, like the kernel
+// returning new buffers after every submission.
+struct BENCH_RenderBuffers {
+   uint32_t command_buffers[2][64];
+   uint64_t allocation_lists[2][8];
+   uint64_t patch_location_lists[2][8];
+};
+
+struct BENCH_Render {
+   uint32_t context;
+   void * command_buffer;
+   void * new_command_buffer;
+   void * new_allocation_list;
+   void * new_patch_location_list;
+};
+
+static std::vector<BENCH_RenderBuffers> bench_render_buffers;
+
+// Stand-in of Real_NtGdiDdDDIRender, called through a pointer like the real one.
+static int32_t BENCH_RenderImpl(BENCH_Render * const render) {
+   BENCH_RenderBuffers & buffers = bench_render_buffers[render->context - 1];
+   uint32_t const next = render->command_buffer == buffers.command_buffers[0] ? 1 : 0;
+   buffers.command_buffers[next][0] = static_cast<uint32_t const *>(render->command_buffer)[0] + 1;
+   render->new_command_buffer = buffers.command_buffers[next];
+   render->new_allocation_list = buffers.allocation_lists[next];
+   render->new_patch_location_list = buffers.patch_location_lists[next];
+   return 0;
+}
+
+static int32_t (* volatile bench_real_render)(BENCH_Render *) = BENCH_RenderImpl;
+
+// Context lookups and buffer updates around submissions by threads each submitting to its own
+// context, in the context table compared to a map behind a shared mutex, locked shared for the
+// lookup and exclusively for the update, like the interceptor used to do.
+static bool BENCH_Contexts() {
+   uint32_t const submission_count = 1 << 16;
+   std::shared_mutex reference_mutex;
+   std::unordered_map<uint32_t, KMTX_Context> reference_contexts;
+
+   uint32_t const hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+   for (uint32_t thread_count = 1; thread_count <= hardware_thread_count; thread_count *= 2) {
+      bench_render_buffers.assign(thread_count, BENCH_RenderBuffers());
+      auto const reset_contexts = [&]() {
+         KMTX_End();
+         reference_contexts.clear();
+         for (uint32_t context = 1; context <= thread_count; ++context) {
+            BENCH_RenderBuffers & buffers = bench_render_buffers[context - 1];
+            KMTX_Context const info = {0, buffers.command_buffers[0], buffers.allocation_lists[0],
+                                       buffers.patch_location_lists[0]};
+            KMTX_AddContext(context, info);
+            reference_contexts.emplace(context, info);
+         }
+      };
+
+      for (bool const is_reference : {true, false}) {
+         std::vector<uint32_t> unknown_counts(thread_count);
+         double const seconds = BENCH_Measure([&]() {
+            reset_contexts();
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+               threads.emplace_back([&, thread_index]() {
+                  uint32_t const context = thread_index + 1;
+                  uint32_t unknown_count = 0;
+                  for (uint32_t submission_index = 0; submission_index < submission_count;
+                       ++submission_index) {
+                     KMTX_Context info;
+                     bool found;
+                     if (is_reference) {
+                        std::shared_lock<std::shared_mutex> lock(reference_mutex);
+                        auto const iterator = reference_contexts.find(context);
+                        found = iterator != reference_contexts.end();
+                        if (found) {
+                           info = iterator->second;
+                        }
+                     } else {
+                        found = KMTX_FindContext(context, info);
+                     }
+                     if (!found) {
+                        ++unknown_count;
+                        continue;
+                     }
+                     BENCH_Render render = {};
+                     render.context = context;
+                     render.command_buffer = info.command_buffer;
+                     bench_real_render(&render);
+                     if (is_reference) {
+                        std::unique_lock<std::shared_mutex> lock(reference_mutex);
+                        KMTX_Context & update = reference_contexts.find(context)->second;
+                        update.command_buffer = render.new_command_buffer;
+                        update.allocation_list = render.new_allocation_list;
+                        update.patch_location_list = render.new_patch_location_list;
+                     } else {
+                        KMTX_SetBuffers(context, render.new_command_buffer,
+                                        render.new_allocation_list,
+                                        render.new_patch_location_list);
+                     }
+                  }
+                  unknown_counts[thread_index] = unknown_count;
+               });
+            }
+            for (std::thread & thread : threads) {
+               thread.join();
+            }
+         });
+         if (std::count(unknown_counts.begin(), unknown_counts.end(), 0u) !=
+             std::ptrdiff_t(thread_count)) {
+            std::fprintf(stderr, "Contexts have not been found.\n");
+            return false;
+         }
+         BENCH_PrintRate("contexts.threads_" + std::to_string(thread_count) +
+                            (is_reference ? ".shared_mutex" : "") + ".submissions_per_second",
+                         double(submission_count) * thread_count, seconds);
+      }
+   }
+   KMTX_End();
+   return true;
+}
+
+// Recording submissions from a synthetic producer to the rings, with the writer writing them to a
+// file continuously or keeping them in the memory of the flight recorder, compared to copying the
+// command buffers. Checks that a trigger dumps the latest events.
+static bool BENCH_Flight() {
+   std::vector<uint32_t> const command_buffer = BENCH_GeneratePM4(1 << 12, 0x3C6EF372FE94F82B);
+   uint32_t const command_length = uint32_t(sizeof(uint32_t) * command_buffer.size());
+   uint32_t const submission_count = 1 << 11;
+   std::size_t const history_size = std::size_t(64) << 20;
+   KMTC_Render render = {};
+   render.node_ordinal = 0;
+   render.command_length = command_length;
+   KMTC_Blob const blobs[] = {
+      {command_buffer.data(), command_length}, {nullptr, 0}, {nullptr, 0},
+      {nullptr, 0}, {nullptr, 0},
+   };
+   uint32_t const blob_count = uint32_t(sizeof(blobs) / sizeof(blobs[0]));
+   uint32_t const event_size = KMTC_GetEventSize(uint32_t(sizeof(render)), blobs, blob_count);
+   uint64_t timestamp = 0;
+   auto const record = [&]() {
+      for (uint32_t submission_index = 0; submission_index < submission_count;
+           ++submission_index) {
+         void * const event = KMTR_Reserve(event_size);
+         if (!event) {
+            continue;
+         }
+         KMTC_EventHeader header = {};
+         header.type = KMTC_EVENT_RENDER;
+         header.timestamp = ++timestamp;
+         KMTC_SerializeEvent(event, &header, &render, uint32_t(sizeof(render)), blobs, blob_count);
+         KMTR_Commit();
+      }
+   };
+
+   double const recorded_size = double(event_size) * submission_count;
+   for (bool const is_flight : {false, true}) {
+      std::FILE * const file = std::tmpfile();
+      if (!file) {
+         std::fprintf(stderr, "Failed to create a temporary file.\n");
+         return false;
+      }
+      KMTR_Begin(file, std::size_t(16) << 20, is_flight ? history_size : 0);
+      double const seconds = BENCH_Measure(record);
+      if (is_flight) {
+         KMTR_Trigger(KMTC_TRIGGER_HOTKEY, 0, ++timestamp);
+      }
+      KMTR_End();
+      if (is_flight) {
+         // Only the latest events fitting in the memory are expected after the trigger.
+         std::vector<uint8_t> dump(std::size_t(std::ftell(file)));
+         std::rewind(file);
+         bool is_dump_valid = std::fread(dump.data(), 1, dump.size(), file) == dump.size();
+         uint64_t expected_timestamp = timestamp - history_size / event_size;
+         for (std::size_t offset = 0; is_dump_valid && offset < dump.size();) {
+            KMTC_EventHeader header;
+            std::memcpy(&header, dump.data() + offset, sizeof(header));
+            is_dump_valid = offset ? header.type == KMTC_EVENT_RENDER &&
+                                        header.timestamp == expected_timestamp++
+                                   : header.type == KMTC_EVENT_TRIGGER;
+            offset += header.size;
+         }
+         if (!is_dump_valid || expected_timestamp != timestamp) {
+            std::fprintf(stderr, "The flight recorder has dumped wrong events.\n");
+            std::fclose(file);
+            return false;
+         }
+      }
+      std::fclose(file);
+      BENCH_PrintRate(std::string("flight.") + (is_flight ? "flight" : "continuous") +
+                         "_mbytes_per_second",
+                      recorded_size, seconds);
+   }
+
+   // Through memory of the size of a ring, like the producer.
+   std::size_t const copy_count = (std::size_t(16) << 20) / event_size;
+   std::vector<uint8_t> copy(event_size * copy_count);
+   double const copy_seconds = BENCH_Measure([&]() {
+      for (uint32_t submission_index = 0; submission_index < submission_count;
+           ++submission_index) {
+         std::memcpy(copy.data() + event_size * (submission_index % copy_count),
+                     command_buffer.data(), command_length);
+      }
+   });
+   BENCH_PrintRate("flight.copy_mbytes_per_second", recorded_size, copy_seconds);
+   return true;
+}
+
+// The size of an event of the synthetic producers, from small to larger than half of the smallest
+// ring for every 64th event, which is written directly rather than through the ring.
+static uint32_t BENCH_GetProducerEventSize(uint32_t const thread_index,
+                                           uint32_t const event_index) {
+   uint32_t const payload_size = event_index % 64 == 63
+                                    ? (uint32_t(48) << 10) + 8 * thread_index
+                                    : 8 * ((event_index * 7 + thread_index * 13) % 512);
+   return uint32_t(sizeof(KMTC_EventHeader)) + payload_size;
+}
+
+// The payload of an event of the synthetic producers, identifying it.
+static uint8_t BENCH_GetProducerEventByte(uint32_t const thread_index, uint32_t const event_index,
+                                          uint32_t const byte_index) {
+   return uint8_t(thread_index * 31 + event_index * 17 + byte_index);
+}
+
+// Recording from many producer threads at once to one writer, through rings small enough to wrap
+// and fill up often, with some events too large for the rings. Checks that every event is written
+// exactly once, intact, and in the order of recording of its thread.
+static bool BENCH_Rings() {
+   uint32_t const thread_count = 8;
+   uint32_t const event_count = 1 << 12;
+   std::size_t recorded_size = 0;
+   for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+      for (uint32_t event_index = 0; event_index < event_count; ++event_index) {
+         recorded_size += BENCH_GetProducerEventSize(thread_index, event_index);
+      }
+   }
+   auto const produce = [event_count](uint32_t const thread_index) {
+      for (uint32_t event_index = 0; event_index < event_count; ++event_index) {
+         uint32_t const size = BENCH_GetProducerEventSize(thread_index, event_index);
+         uint8_t * const event = static_cast<uint8_t *>(KMTR_Reserve(size));
+         if (!event) {
+            return;
+         }
+         KMTC_EventHeader header = {};
+         header.type = KMTC_EVENT_ESCAPE;
+         header.size = size;
+         header.thread_id = thread_index;
+         header.timestamp = event_index;
+         std::memcpy(event, &header, sizeof(header));
+         for (uint32_t byte_index = sizeof(header); byte_index < size; ++byte_index) {
+            event[byte_index] = BENCH_GetProducerEventByte(thread_index, event_index, byte_index);
+         }
+         KMTR_Commit();
+      }
+   };
+   // The file of the last run is checked.
+   std::FILE * file = nullptr;
+   double const seconds = BENCH_Measure([&]() {
+      if (file) {
+         std::fclose(file);
+      }
+      file = std::tmpfile();
+      if (!file) {
+         return;
+      }
+      KMTR_Begin(file, 0, 0);
+      std::vector<std::thread> threads;
+      for (uint32_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+         threads.emplace_back(produce, thread_index);
+      }
+      for (std::thread & thread : threads) {
+         thread.join();
+      }
+      KMTR_End();
+   });
+   if (!file) {
+      std::fputs("Failed to create a temporary file.\n", stderr);
+      return false;
+   }
+
+   std::vector<uint8_t> written(std::size_t(std::ftell(file)));
+   std::rewind(file);
+   bool is_valid = std::fread(written.data(), 1, written.size(), file) == written.size() &&
+                   written.size() == recorded_size;
+   std::fclose(file);
+   std::vector<uint32_t> next_event_indices(thread_count, 0);
+   for (std::size_t offset = 0; is_valid && offset < written.size();) {
+      KMTC_EventHeader header;
+      std::memcpy(&header, written.data() + offset, sizeof(header));
+      uint32_t const thread_index = header.thread_id;
+      if (thread_index >= thread_count || header.timestamp != next_event_indices[thread_index] ||
+          header.size != BENCH_GetProducerEventSize(thread_index, uint32_t(header.timestamp)) ||
+          header.size > written.size() - offset) {
+         is_valid = false;
+         break;
+      }
+      uint32_t const event_index = next_event_indices[thread_index]++;
+      for (uint32_t byte_index = sizeof(header); byte_index < header.size; ++byte_index) {
+         if (written[offset + byte_index] !=
+             BENCH_GetProducerEventByte(thread_index, event_index, byte_index)) {
+            is_valid = false;
+            break;
+         }
+      }
+      offset += header.size;
+   }
+   for (uint32_t const next_event_index : next_event_indices) {
+      is_valid &= next_event_index == event_count;
+   }
+   if (!is_valid) {
+      std::fputs("The events of the producers are missing, repeated, corrupt or reordered.\n",
+                 stderr);
+      return false;
+   }
+   std::printf("rings.threads: %" PRIu32 "\n", thread_count);
+   std::printf("rings.recorded_bytes: %zu\n", recorded_size);
+   BENCH_PrintRate("rings.mbytes_per_second", double(recorded_size), seconds);
+   return true;
+}
+
+struct BENCH_Benchmark {
+   char const * name;
+   bool (* function)();
+};
+
+static BENCH_Benchmark const bench_benchmarks[] = {
+   {"registers", BENCH_RegisterNames},
+   {"print", BENCH_Print},
+   {"resources", BENCH_Resources},
+   {"filler", BENCH_Filler},
+   {"shadow", BENCH_Shadow},
+   {"histogram", BENCH_Histogram},
+   {"query", BENCH_Query},
+   {"dedup", BENCH_Dedup},
+   {"diff", BENCH_Diff},
+   {"reader", BENCH_Reader},
+   {"index", BENCH_Index},
+   {"allocations", BENCH_Allocations},
+   {"contexts", BENCH_Contexts},
+   {"flight", BENCH_Flight},
+   {"rings", BENCH_Rings},
+   {"codec", BENCH_Codec},
+   {"recorded", BENCH_Recorded},
+};
+
+// Compares the rates with the ones in the output of a previous invocation, printing the changes.
+// Returns false if any of them has dropped by more than the tolerance.
+static bool BENCH_CompareWithBaseline(char const * const path, double const tolerance_percent) {
+   FILE * const file = std::fopen(path, "r");
+   if (!file) {
+      std::fprintf(stderr, "Failed to open %s.\n", path);
+      return false;
+   }
+   std::vector<std::pair<std::string, double>> baseline_rates;
+   char line[512];
+   while (std::fgets(line, sizeof(line), file)) {
+      char const * const separator = std::strstr(line, ": ");
+      if (!separator) {
+         continue;
+      }
+      baseline_rates.emplace_back(std::string(line, std::size_t(separator - line)),
+                                  std::strtod(separator + 2, nullptr));
+   }
+   std::fclose(file);
+
+   bool succeeded = true;
+   for (std::pair<std::string, double> const & rate : bench_rates) {
+      auto const baseline_rate =
+         std::find_if(baseline_rates.begin(), baseline_rates.end(),
+                      [&rate](std::pair<std::string, double> const & baseline) {
+                         return baseline.first == rate.first;
+                      });
+      if (baseline_rate == baseline_rates.end() || baseline_rate->second <= 0.0) {
+         continue;
+      }
+      double const change_percent = (rate.second / baseline_rate->second - 1.0) * 100.0;
+      std::printf("baseline.%s: %+.1f%%\n", rate.first.c_str(), change_percent);
+      if (change_percent < -tolerance_percent) {
+         std::fprintf(stderr, "%s has dropped from %.1f to %.1f.\n", rate.first.c_str(),
+                      baseline_rate->second, rate.second);
+         succeeded = false;
+      }
+   }
+   return succeeded;
+}
+
+// Usage: Benchmark [--runs N] [--pm4 <dump>]... [--baseline <output> [--tolerance <percent>]]
+//                  [benchmark]...
+// Runs all the benchmarks if none are named. The output has a "name: value" line per result, so
+// the output of a previous invocation can be used as the baseline.
+int main(int const argc, char const * const argv[]) {
+   std::vector<char const *> selected_names;
+   char const * baseline_path = nullptr;
+   double tolerance_percent = 10.0;
+   for (int argument_index = 1; argument_index < argc; ++argument_index) {
+      char const * const argument = argv[argument_index];
+      bool const has_value = argument_index + 1 < argc;
+      if (!std::strcmp(argument, "--runs") && has_value) {
+         bench_run_count = uint32_t(std::strtoul(argv[++argument_index], nullptr, 10));
+         if (bench_run_count == 0) {
+            std::fputs("The number of runs must be at least 1.\n", stderr);
+            return EXIT_FAILURE;
+         }
+      } else if (!std::strcmp(argument, "--pm4") && has_value) {
+         bench_recorded_pm4.emplace_back();
+         if (!BENCH_LoadPM4(argv[++argument_index], bench_recorded_pm4.back())) {
+            return EXIT_FAILURE;
+         }
+      } else if (!std::strcmp(argument, "--baseline") && has_value) {
+         baseline_path = argv[++argument_index];
+      } else if (!std::strcmp(argument, "--tolerance") && has_value) {
+         tolerance_percent = std::strtod(argv[++argument_index], nullptr);
+      } else {
+         selected_names.push_back(argument);
+      }
+   }
+
+   bool succeeded = true;
+   for (BENCH_Benchmark const & benchmark : bench_benchmarks) {
+      bool selected = selected_names.empty();
+      for (char const * const selected_name : selected_names) {
+         selected |= !std::strcmp(selected_name, benchmark.name);
+      }
+      if (selected && !benchmark.function()) {
+         std::fprintf(stderr, "Benchmark %s failed.\n", benchmark.name);
+         succeeded = false;
+      }
+   }
+   if (baseline_path && !BENCH_CompareWithBaseline(baseline_path, tolerance_percent)) {
+      succeeded = false;
+   }
+   return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
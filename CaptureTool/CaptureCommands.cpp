@@ -0,0 +1,125 @@
+#include "CaptureCommands.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// The amount of the capture to go through before releasing its pages when locating the chunks.
+static constexpr std::size_t CAPT_CHUNK_SCAN_RELEASE_SIZE = std::size_t(1) << 26;
+
+void CAPT_CommandBuffersInit(CAPT_CommandBuffers & commands, KMTC_Reader const & reader,
+                             CAPT_MappedFile const * const capture) {
+   commands.chunk_size = reader.file_header->chunk_size;
+   commands.chunks.clear();
+   commands.has_missing_chunks = false;
+   commands.command_encoding = KMTC_GetCommandEncoding(reader.file_header);
+   commands.models.clear();
+   if (!commands.chunk_size) {
+      return;
+   }
+   KMTC_Reader chunk_reader = reader;
+   std::size_t released_offset = chunk_reader.offset;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&chunk_reader)) {
+      if (capture && chunk_reader.offset - released_offset >= CAPT_CHUNK_SCAN_RELEASE_SIZE) {
+         CAPT_ReleaseMappedRange(*capture, released_offset, chunk_reader.offset - released_offset);
+         released_offset = chunk_reader.offset;
+      }
+      KMTC_Chunk const * chunk;
+      void const * data;
+      // The ids are assigned sequentially, so they're bounded by the number of events.
+      if (!KMTC_ParseChunk(event, &chunk, &data) || chunk->size > commands.chunk_size ||
+          chunk->id >= chunk_reader.size / sizeof(KMTC_EventHeader)) {
+         continue;
+      }
+      if (chunk->id >= commands.chunks.size()) {
+         commands.chunks.resize(std::size_t(chunk->id) + 1, CAPT_ChunkLocation{nullptr, 0});
+      }
+      commands.chunks[chunk->id].data = data;
+      commands.chunks[chunk->id].size = chunk->size;
+   }
+   if (capture) {
+      CAPT_ReleaseMappedRange(*capture, released_offset, chunk_reader.offset - released_offset);
+   }
+}
+
+bool CAPT_ParseCaptureRender(CAPT_CommandBuffers const & commands,
+                             KMTC_EventHeader const * const event, KMTC_RenderView & view) {
+   if (commands.chunk_size) {
+      return KMTC_ParseChunkedRender(event, commands.chunk_size, &view);
+   }
+   if (commands.command_encoding == KMTC_COMMAND_ENCODING_PM4Z) {
+      return KMTC_ParseEncodedRender(event, &view);
+   }
+   return KMTC_ParseRender(event, &view);
+}
+
+static bool CAPT_DecodeCommandBuffer(CAPT_CommandBuffers & commands, KMTC_RenderView & view,
+                                     std::vector<uint32_t> & storage) {
+   KMTC_Render const & render = *view.render;
+   uint32_t const dword_count = render.command_length / sizeof(uint32_t);
+   uint32_t const tail_size = render.command_length % sizeof(uint32_t);
+   if (view.command_encoded_size < tail_size) {
+      return false;
+   }
+   std::unique_ptr<PM4Z_Model> & model = commands.models[render.context];
+   if (!model) {
+      model = std::make_unique<PM4Z_Model>();
+      PM4Z_ModelInit(model.get());
+   }
+   storage.resize(dword_count + (tail_size != 0));
+   if (!PM4Z_Decode(model.get(), view.command_encoded, view.command_encoded_size - tail_size,
+                    storage.data(), dword_count)) {
+      return false;
+   }
+   std::memcpy(storage.data() + dword_count,
+               view.command_encoded + (view.command_encoded_size - tail_size), tail_size);
+   view.command_buffer = storage.data();
+   return true;
+}
+
+bool CAPT_ResolveCommandBuffer(CAPT_CommandBuffers & commands, KMTC_RenderView & view,
+                               std::vector<uint32_t> & storage) {
+   KMTC_Render const & render = *view.render;
+   if (render.node_ordinal == KMTC_NODE_ORDINAL_UNKNOWN) {
+      return true;
+   }
+   if (view.command_encoded) {
+      return CAPT_DecodeCommandBuffer(commands, view, storage);
+   }
+   if (!view.command_chunk_ids) {
+      return true;
+   }
+   uint32_t const chunk_size = commands.chunk_size;
+   storage.resize((std::size_t(render.command_length) + (sizeof(uint32_t) - 1)) /
+                  sizeof(uint32_t));
+   uint8_t * const command_buffer = reinterpret_cast<uint8_t *>(storage.data());
+   uint32_t const chunk_count = KMTC_GetChunkCount(render.command_length, chunk_size);
+   for (uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+      uint32_t const chunk_offset = chunk_size * chunk_index;
+      uint32_t const size = render.command_length - chunk_offset > chunk_size
+                               ? chunk_size
+                               : render.command_length - chunk_offset;
+      uint32_t const chunk_id = view.command_chunk_ids[chunk_index];
+      if (chunk_id < commands.chunks.size() && commands.chunks[chunk_id].size == size) {
+         std::memcpy(command_buffer + chunk_offset, commands.chunks[chunk_id].data, size);
+         continue;
+      }
+      std::memset(command_buffer + chunk_offset, 0, size);
+      if (!commands.has_missing_chunks) {
+         commands.has_missing_chunks = true;
+         std::fputs("Chunks of the command buffers are missing, filled with zeros.\n", stderr);
+      }
+   }
+   view.command_buffer = storage.data();
+   return true;
+}
+
+bool CAPT_ReadCaptureRender(CAPT_CommandBuffers & commands, KMTC_EventHeader const * const event,
+                            KMTC_RenderView & view, std::vector<uint32_t> & storage) {
+   return CAPT_ParseCaptureRender(commands, event, view) &&
+          CAPT_ResolveCommandBuffer(commands, view, storage);
+}
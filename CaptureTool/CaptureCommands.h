@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Access to the command buffers of the submissions in any layout of captures, resolved one
+// submission at a time while going through the events, so captures of any size are processed
+// directly from the mapping of the file, with only the command buffer of the current submission
+// expanded in memory.
+//
+// In deduplicated captures, the chunks may follow the submissions containing them, so they're
+// located by one pass over the events before reading the submissions, keeping only their places in
+// the capture, and copied into the command buffer of a submission when it's resolved.
+//
+// In compressed captures, the command buffers of every context are decoded with the model of the
+// context, so all the submissions of known nodes must be resolved, in the order of the file, and
+// the submissions can't be resolved after going to them directly.
+
+struct CAPT_ChunkLocation {
+   // In the capture.
+   void const * data;
+   // 0 if the chunk is missing.
+   uint32_t size;
+};
+
+struct CAPT_CommandBuffers {
+   // Of the file header.
+   uint32_t chunk_size;
+   // By the id, the chunks of a deduplicated capture.
+   std::vector<CAPT_ChunkLocation> chunks;
+   // Reported once, when the first one is found.
+   bool has_missing_chunks;
+   // KMTC_CommandEncoding of the file header.
+   uint32_t command_encoding;
+   // By the context, for the compressed command buffers.
+   std::unordered_map<uint32_t, std::unique_ptr<PM4Z_Model>> models;
+};
+
+// Prepares for the submissions of the capture from the reader, finding the chunks of a
+// deduplicated capture without advancing the reader. If the capture is mapped, the pages read are
+// released along the way.
+void CAPT_CommandBuffersInit(CAPT_CommandBuffers & commands, KMTC_Reader const & reader,
+                             CAPT_MappedFile const * capture);
+// Returns false if the event is not a well-formed KMTC_EVENT_RENDER in the layout of the capture.
+// The command buffer in the view is null if it's not stored in the event as it is.
+bool CAPT_ParseCaptureRender(CAPT_CommandBuffers const & commands,
+                             KMTC_EventHeader const * event, KMTC_RenderView & view);
+// Points the view from CAPT_ParseCaptureRender to the command buffer of the submission, expanded
+// into the storage if it's not stored in the event as it is. Missing chunks are reported and
+// filled with zeros. Returns false if the compressed command buffer can't be decoded.
+bool CAPT_ResolveCommandBuffer(CAPT_CommandBuffers & commands, KMTC_RenderView & view,
+                               std::vector<uint32_t> & storage);
+// Both of the above.
+bool CAPT_ReadCaptureRender(CAPT_CommandBuffers & commands, KMTC_EventHeader const * event,
+                            KMTC_RenderView & view, std::vector<uint32_t> & storage);
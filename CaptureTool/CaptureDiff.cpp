@@ -0,0 +1,284 @@
+#include "CaptureDiff.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static void CAPT_AddDiffRun(std::vector<CAPT_DiffRun> & runs, CAPT_DiffOperation const operation,
+                            uint32_t const a_begin, uint32_t const b_begin, uint32_t const count) {
+   if (!count) {
+      return;
+   }
+   if (!runs.empty()) {
+      CAPT_DiffRun & last = runs.back();
+      // The runs are appended in order, so a run of the same operation is always adjacent.
+      if (last.operation == operation) {
+         last.count += count;
+         return;
+      }
+   }
+   CAPT_DiffRun run;
+   run.a_begin = a_begin;
+   run.b_begin = b_begin;
+   run.count = count;
+   run.operation = operation;
+   runs.push_back(run);
+}
+
+namespace {
+
+// A part of the sequences still to be diffed, or, if is_equal, a common suffix to be appended after
+// the parts before it.
+struct CAPT_DiffRange {
+   uint32_t a_begin;
+   uint32_t a_end;
+   uint32_t b_begin;
+   uint32_t b_end;
+   bool is_equal;
+};
+
+} // namespace
+
+// Returns the point to split the ranges at, from the beginnings of the ranges, or false if nothing
+// is in common. The ranges must be not empty, and must not begin or end with a common element.
+// v is the storage of the furthest reaching paths.
+static bool CAPT_Bisect(uint64_t const * const a, int64_t const a_count, uint64_t const * const b,
+                        int64_t const b_count, int64_t const max_cost, std::vector<int64_t> & v,
+                        int64_t & split_a, int64_t & split_b) {
+   int64_t const max_d = (a_count + b_count + 1) / 2;
+   int64_t const d_limit = std::min(max_d, max_cost);
+   int64_t const v_offset = d_limit + 1;
+   int64_t const v_length = 2 * v_offset + 1;
+   // Forward paths in the first half, reverse ones in the second.
+   v.assign(std::size_t(2 * v_length), -1);
+   int64_t * const v1 = v.data();
+   int64_t * const v2 = v.data() + v_length;
+   v1[v_offset + 1] = 0;
+   v2[v_offset + 1] = 0;
+   int64_t const delta = a_count - b_count;
+   // With an odd delta, the paths meet in the forward pass, otherwise in the reverse one.
+   bool const front = (delta & 1) != 0;
+   // Diagonals that have gone past the edges and don't need to be extended anymore.
+   int64_t k1_start = 0, k1_end = 0, k2_start = 0, k2_end = 0;
+   int64_t best_a = 0, best_b = 0;
+   for (int64_t d = 0; d < d_limit; ++d) {
+      for (int64_t k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+         int64_t const k1_offset = v_offset + k1;
+         int64_t x1 = k1 == -d || (k1 != d && v1[k1_offset - 1] < v1[k1_offset + 1])
+                         ? v1[k1_offset + 1]
+                         : v1[k1_offset - 1] + 1;
+         int64_t y1 = x1 - k1;
+         while (x1 < a_count && y1 < b_count && a[x1] == b[y1]) {
+            ++x1;
+            ++y1;
+         }
+         v1[k1_offset] = x1;
+         if (x1 > a_count) {
+            k1_end += 2;
+         } else if (y1 > b_count) {
+            k1_start += 2;
+         } else {
+            if (x1 + y1 > best_a + best_b) {
+               best_a = x1;
+               best_b = y1;
+            }
+            if (front) {
+               int64_t const k2_offset = v_offset + delta - k1;
+               if (k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1 &&
+                   x1 >= a_count - v2[k2_offset]) {
+                  split_a = x1;
+                  split_b = y1;
+                  return true;
+               }
+            }
+         }
+      }
+      for (int64_t k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2) {
+         int64_t const k2_offset = v_offset + k2;
+         int64_t x2 = k2 == -d || (k2 != d && v2[k2_offset - 1] < v2[k2_offset + 1])
+                         ? v2[k2_offset + 1]
+                         : v2[k2_offset - 1] + 1;
+         int64_t y2 = x2 - k2;
+         while (x2 < a_count && y2 < b_count && a[a_count - x2 - 1] == b[b_count - y2 - 1]) {
+            ++x2;
+            ++y2;
+         }
+         v2[k2_offset] = x2;
+         if (x2 > a_count) {
+            k2_end += 2;
+         } else if (y2 > b_count) {
+            k2_start += 2;
+         } else if (!front) {
+            int64_t const k1_offset = v_offset + delta - k2;
+            if (k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+               int64_t const x1 = v1[k1_offset];
+               if (x1 >= a_count - x2) {
+                  split_a = x1;
+                  split_b = x1 - (k1_offset - v_offset);
+                  return true;
+               }
+            }
+         }
+      }
+   }
+   if (d_limit == max_d) {
+      return false;
+   }
+   // Too costly to find the middle snake, continuing from the furthest point reached, which the
+   // path to is known to need at most max_cost edits.
+   if (best_a + best_b == 0 || best_a + best_b >= a_count + b_count) {
+      return false;
+   }
+   split_a = best_a;
+   split_b = best_b;
+   return true;
+}
+
+void CAPT_Diff(uint64_t const * const a, uint32_t const a_count, uint64_t const * const b,
+               uint32_t const b_count, uint32_t const max_cost, std::vector<CAPT_DiffRun> & runs) {
+   std::vector<int64_t> v;
+   // Processed last to first, so the parts are pushed in the reverse order.
+   std::vector<CAPT_DiffRange> ranges;
+   ranges.push_back({0, a_count, 0, b_count, false});
+   while (!ranges.empty()) {
+      CAPT_DiffRange range = ranges.back();
+      ranges.pop_back();
+      if (range.is_equal) {
+         CAPT_AddDiffRun(runs, CAPT_DIFF_EQUAL, range.a_begin, range.b_begin,
+                         range.a_end - range.a_begin);
+         continue;
+      }
+      uint32_t prefix = 0;
+      while (range.a_begin + prefix < range.a_end && range.b_begin + prefix < range.b_end &&
+             a[range.a_begin + prefix] == b[range.b_begin + prefix]) {
+         ++prefix;
+      }
+      CAPT_AddDiffRun(runs, CAPT_DIFF_EQUAL, range.a_begin, range.b_begin, prefix);
+      range.a_begin += prefix;
+      range.b_begin += prefix;
+      uint32_t suffix = 0;
+      while (range.a_end - suffix > range.a_begin && range.b_end - suffix > range.b_begin &&
+             a[range.a_end - suffix - 1] == b[range.b_end - suffix - 1]) {
+         ++suffix;
+      }
+      range.a_end -= suffix;
+      range.b_end -= suffix;
+      if (suffix) {
+         ranges.push_back({range.a_end, range.a_end + suffix, range.b_end, range.b_end + suffix,
+                           true});
+      }
+      if (range.a_begin == range.a_end || range.b_begin == range.b_end) {
+         CAPT_AddDiffRun(runs, CAPT_DIFF_REMOVED, range.a_begin, range.b_begin,
+                         range.a_end - range.a_begin);
+         CAPT_AddDiffRun(runs, CAPT_DIFF_INSERTED, range.a_end, range.b_begin,
+                         range.b_end - range.b_begin);
+         continue;
+      }
+      int64_t const a_count_range = range.a_end - range.a_begin;
+      int64_t const b_count_range = range.b_end - range.b_begin;
+      int64_t split_a, split_b;
+      // Splitting must make progress, which shouldn't be possible otherwise, but avoids looping.
+      if (!CAPT_Bisect(a + range.a_begin, a_count_range, b + range.b_begin, b_count_range,
+                       max_cost, v, split_a, split_b) ||
+          split_a + split_b == 0 || split_a + split_b == a_count_range + b_count_range) {
+         CAPT_AddDiffRun(runs, CAPT_DIFF_REMOVED, range.a_begin, range.b_begin,
+                         range.a_end - range.a_begin);
+         CAPT_AddDiffRun(runs, CAPT_DIFF_INSERTED, range.a_end, range.b_begin,
+                         range.b_end - range.b_begin);
+         continue;
+      }
+      uint32_t const a_split = range.a_begin + uint32_t(split_a);
+      uint32_t const b_split = range.b_begin + uint32_t(split_b);
+      ranges.push_back({a_split, range.a_end, b_split, range.b_end, false});
+      ranges.push_back({range.a_begin, a_split, range.b_begin, b_split, false});
+   }
+}
+
+uint64_t CAPT_GetPacketShape(PM4P_Packet const & packet) {
+   // Type-0 packets write registers starting from the base index in the header.
+   uint32_t const register_first =
+      packet.type == 0 ? (packet.header & 0xFFFF) : packet.register_first;
+   return (uint64_t(packet.type) << 40) | (uint64_t(packet.opcode) << 32) | register_first;
+}
+
+bool CAPT_ReadDiffCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                          CAPT_DiffCapture & capture) {
+   capture.reader = reader;
+   capture.commands = &commands;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ReadCaptureRender(commands, event, view, capture.command_buffer)) {
+         return false;
+      }
+      KMTC_Render const & render = *view.render;
+      if (render.node_ordinal != 0) {
+         continue;
+      }
+      CAPT_DiffSubmission submission;
+      submission.event = event;
+      submission.context = render.context;
+      submission.packet_begin = uint32_t(capture.packet_shapes.size());
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+      PM4P_Packet packets[256];
+      uint32_t packet_count;
+      while ((packet_count = PM4P_Decode(&decoder, packets,
+                                         sizeof(packets) / sizeof(packets[0]))) != 0) {
+         for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+            capture.packet_shapes.push_back(CAPT_GetPacketShape(packets[packet_index]));
+         }
+      }
+      submission.packet_count = uint32_t(capture.packet_shapes.size()) - submission.packet_begin;
+      submission.key =
+         KMTC_Hash(capture.packet_shapes.data() + submission.packet_begin,
+                   sizeof(uint64_t) * submission.packet_count) ^
+         submission.packet_count;
+      submission.content_hash = KMTC_Hash(view.command_buffer, render.command_length);
+      capture.submissions.push_back(submission);
+   }
+   // Decoding the compressed submissions again from the beginning.
+   commands.models.clear();
+   return KMTC_ReaderIsAtEnd(&reader);
+}
+
+bool CAPT_ResolveDiffSubmission(CAPT_DiffCapture & capture, uint32_t const submission_index) {
+   CAPT_DiffSubmission const & submission = capture.submissions[submission_index];
+   CAPT_CommandBuffers & commands = *capture.commands;
+   KMTC_RenderView view;
+   if (commands.command_encoding == KMTC_COMMAND_ENCODING_PM4Z) {
+      // The models of the contexts are advanced by every submission with a known node.
+      KMTC_EventHeader const * event;
+      do {
+         event = KMTC_ReaderNext(&capture.reader);
+         if (!event) {
+            return false;
+         }
+         if (event->type == KMTC_EVENT_RENDER &&
+             !CAPT_ReadCaptureRender(commands, event, view, capture.command_buffer)) {
+            return false;
+         }
+      } while (event != submission.event);
+   } else if (!CAPT_ReadCaptureRender(commands, submission.event, view,
+                                      capture.command_buffer)) {
+      return false;
+   }
+   capture.packet_dwords.clear();
+   capture.packet_dword_counts.clear();
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, view.command_buffer, view.render->command_length / sizeof(uint32_t));
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+         PM4P_Packet const & packet = packets[packet_index];
+         capture.packet_dwords.push_back(packet.dwords);
+         capture.packet_dword_counts.push_back(1 + packet.body_dword_count);
+      }
+   }
+   return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+#include "CaptureCommands.h"
+
+#include <cstdint>
+#include <vector>
+
+// Alignment of the graphics command buffers of two captures at the packet level, for finding what
+// has changed between driver versions.
+//
+// Packets are aligned by their shape: the type, the opcode, and the first register written, so a
+// packet writing different values, or a different number of them, is aligned with its counterpart
+// and reported as changed rather than as removed and inserted. The submissions are aligned first by
+// the shapes of all their packets, and the packets are aligned only within the pairs of
+// submissions, keeping every diff small.
+
+enum CAPT_DiffOperation : uint8_t {
+   CAPT_DIFF_EQUAL,
+   CAPT_DIFF_REMOVED,
+   CAPT_DIFF_INSERTED,
+};
+
+// count elements from a_begin in the first sequence and from b_begin in the second. Only one of the
+// positions is advanced by removals and insertions.
+struct CAPT_DiffRun {
+   uint32_t a_begin;
+   uint32_t b_begin;
+   uint32_t count;
+   CAPT_DiffOperation operation;
+};
+
+// Appends the runs transforming the first sequence into the second, with the adjacent runs of the
+// same operation merged. Myers's algorithm, bisecting at the middle snake to use memory linear in
+// the size of the sequences. Where more than max_cost edits would be needed to find the middle
+// snake, splits at the furthest point reached instead, so the diff is not minimal there, but the
+// time is bounded by O((a_count + b_count) * max_cost) per split.
+void CAPT_Diff(uint64_t const * a, uint32_t a_count, uint64_t const * b, uint32_t b_count,
+               uint32_t max_cost, std::vector<CAPT_DiffRun> & runs);
+
+struct CAPT_DiffSubmission {
+   KMTC_EventHeader const * event;
+   uint32_t context;
+   // In the packet shapes of the capture.
+   uint32_t packet_begin;
+   uint32_t packet_count;
+   // Of the shapes of the packets.
+   uint64_t key;
+   // KMTC_Hash of the command buffer, telling if the packets of aligned submissions are the same
+   // without resolving the command buffers again.
+   uint64_t content_hash;
+};
+
+// The graphics submissions of a capture, with the shapes of the packets of all of them stored one
+// after another. The command buffers aren't kept, so the memory doesn't grow with their size: only
+// the one of the submission being compared is resolved at a time.
+struct CAPT_DiffCapture {
+   std::vector<CAPT_DiffSubmission> submissions;
+   std::vector<uint64_t> packet_shapes;
+   // At the beginning of the events, then after the submission last resolved if the command
+   // buffers are compressed.
+   KMTC_Reader reader;
+   CAPT_CommandBuffers * commands;
+   // Of the submission last resolved, if it's not stored in the capture as it is.
+   std::vector<uint32_t> command_buffer;
+   // Of the packets of the submission last resolved, into its command buffer, which must stay
+   // mapped while they're used.
+   std::vector<uint32_t const *> packet_dwords;
+   // Including the header.
+   std::vector<uint32_t> packet_dword_counts;
+};
+
+// The shape of a packet, which packets must have in common to be aligned.
+uint64_t CAPT_GetPacketShape(PM4P_Packet const & packet);
+// Reads the graphics submissions of the capture from the beginning of the events. Returns false if
+// the capture is malformed. The commands are used again for resolving the submissions.
+bool CAPT_ReadDiffCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                          CAPT_DiffCapture & capture);
+// Resolves the command buffer of the submission again and decodes its packets to packet_dwords
+// and packet_dword_counts. The submissions must be resolved in their order, as compressed ones are
+// decoded by going through all the submissions before them. Returns false if the capture is
+// malformed.
+bool CAPT_ResolveDiffSubmission(CAPT_DiffCapture & capture, uint32_t submission_index);
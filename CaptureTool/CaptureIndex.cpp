@@ -0,0 +1,172 @@
+#include "CaptureIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Queries of wider register ranges are assumed to match rather than probing every group.
+static constexpr uint32_t CAPT_INDEX_MAX_PROBED_GROUPS = 1024;
+
+// The two bits of the group in the filter.
+static void CAPT_GetRegisterGroupBits(uint32_t const group, uint32_t & bit_0, uint32_t & bit_1) {
+   uint32_t const bit_count = 64 * CAPT_INDEX_BLOOM_WORD_COUNT;
+   uint64_t const hash = (uint64_t(group) + 1) * 0x9E3779B97F4A7C15;
+   bit_0 = uint32_t(hash >> 32) % bit_count;
+   bit_1 = uint32_t(hash >> 48) % bit_count;
+}
+
+static void CAPT_AddRegisterGroup(CAPT_IndexChunk & chunk, uint32_t const group) {
+   uint32_t bit_0, bit_1;
+   CAPT_GetRegisterGroupBits(group, bit_0, bit_1);
+   chunk.register_bloom[bit_0 >> 6] |= uint64_t(1) << (bit_0 & 63);
+   chunk.register_bloom[bit_1 >> 6] |= uint64_t(1) << (bit_1 & 63);
+}
+
+static bool CAPT_MayHaveRegisterGroup(CAPT_IndexChunk const & chunk, uint32_t const group) {
+   uint32_t bit_0, bit_1;
+   CAPT_GetRegisterGroupBits(group, bit_0, bit_1);
+   return ((chunk.register_bloom[bit_0 >> 6] >> (bit_0 & 63)) &
+           (chunk.register_bloom[bit_1 >> 6] >> (bit_1 & 63)) & 1) != 0;
+}
+
+// Adds the packets of the graphics command buffer to the summary of the chunk.
+static void CAPT_SummarizeCommandBuffer(CAPT_IndexChunk & chunk, KMTC_RenderView const & view) {
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, view.command_buffer,
+                    view.render->command_length / sizeof(uint32_t));
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+         PM4P_Packet const & packet = packets[packet_index];
+         if (packet.type != 3) {
+            continue;
+         }
+         chunk.opcodes[packet.opcode >> 6] |= uint64_t(1) << (packet.opcode & 63);
+         if (packet.register_base == 0 || packet.body_dword_count < 2) {
+            continue;
+         }
+         uint32_t const last = packet.register_first + (packet.body_dword_count - 2);
+         for (uint32_t group = packet.register_first / CAPT_INDEX_REGISTER_GROUP_SIZE;
+              group <= last / CAPT_INDEX_REGISTER_GROUP_SIZE; ++group) {
+            CAPT_AddRegisterGroup(chunk, group);
+         }
+      }
+   }
+}
+
+bool CAPT_WriteIndex(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                     std::FILE * const file) {
+   CAPT_IndexHeader header = {};
+   header.magic = CAPT_INDEX_MAGIC;
+   header.version = CAPT_INDEX_VERSION;
+   header.capture_size = reader.size;
+   // Rewritten with the number of the entries in the end.
+   bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+   CAPT_IndexChunk chunk = {};
+   std::vector<uint32_t> command_buffer;
+   bool malformed = false;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+         malformed = true;
+         break;
+      }
+      CAPT_IndexEntry & entry = chunk.entries[chunk.entry_count++];
+      entry.offset = uint64_t(reinterpret_cast<uint8_t const *>(event) - reader.data);
+      entry.context = view.render->context;
+      entry.node_ordinal = view.render->node_ordinal;
+      if (entry.node_ordinal == 0) {
+         CAPT_SummarizeCommandBuffer(chunk, view);
+      }
+      ++header.entry_count;
+      if (chunk.entry_count == CAPT_INDEX_CHUNK_ENTRY_COUNT) {
+         written &= std::fwrite(&chunk, sizeof(chunk), 1, file) == 1;
+         chunk = {};
+      }
+   }
+   if (chunk.entry_count) {
+      written &= std::fwrite(&chunk, sizeof(chunk), 1, file) == 1;
+   }
+   written &= !std::fseek(file, 0, SEEK_SET) &&
+              std::fwrite(&header, sizeof(header), 1, file) == 1;
+   return written && !malformed && KMTC_ReaderIsAtEnd(&reader);
+}
+
+CAPT_IndexChunk const * CAPT_GetIndexChunks(void const * const index,
+                                            std::size_t const index_size,
+                                            std::size_t const capture_size,
+                                            uint32_t & chunk_count) {
+   if (index_size < sizeof(CAPT_IndexHeader)) {
+      return nullptr;
+   }
+   CAPT_IndexHeader header;
+   std::memcpy(&header, index, sizeof(header));
+   if (header.magic != CAPT_INDEX_MAGIC || header.version != CAPT_INDEX_VERSION ||
+       header.capture_size != capture_size) {
+      return nullptr;
+   }
+   chunk_count = (header.entry_count + (CAPT_INDEX_CHUNK_ENTRY_COUNT - 1)) /
+                 CAPT_INDEX_CHUNK_ENTRY_COUNT;
+   if (index_size != sizeof(header) + sizeof(CAPT_IndexChunk) * std::size_t(chunk_count)) {
+      return nullptr;
+   }
+   // The header keeps the chunks aligned to 8 bytes, as mappings are aligned to pages.
+   return reinterpret_cast<CAPT_IndexChunk const *>(static_cast<uint8_t const *>(index) +
+                                                    sizeof(header));
+}
+
+bool CAPT_IndexChunkMayMatch(CAPT_IndexChunk const & chunk, PM4Q_Query const & query) {
+   if (query.has_opcodes) {
+      uint64_t used_opcodes = 0;
+      for (uint32_t word_index = 0; word_index < 4; ++word_index) {
+         used_opcodes |= chunk.opcodes[word_index] & query.opcodes[word_index];
+      }
+      if (!used_opcodes) {
+         return false;
+      }
+   }
+   if (query.has_registers) {
+      uint32_t const first_group = query.register_first / CAPT_INDEX_REGISTER_GROUP_SIZE;
+      uint32_t const last_group = query.register_last / CAPT_INDEX_REGISTER_GROUP_SIZE;
+      if (last_group - first_group >= CAPT_INDEX_MAX_PROBED_GROUPS) {
+         return true;
+      }
+      for (uint32_t group = first_group; group <= last_group; ++group) {
+         if (CAPT_MayHaveRegisterGroup(chunk, group)) {
+            return true;
+         }
+      }
+      return false;
+   }
+   if (query.has_value) {
+      // Needs any register to be written.
+      uint64_t written_groups = 0;
+      for (uint64_t const word : chunk.register_bloom) {
+         written_groups |= word;
+      }
+      return written_groups != 0;
+   }
+   return true;
+}
+
+KMTC_EventHeader const * CAPT_GetIndexedEvent(KMTC_Reader const & reader,
+                                              CAPT_IndexEntry const & entry) {
+   if (entry.offset % KMTC_ALIGNMENT || entry.offset >= reader.size ||
+       reader.size - entry.offset < sizeof(KMTC_EventHeader)) {
+      return nullptr;
+   }
+   KMTC_EventHeader const * const event =
+      reinterpret_cast<KMTC_EventHeader const *>(reader.data + entry.offset);
+   if (event->type != KMTC_EVENT_RENDER || event->size < sizeof(KMTC_EventHeader) ||
+       event->size > reader.size - entry.offset) {
+      return nullptr;
+   }
+   return event;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+#include "CaptureCommands.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Sidecar index of the submissions of a capture, for going to any submission without reading the
+// events before it, and for skipping the parts of the capture that can't contain the packets
+// looked for.
+//
+// The submissions are grouped into chunks of a fixed number, with a summary of the graphics
+// packets of every chunk: the PKT3 opcodes used, and a Bloom filter of the groups of registers
+// written. The chunks have a fixed size, so chunk n is at a known offset in the index, and the
+// index is written in one pass over the capture, keeping only the current chunk in memory.
+//
+// The event offsets are in the capture file in any layout, with the command buffers of the
+// submissions resolved when they're read.
+
+#define CAPT_INDEX_MAGIC 0x58444E49 // "INDX".
+// 2 - offsets in the file rather than in the expanded deduplicated or compressed capture.
+#define CAPT_INDEX_VERSION 2
+
+static constexpr uint32_t CAPT_INDEX_CHUNK_ENTRY_COUNT = 64;
+static constexpr uint32_t CAPT_INDEX_BLOOM_WORD_COUNT = 16;
+// Registers in a group, in dwords, a power of two. Register blocks are usually set in contiguous
+// ranges, so the groups rather than the registers are added to the filters, keeping them sparse.
+static constexpr uint32_t CAPT_INDEX_REGISTER_GROUP_SIZE = 8;
+
+struct CAPT_IndexHeader {
+   uint32_t magic;
+   uint32_t version;
+   // Of the capture the index is for, for detecting stale indices.
+   uint64_t capture_size;
+   uint32_t entry_count;
+   uint32_t reserved;
+};
+
+struct CAPT_IndexEntry {
+   // Of the render event in the capture.
+   uint64_t offset;
+   uint32_t context;
+   // KMTC_NODE_ORDINAL_UNKNOWN if the context is unknown.
+   uint32_t node_ordinal;
+};
+
+struct CAPT_IndexChunk {
+   // Of the graphics submissions of the chunk. Bits by the PKT3 opcode.
+   uint64_t opcodes[4];
+   // Two bits for every register group written by the graphics submissions of the chunk.
+   uint64_t register_bloom[CAPT_INDEX_BLOOM_WORD_COUNT];
+   // Up to CAPT_INDEX_CHUNK_ENTRY_COUNT, fewer only in the last chunk.
+   uint32_t entry_count;
+   uint32_t reserved;
+   CAPT_IndexEntry entries[CAPT_INDEX_CHUNK_ENTRY_COUNT];
+};
+
+// Reads the render events of the capture from the beginning of the events, writing the index to
+// the file, which must be seekable. Returns false if the capture is malformed or the writing has
+// failed.
+bool CAPT_WriteIndex(KMTC_Reader & reader, CAPT_CommandBuffers & commands, std::FILE * file);
+// Returns the chunks of an index read into memory, or null if it's malformed or not for a capture
+// of the size.
+CAPT_IndexChunk const * CAPT_GetIndexChunks(void const * index, std::size_t index_size,
+                                            std::size_t capture_size, uint32_t & chunk_count);
+// Whether the graphics submissions of the chunk may contain packets matching the query, false if
+// they certainly don't.
+bool CAPT_IndexChunkMayMatch(CAPT_IndexChunk const & chunk, PM4Q_Query const & query);
+// Returns the event of the entry, or null if it's out of the capture or not a render event.
+KMTC_EventHeader const * CAPT_GetIndexedEvent(KMTC_Reader const & reader,
+                                              CAPT_IndexEntry const & entry);
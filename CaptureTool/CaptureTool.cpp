@@ -0,0 +1,2283 @@
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+#include "CaptureCommands.h"
+#include "CaptureDiff.h"
+#include "CaptureIndex.h"
+#include "DeduplicatedCapture.h"
+#include "EncodedCapture.h"
+#include "IndirectBuffers.h"
+#include "MappedFile.h"
+#include "OrderedOutput.h"
+#include "PatchIndex.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// Offline processing of captures written by KMTI.
+
+// Prints the bytes from begin to end of an array, which may be printed in multiple parts split at
+// any byte.
+static void CAPT_PrintArrayBytes(TXTW_Writer & text, void const * const data,
+                                 std::size_t const begin, std::size_t const end) {
+   for (std::size_t byte_index = begin; byte_index < end; ++byte_index) {
+      // Up to "\n  " + ' ' + ' ' + 8 bytes written by TXTW_FormatHex.
+      char * destination = TXTW_Reserve(&text, 3 + 1 + 1 + 8);
+      if (!destination) {
+         return;
+      }
+      if ((byte_index & 0xF) == 0) {
+         destination = TXTW_FORMAT_LITERAL(destination, "\n  ");
+      }
+      if ((byte_index & 0x3) == 0) {
+         *(destination++) = ' ';
+      }
+      *(destination++) = ' ';
+      destination =
+         TXTW_FormatHex(destination, static_cast<unsigned char const *>(data)[byte_index], 2);
+      *(destination++) = ',';
+      TXTW_Commit(&text, destination);
+   }
+}
+
+static void CAPT_PrintArray(TXTW_Writer & text, char const * const name, void const * const data,
+                            std::size_t const size) {
+   TXTW_Printf(&text, "  %s:", name);
+   CAPT_PrintArrayBytes(text, data, 0, size);
+   TXTW_PutChar(&text, '\n');
+}
+
+static void CAPT_PrintEventHeader(TXTW_Writer & text, char const * const name,
+                                  KMTC_EventHeader const & event) {
+   TXTW_Printf(&text, "%s @ %" PRIu32 ", %" PRIu64 ":\n", name, event.thread_id, event.timestamp);
+}
+
+static void CAPT_PrintStatus(TXTW_Writer & text, KMTC_EventHeader const & event) {
+   TXTW_Printf(&text, "    Status = 0x%08" PRIX32 "\n", uint32_t(event.status));
+}
+
+#define CAPT_TAKE(type, name) \
+   type const * const name = \
+      static_cast<type const *>(KMTC_EventCursorTake(&cursor, sizeof(type))); \
+   if (!name) { \
+      return false; \
+   }
+#define CAPT_TAKE_BLOB(name, size) \
+   void const * const name = KMTC_EventCursorTake(&cursor, (size)); \
+   if (!name) { \
+      return false; \
+   }
+
+static bool CAPT_PrintEscape(TXTW_Writer & text, KMTC_EventHeader const & event,
+                             KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_Escape, escape)
+   CAPT_TAKE_BLOB(private_driver_data_in, escape->private_driver_data_size)
+   CAPT_TAKE_BLOB(private_driver_data_out, escape->private_driver_data_size)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDIEscape", event);
+   TXTW_Printf(&text, "  > hAdapter = 0x%" PRIX32 "\n", escape->adapter);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", escape->device);
+   TXTW_Printf(&text, "  > Type = %" PRIu32 "\n", escape->type);
+   TXTW_Printf(&text, "  > Flags = 0x%08" PRIX32 "\n", escape->flags);
+   CAPT_PrintArray(text, "> pPrivateDriverData", private_driver_data_in,
+                   escape->private_driver_data_size);
+   TXTW_Printf(&text, "  > PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               escape->private_driver_data_size);
+   TXTW_Printf(&text, "  > hContext = 0x%" PRIX32 "\n", escape->context);
+   CAPT_PrintStatus(text, event);
+   CAPT_PrintArray(text, "< pPrivateDriverData", private_driver_data_out,
+                   escape->private_driver_data_size);
+   return true;
+}
+
+static bool CAPT_PrintQueryAdapterInfo(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                       KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_QueryAdapterInfo, query_adapter_info)
+   CAPT_TAKE_BLOB(private_driver_data_in, query_adapter_info->private_driver_data_size_in)
+   CAPT_TAKE_BLOB(private_driver_data_out, query_adapter_info->private_driver_data_size_in)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDIQueryAdapterInfo", event);
+   TXTW_Printf(&text, "  > hAdapter = 0x%" PRIX32 "\n", query_adapter_info->adapter);
+   TXTW_Printf(&text, "  > Type = %" PRIu32 "\n", query_adapter_info->type);
+   CAPT_PrintArray(text, "> pPrivateDriverData", private_driver_data_in,
+                   query_adapter_info->private_driver_data_size_in);
+   TXTW_Printf(&text, "  > PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               query_adapter_info->private_driver_data_size_in);
+   CAPT_PrintStatus(text, event);
+   CAPT_PrintArray(text, "< pPrivateDriverData", private_driver_data_out,
+                   query_adapter_info->private_driver_data_size_in);
+   TXTW_Printf(&text, "  < PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               query_adapter_info->private_driver_data_size_out);
+   return true;
+}
+
+static bool CAPT_PrintCreateDevice(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                   KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_CreateDevice, create_device)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDICreateDevice", event);
+   TXTW_Printf(&text, "  > hAdapter = 0x%" PRIX32 "\n", create_device->adapter);
+   TXTW_Printf(&text, "  > Flags.LegacyMode = %" PRIu32 "\n", create_device->flags & 1);
+   TXTW_Printf(&text, "  > Flags.RequestVSync = %" PRIu32 "\n", (create_device->flags >> 1) & 1);
+   TXTW_Printf(&text, "  > Flags.DisableGpuTimeout = %" PRIu32 "\n",
+               (create_device->flags >> 2) & 1);
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < hDevice = 0x%" PRIX32 "\n", create_device->device);
+   TXTW_Printf(&text, "  < pCommandBuffer = 0x%016" PRIX64 "\n", create_device->command_buffer);
+   TXTW_Printf(&text, "  < CommandBufferSize = 0x%" PRIX32 "\n",
+               create_device->command_buffer_size);
+   TXTW_Printf(&text, "  < pAllocationList = 0x%016" PRIX64 "\n", create_device->allocation_list);
+   TXTW_Printf(&text, "  < AllocationListSize = 0x%" PRIX32 "\n",
+               create_device->allocation_list_size);
+   TXTW_Printf(&text, "  < pPatchLocationList = 0x%016" PRIX64 "\n",
+               create_device->patch_location_list);
+   TXTW_Printf(&text, "  < PatchLocationListSize = 0x%" PRIX32 "\n",
+               create_device->patch_location_list_size);
+   return true;
+}
+
+static bool CAPT_PrintCreateSynchronizationObject(TXTW_Writer & text,
+                                                  KMTC_EventHeader const & event,
+                                                  KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_CreateSynchronizationObject, create_synchronization_object)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDICreateSynchronizationObject", event);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", create_synchronization_object->device);
+   TXTW_Printf(&text, "  > Info.Type = %" PRIu32 "\n", create_synchronization_object->type_in);
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < Info.Type = %" PRIu32 "\n", create_synchronization_object->type_out);
+   TXTW_Printf(&text, "  < hSyncObject = 0x%" PRIX32 "\n",
+               create_synchronization_object->synchronization_object);
+   return true;
+}
+
+static bool CAPT_PrintCreateAllocation(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                       KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_CreateAllocation, create_allocation)
+   CAPT_TAKE_BLOB(private_runtime_data, create_allocation->private_runtime_data_size)
+   CAPT_TAKE_BLOB(private_driver_data, create_allocation->private_driver_data_size)
+   if (create_allocation->allocation_count > UINT32_MAX / sizeof(KMTC_AllocationInfo)) {
+      return false;
+   }
+   CAPT_TAKE_BLOB(allocation_infos_blob, uint32_t(sizeof(KMTC_AllocationInfo) *
+                                                  create_allocation->allocation_count))
+   auto const allocation_infos = static_cast<KMTC_AllocationInfo const *>(allocation_infos_blob);
+   // The private driver data of the allocations follows, before and after the call.
+   KMTC_EventCursor const allocation_private_driver_data_cursor = cursor;
+   for (uint32_t allocation_index = 0; allocation_index < create_allocation->allocation_count;
+        ++allocation_index) {
+      for (uint32_t copy_index = 0; copy_index < 2; ++copy_index) {
+         if (!KMTC_EventCursorTake(&cursor,
+                                   allocation_infos[allocation_index].private_driver_data_size)) {
+            return false;
+         }
+      }
+   }
+   CAPT_PrintEventHeader(text, "NtGdiDdDDICreateAllocation", event);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", create_allocation->device);
+   TXTW_Printf(&text, "  > hResource = 0x%" PRIX32 "\n", create_allocation->resource_in);
+   CAPT_PrintArray(text, "> pPrivateRuntimeData", private_runtime_data,
+                   create_allocation->private_runtime_data_size);
+   TXTW_Printf(&text, "  > PrivateRuntimeDataSize = 0x%" PRIX32 "\n",
+               create_allocation->private_runtime_data_size);
+   CAPT_PrintArray(text, "> pPrivateDriverData", private_driver_data,
+                   create_allocation->private_driver_data_size);
+   TXTW_Printf(&text, "  > PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               create_allocation->private_driver_data_size);
+   TXTW_Printf(&text, "  > NumAllocations = %" PRIu32 "\n", create_allocation->allocation_count);
+   TXTW_PutString(&text, "  > pAllocationInfo2:\n");
+   cursor = allocation_private_driver_data_cursor;
+   for (uint32_t allocation_index = 0; allocation_index < create_allocation->allocation_count;
+        ++allocation_index) {
+      KMTC_AllocationInfo const & allocation_info = allocation_infos[allocation_index];
+      TXTW_Printf(&text, "    [%" PRIu32 "]:\n", allocation_index);
+      TXTW_Printf(&text, "      hSection = 0x%016" PRIX64 "\n", allocation_info.section);
+      CAPT_PrintArray(text, "    pPrivateDriverData",
+                      KMTC_EventCursorTake(&cursor, allocation_info.private_driver_data_size),
+                      allocation_info.private_driver_data_size);
+      KMTC_EventCursorTake(&cursor, allocation_info.private_driver_data_size);
+      TXTW_Printf(&text, "      PrivateDriverDataSize = 0x%" PRIX32 "\n",
+                  allocation_info.private_driver_data_size);
+      TXTW_Printf(&text, "      VidPnSourceId = 0x%" PRIX32 "\n", allocation_info.vidpn_source_id);
+      TXTW_Printf(&text, "      Flags.Primary = %" PRIu32 "\n", allocation_info.flags & 1);
+      TXTW_Printf(&text, "      Flags.Stereo = %" PRIu32 "\n", (allocation_info.flags >> 1) & 1);
+   }
+   static char const * const flag_names[] = {
+      "CreateResource",
+      "CreateShared",
+      "NonSecure",
+      "CreateProtected (KM)",
+      "RestrictSharedAccess",
+      "ExistingSysMem (KM)",
+      "NtSecuritySharing",
+      "ReadOnly",
+      "CreateWriteCombined (KM)",
+      "CreateCached (KM)",
+      "SwapChainBackBuffer",
+      "CrossAdapter",
+      "OpenCrossAdapter (KM)",
+      "PartialSharedCreation",
+      "Zeroed",
+      "WriteWatch",
+   };
+   for (uint32_t flag_index = 0; flag_index < sizeof(flag_names) / sizeof(flag_names[0]);
+        ++flag_index) {
+      // Zeroed wasn't printed by the original interceptor either.
+      if (flag_index != 14) {
+         TXTW_Printf(&text, "  > Flags.%s = %" PRIu32 "\n", flag_names[flag_index],
+                     (create_allocation->flags >> flag_index) & 1);
+      }
+   }
+   TXTW_Printf(&text, "  > hPrivateRuntimeResourceHandle = 0x%016" PRIX64 "\n",
+               create_allocation->private_runtime_resource_handle_in);
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < hResource = 0x%" PRIX32 "\n", create_allocation->resource_out);
+   TXTW_Printf(&text, "  < hGlobalShare = 0x%" PRIX32 "\n", create_allocation->global_share);
+   TXTW_PutString(&text, "  < pAllocationInfo2:\n");
+   cursor = allocation_private_driver_data_cursor;
+   for (uint32_t allocation_index = 0; allocation_index < create_allocation->allocation_count;
+        ++allocation_index) {
+      KMTC_AllocationInfo const & allocation_info = allocation_infos[allocation_index];
+      TXTW_Printf(&text, "    [%" PRIu32 "]:\n", allocation_index);
+      TXTW_Printf(&text, "      hAllocation = 0x%" PRIX32 "\n", allocation_info.allocation);
+      KMTC_EventCursorTake(&cursor, allocation_info.private_driver_data_size);
+      CAPT_PrintArray(text, "    pPrivateDriverData",
+                      KMTC_EventCursorTake(&cursor, allocation_info.private_driver_data_size),
+                      allocation_info.private_driver_data_size);
+   }
+   TXTW_Printf(&text, "  < hPrivateRuntimeResourceHandle = 0x%016" PRIX64 "\n",
+               create_allocation->private_runtime_resource_handle_out);
+   return true;
+}
+
+static bool CAPT_PrintLock(TXTW_Writer & text, KMTC_EventHeader const & event,
+                           KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_Lock, lock)
+   if (lock->page_count > UINT32_MAX / sizeof(uint32_t)) {
+      return false;
+   }
+   CAPT_TAKE_BLOB(pages_blob, uint32_t(sizeof(uint32_t) * lock->page_count))
+   auto const pages = static_cast<uint32_t const *>(pages_blob);
+   CAPT_PrintEventHeader(text, "NtGdiDdDDILock", event);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", lock->device);
+   TXTW_Printf(&text, "  > hAllocation = 0x%" PRIX32 "\n", lock->allocation);
+   TXTW_Printf(&text, "  > PrivateDriverData = 0x%" PRIX32 "\n", lock->private_driver_data);
+   TXTW_Printf(&text, "  > NumPages = %" PRIu32 "\n", lock->page_count);
+   for (uint32_t page_index = 0; page_index < lock->page_count; ++page_index) {
+      TXTW_Printf(&text, "    [0x%" PRIX32 "] = 0x%" PRIX32 "\n", page_index, pages[page_index]);
+   }
+   static char const * const flag_names[] = {
+      "ReadOnly",
+      "WriteOnly",
+      "DonotWait",
+      "IgnoreSync",
+      "LockEntire",
+      "DonotEvict",
+      "AcquireAperture",
+      "Discard",
+      "NoExistingReference",
+      "UseAlternateVA",
+      "IgnoreReadSync",
+   };
+   for (uint32_t flag_index = 0; flag_index < sizeof(flag_names) / sizeof(flag_names[0]);
+        ++flag_index) {
+      TXTW_Printf(&text, "  > Flags.%s = %" PRIu32 "\n", flag_names[flag_index],
+                  (lock->flags >> flag_index) & 1);
+   }
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < pData = 0x%016" PRIX64 "\n", lock->data);
+   TXTW_Printf(&text, "  < GpuVirtualAddress = 0x%" PRIX64 "\n", lock->gpu_virtual_address);
+   return true;
+}
+
+static bool CAPT_PrintUnlock(TXTW_Writer & text, KMTC_EventHeader const & event,
+                             KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_Unlock, unlock)
+   if (unlock->allocation_count > UINT32_MAX / sizeof(uint32_t)) {
+      return false;
+   }
+   CAPT_TAKE_BLOB(allocations_blob, uint32_t(sizeof(uint32_t) * unlock->allocation_count))
+   auto const allocations = static_cast<uint32_t const *>(allocations_blob);
+   CAPT_PrintEventHeader(text, "NtGdiDdDDIUnlock", event);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", unlock->device);
+   TXTW_Printf(&text, "  > NumAllocations = %" PRIu32 "\n", unlock->allocation_count);
+   for (uint32_t allocation_index = 0; allocation_index < unlock->allocation_count;
+        ++allocation_index) {
+      TXTW_Printf(&text, "  > phAllocations[%" PRIu32 "] = 0x%" PRIX32 "\n", allocation_index,
+                  allocations[allocation_index]);
+   }
+   CAPT_PrintStatus(text, event);
+   return true;
+}
+
+static bool CAPT_PrintTrigger(TXTW_Writer & text, KMTC_EventHeader const & event,
+                              KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_Trigger, trigger)
+   static char const * const reason_names[] = {
+      "hotkey",
+      "named event",
+      "frame time",
+      "render stall",
+   };
+   CAPT_PrintEventHeader(text, "Flight recorder trigger", event);
+   if (trigger->reason < sizeof(reason_names) / sizeof(reason_names[0])) {
+      TXTW_Printf(&text, "  Reason = %s\n", reason_names[trigger->reason]);
+   } else {
+      TXTW_Printf(&text, "  Reason = %" PRIu32 "\n", trigger->reason);
+   }
+   TXTW_Printf(&text, "  DiscardedSize = 0x%" PRIX64 "\n", trigger->discarded_size);
+   return true;
+}
+
+// The contents are printed decoded at the submissions executing them.
+static bool CAPT_PrintAllocationData(TXTW_Writer & text, KMTC_EventHeader const & event) {
+   KMTC_AllocationData const * allocation_data;
+   void const * data;
+   if (!KMTC_ParseAllocationData(&event, &allocation_data, &data)) {
+      return false;
+   }
+   CAPT_PrintEventHeader(text, "Allocation data", event);
+   TXTW_Printf(&text, "  hAllocation = 0x%" PRIX32 "\n", allocation_data->allocation);
+   TXTW_Printf(&text, "  Offset = 0x%" PRIX32 "\n", allocation_data->offset);
+   TXTW_Printf(&text, "  Size = 0x%" PRIX32 "\n", allocation_data->size);
+   TXTW_Printf(&text, "  GpuVirtualAddress = 0x%" PRIX64 "\n",
+               allocation_data->gpu_virtual_address);
+   TXTW_Printf(&text, "  Hash = 0x%016" PRIX64 "\n", allocation_data->hash);
+   return true;
+}
+
+static bool CAPT_PrintCreateContext(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                    KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_CreateContext, create_context)
+   CAPT_TAKE_BLOB(private_driver_data, create_context->private_driver_data_size)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDICreateContext", event);
+   TXTW_Printf(&text, "  > hDevice = 0x%" PRIX32 "\n", create_context->device);
+   TXTW_Printf(&text, "  > NodeOrdinal = %" PRIu32 "\n", create_context->node_ordinal);
+   TXTW_Printf(&text, "  > EngineAffinity = 0x%" PRIX32 "\n", create_context->engine_affinity);
+   TXTW_Printf(&text, "  > Flags = 0x%" PRIX32 "\n", create_context->flags);
+   CAPT_PrintArray(text, "> pPrivateDriverData", private_driver_data,
+                   create_context->private_driver_data_size);
+   TXTW_Printf(&text, "  > PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               create_context->private_driver_data_size);
+   TXTW_Printf(&text, "  > ClientHint = %" PRIu32 "\n", create_context->client_hint);
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < hContext = 0x%" PRIX32 "\n", create_context->context);
+   TXTW_Printf(&text, "  < pCommandBuffer = 0x%016" PRIX64 "\n",
+               create_context->command_buffer_pointer);
+   TXTW_Printf(&text, "  < CommandBufferSize = 0x%" PRIX32 "\n",
+               create_context->command_buffer_size);
+   TXTW_Printf(&text, "  < pAllocationList = 0x%016" PRIX64 "\n", create_context->allocation_list);
+   TXTW_Printf(&text, "  < AllocationListSize = 0x%" PRIX32 "\n",
+               create_context->allocation_list_size);
+   TXTW_Printf(&text, "  < pPatchLocationList = 0x%016" PRIX64 "\n",
+               create_context->patch_location_list);
+   TXTW_Printf(&text, "  < PatchLocationListSize = 0x%" PRIX32 "\n",
+               create_context->patch_location_list_size);
+   TXTW_Printf(&text, "  < CommandBuffer = 0x%" PRIX64 "\n", create_context->command_buffer);
+   return true;
+}
+
+static bool CAPT_PrintSetContextSchedulingPriority(TXTW_Writer & text,
+                                                   KMTC_EventHeader const & event,
+                                                   KMTC_EventCursor cursor) {
+   CAPT_TAKE(KMTC_SetContextSchedulingPriority, set_scheduling_priority)
+   CAPT_PrintEventHeader(text, "NtGdiDdDDISetContextSchedulingPriority", event);
+   TXTW_Printf(&text, "  > hContext = 0x%" PRIX32 "\n", set_scheduling_priority->context);
+   TXTW_Printf(&text, "  > Priority = %" PRId32 "\n", set_scheduling_priority->priority);
+   CAPT_PrintStatus(text, event);
+   return true;
+}
+
+// The render event is printed in parts, so the command buffer of a large submission can be printed
+// on multiple threads: the beginning up to the name of the command buffer array, the bytes of the
+// command buffer, the decoded PM4 if it's for the graphics node, and the end.
+
+static void CAPT_PrintRenderBegin(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                  KMTC_RenderView const & view) {
+   KMTC_Render const & render = *view.render;
+   CAPT_PrintEventHeader(text, "NtGdiDdDDIRender", event);
+   TXTW_Printf(&text, "  > hContext = 0x%" PRIX32 "\n", render.context);
+   TXTW_Printf(&text, "  > CommandOffset = 0x%" PRIX32 "\n", render.command_offset);
+   TXTW_Printf(&text, "  > CommandLength = 0x%" PRIX32 "\n", render.command_length);
+   if (render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN) {
+      TXTW_PUT_LITERAL(&text, "  > pCommandBuffer:");
+   }
+}
+
+static void CAPT_PrintRenderCommandBytes(TXTW_Writer & text, KMTC_RenderView const & view,
+                                         uint32_t const begin, uint32_t const end) {
+   CAPT_PrintArrayBytes(text, view.command_buffer, begin, end);
+   if (end == view.render->command_length) {
+      TXTW_PutChar(&text, '\n');
+   }
+}
+
+// Decodes the packets starting from dword_index, which must be the beginning of a packet, before
+// dword_end, which must be the end of a packet or of the command buffer.
+// The patches are those of the whole submission, sorted by the offset.
+static void CAPT_PrintRenderPM4(TXTW_Writer & text, KMTC_RenderView const & view,
+                                uint32_t const dword_index, uint32_t const dword_end,
+                                bool const follows_packet2, PM4P_Patch const * const patches,
+                                uint32_t const patch_count, PM4P_Family const * const family,
+                                PM4P_FieldDecoder * const field_decoder) {
+   // Offsets are printed relative to the beginning of the command buffer.
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, view.command_buffer, dword_end);
+   decoder.dword_index = dword_index;
+   decoder.follows_packet2 = follows_packet2;
+   PM4P_PatchCursor patch_cursor;
+   PM4P_PatchCursorInit(&patch_cursor, patches, patch_count, dword_index);
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      PM4P_PrintPatchedPackets(&text, packets, packet_count, &patch_cursor, family,
+                               field_decoder);
+   }
+}
+
+static void CAPT_PrintIndirectBuffers(TXTW_Writer & text,
+                                      CAPT_IndirectBufferReference const * const references,
+                                      uint32_t const reference_count,
+                                      PM4P_Family const * const family,
+                                      PM4P_FieldDecoder * const field_decoder) {
+   static char const * const status_names[] = {
+      "",
+      ", printed before",
+      ", not captured",
+      ", executed recursively",
+      ", too deep",
+   };
+   for (uint32_t reference_index = 0; reference_index < reference_count; ++reference_index) {
+      CAPT_IndirectBufferReference const & reference = references[reference_index];
+      TXTW_Printf(&text, "  > IndirectBuffer[%" PRIu32 "] from dword 0x%" PRIX32 " of ",
+                  reference_index, reference.packet_offset);
+      if (reference.parent_index == UINT32_MAX) {
+         TXTW_PUT_LITERAL(&text, "pCommandBuffer");
+      } else {
+         TXTW_Printf(&text, "IndirectBuffer[%" PRIu32 "]", reference.parent_index);
+      }
+      TXTW_Printf(&text, ": 0x%" PRIX32 " dwords at 0x%010" PRIX64,
+                  reference.indirect_buffer.dword_count, reference.indirect_buffer.address);
+      if (reference.dwords) {
+         TXTW_Printf(&text, ", hash 0x%016" PRIX64, reference.hash);
+      }
+      TXTW_Printf(&text, "%s\n", status_names[reference.status]);
+      if (reference.status != CAPT_INDIRECT_BUFFER_FIRST) {
+         continue;
+      }
+      // Offsets are printed relative to the beginning of the indirect buffer.
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, reference.dwords, reference.dword_count);
+      PM4P_Packet packets[256];
+      uint32_t packet_count;
+      while ((packet_count =
+                 PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) != 0) {
+         PM4P_PrintPatchedPackets(&text, packets, packet_count, nullptr, family, field_decoder);
+      }
+   }
+}
+
+static void CAPT_PrintRenderEnd(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                KMTC_RenderView const & view) {
+   KMTC_Render const & render = *view.render;
+   bool const has_lists = render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN;
+   TXTW_Printf(&text, "  > AllocationCount = %" PRIu32 "\n", render.allocation_count);
+   if (has_lists) {
+      for (uint32_t allocation_index = 0; allocation_index < render.allocation_count;
+           ++allocation_index) {
+         KMTC_AllocationListEntry const & allocation = view.allocation_list[allocation_index];
+         TXTW_Printf(&text, "    [%" PRIu32 "] = 0x%" PRIX32 ", flags %" PRIX32 "\n",
+                     allocation_index, allocation.allocation, allocation.flags);
+      }
+   }
+   TXTW_Printf(&text, "  > PatchLocationCount = %" PRIu32 "\n", render.patch_location_count);
+   if (has_lists) {
+      for (uint32_t patch_location_index = 0; patch_location_index < render.patch_location_count;
+           ++patch_location_index) {
+         KMTC_PatchLocation const & patch_location =
+            view.patch_location_list[patch_location_index];
+         TXTW_Printf(
+            &text,
+            "    [%" PRIu32 "] = allocation %" PRIu32 ", slot 0x%" PRIX32 " << 10 | 0x%" PRIX32
+            " (0x%" PRIX32 "), driver ID 0x%" PRIX32 ", allocation offset 0x%" PRIX32
+            ", patch offset 0x%" PRIX32 ", split offset 0x%" PRIX32 "\n",
+            patch_location_index, patch_location.allocation_index,
+            (patch_location.slot_id & 0xFFFFFF) >> 10,
+            patch_location.slot_id & ((uint32_t(1) << 10) - 1), patch_location.slot_id & 0xFFFFFF,
+            patch_location.driver_id, patch_location.allocation_offset,
+            patch_location.patch_offset, patch_location.split_offset);
+      }
+   }
+   TXTW_Printf(&text, "  > NewCommandBufferSize = 0x%" PRIX32 "\n",
+               render.new_command_buffer_size_in);
+   TXTW_Printf(&text, "  > NewAllocationListSize = 0x%" PRIX32 "\n",
+               render.new_allocation_list_size_in);
+   TXTW_Printf(&text, "  > NewPatchLocationListSize = 0x%" PRIX32 "\n",
+               render.new_patch_location_list_size_in);
+   static char const * const flag_names[] = {
+      "ResizeCommandBuffer",
+      "ResizeAllocationList",
+      "ResizePatchLocationList",
+      "NullRendering",
+      "PresentRedirected",
+      "RenderKm",
+      "RenderKmReadback",
+   };
+   for (uint32_t flag_index = 0; flag_index < sizeof(flag_names) / sizeof(flag_names[0]);
+        ++flag_index) {
+      TXTW_Printf(&text, "  > Flags.%s = %" PRIu32 "\n", flag_names[flag_index],
+                  (render.flags >> flag_index) & 1);
+   }
+   TXTW_Printf(&text, "  > PresentHistoryToken = 0x%" PRIX64 "\n", render.present_history_token);
+   TXTW_Printf(&text, "  > BroadcastContextCount = %" PRIu32 "\n", render.broadcast_context_count);
+   for (uint32_t broadcast_context_index = 0;
+        broadcast_context_index < render.broadcast_context_count; ++broadcast_context_index) {
+      TXTW_Printf(&text, "  > BroadcastContext[%" PRIu32 "] = 0x%" PRIX32 "\n",
+                  broadcast_context_index, view.broadcast_contexts[broadcast_context_index]);
+   }
+   CAPT_PrintArray(text, "> pPrivateDriverData", view.private_driver_data,
+                   render.private_driver_data_size);
+   TXTW_Printf(&text, "  > PrivateDriverDataSize = 0x%" PRIX32 "\n",
+               render.private_driver_data_size);
+   CAPT_PrintStatus(text, event);
+   TXTW_Printf(&text, "  < pNewCommandBuffer = 0x%016" PRIX64 "\n",
+               render.new_command_buffer_pointer);
+   TXTW_Printf(&text, "  < NewCommandBufferSize = 0x%" PRIX32 "\n",
+               render.new_command_buffer_size_out);
+   TXTW_Printf(&text, "  < pNewAllocationList = 0x%016" PRIX64 "\n", render.new_allocation_list);
+   TXTW_Printf(&text, "  < NewAllocationListSize = 0x%" PRIX32 "\n",
+               render.new_allocation_list_size_out);
+   TXTW_Printf(&text, "  < pNewPatchLocationList = 0x%016" PRIX64 "\n",
+               render.new_patch_location_list);
+   TXTW_Printf(&text, "  < NewPatchLocationListSize = 0x%" PRIX32 "\n",
+               render.new_patch_location_list_size_out);
+   TXTW_Printf(&text, "  < QueuedBufferCount = %" PRIu32 "\n", render.queued_buffer_count);
+   TXTW_Printf(&text, "  < NewCommandBuffer = 0x%" PRIX64 "\n", render.new_command_buffer);
+}
+
+// For the submissions printed as a whole, which have no patches in the graphics command buffer.
+static void CAPT_PrintRender(TXTW_Writer & text, KMTC_EventHeader const & event,
+                             KMTC_RenderView const & view, PM4P_Family const * const family,
+                             PM4P_FieldDecoder * const field_decoder) {
+   KMTC_Render const & render = *view.render;
+   CAPT_PrintRenderBegin(text, event, view);
+   if (render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN) {
+      CAPT_PrintRenderCommandBytes(text, view, 0, render.command_length);
+      if (render.node_ordinal == 0) {
+         CAPT_PrintRenderPM4(text, view, 0, render.command_length / sizeof(uint32_t), false,
+                             nullptr, 0, family, field_decoder);
+      }
+   }
+   CAPT_PrintRenderEnd(text, event, view);
+}
+
+#undef CAPT_TAKE_BLOB
+#undef CAPT_TAKE
+
+// The field decoder is used only for the graphics command buffer of a submission. The view with the
+// command buffer resolved is required for render events, which are malformed if it's null.
+static bool CAPT_PrintEvent(TXTW_Writer & text, KMTC_EventHeader const & event,
+                            KMTC_RenderView const * const render_view,
+                            PM4P_Family const * const family,
+                            PM4P_FieldDecoder * const field_decoder) {
+   KMTC_EventCursor cursor;
+   KMTC_EventCursorInit(&cursor, &event);
+   switch (event.type) {
+   case KMTC_EVENT_ESCAPE:
+      return CAPT_PrintEscape(text, event, cursor);
+   case KMTC_EVENT_QUERY_ADAPTER_INFO:
+      return CAPT_PrintQueryAdapterInfo(text, event, cursor);
+   case KMTC_EVENT_CREATE_DEVICE:
+      return CAPT_PrintCreateDevice(text, event, cursor);
+   case KMTC_EVENT_CREATE_SYNCHRONIZATION_OBJECT:
+      return CAPT_PrintCreateSynchronizationObject(text, event, cursor);
+   case KMTC_EVENT_CREATE_ALLOCATION:
+      return CAPT_PrintCreateAllocation(text, event, cursor);
+   case KMTC_EVENT_LOCK:
+      return CAPT_PrintLock(text, event, cursor);
+   case KMTC_EVENT_CREATE_CONTEXT:
+      return CAPT_PrintCreateContext(text, event, cursor);
+   case KMTC_EVENT_SET_CONTEXT_SCHEDULING_PRIORITY:
+      return CAPT_PrintSetContextSchedulingPriority(text, event, cursor);
+   case KMTC_EVENT_RENDER:
+      if (!render_view) {
+         return false;
+      }
+      CAPT_PrintRender(text, event, *render_view, family, field_decoder);
+      return true;
+   case KMTC_EVENT_UNLOCK:
+      return CAPT_PrintUnlock(text, event, cursor);
+   case KMTC_EVENT_ALLOCATION_DATA:
+      return CAPT_PrintAllocationData(text, event);
+   case KMTC_EVENT_TRIGGER:
+      return CAPT_PrintTrigger(text, event, cursor);
+   }
+   return false;
+}
+
+static bool CAPT_IsEventTypeKnown(uint32_t const type) {
+   switch (type) {
+   case KMTC_EVENT_ESCAPE:
+   case KMTC_EVENT_QUERY_ADAPTER_INFO:
+   case KMTC_EVENT_CREATE_DEVICE:
+   case KMTC_EVENT_CREATE_SYNCHRONIZATION_OBJECT:
+   case KMTC_EVENT_CREATE_ALLOCATION:
+   case KMTC_EVENT_LOCK:
+   case KMTC_EVENT_CREATE_CONTEXT:
+   case KMTC_EVENT_SET_CONTEXT_SCHEDULING_PRIORITY:
+   case KMTC_EVENT_RENDER:
+   case KMTC_EVENT_UNLOCK:
+   case KMTC_EVENT_ALLOCATION_DATA:
+   case KMTC_EVENT_TRIGGER:
+      return true;
+   }
+   return false;
+}
+
+// Printing of captures is split into jobs run on multiple threads, a whole event for most events,
+// and parts of the command buffer split at packet boundaries for large submissions.
+
+// The size of the parts of the command buffer of a submission, in dwords. Submissions not larger
+// than this are printed as a whole.
+static constexpr uint32_t CAPT_PRINT_PART_DWORD_COUNT = uint32_t(1) << 14;
+
+enum CAPT_PrintPart : uint8_t {
+   CAPT_PRINT_PART_EVENT,
+   CAPT_PRINT_PART_RENDER_BEGIN,
+   // From begin to end in bytes.
+   CAPT_PRINT_PART_RENDER_COMMAND_BYTES,
+   // From begin to end in dwords.
+   CAPT_PRINT_PART_RENDER_PM4,
+   // The indirect buffers from begin to end in CAPT_PrintContext::indirect_buffers.
+   CAPT_PRINT_PART_RENDER_INDIRECT_BUFFERS,
+   CAPT_PRINT_PART_RENDER_END,
+};
+
+struct CAPT_PrintJob {
+   KMTC_EventHeader const * event;
+   // Of a render event with the command buffer of a known node, resolved while adding the jobs.
+   uint32_t const * command_buffer;
+   uint32_t begin;
+   uint32_t end;
+   // The patches of the submission in CAPT_PrintContext::patches, for the PM4 parts.
+   uint32_t patch_begin;
+   uint32_t patch_end;
+   CAPT_PrintPart part;
+   bool follows_packet2;
+};
+
+struct CAPT_PrintContext {
+   CAPT_CommandBuffers * commands;
+   std::vector<CAPT_PrintJob> jobs;
+   // Expanded from the chunks of a deduplicated capture for the jobs of the batch, the first
+   // command_buffer_count of them, and kept allocated for the next batches.
+   std::vector<std::vector<uint32_t>> command_buffers;
+   std::size_t command_buffer_count;
+   // Of the ones used in the batch, in bytes.
+   std::size_t command_buffer_size;
+   // The patch locations of the graphics submissions, indexed by the patched dword.
+   std::vector<PM4P_Patch> patches;
+   // Resolved while adding the jobs, in the order of the file.
+   CAPT_IndirectBuffers indirect_buffer_state;
+   std::vector<CAPT_IndirectBufferReference> indirect_buffers;
+   PM4P_Family const * family;
+   // The registers to decode the fields of, or null. Shared by the jobs if only the requested
+   // registers are decoded, otherwise copied for every context to track the values written in it,
+   // and the jobs must be run in order on one thread.
+   PM4P_FieldDecoder const * field_decoder;
+   std::unordered_map<uint32_t, std::unique_ptr<PM4P_FieldDecoder>> context_field_decoders;
+};
+
+static void CAPT_AddPrintJob(CAPT_PrintContext & context, KMTC_EventHeader const & event,
+                             uint32_t const * const command_buffer, CAPT_PrintPart const part,
+                             uint32_t const begin = 0, uint32_t const end = 0,
+                             bool const follows_packet2 = false, uint32_t const patch_begin = 0,
+                             uint32_t const patch_end = 0) {
+   CAPT_PrintJob job;
+   job.event = &event;
+   job.command_buffer = command_buffer;
+   job.begin = begin;
+   job.end = end;
+   job.patch_begin = patch_begin;
+   job.patch_end = patch_end;
+   job.part = part;
+   job.follows_packet2 = follows_packet2;
+   context.jobs.push_back(job);
+}
+
+static void CAPT_AddPrintJobs(CAPT_PrintContext & context, KMTC_EventHeader const & event) {
+   CAPT_AddAllocationData(context.indirect_buffer_state, event);
+   KMTC_RenderView view;
+   if (event.type != KMTC_EVENT_RENDER ||
+       !CAPT_ParseCaptureRender(*context.commands, &event, view) ||
+       view.render->node_ordinal == KMTC_NODE_ORDINAL_UNKNOWN) {
+      CAPT_AddPrintJob(context, event, nullptr, CAPT_PRINT_PART_EVENT);
+      return;
+   }
+   if (context.command_buffer_count == context.command_buffers.size()) {
+      context.command_buffers.emplace_back();
+   }
+   // Growing the list moves the command buffers without reallocating them.
+   std::vector<uint32_t> & command_buffer = context.command_buffers[context.command_buffer_count];
+   if (!CAPT_ResolveCommandBuffer(*context.commands, view, command_buffer)) {
+      // Reported as malformed when printing.
+      CAPT_AddPrintJob(context, event, nullptr, CAPT_PRINT_PART_EVENT);
+      return;
+   }
+   if (view.command_buffer == command_buffer.data()) {
+      ++context.command_buffer_count;
+      context.command_buffer_size += view.render->command_length;
+   }
+   uint32_t const patch_begin = uint32_t(context.patches.size());
+   if (view.render->node_ordinal == 0) {
+      CAPT_IndexPatches(view, context.patches);
+   }
+   uint32_t const patch_end = uint32_t(context.patches.size());
+   // Only looked for once the capture has contents of allocations.
+   uint32_t const indirect_buffer_begin = uint32_t(context.indirect_buffers.size());
+   if (view.render->node_ordinal == 0 && !context.indirect_buffer_state.ranges.empty()) {
+      CAPT_ResolveIndirectBuffers(context.indirect_buffer_state, view,
+                                  context.patches.data() + patch_begin, patch_end - patch_begin,
+                                  context.indirect_buffers);
+   }
+   uint32_t const indirect_buffer_end = uint32_t(context.indirect_buffers.size());
+   // Printed as a whole only if there's nothing else to print with the command buffer.
+   if (patch_begin == patch_end && indirect_buffer_begin == indirect_buffer_end &&
+       view.render->command_length <= sizeof(uint32_t) * CAPT_PRINT_PART_DWORD_COUNT) {
+      CAPT_AddPrintJob(context, event, view.command_buffer, CAPT_PRINT_PART_EVENT);
+      return;
+   }
+   KMTC_Render const & render = *view.render;
+   CAPT_AddPrintJob(context, event, view.command_buffer, CAPT_PRINT_PART_RENDER_BEGIN);
+   // Bytes are printed about 4 times as slowly as dwords are decoded.
+   uint32_t const part_byte_count = CAPT_PRINT_PART_DWORD_COUNT;
+   for (uint32_t byte_index = 0; byte_index < render.command_length;
+        byte_index += part_byte_count) {
+      uint32_t const byte_end = render.command_length - byte_index > part_byte_count
+                                   ? byte_index + part_byte_count
+                                   : render.command_length;
+      CAPT_AddPrintJob(context, event, view.command_buffer, CAPT_PRINT_PART_RENDER_COMMAND_BYTES,
+                       byte_index, byte_end);
+   }
+   if (render.node_ordinal == 0) {
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+      while (decoder.dword_index < decoder.pm4_dword_count) {
+         uint32_t const part_dword_index = decoder.dword_index;
+         bool const part_follows_packet2 = decoder.follows_packet2;
+         PM4P_Skip(&decoder, CAPT_PRINT_PART_DWORD_COUNT);
+         CAPT_AddPrintJob(context, event, view.command_buffer, CAPT_PRINT_PART_RENDER_PM4,
+                          part_dword_index, decoder.dword_index, part_follows_packet2,
+                          patch_begin, patch_end);
+      }
+   }
+   if (indirect_buffer_begin != indirect_buffer_end) {
+      CAPT_AddPrintJob(context, event, view.command_buffer,
+                       CAPT_PRINT_PART_RENDER_INDIRECT_BUFFERS, indirect_buffer_begin,
+                       indirect_buffer_end);
+   }
+   CAPT_AddPrintJob(context, event, view.command_buffer, CAPT_PRINT_PART_RENDER_END);
+}
+
+// Returns the field decoder for the graphics command buffer of the submission, or null if fields
+// are not decoded or the event is not a render event.
+static PM4P_FieldDecoder * CAPT_GetPrintFieldDecoder(CAPT_PrintContext & context,
+                                                     KMTC_RenderView const * const view) {
+   if (!context.field_decoder) {
+      return nullptr;
+   }
+   if (!context.field_decoder->decode_changed) {
+      // Only read when not tracking the values.
+      return const_cast<PM4P_FieldDecoder *>(context.field_decoder);
+   }
+   if (!view) {
+      return nullptr;
+   }
+   std::unique_ptr<PM4P_FieldDecoder> & field_decoder =
+      context.context_field_decoders[view->render->context];
+   if (!field_decoder) {
+      field_decoder = std::make_unique<PM4P_FieldDecoder>(*context.field_decoder);
+   }
+   return field_decoder.get();
+}
+
+static bool CAPT_RunPrintJob(void * const context_pointer, std::size_t const job_index,
+                             TXTW_Writer * const text) {
+   CAPT_PrintContext & context = *static_cast<CAPT_PrintContext *>(context_pointer);
+   CAPT_PrintJob const & job = context.jobs[job_index];
+   // Validated when splitting for the parts of render events. Submissions of known nodes with the
+   // command buffer not resolved are malformed.
+   KMTC_RenderView view;
+   bool const is_render =
+      job.event->type == KMTC_EVENT_RENDER &&
+      CAPT_ParseCaptureRender(*context.commands, job.event, view) &&
+      (job.command_buffer || !view.render->command_length ||
+       view.render->node_ordinal == KMTC_NODE_ORDINAL_UNKNOWN);
+   if (is_render) {
+      view.command_buffer = job.command_buffer;
+   }
+   // The indirect buffers are tracked as if executed after the command buffer of the submission.
+   PM4P_FieldDecoder * const field_decoder =
+      CAPT_GetPrintFieldDecoder(context, is_render ? &view : nullptr);
+   if (job.part == CAPT_PRINT_PART_EVENT) {
+      if (!CAPT_PrintEvent(*text, *job.event, is_render ? &view : nullptr, context.family,
+                           field_decoder)) {
+         return false;
+      }
+      TXTW_PutChar(text, '\n');
+      return true;
+   }
+   switch (job.part) {
+   case CAPT_PRINT_PART_RENDER_BEGIN:
+      CAPT_PrintRenderBegin(*text, *job.event, view);
+      break;
+   case CAPT_PRINT_PART_RENDER_COMMAND_BYTES:
+      CAPT_PrintRenderCommandBytes(*text, view, job.begin, job.end);
+      break;
+   case CAPT_PRINT_PART_RENDER_PM4:
+      CAPT_PrintRenderPM4(*text, view, job.begin, job.end, job.follows_packet2,
+                          context.patches.data() + job.patch_begin,
+                          job.patch_end - job.patch_begin, context.family, field_decoder);
+      break;
+   case CAPT_PRINT_PART_RENDER_INDIRECT_BUFFERS:
+      CAPT_PrintIndirectBuffers(*text, context.indirect_buffers.data() + job.begin,
+                                job.end - job.begin, context.family, field_decoder);
+      break;
+   default:
+      CAPT_PrintRenderEnd(*text, *job.event, view);
+      TXTW_PutChar(text, '\n');
+      break;
+   }
+   return true;
+}
+
+// The amount of the capture, and of the command buffers expanded from it, to split into jobs at
+// once, bounding the memory used by the jobs and by the pages of the capture, which are released
+// after printing each batch.
+static constexpr std::size_t CAPT_PRINT_BATCH_SIZE = std::size_t(1) << 26;
+
+static bool CAPT_Print(KMTC_Reader & reader, CAPT_MappedFile const & capture,
+                       CAPT_CommandBuffers & commands, PM4P_Family const * const family,
+                       PM4P_FieldDecoder const * const field_decoder,
+                       unsigned const thread_count) {
+   CAPT_PrintContext context;
+   context.commands = &commands;
+   context.family = family;
+   context.field_decoder = field_decoder;
+   // The changes are found in the order of the submissions.
+   unsigned const job_thread_count =
+      field_decoder && field_decoder->decode_changed ? 1 : thread_count;
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   bool succeeded = true;
+   bool is_end = false;
+   while (!is_end) {
+      std::size_t const batch_offset = reader.offset;
+      context.jobs.clear();
+      context.patches.clear();
+      context.indirect_buffers.clear();
+      context.command_buffer_count = 0;
+      context.command_buffer_size = 0;
+      while (reader.offset - batch_offset + context.command_buffer_size < CAPT_PRINT_BATCH_SIZE) {
+         KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader);
+         if (!event) {
+            is_end = true;
+            break;
+         }
+         // Events from a newer version are skipped.
+         if (CAPT_IsEventTypeKnown(event->type)) {
+            CAPT_AddPrintJobs(context, *event);
+         }
+      }
+      std::size_t const printed_job_count =
+         CAPT_RunOrdered(context.jobs.size(), job_thread_count, CAPT_RunPrintJob, &context,
+                         &text);
+      if (printed_job_count < context.jobs.size()) {
+         std::fprintf(stderr, "Malformed event of type %" PRIu32 ".\n",
+                      context.jobs[printed_job_count].event->type);
+         succeeded = false;
+         break;
+      }
+      CAPT_ReleaseMappedRange(capture, batch_offset, reader.offset - batch_offset);
+   }
+   TXTW_Destroy(&text);
+   return succeeded && KMTC_ReaderIsAtEnd(&reader);
+}
+
+// Prints the registers written before every draw and dispatch in the graphics command buffers,
+// with the register state tracked separately for every context across its submissions.
+static bool CAPT_PrintDraws(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                            PM4P_Family const * const family) {
+   std::unordered_map<uint32_t, std::unique_ptr<PM4S_Shadow>> shadows;
+   std::vector<PM4S_RegisterWrite> writes(PM4S_REGISTER_COUNT);
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   std::vector<uint32_t> command_buffer;
+   bool succeeded = true;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+         std::fprintf(stderr, "Malformed event of type %" PRIu32 ".\n", event->type);
+         succeeded = false;
+         break;
+      }
+      KMTC_Render const & render = *view.render;
+      if (render.node_ordinal != 0) {
+         continue;
+      }
+      std::unique_ptr<PM4S_Shadow> & shadow = shadows[render.context];
+      if (!shadow) {
+         shadow = std::make_unique<PM4S_Shadow>();
+         PM4S_ShadowInit(shadow.get());
+      }
+      TXTW_Printf(&text, "NtGdiDdDDIRender @ %" PRIu32 ", %" PRIu64 ", hContext = 0x%" PRIX32 ":\n",
+                  event->thread_id, event->timestamp, render.context);
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+      PM4P_Packet packets[256];
+      uint32_t packet_count;
+      while ((packet_count = PM4P_Decode(&decoder, packets,
+                                         sizeof(packets) / sizeof(packets[0]))) != 0) {
+         for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+            PM4P_Packet const & packet = packets[packet_index];
+            PM4S_ShadowApply(shadow.get(), &packet);
+            if (!PM4S_IsDrawOrDispatch(&packet)) {
+               continue;
+            }
+            TXTW_Printf(&text, "  /* @ 0x%" PRIX32 " */ %s:\n",
+                        uint32_t(sizeof(uint32_t) * packet.offset),
+                        PM4P_GetPacket3OpcodeName(packet.opcode));
+            uint32_t const write_count = PM4S_ShadowTakeDelta(shadow.get(), writes.data());
+            for (uint32_t write_index = 0; write_index < write_count; ++write_index) {
+               PM4S_RegisterWrite const & write = writes[write_index];
+               char const * const name = PM4P_GetRegisterName(write.index, family);
+               if (name) {
+                  TXTW_Printf(&text, "    %s = 0x%" PRIX32 "\n", name, write.value);
+               } else {
+                  TXTW_Printf(&text, "    0x%" PRIX32 " = 0x%" PRIX32 "\n",
+                              uint32_t(sizeof(uint32_t) * write.index), write.value);
+               }
+            }
+         }
+      }
+      TXTW_PutChar(&text, '\n');
+   }
+   TXTW_Destroy(&text);
+   return succeeded && KMTC_ReaderIsAtEnd(&reader);
+}
+
+static void CAPT_PrintRegisterName(TXTW_Writer & text, uint32_t const index,
+                                   PM4P_Family const * const family) {
+   char const * const name = PM4P_GetRegisterName(index, family);
+   if (name) {
+      TXTW_PutString(&text, name);
+   } else {
+      TXTW_Printf(&text, "0x%" PRIX32, uint32_t(sizeof(uint32_t) * index));
+   }
+}
+
+static void CAPT_PrintRedundancyCounts(TXTW_Writer & text, char const * const name,
+                                       PM4S_RedundancyCounts const & counts) {
+   TXTW_Printf(&text,
+               "  %s: %" PRIu64 " of %" PRIu64 " register writes redundant, %" PRIu64 " of %" PRIu64
+               " packets, %" PRIu64 " dwords wasted\n",
+               name, counts.redundant_write_count, counts.write_count,
+               counts.redundant_packet_count, counts.packet_count, counts.wasted_dword_count);
+}
+
+// Flags the register writes of the graphics command buffers that write the value the register
+// already has, with the register state tracked separately for every context across its
+// submissions, and sums them up for every submission and register.
+static bool CAPT_PrintRedundantWrites(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                                      PM4P_Family const * const family) {
+   std::unordered_map<uint32_t, std::unique_ptr<PM4S_Shadow>> shadows;
+   auto const redundancy = std::make_unique<PM4S_Redundancy>();
+   PM4S_RedundancyInit(redundancy.get());
+   std::vector<uint32_t> redundant_indices(PM4P_MAX_PACKET_DWORDS);
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   std::vector<uint32_t> command_buffer;
+   bool succeeded = true;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+         std::fprintf(stderr, "Malformed event of type %" PRIu32 ".\n", event->type);
+         succeeded = false;
+         break;
+      }
+      KMTC_Render const & render = *view.render;
+      if (render.node_ordinal != 0) {
+         continue;
+      }
+      std::unique_ptr<PM4S_Shadow> & shadow = shadows[render.context];
+      if (!shadow) {
+         shadow = std::make_unique<PM4S_Shadow>();
+         PM4S_ShadowInit(shadow.get());
+      }
+      PM4S_RedundancyBeginSubmission(redundancy.get());
+      TXTW_Printf(&text, "NtGdiDdDDIRender @ %" PRIu32 ", %" PRIu64 ", hContext = 0x%" PRIX32 ":\n",
+                  event->thread_id, event->timestamp, render.context);
+      PM4P_Decoder decoder;
+      PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+      PM4P_Packet packets[256];
+      uint32_t packet_count;
+      while ((packet_count = PM4P_Decode(&decoder, packets,
+                                         sizeof(packets) / sizeof(packets[0]))) != 0) {
+         for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+            PM4P_Packet const & packet = packets[packet_index];
+            uint32_t const redundant_count = PM4S_ShadowApplyCountingRedundancy(
+               shadow.get(), redundancy.get(), &packet, redundant_indices.data());
+            if (!redundant_count) {
+               continue;
+            }
+            TXTW_Printf(&text, "  /* @ 0x%" PRIX32 " */ %s: %" PRIu32 " of %" PRIu32
+                        " values redundant\n",
+                        uint32_t(sizeof(uint32_t) * packet.offset),
+                        PM4P_GetPacket3OpcodeName(packet.opcode), redundant_count,
+                        packet.body_dword_count - 1);
+            for (uint32_t redundant_index = 0; redundant_index < redundant_count;
+                 ++redundant_index) {
+               uint32_t const index = redundant_indices[redundant_index];
+               TXTW_PUT_LITERAL(&text, "    ");
+               CAPT_PrintRegisterName(text, index, family);
+               TXTW_Printf(&text, " = 0x%" PRIX32 "\n",
+                           shadow->state.values[PM4S_GetShadowIndex(index)]);
+            }
+         }
+      }
+      CAPT_PrintRedundancyCounts(text, "Submission", redundancy->submission);
+      TXTW_PutChar(&text, '\n');
+   }
+
+   if (succeeded) {
+      TXTW_PUT_LITERAL(&text, "Summary:\n");
+      CAPT_PrintRedundancyCounts(text, "Total", redundancy->total);
+      // The most wasteful registers first.
+      std::vector<uint32_t> shadow_indices;
+      for (uint32_t shadow_index = 0; shadow_index < PM4S_REGISTER_COUNT; ++shadow_index) {
+         if (redundancy->redundant_write_counts[shadow_index]) {
+            shadow_indices.push_back(shadow_index);
+         }
+      }
+      std::stable_sort(shadow_indices.begin(), shadow_indices.end(),
+                       [&redundancy](uint32_t const a, uint32_t const b) {
+                          return redundancy->redundant_write_counts[a] >
+                                 redundancy->redundant_write_counts[b];
+                       });
+      for (uint32_t const shadow_index : shadow_indices) {
+         TXTW_PUT_LITERAL(&text, "  ");
+         CAPT_PrintRegisterName(text, PM4S_GetRegisterIndex(shadow_index), family);
+         TXTW_Printf(&text, ": %" PRIu64 " of %" PRIu64 " writes redundant\n",
+                     redundancy->redundant_write_counts[shadow_index],
+                     redundancy->write_counts[shadow_index]);
+      }
+   }
+   TXTW_Destroy(&text);
+   return succeeded && KMTC_ReaderIsAtEnd(&reader);
+}
+
+static void CAPT_GetPacketTypeName(char (& name)[32], uint32_t const type) {
+   std::snprintf(name, sizeof(name), "PKT_TYPE_S(%" PRIu32 ")", type);
+}
+
+static void CAPT_GetOpcodeName(char (& name)[32], uint32_t const opcode) {
+   char const * const opcode_name = PM4P_GetPacket3OpcodeName(opcode);
+   if (opcode_name) {
+      std::snprintf(name, sizeof(name), "%s", opcode_name);
+   } else {
+      std::snprintf(name, sizeof(name), "PKT3(0x%02" PRIX32 ")", opcode);
+   }
+}
+
+// Returns the opcodes with packets, the ones with the most dwords first.
+static std::vector<uint32_t> CAPT_SortOpcodes(PM4H_Histogram const & histogram) {
+   std::vector<uint32_t> opcodes;
+   for (uint32_t opcode = 0; opcode < 0x100; ++opcode) {
+      if (histogram.opcodes[opcode].packet_count) {
+         opcodes.push_back(opcode);
+      }
+   }
+   std::stable_sort(opcodes.begin(), opcodes.end(),
+                    [&histogram](uint32_t const a, uint32_t const b) {
+                       return histogram.opcodes[a].dword_count > histogram.opcodes[b].dword_count;
+                    });
+   return opcodes;
+}
+
+static void CAPT_PrintPacketCounts(TXTW_Writer & text, char const * const name,
+                                   PM4H_PacketCounts const & counts, uint64_t const total_dwords) {
+   TXTW_Printf(&text,
+               "  %-40s %12" PRIu64 " packets %14" PRIu64 " dwords %16" PRIu64 " bytes %5.1f%%\n",
+               name, counts.packet_count, counts.dword_count,
+               uint64_t(sizeof(uint32_t)) * counts.dword_count,
+               total_dwords ? 100.0 * double(counts.dword_count) / double(total_dwords) : 0.0);
+}
+
+static void CAPT_WriteHistogramCSV(TXTW_Writer & csv, char const * const scope,
+                                   PM4H_Histogram const & histogram,
+                                   PM4P_Family const * const family) {
+   char name[32];
+   for (uint32_t type = 0; type < 4; ++type) {
+      PM4H_PacketCounts const & counts = histogram.types[type];
+      if (counts.packet_count) {
+         CAPT_GetPacketTypeName(name, type);
+         TXTW_Printf(&csv, "%s,type,%" PRIu32 ",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", scope,
+                     type, name, counts.packet_count, counts.dword_count,
+                     uint64_t(sizeof(uint32_t)) * counts.dword_count);
+      }
+   }
+   for (uint32_t const opcode : CAPT_SortOpcodes(histogram)) {
+      PM4H_PacketCounts const & counts = histogram.opcodes[opcode];
+      CAPT_GetOpcodeName(name, opcode);
+      TXTW_Printf(&csv, "%s,opcode,0x%02" PRIX32 ",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                  scope, opcode, name, counts.packet_count, counts.dword_count,
+                  uint64_t(sizeof(uint32_t)) * counts.dword_count);
+   }
+   // A register write is a dword.
+   for (uint32_t shadow_index = 0; shadow_index < PM4S_REGISTER_COUNT; ++shadow_index) {
+      uint64_t const write_count = histogram.register_write_counts[shadow_index];
+      if (!write_count) {
+         continue;
+      }
+      uint32_t const index = PM4S_GetRegisterIndex(shadow_index);
+      char const * const register_name = PM4P_GetRegisterName(index, family);
+      TXTW_Printf(&csv, "%s,register,0x%" PRIX32 ",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                  scope, uint32_t(sizeof(uint32_t) * index), register_name ? register_name : "",
+                  write_count, write_count, uint64_t(sizeof(uint32_t)) * write_count);
+   }
+}
+
+// Prints the numbers of packets, dwords and bytes by the opcode and of writes by the register for
+// every submission and overall, sorted by the size, and also writes them as CSV if csv is not
+// null.
+static bool CAPT_PrintStatistics(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                                 PM4P_Family const * const family, TXTW_Writer * const csv) {
+   auto const submission = std::make_unique<PM4H_Histogram>();
+   auto const total = std::make_unique<PM4H_Histogram>();
+   PM4H_HistogramInit(total.get());
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   if (csv) {
+      TXTW_PUT_LITERAL(csv, "scope,category,id,name,count,dwords,bytes\n");
+   }
+   char name[32];
+   std::vector<uint32_t> command_buffer;
+   bool succeeded = true;
+   uint32_t submission_index = 0;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+         std::fprintf(stderr, "Malformed event of type %" PRIu32 ".\n", event->type);
+         succeeded = false;
+         break;
+      }
+      KMTC_Render const & render = *view.render;
+      if (render.node_ordinal != 0) {
+         continue;
+      }
+      PM4H_HistogramInit(submission.get());
+      PM4H_HistogramAddBuffer(submission.get(), view.command_buffer,
+                              render.command_length / sizeof(uint32_t));
+      PM4H_HistogramMerge(total.get(), submission.get());
+
+      uint64_t packet_count = 0;
+      uint64_t dword_count = 0;
+      for (PM4H_PacketCounts const & counts : submission->types) {
+         packet_count += counts.packet_count;
+         dword_count += counts.dword_count;
+      }
+      TXTW_Printf(&text,
+                  "Submission %" PRIu32 ", NtGdiDdDDIRender @ %" PRIu32 ", %" PRIu64
+                  ", hContext = 0x%" PRIX32 ": %" PRIu64 " packets, %" PRIu64 " dwords\n",
+                  submission_index, event->thread_id, event->timestamp, render.context,
+                  packet_count, dword_count);
+      // Only the largest opcodes of every submission, all of them are in the CSV.
+      std::vector<uint32_t> const opcodes = CAPT_SortOpcodes(*submission);
+      for (std::size_t opcode_index = 0; opcode_index < opcodes.size() && opcode_index < 3;
+           ++opcode_index) {
+         CAPT_GetOpcodeName(name, opcodes[opcode_index]);
+         CAPT_PrintPacketCounts(text, name, submission->opcodes[opcodes[opcode_index]],
+                                dword_count);
+      }
+      if (csv) {
+         char scope[16];
+         std::snprintf(scope, sizeof(scope), "%" PRIu32, submission_index);
+         CAPT_WriteHistogramCSV(*csv, scope, *submission, family);
+      }
+      ++submission_index;
+   }
+
+   if (succeeded) {
+      uint64_t total_dwords = 0;
+      for (PM4H_PacketCounts const & counts : total->types) {
+         total_dwords += counts.dword_count;
+      }
+      TXTW_PUT_LITERAL(&text, "\nPacket types:\n");
+      for (uint32_t type = 0; type < 4; ++type) {
+         CAPT_GetPacketTypeName(name, type);
+         CAPT_PrintPacketCounts(text, name, total->types[type], total_dwords);
+      }
+      TXTW_PUT_LITERAL(&text, "\nOpcodes:\n");
+      for (uint32_t const opcode : CAPT_SortOpcodes(*total)) {
+         CAPT_GetOpcodeName(name, opcode);
+         CAPT_PrintPacketCounts(text, name, total->opcodes[opcode], total_dwords);
+      }
+      TXTW_PUT_LITERAL(&text, "\nRegister writes:\n");
+      std::vector<uint32_t> shadow_indices;
+      for (uint32_t shadow_index = 0; shadow_index < PM4S_REGISTER_COUNT; ++shadow_index) {
+         if (total->register_write_counts[shadow_index]) {
+            shadow_indices.push_back(shadow_index);
+         }
+      }
+      std::stable_sort(shadow_indices.begin(), shadow_indices.end(),
+                       [&total](uint32_t const a, uint32_t const b) {
+                          return total->register_write_counts[a] >
+                                 total->register_write_counts[b];
+                       });
+      for (uint32_t const shadow_index : shadow_indices) {
+         TXTW_PUT_LITERAL(&text, "  ");
+         CAPT_PrintRegisterName(text, PM4S_GetRegisterIndex(shadow_index), family);
+         TXTW_Printf(&text, ": %" PRIu64 "\n", total->register_write_counts[shadow_index]);
+      }
+      TXTW_Printf(&text, "  Outside the known blocks: %" PRIu64 "\n",
+                  total->untracked_register_write_count);
+      if (csv) {
+         CAPT_WriteHistogramCSV(*csv, "total", *total, family);
+      }
+   }
+   TXTW_Destroy(&text);
+   return succeeded && KMTC_ReaderIsAtEnd(&reader);
+}
+
+static void CAPT_PrintPM4Chunk(TXTW_Writer & text, PM4P_StreamDecoder & decoder,
+                               uint32_t const * const dwords, uint32_t const dword_count,
+                               PM4P_Family const * const family,
+                               PM4P_FieldDecoder * const field_decoder) {
+   PM4P_Packet packets[256];
+   PM4P_StreamDecoderPush(&decoder, dwords, dword_count);
+   uint32_t packet_count;
+   while ((packet_count = PM4P_StreamDecode(&decoder, packets,
+                                            sizeof(packets) / sizeof(packets[0]))) != 0) {
+      PM4P_PrintPatchedPackets(&text, packets, packet_count, nullptr, family, field_decoder);
+   }
+}
+
+static void CAPT_FinishPM4(TXTW_Writer & text, PM4P_StreamDecoder & decoder,
+                           PM4P_Family const * const family,
+                           PM4P_FieldDecoder * const field_decoder) {
+   PM4P_Packet packet;
+   if (PM4P_StreamDecoderFinish(&decoder, &packet)) {
+      PM4P_PrintPatchedPackets(&text, &packet, 1, nullptr, family, field_decoder);
+   }
+}
+
+static void CAPT_PrintIgnoredBytes(std::size_t const ignored_byte_count) {
+   if (ignored_byte_count) {
+      std::fprintf(stderr, "Ignored %zu bytes at the end, not a whole dword.\n",
+                   ignored_byte_count);
+   }
+}
+
+// Decodes a raw PM4 dump read in fixed-size pieces, so pipes can be printed with bounded memory.
+static bool CAPT_PrintPM4Stream(std::FILE * const file, PM4P_Family const * const family,
+                                PM4P_FieldDecoder * const field_decoder) {
+   std::vector<uint32_t> chunk(std::size_t(1) << 16);
+   auto const decoder = std::make_unique<PM4P_StreamDecoder>();
+   PM4P_StreamDecoderInit(decoder.get());
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   // Bytes of a dword split between reads are moved to the beginning of the chunk.
+   std::size_t partial_byte_count = 0;
+   for (;;) {
+      std::size_t const read_byte_count =
+         std::fread(reinterpret_cast<uint8_t *>(chunk.data()) + partial_byte_count, 1,
+                    sizeof(uint32_t) * chunk.size() - partial_byte_count, file);
+      if (!read_byte_count) {
+         break;
+      }
+      std::size_t const chunk_byte_count = partial_byte_count + read_byte_count;
+      uint32_t const chunk_dword_count = uint32_t(chunk_byte_count / sizeof(uint32_t));
+      CAPT_PrintPM4Chunk(text, *decoder, chunk.data(), chunk_dword_count, family, field_decoder);
+      partial_byte_count = chunk_byte_count % sizeof(uint32_t);
+      std::memmove(chunk.data(), chunk.data() + chunk_dword_count, partial_byte_count);
+   }
+   CAPT_FinishPM4(text, *decoder, family, field_decoder);
+   bool const succeeded = TXTW_Destroy(&text) && !std::ferror(file);
+   CAPT_PrintIgnoredBytes(partial_byte_count);
+   return succeeded;
+}
+
+// The amount of a mapped PM4 dump decoded before releasing its pages.
+static constexpr uint32_t CAPT_PM4_MAPPED_CHUNK_DWORD_COUNT = uint32_t(1) << 22;
+
+// Decodes a raw PM4 dump directly from the mapping of the file, in chunks that are released after
+// decoding, so dumps of any size are printed without copying and with bounded memory.
+static bool CAPT_PrintPM4Mapped(CAPT_MappedFile const & dump, PM4P_Family const * const family,
+                                PM4P_FieldDecoder * const field_decoder) {
+   uint32_t const * const pm4 = static_cast<uint32_t const *>(dump.data);
+   std::size_t const pm4_dword_count = dump.size / sizeof(uint32_t);
+   auto const decoder = std::make_unique<PM4P_StreamDecoder>();
+   PM4P_StreamDecoderInit(decoder.get());
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   for (std::size_t dword_index = 0; dword_index < pm4_dword_count;
+        dword_index += CAPT_PM4_MAPPED_CHUNK_DWORD_COUNT) {
+      uint32_t const chunk_dword_count =
+         pm4_dword_count - dword_index > CAPT_PM4_MAPPED_CHUNK_DWORD_COUNT
+            ? CAPT_PM4_MAPPED_CHUNK_DWORD_COUNT
+            : uint32_t(pm4_dword_count - dword_index);
+      CAPT_PrintPM4Chunk(text, *decoder, pm4 + dword_index, chunk_dword_count, family,
+                         field_decoder);
+      // The beginning of a packet continuing in the next chunk is copied by the decoder.
+      CAPT_ReleaseMappedRange(dump, sizeof(uint32_t) * dword_index,
+                              sizeof(uint32_t) * chunk_dword_count);
+   }
+   CAPT_FinishPM4(text, *decoder, family, field_decoder);
+   bool const succeeded = TXTW_Destroy(&text);
+   CAPT_PrintIgnoredBytes(dump.size % sizeof(uint32_t));
+   return succeeded;
+}
+
+// The number of edits to look for the middle snake within before splitting at the furthest point
+// reached, bounding the time of diffing very different captures.
+static constexpr uint32_t CAPT_DIFF_MAX_COST = 1024;
+
+struct CAPT_DiffCounts {
+   uint64_t removed_submission_count = 0;
+   uint64_t inserted_submission_count = 0;
+   uint64_t paired_submission_count = 0;
+   uint64_t equal_packet_count = 0;
+   uint64_t changed_packet_count = 0;
+   uint64_t removed_packet_count = 0;
+   uint64_t inserted_packet_count = 0;
+   uint64_t changed_value_count = 0;
+};
+
+// The packet index is in the submission last resolved.
+static void CAPT_PrintDiffPacket(TXTW_Writer & text, CAPT_DiffCapture const & capture,
+                                 CAPT_DiffSubmission const & submission, char const sign,
+                                 uint32_t const packet_index) {
+   uint64_t const shape = capture.packet_shapes[submission.packet_begin + packet_index];
+   uint32_t const type = uint32_t(shape >> 40);
+   char name[32];
+   if (type == 3) {
+      CAPT_GetOpcodeName(name, uint32_t(shape >> 32) & 0xFF);
+   } else {
+      CAPT_GetPacketTypeName(name, type);
+   }
+   uint32_t const offset =
+      uint32_t(capture.packet_dwords[packet_index] - capture.packet_dwords[0]);
+   TXTW_Printf(&text, "  %c /* @ 0x%" PRIX32 " */ %s\n", sign, uint32_t(sizeof(uint32_t) * offset),
+               name);
+}
+
+static void CAPT_PrintDiffValue(TXTW_Writer & text, uint32_t const * const values,
+                                uint32_t const value_count, uint32_t const value_index) {
+   if (value_index < value_count) {
+      TXTW_Printf(&text, "0x%" PRIX32, values[value_index]);
+   } else {
+      TXTW_PUT_LITERAL(&text, "(none)");
+   }
+}
+
+// Prints the values of the aligned packets that differ, which are register values for
+// register-setting packets, and dwords of the whole packet for others. The packet indices are in
+// the submissions last resolved.
+static void CAPT_PrintPacketChanges(TXTW_Writer & text, CAPT_DiffCapture const & a,
+                                    CAPT_DiffSubmission const & a_submission,
+                                    uint32_t const a_packet_index, CAPT_DiffCapture const & b,
+                                    CAPT_DiffSubmission const & b_submission,
+                                    uint32_t const b_packet_index,
+                                    PM4P_Family const * const family, CAPT_DiffCounts & counts) {
+   uint32_t const * a_values = a.packet_dwords[a_packet_index];
+   uint32_t const * b_values = b.packet_dwords[b_packet_index];
+   uint32_t a_value_count = a.packet_dword_counts[a_packet_index];
+   uint32_t b_value_count = b.packet_dword_counts[b_packet_index];
+   uint32_t const a_offset = uint32_t(a_values - a.packet_dwords[0]);
+   uint32_t const b_offset = uint32_t(b_values - b.packet_dwords[0]);
+   uint64_t const shape = a.packet_shapes[a_submission.packet_begin + a_packet_index];
+   uint32_t const type = uint32_t(shape >> 40);
+   // Only register-setting type-3 packets with the offset in the body have the first register.
+   uint32_t const register_first = type == 3 ? uint32_t(shape) : 0;
+   char name[32];
+   if (type == 3) {
+      CAPT_GetOpcodeName(name, uint32_t(shape >> 32) & 0xFF);
+   } else {
+      CAPT_GetPacketTypeName(name, type);
+   }
+   TXTW_Printf(&text, "  ~ /* @ 0x%" PRIX32 " -> 0x%" PRIX32 " */ %s\n",
+               uint32_t(sizeof(uint32_t) * a_offset), uint32_t(sizeof(uint32_t) * b_offset),
+               name);
+   if (register_first) {
+      // Skipping the header and the register offset.
+      a_values += 2;
+      b_values += 2;
+      a_value_count -= 2;
+      b_value_count -= 2;
+   }
+   uint32_t const value_count = std::max(a_value_count, b_value_count);
+   for (uint32_t value_index = 0; value_index < value_count; ++value_index) {
+      if (value_index < a_value_count && value_index < b_value_count &&
+          a_values[value_index] == b_values[value_index]) {
+         continue;
+      }
+      ++counts.changed_value_count;
+      if (register_first) {
+         TXTW_PUT_LITERAL(&text, "    ");
+         CAPT_PrintRegisterName(text, register_first + value_index, family);
+         TXTW_PUT_LITERAL(&text, ": ");
+      } else {
+         TXTW_Printf(&text, "    [%" PRIu32 "]: ", value_index);
+      }
+      CAPT_PrintDiffValue(text, a_values, a_value_count, value_index);
+      TXTW_PUT_LITERAL(&text, " -> ");
+      CAPT_PrintDiffValue(text, b_values, b_value_count, value_index);
+      TXTW_PutChar(&text, '\n');
+   }
+}
+
+static void CAPT_PrintDiffSubmission(TXTW_Writer & text, CAPT_DiffCapture const & capture,
+                                     uint32_t const submission_index) {
+   CAPT_DiffSubmission const & submission = capture.submissions[submission_index];
+   TXTW_Printf(&text, "submission %" PRIu32 " @ %" PRIu64 ", hContext = 0x%" PRIX32,
+               submission_index, submission.event->timestamp, submission.context);
+}
+
+// Aligns the packets of a pair of submissions and prints the differences, with the header of the
+// pair only if there are any. The command buffers are resolved again only if the packets are not
+// known to be the same. Returns false if resolving fails.
+static bool CAPT_PrintSubmissionPairDiff(TXTW_Writer & text, CAPT_DiffCapture & a,
+                                         uint32_t const a_submission_index, CAPT_DiffCapture & b,
+                                         uint32_t const b_submission_index,
+                                         PM4P_Family const * const family,
+                                         std::vector<CAPT_DiffRun> & runs,
+                                         CAPT_DiffCounts & counts) {
+   CAPT_DiffSubmission const & a_submission = a.submissions[a_submission_index];
+   CAPT_DiffSubmission const & b_submission = b.submissions[b_submission_index];
+   ++counts.paired_submission_count;
+   if (a_submission.key == b_submission.key &&
+       a_submission.content_hash == b_submission.content_hash) {
+      counts.equal_packet_count += a_submission.packet_count;
+      return true;
+   }
+   if (!CAPT_ResolveDiffSubmission(a, a_submission_index) ||
+       !CAPT_ResolveDiffSubmission(b, b_submission_index)) {
+      return false;
+   }
+   runs.clear();
+   CAPT_Diff(a.packet_shapes.data() + a_submission.packet_begin, a_submission.packet_count,
+             b.packet_shapes.data() + b_submission.packet_begin, b_submission.packet_count,
+             CAPT_DIFF_MAX_COST, runs);
+   bool header_printed = false;
+   auto const print_header = [&]() {
+      if (header_printed) {
+         return;
+      }
+      header_printed = true;
+      TXTW_PUT_LITERAL(&text, "~ ");
+      CAPT_PrintDiffSubmission(text, a, a_submission_index);
+      TXTW_PUT_LITERAL(&text, " -> ");
+      CAPT_PrintDiffSubmission(text, b, b_submission_index);
+      TXTW_PUT_LITERAL(&text, ":\n");
+   };
+   for (CAPT_DiffRun const & run : runs) {
+      uint32_t const a_begin = run.a_begin;
+      uint32_t const b_begin = run.b_begin;
+      switch (run.operation) {
+      case CAPT_DIFF_EQUAL:
+         for (uint32_t run_index = 0; run_index < run.count; ++run_index) {
+            uint32_t const a_packet_index = a_begin + run_index;
+            uint32_t const b_packet_index = b_begin + run_index;
+            // Comparing before printing the header, which is needed only if there are changes.
+            if (a.packet_dword_counts[a_packet_index] == b.packet_dword_counts[b_packet_index] &&
+                !std::memcmp(a.packet_dwords[a_packet_index], b.packet_dwords[b_packet_index],
+                             sizeof(uint32_t) * a.packet_dword_counts[a_packet_index])) {
+               ++counts.equal_packet_count;
+               continue;
+            }
+            print_header();
+            CAPT_PrintPacketChanges(text, a, a_submission, a_packet_index, b, b_submission,
+                                    b_packet_index, family, counts);
+            ++counts.changed_packet_count;
+         }
+         break;
+      case CAPT_DIFF_REMOVED:
+         print_header();
+         for (uint32_t run_index = 0; run_index < run.count; ++run_index) {
+            CAPT_PrintDiffPacket(text, a, a_submission, '-', a_begin + run_index);
+         }
+         counts.removed_packet_count += run.count;
+         break;
+      case CAPT_DIFF_INSERTED:
+         print_header();
+         for (uint32_t run_index = 0; run_index < run.count; ++run_index) {
+            CAPT_PrintDiffPacket(text, b, b_submission, '+', b_begin + run_index);
+         }
+         counts.inserted_packet_count += run.count;
+         break;
+      }
+   }
+   if (header_printed) {
+      TXTW_PutChar(&text, '\n');
+   }
+   return true;
+}
+
+// Prints the submissions removed between the submissions aligned as the same, and inserted between
+// them, pairing them in order, as the same submission in both captures usually has the same
+// position among its neighbors even if its packets differ. Returns false if resolving fails.
+static bool CAPT_PrintUnalignedSubmissions(TXTW_Writer & text, CAPT_DiffCapture & a,
+                                           uint32_t const a_begin, uint32_t const a_end,
+                                           CAPT_DiffCapture & b, uint32_t const b_begin,
+                                           uint32_t const b_end, PM4P_Family const * const family,
+                                           std::vector<CAPT_DiffRun> & runs,
+                                           CAPT_DiffCounts & counts) {
+   uint32_t const pair_count = std::min(a_end - a_begin, b_end - b_begin);
+   for (uint32_t pair_index = 0; pair_index < pair_count; ++pair_index) {
+      if (!CAPT_PrintSubmissionPairDiff(text, a, a_begin + pair_index, b, b_begin + pair_index,
+                                        family, runs, counts)) {
+         return false;
+      }
+   }
+   for (uint32_t a_index = a_begin + pair_count; a_index < a_end; ++a_index) {
+      TXTW_PUT_LITERAL(&text, "- ");
+      CAPT_PrintDiffSubmission(text, a, a_index);
+      TXTW_Printf(&text, ", %" PRIu32 " packets\n\n", a.submissions[a_index].packet_count);
+      ++counts.removed_submission_count;
+      counts.removed_packet_count += a.submissions[a_index].packet_count;
+   }
+   for (uint32_t b_index = b_begin + pair_count; b_index < b_end; ++b_index) {
+      TXTW_PUT_LITERAL(&text, "+ ");
+      CAPT_PrintDiffSubmission(text, b, b_index);
+      TXTW_Printf(&text, ", %" PRIu32 " packets\n\n", b.submissions[b_index].packet_count);
+      ++counts.inserted_submission_count;
+      counts.inserted_packet_count += b.submissions[b_index].packet_count;
+   }
+   return true;
+}
+
+// Aligns the graphics submissions of the captures by the shapes of their packets, then the packets
+// within the pairs of submissions, and prints the removed, inserted and changed packets, with the
+// register values that differ. The submissions are visited in their order in both captures, so the
+// compressed ones can be decoded again as the pairs are printed.
+static bool CAPT_PrintDiff(KMTC_Reader & a_reader, CAPT_CommandBuffers & a_commands,
+                           KMTC_Reader & b_reader, CAPT_CommandBuffers & b_commands,
+                           PM4P_Family const * const family) {
+   CAPT_DiffCapture a, b;
+   if (!CAPT_ReadDiffCapture(a_reader, a_commands, a) ||
+       !CAPT_ReadDiffCapture(b_reader, b_commands, b)) {
+      return false;
+   }
+   std::vector<uint64_t> a_keys, b_keys;
+   a_keys.reserve(a.submissions.size());
+   for (CAPT_DiffSubmission const & submission : a.submissions) {
+      a_keys.push_back(submission.key);
+   }
+   b_keys.reserve(b.submissions.size());
+   for (CAPT_DiffSubmission const & submission : b.submissions) {
+      b_keys.push_back(submission.key);
+   }
+   std::vector<CAPT_DiffRun> submission_runs;
+   CAPT_Diff(a_keys.data(), uint32_t(a_keys.size()), b_keys.data(), uint32_t(b_keys.size()),
+             CAPT_DIFF_MAX_COST, submission_runs);
+
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   CAPT_DiffCounts counts;
+   std::vector<CAPT_DiffRun> packet_runs;
+   // The submissions not aligned since the last ones aligned as the same.
+   uint32_t a_unaligned_begin = 0, a_unaligned_end = 0;
+   uint32_t b_unaligned_begin = 0, b_unaligned_end = 0;
+   bool resolved = true;
+   for (CAPT_DiffRun const & run : submission_runs) {
+      if (!resolved) {
+         break;
+      }
+      switch (run.operation) {
+      case CAPT_DIFF_EQUAL:
+         resolved = CAPT_PrintUnalignedSubmissions(text, a, a_unaligned_begin, a_unaligned_end, b,
+                                                   b_unaligned_begin, b_unaligned_end, family,
+                                                   packet_runs, counts);
+         for (uint32_t run_index = 0; resolved && run_index < run.count; ++run_index) {
+            resolved = CAPT_PrintSubmissionPairDiff(text, a, run.a_begin + run_index, b,
+                                                    run.b_begin + run_index, family, packet_runs,
+                                                    counts);
+         }
+         a_unaligned_begin = a_unaligned_end = run.a_begin + run.count;
+         b_unaligned_begin = b_unaligned_end = run.b_begin + run.count;
+         break;
+      case CAPT_DIFF_REMOVED:
+         a_unaligned_end = run.a_begin + run.count;
+         break;
+      case CAPT_DIFF_INSERTED:
+         b_unaligned_end = run.b_begin + run.count;
+         break;
+      }
+   }
+   resolved = resolved && CAPT_PrintUnalignedSubmissions(text, a, a_unaligned_begin,
+                                                         a_unaligned_end, b, b_unaligned_begin,
+                                                         b_unaligned_end, family, packet_runs,
+                                                         counts);
+   if (!resolved) {
+      TXTW_Destroy(&text);
+      return false;
+   }
+
+   TXTW_PUT_LITERAL(&text, "Summary:\n");
+   TXTW_Printf(&text,
+               "  Submissions: %" PRIu64 " paired, %" PRIu64 " removed, %" PRIu64 " inserted\n",
+               counts.paired_submission_count, counts.removed_submission_count,
+               counts.inserted_submission_count);
+   TXTW_Printf(&text,
+               "  Packets: %" PRIu64 " equal, %" PRIu64 " changed, %" PRIu64 " removed, %" PRIu64
+               " inserted\n",
+               counts.equal_packet_count, counts.changed_packet_count, counts.removed_packet_count,
+               counts.inserted_packet_count);
+   TXTW_Printf(&text, "  Changed values: %" PRIu64 "\n", counts.changed_value_count);
+   TXTW_Destroy(&text);
+   return true;
+}
+
+// The conditions of the query command, with the ones on the submissions checked before decoding
+// them.
+struct CAPT_Query {
+   PM4Q_Query packets;
+   // Among the graphics submissions, inclusive.
+   uint32_t submission_first = 0;
+   uint32_t submission_last = UINT32_MAX;
+   uint32_t context = 0;
+   bool has_context = false;
+};
+
+// Accepts decimal, hexadecimal with 0x, and octal with 0 numbers.
+static bool CAPT_ParseNumber(std::string const & string, uint32_t & number) {
+   if (string.empty()) {
+      return false;
+   }
+   char * end;
+   unsigned long const parsed = std::strtoul(string.c_str(), &end, 0);
+   if (*end || parsed > UINT32_MAX) {
+      return false;
+   }
+   number = uint32_t(parsed);
+   return true;
+}
+
+// Accepts the name with or without the PKT3_ prefix, or the number.
+static bool CAPT_ParseOpcode(std::string const & string, uint32_t & opcode) {
+   if (CAPT_ParseNumber(string, opcode)) {
+      return opcode <= 0xFF;
+   }
+   for (uint32_t opcode_index = 0; opcode_index <= 0xFF; ++opcode_index) {
+      char const * const name = PM4P_GetPacket3OpcodeName(opcode_index);
+      if (name && (string == name || (!std::strncmp(name, "PKT3_", 5) && string == name + 5))) {
+         opcode = opcode_index;
+         return true;
+      }
+   }
+   return false;
+}
+
+// Accepts the name, or the byte address, and returns the dword index.
+static bool CAPT_ParseRegister(std::string const & string, PM4P_Family const * const family,
+                               uint32_t & index) {
+   uint32_t address;
+   if (CAPT_ParseNumber(string, address)) {
+      index = address / sizeof(uint32_t);
+      return true;
+   }
+   for (uint32_t register_index = 0; register_index < family->register_count; ++register_index) {
+      PM4P_Register const & register_record = *family->registers[register_index];
+      if (string == register_record.name) {
+         index = register_record.index;
+         return true;
+      }
+   }
+   return false;
+}
+
+// Selections of the registers to decode the fields of, separated by commas:
+// - all - every register.
+// - changed - the registers written with a different value than before, or for the first time.
+// - <register> - every write of the register, in the blocks tracked by the shadow.
+static bool CAPT_ParseFieldSelection(char const * const selection,
+                                     PM4P_Family const * const family,
+                                     PM4P_FieldDecoder & field_decoder) {
+   std::string const argument(selection);
+   std::size_t begin = 0;
+   while (begin <= argument.size()) {
+      std::size_t end = argument.find(',', begin);
+      if (end == std::string::npos) {
+         end = argument.size();
+      }
+      std::string const element = argument.substr(begin, end - begin);
+      uint32_t index;
+      if (element == "all") {
+         PM4P_FieldDecoderRequestAll(&field_decoder);
+      } else if (element == "changed") {
+         field_decoder.decode_changed = true;
+      } else if (!CAPT_ParseRegister(element, family, index) ||
+                 !PM4P_FieldDecoderRequest(&field_decoder, index)) {
+         return false;
+      }
+      begin = end + 1;
+   }
+   return true;
+}
+
+// Splits first-last, or a single element being both.
+static void CAPT_SplitRange(std::string const & string, std::string & first, std::string & last) {
+   std::size_t const separator = string.find('-');
+   first = string.substr(0, separator);
+   last = separator != std::string::npos ? string.substr(separator + 1) : first;
+}
+
+// Terms:
+// - opcode=<opcode>[,<opcode>...] - type-3 packets with any of the opcodes.
+// - register=<register>[-<register>] - register-setting packets writing any of the registers.
+// - value=<value>[/<mask>] - register-setting packets writing the value, with only the bits of the
+//   mask compared, to a register of the range if there is one.
+// - submission=<index>[-<index>] - among the graphics submissions, from 0.
+// - context=<hContext>.
+static bool CAPT_ParseQueryTerm(char const * const term, PM4P_Family const * const family,
+                                CAPT_Query & query) {
+   char const * const separator = std::strchr(term, '=');
+   if (!separator) {
+      return false;
+   }
+   std::string const key(term, separator);
+   std::string const argument(separator + 1);
+   std::string first, last;
+   if (key == "opcode") {
+      std::size_t begin = 0;
+      while (begin <= argument.size()) {
+         std::size_t end = argument.find(',', begin);
+         if (end == std::string::npos) {
+            end = argument.size();
+         }
+         uint32_t opcode;
+         if (!CAPT_ParseOpcode(argument.substr(begin, end - begin), opcode)) {
+            return false;
+         }
+         PM4Q_QueryAddOpcode(&query.packets, opcode);
+         begin = end + 1;
+      }
+      return true;
+   }
+   if (key == "register") {
+      CAPT_SplitRange(argument, first, last);
+      query.packets.has_registers = true;
+      return CAPT_ParseRegister(first, family, query.packets.register_first) &&
+             CAPT_ParseRegister(last, family, query.packets.register_last) &&
+             query.packets.register_first <= query.packets.register_last;
+   }
+   if (key == "value") {
+      std::size_t const mask_separator = argument.find('/');
+      query.packets.has_value = true;
+      query.packets.value_mask = UINT32_MAX;
+      if (mask_separator != std::string::npos &&
+          !CAPT_ParseNumber(argument.substr(mask_separator + 1), query.packets.value_mask)) {
+         return false;
+      }
+      if (!CAPT_ParseNumber(argument.substr(0, mask_separator), query.packets.value_expected)) {
+         return false;
+      }
+      query.packets.value_expected &= query.packets.value_mask;
+      return true;
+   }
+   if (key == "submission") {
+      CAPT_SplitRange(argument, first, last);
+      return CAPT_ParseNumber(first, query.submission_first) &&
+             CAPT_ParseNumber(last, query.submission_last) &&
+             query.submission_first <= query.submission_last;
+   }
+   if (key == "context") {
+      query.has_context = true;
+      return CAPT_ParseNumber(argument, query.context);
+   }
+   return false;
+}
+
+struct CAPT_QueryCounts {
+   uint64_t submission_count = 0;
+   uint64_t packet_count = 0;
+};
+
+// Prints the packets of the graphics command buffer matching the query. The packets are checked in
+// the decoded form, and only the matching ones are printed.
+static void CAPT_PrintQueryRender(TXTW_Writer & text, KMTC_EventHeader const & event,
+                                  KMTC_RenderView const & view, uint32_t const submission_index,
+                                  CAPT_Query const & query, PM4P_Family const * const family,
+                                  CAPT_QueryCounts & counts) {
+   KMTC_Render const & render = *view.render;
+   bool has_matches = false;
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+   PM4P_Packet packets[256];
+   uint32_t match_indices[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      uint32_t const match_count = PM4Q_Match(&query.packets, packets, packet_count, match_indices);
+      if (!match_count) {
+         continue;
+      }
+      if (!has_matches) {
+         has_matches = true;
+         ++counts.submission_count;
+         TXTW_Printf(&text,
+                     "NtGdiDdDDIRender @ %" PRIu32 ", %" PRIu64 ", hContext = 0x%" PRIX32
+                     ", submission %" PRIu32 ":\n",
+                     event.thread_id, event.timestamp, render.context, submission_index);
+      }
+      for (uint32_t match_index = 0; match_index < match_count; ++match_index) {
+         PM4P_PrintPackets(&text, &packets[match_indices[match_index]], 1, family);
+      }
+      counts.packet_count += match_count;
+   }
+   if (has_matches) {
+      TXTW_PutChar(&text, '\n');
+   }
+}
+
+static bool CAPT_IsQuerySubmission(CAPT_Query const & query, uint32_t const submission_index,
+                                   uint32_t const context) {
+   return submission_index >= query.submission_first &&
+          submission_index <= query.submission_last &&
+          (!query.has_context || context == query.context);
+}
+
+static void CAPT_PrintQueryCounts(TXTW_Writer & text, CAPT_QueryCounts const & counts) {
+   TXTW_Printf(&text, "%" PRIu64 " packets matched in %" PRIu64 " submissions.\n",
+               counts.packet_count, counts.submission_count);
+}
+
+// Prints the packets of the graphics command buffers matching the query, going through all the
+// events.
+static bool CAPT_PrintQuery(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                            CAPT_Query const & query, PM4P_Family const * const family) {
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   std::vector<uint32_t> command_buffer;
+   bool succeeded = true;
+   uint32_t submission_index = 0;
+   CAPT_QueryCounts counts;
+   while (KMTC_EventHeader const * const event = KMTC_ReaderNext(&reader)) {
+      if (event->type != KMTC_EVENT_RENDER) {
+         continue;
+      }
+      KMTC_RenderView view;
+      // Compressed command buffers are decoded in order, so the ones not selected are resolved too.
+      if (!CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+         std::fprintf(stderr, "Malformed event of type %" PRIu32 ".\n", event->type);
+         succeeded = false;
+         break;
+      }
+      KMTC_Render const & render = *view.render;
+      if (render.node_ordinal != 0) {
+         continue;
+      }
+      uint32_t const render_submission_index = submission_index++;
+      if (CAPT_IsQuerySubmission(query, render_submission_index, render.context)) {
+         CAPT_PrintQueryRender(text, *event, view, render_submission_index, query, family,
+                               counts);
+      }
+   }
+   if (succeeded) {
+      CAPT_PrintQueryCounts(text, counts);
+   }
+   TXTW_Destroy(&text);
+   return succeeded && KMTC_ReaderIsAtEnd(&reader);
+}
+
+// The same as CAPT_PrintQuery, but only reading the submissions that may match according to the
+// index, skipping the chunks of submissions without the opcodes or the registers looked for.
+static bool CAPT_PrintIndexedQuery(KMTC_Reader const & reader, CAPT_CommandBuffers & commands,
+                                   CAPT_IndexChunk const * const chunks,
+                                   uint32_t const chunk_count, CAPT_Query const & query,
+                                   PM4P_Family const * const family) {
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, nullptr, 0);
+   std::vector<uint32_t> command_buffer;
+   bool succeeded = true;
+   uint32_t submission_index = 0;
+   CAPT_QueryCounts counts;
+   // Stopping after the last submission selected, as the ones after it aren't read anyway.
+   for (uint32_t chunk_index = 0;
+        chunk_index < chunk_count && succeeded && submission_index <= query.submission_last;
+        ++chunk_index) {
+      CAPT_IndexChunk const & chunk = chunks[chunk_index];
+      uint32_t const entry_count = std::min(chunk.entry_count, CAPT_INDEX_CHUNK_ENTRY_COUNT);
+      bool const may_match = CAPT_IndexChunkMayMatch(chunk, query.packets);
+      for (uint32_t entry_index = 0; entry_index < entry_count; ++entry_index) {
+         CAPT_IndexEntry const & entry = chunk.entries[entry_index];
+         if (entry.node_ordinal != 0) {
+            continue;
+         }
+         uint32_t const render_submission_index = submission_index++;
+         if (!may_match || !CAPT_IsQuerySubmission(query, render_submission_index, entry.context)) {
+            continue;
+         }
+         KMTC_EventHeader const * const event = CAPT_GetIndexedEvent(reader, entry);
+         KMTC_RenderView view;
+         if (!event || !CAPT_ReadCaptureRender(commands, event, view, command_buffer)) {
+            std::fprintf(stderr, "Indexed submission %" PRIu32 " is malformed.\n",
+                         render_submission_index);
+            succeeded = false;
+            break;
+         }
+         CAPT_PrintQueryRender(text, *event, view, render_submission_index, query, family,
+                               counts);
+      }
+   }
+   if (succeeded) {
+      CAPT_PrintQueryCounts(text, counts);
+   }
+   TXTW_Destroy(&text);
+   return succeeded;
+}
+
+// Maps the capture and prepares the reader for its events, and the command buffers of the
+// submissions for being resolved while reading them. Prints the error and returns false if the
+// capture can't be read.
+static bool CAPT_LoadCapture(char const * const path, CAPT_MappedFile & capture,
+                             KMTC_Reader & reader, CAPT_CommandBuffers & commands) {
+   if (!CAPT_MapFile(path, CAPT_MAPPED_ACCESS_SEQUENTIAL, capture)) {
+      return false;
+   }
+   // Mappings are aligned to pages, more than KMTC_ALIGNMENT.
+   if (!KMTC_ReaderInit(&reader, capture.data, capture.size)) {
+      std::fprintf(stderr, "%s is not a supported capture.\n", path);
+      CAPT_UnmapFile(capture);
+      return false;
+   }
+   uint32_t const command_encoding = KMTC_GetCommandEncoding(reader.file_header);
+   if (command_encoding != KMTC_COMMAND_ENCODING_RAW &&
+       (command_encoding != KMTC_COMMAND_ENCODING_PM4Z || reader.file_header->chunk_size != 0)) {
+      std::fprintf(stderr, "%s has an unsupported command buffer encoding.\n", path);
+      CAPT_UnmapFile(capture);
+      return false;
+   }
+   CAPT_CommandBuffersInit(commands, reader, &capture);
+   return true;
+}
+
+int main(int const argc, char const * const argv[]) {
+   if (argc < 3) {
+      std::fputs(
+         "Usage: CaptureTool <command> <capture> [options]\n"
+         "Commands:\n"
+         "  print - print the events and decode the graphics command buffers.\n"
+         "  pm4 - decode a raw graphics command buffer dump, - for stdin.\n"
+         "  draws - print the registers written before every draw and dispatch.\n"
+         "  redundant - print the register writes not changing the value.\n"
+         "  stats - print the numbers of packets by the opcode and writes by the register.\n"
+         "  inflate - write the capture with the deduplicated or compressed command buffers\n"
+         "    expanded.\n"
+         "  compress - write the capture with the command buffers compressed.\n"
+         "  diff <other capture> - align the graphics packets of the captures and print the\n"
+         "    removed, inserted and changed ones.\n"
+         "  query <term>... - print the graphics packets matching all the terms:\n"
+         "    opcode=<opcode>[,<opcode>...], register=<register>[-<register>],\n"
+         "    value=<value>[/<mask>], submission=<index>[-<index>], context=<hContext>.\n"
+         "  index - write the index of the submissions for going to them directly, to the\n"
+         "    capture path with .index appended by default.\n"
+         "Options:\n"
+         "  --family <family> - the register names of r600, r700, evergreen (by default) or\n"
+         "    cayman.\n"
+         "  --r9xx - same as --family cayman.\n"
+         "  --fields <selection>[,<selection>...] - with print and pm4, decode the fields of\n"
+         "    the values written to the registers selected by all, changed (different from the\n"
+         "    last write, printing on one thread), or <register>.\n"
+         "  --jobs <count> - threads to print on, all hardware threads by default.\n"
+         "  --csv <path> - also write the statistics as CSV.\n"
+         "  --output <path> - where to write the expanded or compressed capture, or the index.\n"
+         "  --index <path> - the index to skip the submissions not matching the query with.\n",
+         stderr);
+      return EXIT_FAILURE;
+   }
+   char const * const command = argv[1];
+   char const * const capture_path = argv[2];
+   // The only command with a second capture.
+   bool const is_diff = !std::strcmp(command, "diff");
+   if (is_diff && argc < 4) {
+      std::fputs("The capture to compare with must be specified.\n", stderr);
+      return EXIT_FAILURE;
+   }
+   char const * const other_capture_path = is_diff ? argv[3] : nullptr;
+   PM4P_Family const * family = PM4P_GetFamily(PM4P_FAMILY_EVERGREEN);
+   unsigned thread_count = std::thread::hardware_concurrency();
+   char const * csv_path = nullptr;
+   char const * output_path = nullptr;
+   char const * index_path = nullptr;
+   bool const is_query = !std::strcmp(command, "query");
+   // Parsed after the options, as the register names depend on them.
+   std::vector<char const *> query_terms;
+   std::vector<char const *> field_selections;
+   for (int argument_index = is_diff ? 4 : 3; argument_index < argc; ++argument_index) {
+      if (is_query && std::strncmp(argv[argument_index], "--", 2)) {
+         query_terms.push_back(argv[argument_index]);
+      } else if (!std::strcmp(argv[argument_index], "--r9xx")) {
+         family = PM4P_GetFamily(PM4P_FAMILY_CAYMAN);
+      } else if (!std::strcmp(argv[argument_index], "--family") && argument_index + 1 < argc) {
+         family = PM4P_FindFamily(argv[++argument_index]);
+         if (!family) {
+            std::fprintf(stderr, "Unknown family %s.\n", argv[argument_index]);
+            return EXIT_FAILURE;
+         }
+      } else if (!std::strcmp(argv[argument_index], "--fields") && argument_index + 1 < argc) {
+         field_selections.push_back(argv[++argument_index]);
+      } else if (!std::strcmp(argv[argument_index], "--jobs") && argument_index + 1 < argc) {
+         thread_count = unsigned(std::strtoul(argv[++argument_index], nullptr, 10));
+      } else if (!std::strcmp(argv[argument_index], "--csv") && argument_index + 1 < argc) {
+         csv_path = argv[++argument_index];
+      } else if (!std::strcmp(argv[argument_index], "--output") && argument_index + 1 < argc) {
+         output_path = argv[++argument_index];
+      } else if (!std::strcmp(argv[argument_index], "--index") && argument_index + 1 < argc) {
+         index_path = argv[++argument_index];
+      } else {
+         std::fprintf(stderr, "Unknown option %s.\n", argv[argument_index]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   CAPT_Query query;
+   PM4Q_QueryInit(&query.packets);
+   for (char const * const term : query_terms) {
+      if (!CAPT_ParseQueryTerm(term, family, query)) {
+         std::fprintf(stderr, "Invalid query term %s.\n", term);
+         return EXIT_FAILURE;
+      }
+   }
+   std::unique_ptr<PM4P_FieldDecoder> field_decoder;
+   if (!field_selections.empty()) {
+      field_decoder = std::make_unique<PM4P_FieldDecoder>();
+      PM4P_FieldDecoderInit(field_decoder.get(), false);
+      for (char const * const selection : field_selections) {
+         if (!CAPT_ParseFieldSelection(selection, family, *field_decoder)) {
+            std::fprintf(stderr, "Invalid field selection %s.\n", selection);
+            return EXIT_FAILURE;
+         }
+      }
+   }
+
+   if (!std::strcmp(command, "pm4")) {
+      bool succeeded;
+      if (!std::strcmp(capture_path, "-")) {
+#ifdef _WIN32
+         _setmode(_fileno(stdin), _O_BINARY);
+#endif
+         succeeded = CAPT_PrintPM4Stream(stdin, family, field_decoder.get());
+      } else {
+         CAPT_MappedFile dump;
+         if (!CAPT_MapFile(capture_path, CAPT_MAPPED_ACCESS_SEQUENTIAL, dump)) {
+            return EXIT_FAILURE;
+         }
+         succeeded = CAPT_PrintPM4Mapped(dump, family, field_decoder.get());
+         CAPT_UnmapFile(dump);
+      }
+      if (!succeeded) {
+         std::fprintf(stderr, "Failed to decode %s.\n", capture_path);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   CAPT_MappedFile capture;
+   KMTC_Reader reader;
+   CAPT_CommandBuffers commands;
+   if (!CAPT_LoadCapture(capture_path, capture, reader, commands)) {
+      return EXIT_FAILURE;
+   }
+
+   if (is_diff) {
+      CAPT_MappedFile other_capture;
+      KMTC_Reader other_reader;
+      CAPT_CommandBuffers other_commands;
+      if (!CAPT_LoadCapture(other_capture_path, other_capture, other_reader, other_commands)) {
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      bool const succeeded =
+         CAPT_PrintDiff(reader, commands, other_reader, other_commands, family);
+      CAPT_UnmapFile(other_capture);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("A capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "inflate") || !std::strcmp(command, "compress")) {
+      if (!output_path) {
+         std::fputs("The output path must be specified with --output.\n", stderr);
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      std::FILE * const output_file = std::fopen(output_path, "wb");
+      if (!output_file) {
+         std::fprintf(stderr, "Failed to open %s.\n", output_path);
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      bool const written = !std::strcmp(command, "compress")
+                              ? CAPT_EncodeCapture(reader, commands, output_file)
+                              : CAPT_InflateCapture(reader, commands, output_file);
+      bool const is_read = KMTC_ReaderIsAtEnd(&reader);
+      CAPT_UnmapFile(capture);
+      if (std::fclose(output_file) || !written) {
+         // Not leaving a capture that would silently lack the events after the malformed ones.
+         std::remove(output_path);
+         if (!is_read) {
+            std::fputs("The capture is truncated or malformed.\n", stderr);
+         } else {
+            std::fprintf(stderr, "Failed to write %s.\n", output_path);
+         }
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "print")) {
+      bool const succeeded = CAPT_Print(reader, capture, commands, family, field_decoder.get(),
+                                            thread_count);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("The capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "draws")) {
+      bool const succeeded = CAPT_PrintDraws(reader, commands, family);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("The capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "redundant")) {
+      bool const succeeded = CAPT_PrintRedundantWrites(reader, commands, family);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("The capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "index")) {
+      std::string const default_output_path = std::string(capture_path) + ".index";
+      char const * const index_output_path =
+         output_path ? output_path : default_output_path.c_str();
+      std::FILE * const output_file = std::fopen(index_output_path, "wb");
+      if (!output_file) {
+         std::fprintf(stderr, "Failed to open %s.\n", index_output_path);
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      bool const succeeded = CAPT_WriteIndex(reader, commands, output_file);
+      CAPT_UnmapFile(capture);
+      if (std::fclose(output_file) || !succeeded) {
+         std::fprintf(stderr, "Failed to index the capture to %s.\n", index_output_path);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   // Compressed submissions can't be decoded without the ones before them, so all the events are
+   // read.
+   if (is_query && index_path && commands.command_encoding != KMTC_COMMAND_ENCODING_PM4Z) {
+      CAPT_MappedFile index;
+      if (!CAPT_MapFile(index_path, CAPT_MAPPED_ACCESS_SEQUENTIAL, index)) {
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      uint32_t chunk_count;
+      CAPT_IndexChunk const * const chunks =
+         CAPT_GetIndexChunks(index.data, index.size, reader.size, chunk_count);
+      if (!chunks) {
+         std::fprintf(stderr, "%s is not an index of %s.\n", index_path, capture_path);
+         CAPT_UnmapFile(index);
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      // Only the submissions that may match are read.
+      CAPT_AdviseMappedRange(capture, 0, capture.size, CAPT_MAPPED_ACCESS_RANDOM);
+      bool const succeeded =
+         CAPT_PrintIndexedQuery(reader, commands, chunks, chunk_count, query, family);
+      CAPT_UnmapFile(index);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("The capture doesn't match the index.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (is_query) {
+      bool const succeeded = CAPT_PrintQuery(reader, commands, query, family);
+      CAPT_UnmapFile(capture);
+      if (!succeeded) {
+         std::fputs("The capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   if (!std::strcmp(command, "stats")) {
+      std::FILE * const csv_file = csv_path ? std::fopen(csv_path, "w") : nullptr;
+      if (csv_path && !csv_file) {
+         std::fprintf(stderr, "Failed to open %s.\n", csv_path);
+         CAPT_UnmapFile(capture);
+         return EXIT_FAILURE;
+      }
+      TXTW_Writer csv;
+      if (csv_file) {
+         TXTW_InitFile(&csv, csv_file, nullptr, 0);
+      }
+      bool const succeeded =
+         CAPT_PrintStatistics(reader, commands, family, csv_file ? &csv : nullptr);
+      CAPT_UnmapFile(capture);
+      if (csv_file) {
+         bool const csv_succeeded = TXTW_Destroy(&csv);
+         if (std::fclose(csv_file) || !csv_succeeded) {
+            std::fprintf(stderr, "Failed to write %s.\n", csv_path);
+            return EXIT_FAILURE;
+         }
+      }
+      if (!succeeded) {
+         std::fputs("The capture is truncated or malformed.\n", stderr);
+         return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+   }
+
+   CAPT_UnmapFile(capture);
+   std::fprintf(stderr, "Unknown command %s.\n", command);
+   return EXIT_FAILURE;
+}
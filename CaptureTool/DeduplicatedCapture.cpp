@@ -0,0 +1,64 @@
+#include "DeduplicatedCapture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+bool CAPT_InflateCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                         std::FILE * const file) {
+   std::size_t const events_offset = reader.offset;
+   std::vector<uint8_t> file_header(reader.data, reader.data + events_offset);
+   uint32_t const inflated_chunk_size = 0;
+   std::memcpy(file_header.data() + offsetof(KMTC_FileHeader, chunk_size), &inflated_chunk_size,
+               sizeof(inflated_chunk_size));
+   // Only in the headers of the versions with the field.
+   if (KMTC_GetCommandEncoding(reader.file_header) != KMTC_COMMAND_ENCODING_RAW) {
+      uint32_t const inflated_command_encoding = KMTC_COMMAND_ENCODING_RAW;
+      std::memcpy(file_header.data() + offsetof(KMTC_FileHeader, command_encoding),
+                  &inflated_command_encoding, sizeof(inflated_command_encoding));
+   }
+   if (std::fwrite(file_header.data(), 1, events_offset, file) != events_offset) {
+      return false;
+   }
+
+   std::vector<uint32_t> command_buffer;
+   std::vector<uint64_t> inflated_event;
+   KMTC_EventHeader const * event;
+   while ((event = KMTC_ReaderNext(&reader)) != nullptr) {
+      if (event->type == KMTC_EVENT_CHUNK) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ParseCaptureRender(commands, event, view)) {
+         if (std::fwrite(event, 1, event->size, file) != event->size) {
+            return false;
+         }
+         continue;
+      }
+      if (!CAPT_ResolveCommandBuffer(commands, view, command_buffer)) {
+         return false;
+      }
+      KMTC_Render const & render = *view.render;
+      bool const has_lists = render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN;
+      KMTC_Blob const blobs[] = {
+         {view.command_buffer, has_lists ? render.command_length : 0},
+         {view.allocation_list,
+          has_lists ? uint32_t(sizeof(KMTC_AllocationListEntry) * render.allocation_count) : 0},
+         {view.patch_location_list,
+          has_lists ? uint32_t(sizeof(KMTC_PatchLocation) * render.patch_location_count) : 0},
+         {view.broadcast_contexts, uint32_t(sizeof(uint32_t) * render.broadcast_context_count)},
+         {view.private_driver_data, render.private_driver_data_size},
+      };
+      uint32_t const blob_count = uint32_t(sizeof(blobs) / sizeof(blobs[0]));
+      uint32_t const size = KMTC_GetEventSize(sizeof(KMTC_Render), blobs, blob_count);
+      inflated_event.resize(size / sizeof(uint64_t));
+      KMTC_SerializeEvent(inflated_event.data(), event, &render, sizeof(KMTC_Render), blobs,
+                          blob_count);
+      if (std::fwrite(inflated_event.data(), 1, size, file) != size) {
+         return false;
+      }
+   }
+   return KMTC_ReaderIsAtEnd(&reader);
+}
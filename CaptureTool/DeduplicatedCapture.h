@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../Catanalyst/KMTCapture.h"
+#include "CaptureCommands.h"
+
+#include <cstdio>
+
+// Expansion of captures with deduplicated or compressed command buffers into the layout with the
+// command buffers stored in the submissions as they are, so they can be read without looking up
+// the chunks or decoding the submissions before them.
+
+// Reads the capture from the beginning of the events, writing the expanded capture with chunk_size
+// 0, KMTC_COMMAND_ENCODING_RAW and without the chunk events to the file one event at a time.
+// Returns false if the capture is not read completely, with the events before the truncated or
+// malformed data written, or if writing fails.
+bool CAPT_InflateCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands, std::FILE * file);
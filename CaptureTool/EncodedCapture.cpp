@@ -0,0 +1,115 @@
+#include "EncodedCapture.h"
+#include "../Catanalyst/Catanalyst.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Returns the file header of the current version with the encoding.
+static KMTC_FileHeader CAPT_MakeFileHeader(KMTC_FileHeader const & source,
+                                           uint32_t const command_encoding) {
+   KMTC_FileHeader file_header = {};
+   file_header.magic = KMTC_MAGIC;
+   file_header.version = KMTC_VERSION;
+   file_header.header_size = sizeof(file_header);
+   file_header.timestamp_frequency = source.timestamp_frequency;
+   file_header.command_encoding = command_encoding;
+   return file_header;
+}
+
+static PM4Z_Model & CAPT_GetContextModel(
+   std::unordered_map<uint32_t, std::unique_ptr<PM4Z_Model>> & models, uint32_t const context) {
+   std::unique_ptr<PM4Z_Model> & model = models[context];
+   if (!model) {
+      model = std::make_unique<PM4Z_Model>();
+      PM4Z_ModelInit(model.get());
+   }
+   return *model;
+}
+
+// Serializes the render event with the command buffer blobs replaced, and the rest as in the view,
+// into the storage, and returns its size in bytes.
+static uint32_t CAPT_SerializeRender(std::vector<uint64_t> & storage,
+                                     KMTC_EventHeader const & event, KMTC_RenderView const & view,
+                                     KMTC_Blob const * const command_blobs,
+                                     uint32_t const command_blob_count) {
+   KMTC_Render const & render = *view.render;
+   bool const has_lists = render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN;
+   KMTC_Blob blobs[6];
+   uint32_t blob_count = 0;
+   for (uint32_t command_blob_index = 0; command_blob_index < command_blob_count;
+        ++command_blob_index) {
+      blobs[blob_count++] = command_blobs[command_blob_index];
+   }
+   blobs[blob_count++] = {
+      view.allocation_list,
+      has_lists ? uint32_t(sizeof(KMTC_AllocationListEntry) * render.allocation_count) : 0};
+   blobs[blob_count++] = {
+      view.patch_location_list,
+      has_lists ? uint32_t(sizeof(KMTC_PatchLocation) * render.patch_location_count) : 0};
+   blobs[blob_count++] = {view.broadcast_contexts,
+                          uint32_t(sizeof(uint32_t) * render.broadcast_context_count)};
+   blobs[blob_count++] = {view.private_driver_data, render.private_driver_data_size};
+   uint32_t const size = KMTC_GetEventSize(sizeof(KMTC_Render), blobs, blob_count);
+   storage.resize(size / sizeof(uint64_t));
+   KMTC_SerializeEvent(storage.data(), &event, &render, sizeof(KMTC_Render), blobs, blob_count);
+   return size;
+}
+
+bool CAPT_EncodeCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands,
+                        std::FILE * const file) {
+   KMTC_FileHeader const file_header =
+      CAPT_MakeFileHeader(*reader.file_header, KMTC_COMMAND_ENCODING_PM4Z);
+   if (std::fwrite(&file_header, 1, sizeof(file_header), file) != sizeof(file_header)) {
+      return false;
+   }
+   std::unordered_map<uint32_t, std::unique_ptr<PM4Z_Model>> models;
+   std::vector<uint32_t> command_buffer;
+   std::vector<uint8_t> encoded_command_buffer;
+   std::vector<uint64_t> encoded_event;
+   KMTC_EventHeader const * event;
+   while ((event = KMTC_ReaderNext(&reader)) != nullptr) {
+      if (event->type == KMTC_EVENT_CHUNK) {
+         continue;
+      }
+      KMTC_RenderView view;
+      if (!CAPT_ParseCaptureRender(commands, event, view)) {
+         if (std::fwrite(event, 1, event->size, file) != event->size) {
+            return false;
+         }
+         continue;
+      }
+      if (!CAPT_ResolveCommandBuffer(commands, view, command_buffer)) {
+         return false;
+      }
+      KMTC_Render const & render = *view.render;
+      uint32_t const dword_count = render.command_length / sizeof(uint32_t);
+      uint32_t const tail_size = render.command_length % sizeof(uint32_t);
+      encoded_command_buffer.resize(PM4Z_GetMaxEncodedSize(dword_count) + tail_size);
+      std::size_t command_size = 0;
+      if (render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN) {
+         command_size =
+            PM4Z_Encode(&CAPT_GetContextModel(models, render.context), view.command_buffer,
+                        dword_count, encoded_command_buffer.data());
+         std::memcpy(encoded_command_buffer.data() + command_size,
+                     view.command_buffer + dword_count, tail_size);
+         command_size += tail_size;
+      }
+      KMTC_EncodedCommands encoded_commands = {};
+      encoded_commands.encoded_size = uint32_t(command_size);
+      bool const has_lists = render.node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN;
+      KMTC_Blob const command_blobs[] = {
+         {&encoded_commands, has_lists ? uint32_t(sizeof(encoded_commands)) : 0},
+         {encoded_command_buffer.data(), uint32_t(command_size)},
+      };
+      uint32_t const size = CAPT_SerializeRender(encoded_event, *event, view, command_blobs, 2);
+      if (std::fwrite(encoded_event.data(), 1, size, file) != size) {
+         return false;
+      }
+   }
+   return KMTC_ReaderIsAtEnd(&reader);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../Catanalyst/KMTCapture.h"
+#include "CaptureCommands.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Compression of the command buffers of captures with PM4Z. The submissions of every context are
+// encoded with their own model, in the order of the file, and decoded the same way when they're
+// resolved by CAPT_ResolveCommandBuffer.
+
+// Reads the capture in any layout from the beginning of the events, writing it with
+// KMTC_COMMAND_ENCODING_PM4Z and without the chunk events to the file one event at a time.
+// Returns false if the capture is not read completely, with the events before the truncated or
+// malformed data written, or if writing fails.
+bool CAPT_EncodeCapture(KMTC_Reader & reader, CAPT_CommandBuffers & commands, std::FILE * file);
@@ -0,0 +1,164 @@
+#include "IndirectBuffers.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+void CAPT_AddAllocationData(CAPT_IndirectBuffers & indirect_buffers,
+                            KMTC_EventHeader const & event) {
+   KMTC_AllocationData const * allocation_data;
+   void const * data;
+   if (!KMTC_ParseAllocationData(&event, &allocation_data, &data)) {
+      return;
+   }
+   CAPT_IndirectBufferData contents;
+   // Blobs are aligned to KMTC_ALIGNMENT.
+   contents.dwords = static_cast<uint32_t const *>(data);
+   contents.dword_count = allocation_data->size / sizeof(uint32_t);
+   contents.gpu_virtual_address = allocation_data->gpu_virtual_address;
+   contents.hash = allocation_data->hash;
+   indirect_buffers.ranges[(uint64_t(allocation_data->allocation) << 32) |
+                           allocation_data->offset] = contents;
+   if (contents.gpu_virtual_address) {
+      indirect_buffers.addresses[contents.gpu_virtual_address] = contents;
+   }
+}
+
+// Finds the captured contents containing the beginning of the indirect buffer executed from
+// another one.
+static bool CAPT_FindIndirectBufferByAddress(CAPT_IndirectBuffers const & indirect_buffers,
+                                             PM4P_IndirectBuffer const & indirect_buffer,
+                                             CAPT_IndirectBufferReference & reference) {
+   auto iterator = indirect_buffers.addresses.upper_bound(indirect_buffer.address);
+   if (iterator == indirect_buffers.addresses.begin()) {
+      return false;
+   }
+   --iterator;
+   CAPT_IndirectBufferData const & contents = iterator->second;
+   uint64_t const dword_offset = (indirect_buffer.address - iterator->first) / sizeof(uint32_t);
+   if (dword_offset >= contents.dword_count) {
+      return false;
+   }
+   reference.dwords = contents.dwords + dword_offset;
+   reference.dword_count =
+      std::min(indirect_buffer.dword_count, contents.dword_count - uint32_t(dword_offset));
+   reference.hash = dword_offset == 0 && reference.dword_count == contents.dword_count
+                       ? contents.hash
+                       : KMTC_Hash(reference.dwords, sizeof(uint32_t) * reference.dword_count);
+   return true;
+}
+
+static std::vector<CAPT_IndirectBufferChild> const & CAPT_GetIndirectBufferChildren(
+   CAPT_IndirectBuffers & indirect_buffers, CAPT_IndirectBufferReference const & reference) {
+   auto const emplaced =
+      indirect_buffers.children.emplace(reference.hash, std::vector<CAPT_IndirectBufferChild>());
+   std::vector<CAPT_IndirectBufferChild> & children = emplaced.first->second;
+   if (!emplaced.second) {
+      return children;
+   }
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, reference.dwords, reference.dword_count);
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+         CAPT_IndirectBufferChild child;
+         if (PM4P_GetIndirectBuffer(&packets[packet_index], &child.indirect_buffer)) {
+            child.packet_offset = packets[packet_index].offset;
+            children.push_back(child);
+         }
+      }
+   }
+   return children;
+}
+
+// Appends the reference, and the references made from it if its contents are printed with it.
+// The ancestors are the hashes of the contents of the references that it's made from.
+static void CAPT_AddIndirectBufferReference(
+   CAPT_IndirectBuffers & indirect_buffers, CAPT_IndirectBufferReference reference,
+   std::vector<uint64_t> & ancestors, std::vector<CAPT_IndirectBufferReference> & references) {
+   if (!reference.dwords) {
+      reference.status = CAPT_INDIRECT_BUFFER_NOT_CAPTURED;
+   } else if (std::find(ancestors.begin(), ancestors.end(), reference.hash) != ancestors.end()) {
+      reference.status = CAPT_INDIRECT_BUFFER_CYCLE;
+   } else if (ancestors.size() >= CAPT_INDIRECT_BUFFER_MAX_DEPTH) {
+      reference.status = CAPT_INDIRECT_BUFFER_TOO_DEEP;
+   } else if (!indirect_buffers.printed_hashes.insert(reference.hash).second) {
+      reference.status = CAPT_INDIRECT_BUFFER_REPEATED;
+   } else {
+      reference.status = CAPT_INDIRECT_BUFFER_FIRST;
+   }
+   uint32_t const reference_index = uint32_t(references.size());
+   references.push_back(reference);
+   if (reference.status != CAPT_INDIRECT_BUFFER_FIRST) {
+      return;
+   }
+   // Elements of unordered_map stay in place when others are added during the recursion.
+   std::vector<CAPT_IndirectBufferChild> const & children =
+      CAPT_GetIndirectBufferChildren(indirect_buffers, reference);
+   ancestors.push_back(reference.hash);
+   for (CAPT_IndirectBufferChild const & child : children) {
+      CAPT_IndirectBufferReference child_reference = {};
+      child_reference.indirect_buffer = child.indirect_buffer;
+      child_reference.packet_offset = child.packet_offset;
+      child_reference.parent_index = reference_index;
+      CAPT_FindIndirectBufferByAddress(indirect_buffers, child.indirect_buffer, child_reference);
+      CAPT_AddIndirectBufferReference(indirect_buffers, child_reference, ancestors, references);
+   }
+   ancestors.pop_back();
+}
+
+void CAPT_ResolveIndirectBuffers(CAPT_IndirectBuffers & indirect_buffers,
+                                 KMTC_RenderView const & view, PM4P_Patch const * const patches,
+                                 uint32_t const patch_count,
+                                 std::vector<CAPT_IndirectBufferReference> & references) {
+   KMTC_Render const & render = *view.render;
+   uint32_t const reference_begin = uint32_t(references.size());
+   std::vector<uint64_t> ancestors;
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, view.command_buffer, render.command_length / sizeof(uint32_t));
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+         PM4P_Packet const & packet = packets[packet_index];
+         CAPT_IndirectBufferReference reference = {};
+         if (!PM4P_GetIndirectBuffer(&packet, &reference.indirect_buffer)) {
+            continue;
+         }
+         reference.packet_offset = packet.offset;
+         reference.parent_index = UINT32_MAX;
+         // IB_BASE_LO is patched with the address of the allocation.
+         PM4P_PatchCursor patch_cursor;
+         PM4P_PatchCursorInit(&patch_cursor, patches, patch_count, packet.offset + 1);
+         PM4P_Patch const * const patch = patch_cursor.patch_index < patch_count
+                                             ? &patches[patch_cursor.patch_index]
+                                             : nullptr;
+         if (patch && patch->offset == packet.offset + 1) {
+            auto const contents = indirect_buffers.ranges.find(
+               (uint64_t(patch->allocation) << 32) | patch->allocation_offset);
+            if (contents != indirect_buffers.ranges.end()) {
+               reference.dwords = contents->second.dwords;
+               reference.dword_count =
+                  std::min(reference.indirect_buffer.dword_count, contents->second.dword_count);
+               reference.hash = reference.dword_count == contents->second.dword_count
+                                   ? contents->second.hash
+                                   : KMTC_Hash(reference.dwords,
+                                               sizeof(uint32_t) * reference.dword_count);
+            }
+         }
+         CAPT_AddIndirectBufferReference(indirect_buffers, reference, ancestors, references);
+      }
+   }
+   // The parent indices are relative to the references of the submission.
+   for (uint32_t reference_index = reference_begin; reference_index < references.size();
+        ++reference_index) {
+      CAPT_IndirectBufferReference & reference = references[reference_index];
+      if (reference.parent_index != UINT32_MAX) {
+         reference.parent_index -= reference_begin;
+      }
+   }
+}
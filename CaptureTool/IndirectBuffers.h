@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Resolution of the indirect buffer packets of the graphics command buffers to the contents of the
+// allocations captured as KMTC_EVENT_ALLOCATION_DATA, following the indirect buffers executed from
+// them recursively.
+
+// The depth of the indirect buffers executed from the command buffer of the submission.
+static constexpr uint32_t CAPT_INDIRECT_BUFFER_MAX_DEPTH = 4;
+
+enum CAPT_IndirectBufferStatus : uint8_t {
+   // The contents are printed with the reference, followed by the references they make.
+   CAPT_INDIRECT_BUFFER_FIRST,
+   // The same contents were printed with an earlier reference.
+   CAPT_INDIRECT_BUFFER_REPEATED,
+   CAPT_INDIRECT_BUFFER_NOT_CAPTURED,
+   // The contents are those of an indirect buffer that the reference is made from.
+   CAPT_INDIRECT_BUFFER_CYCLE,
+   // Deeper than CAPT_INDIRECT_BUFFER_MAX_DEPTH.
+   CAPT_INDIRECT_BUFFER_TOO_DEEP,
+};
+
+struct CAPT_IndirectBufferReference {
+   PM4P_IndirectBuffer indirect_buffer;
+   // Of the packet, in dwords from the beginning of the buffer containing it.
+   uint32_t packet_offset;
+   // The index of the reference that the packet is in among the references of the submission, or
+   // UINT32_MAX if it's in the command buffer of the submission.
+   uint32_t parent_index;
+   // The contents, up to the size of the indirect buffer, or null if not captured.
+   uint32_t const * dwords;
+   uint32_t dword_count;
+   uint64_t hash;
+   CAPT_IndirectBufferStatus status;
+};
+
+struct CAPT_IndirectBufferData {
+   uint32_t const * dwords;
+   uint32_t dword_count;
+   uint64_t gpu_virtual_address;
+   uint64_t hash;
+};
+
+struct CAPT_IndirectBufferChild {
+   PM4P_IndirectBuffer indirect_buffer;
+   uint32_t packet_offset;
+};
+
+struct CAPT_IndirectBuffers {
+   // The latest contents of the ranges, by the allocation in the high and the offset in the low 32
+   // bits.
+   std::unordered_map<uint64_t, CAPT_IndirectBufferData> ranges;
+   // The same by the GPU virtual address, for the indirect buffers executed from others, which are
+   // not patched.
+   std::map<uint64_t, CAPT_IndirectBufferData> addresses;
+   // The indirect buffer packets in the contents with the hash, decoded once for all references.
+   std::unordered_map<uint64_t, std::vector<CAPT_IndirectBufferChild>> children;
+   std::unordered_set<uint64_t> printed_hashes;
+};
+
+// Makes the contents in the event, if it's a well-formed KMTC_EVENT_ALLOCATION_DATA, the latest
+// ones of their range.
+void CAPT_AddAllocationData(CAPT_IndirectBuffers & indirect_buffers,
+                            KMTC_EventHeader const & event);
+// Appends the references made from the command buffer of the submission and recursively from the
+// indirect buffers, in the order they're printed, with every reference followed by the ones made
+// from it if its contents are printed with it. The patches are those from CAPT_IndexPatches.
+void CAPT_ResolveIndirectBuffers(CAPT_IndirectBuffers & indirect_buffers,
+                                 KMTC_RenderView const & view, PM4P_Patch const * patches,
+                                 uint32_t patch_count,
+                                 std::vector<CAPT_IndirectBufferReference> & references);
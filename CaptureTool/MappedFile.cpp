@@ -0,0 +1,206 @@
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static std::size_t CAPT_GetPageSize() {
+#ifdef _WIN32
+   SYSTEM_INFO system_info;
+   GetSystemInfo(&system_info);
+   return system_info.dwPageSize;
+#else
+   long const page_size = sysconf(_SC_PAGESIZE);
+   return page_size > 0 ? std::size_t(page_size) : 4096;
+#endif
+}
+
+// Returns false if the range doesn't contain any whole pages.
+static bool CAPT_GetMappedPages(CAPT_MappedFile const & mapped, std::size_t const offset,
+                                std::size_t const size, uintptr_t & begin_out,
+                                std::size_t & size_out) {
+   if (offset >= mapped.size || !size) {
+      return false;
+   }
+   std::size_t const end = mapped.size - offset > size ? offset + size : mapped.size;
+   std::size_t const page_size = CAPT_GetPageSize();
+   uintptr_t const data = uintptr_t(mapped.data);
+   uintptr_t const begin_page = (data + offset + (page_size - 1)) & ~uintptr_t(page_size - 1);
+   // The last page may be partial only at the end of the file.
+   uintptr_t const end_page =
+      end == mapped.size ? data + end : (data + end) & ~uintptr_t(page_size - 1);
+   if (end_page <= begin_page) {
+      return false;
+   }
+   begin_out = begin_page;
+   size_out = std::size_t(end_page - begin_page);
+   return true;
+}
+
+#ifdef _WIN32
+
+bool CAPT_MapFile(char const * const path, CAPT_MappedAccess const access,
+                  CAPT_MappedFile & mapped) {
+   mapped.data = nullptr;
+   mapped.size = 0;
+   mapped.file_handle = INVALID_HANDLE_VALUE;
+   mapped.mapping_handle = nullptr;
+   // The access pattern can only be specified for the whole file on Windows.
+   HANDLE const file_handle = CreateFileA(
+      path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      access == CAPT_MAPPED_ACCESS_SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS,
+      nullptr);
+   if (file_handle == INVALID_HANDLE_VALUE) {
+      std::fprintf(stderr, "Failed to open %s.\n", path);
+      return false;
+   }
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(file_handle, &size) || uint64_t(size.QuadPart) > SIZE_MAX) {
+      std::fprintf(stderr, "Failed to get the size of %s.\n", path);
+      CloseHandle(file_handle);
+      return false;
+   }
+   mapped.file_handle = file_handle;
+   if (!size.QuadPart) {
+      return true;
+   }
+   HANDLE const mapping_handle =
+      CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   void const * const data =
+      mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+   if (!data) {
+      std::fprintf(stderr, "Failed to map %s.\n", path);
+      if (mapping_handle) {
+         CloseHandle(mapping_handle);
+      }
+      CloseHandle(file_handle);
+      mapped.file_handle = INVALID_HANDLE_VALUE;
+      return false;
+   }
+   mapped.data = data;
+   mapped.size = std::size_t(size.QuadPart);
+   mapped.mapping_handle = mapping_handle;
+   return true;
+}
+
+void CAPT_UnmapFile(CAPT_MappedFile & mapped) {
+   if (mapped.data) {
+      UnmapViewOfFile(mapped.data);
+   }
+   if (mapped.mapping_handle) {
+      CloseHandle(mapped.mapping_handle);
+   }
+   if (mapped.file_handle != INVALID_HANDLE_VALUE) {
+      CloseHandle(mapped.file_handle);
+   }
+   mapped.data = nullptr;
+   mapped.size = 0;
+   mapped.file_handle = INVALID_HANDLE_VALUE;
+   mapped.mapping_handle = nullptr;
+}
+
+void CAPT_AdviseMappedRange(CAPT_MappedFile const & mapped, std::size_t const offset,
+                            std::size_t const size, CAPT_MappedAccess const access) {
+   // Prefetch the range if it's about to be read sequentially.
+   uintptr_t begin;
+   std::size_t range_size;
+   if (access != CAPT_MAPPED_ACCESS_SEQUENTIAL ||
+       !CAPT_GetMappedPages(mapped, offset, size, begin, range_size)) {
+      return;
+   }
+   WIN32_MEMORY_RANGE_ENTRY range;
+   range.VirtualAddress = reinterpret_cast<void *>(begin);
+   range.NumberOfBytes = range_size;
+   PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void CAPT_ReleaseMappedRange(CAPT_MappedFile const & mapped, std::size_t const offset,
+                             std::size_t const size) {
+   uintptr_t begin;
+   std::size_t range_size;
+   if (CAPT_GetMappedPages(mapped, offset, size, begin, range_size)) {
+      // Unlocking pages that are not locked removes them from the working set.
+      VirtualUnlock(reinterpret_cast<void *>(begin), range_size);
+   }
+}
+
+#else
+
+static int CAPT_GetAdvice(CAPT_MappedAccess const access) {
+   return access == CAPT_MAPPED_ACCESS_SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM;
+}
+
+bool CAPT_MapFile(char const * const path, CAPT_MappedAccess const access,
+                  CAPT_MappedFile & mapped) {
+   mapped.data = nullptr;
+   mapped.size = 0;
+   int const fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      std::fprintf(stderr, "Failed to open %s.\n", path);
+      return false;
+   }
+   struct stat status;
+   if (fstat(fd, &status) || status.st_size < 0 || uint64_t(status.st_size) > SIZE_MAX) {
+      std::fprintf(stderr, "Failed to get the size of %s.\n", path);
+      close(fd);
+      return false;
+   }
+   if (!status.st_size) {
+      close(fd);
+      return true;
+   }
+   std::size_t const size = std::size_t(status.st_size);
+   void * const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   // The mapping keeps the file referenced.
+   close(fd);
+   if (data == MAP_FAILED) {
+      std::fprintf(stderr, "Failed to map %s.\n", path);
+      return false;
+   }
+   madvise(data, size, CAPT_GetAdvice(access));
+   mapped.data = data;
+   mapped.size = size;
+   return true;
+}
+
+void CAPT_UnmapFile(CAPT_MappedFile & mapped) {
+   if (mapped.data) {
+      munmap(const_cast<void *>(mapped.data), mapped.size);
+   }
+   mapped.data = nullptr;
+   mapped.size = 0;
+}
+
+void CAPT_AdviseMappedRange(CAPT_MappedFile const & mapped, std::size_t const offset,
+                            std::size_t const size, CAPT_MappedAccess const access) {
+   uintptr_t begin;
+   std::size_t range_size;
+   if (CAPT_GetMappedPages(mapped, offset, size, begin, range_size)) {
+      madvise(reinterpret_cast<void *>(begin), range_size, CAPT_GetAdvice(access));
+   }
+}
+
+void CAPT_ReleaseMappedRange(CAPT_MappedFile const & mapped, std::size_t const offset,
+                             std::size_t const size) {
+   uintptr_t begin;
+   std::size_t range_size;
+   if (CAPT_GetMappedPages(mapped, offset, size, begin, range_size)) {
+      // The mapping is read-only, so the pages are only dropped from the page tables and read
+      // again from the file if needed.
+      madvise(reinterpret_cast<void *>(begin), range_size, MADV_DONTNEED);
+   }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory mapping of a whole file, for reading captures and dumps of any size without
+// loading them: the data is paged in when it's accessed, and pointers into the mapping can be used
+// directly instead of copies.
+
+enum CAPT_MappedAccess {
+   // Read ahead aggressively, and drop pages behind the reading position.
+   CAPT_MAPPED_ACCESS_SEQUENTIAL,
+   // Only read the pages that are accessed.
+   CAPT_MAPPED_ACCESS_RANDOM,
+};
+
+struct CAPT_MappedFile {
+   void const * data;
+   std::size_t size;
+#ifdef _WIN32
+   void * file_handle;
+   void * mapping_handle;
+#endif
+};
+
+// Prints the error and returns false if the file can't be mapped. Empty files are mapped with null
+// data.
+bool CAPT_MapFile(char const * path, CAPT_MappedAccess access, CAPT_MappedFile & mapped);
+void CAPT_UnmapFile(CAPT_MappedFile & mapped);
+// Changes the expected access pattern of a range of the file.
+void CAPT_AdviseMappedRange(CAPT_MappedFile const & mapped, std::size_t offset, std::size_t size,
+                            CAPT_MappedAccess access);
+// Tells that a range of the file won't be accessed soon, so the pages fully in it can be removed
+// from the memory of the process, keeping the resident size bounded when going through a large
+// file. Accessing the range later reads the pages again.
+void CAPT_ReleaseMappedRange(CAPT_MappedFile const & mapped, std::size_t offset,
+                             std::size_t size);
@@ -0,0 +1,140 @@
+#include "OrderedOutput.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The number of jobs that may be rendered ahead of the output per thread, to keep the threads busy
+// while a long job is blocking the output.
+static constexpr unsigned CAPT_ORDERED_SLOTS_PER_THREAD = 4;
+
+namespace {
+
+struct CAPT_OrderedSlot {
+   TXTW_Writer text;
+   bool done;
+   bool succeeded;
+};
+
+struct CAPT_OrderedState {
+   CAPT_OrderedJobFunction function;
+   void * context;
+   std::size_t job_count;
+   std::mutex mutex;
+   // Signaled when the slot of the next job to write is done.
+   std::condition_variable done_condition;
+   // Signaled when a slot is freed by writing its text, or when stopping.
+   std::condition_variable free_condition;
+   std::vector<CAPT_OrderedSlot> slots;
+   std::size_t next_job_index;
+   std::size_t written_job_count;
+   bool stopping;
+};
+
+} // namespace
+
+static void CAPT_RunOrderedWorker(CAPT_OrderedState & state) {
+   std::size_t const slot_count = state.slots.size();
+   std::unique_lock<std::mutex> lock(state.mutex);
+   for (;;) {
+      // The slot of a job is reused only after the job slot_count before it has been written.
+      while (!state.stopping && state.next_job_index < state.job_count &&
+             state.next_job_index >= state.written_job_count + slot_count) {
+         state.free_condition.wait(lock);
+      }
+      if (state.stopping || state.next_job_index >= state.job_count) {
+         return;
+      }
+      std::size_t const job_index = state.next_job_index++;
+      CAPT_OrderedSlot & slot = state.slots[job_index % slot_count];
+      lock.unlock();
+      slot.text.size = 0;
+      slot.text.failed = false;
+      bool const succeeded = state.function(state.context, job_index, &slot.text);
+      lock.lock();
+      slot.done = true;
+      // Running out of memory for the text is a failure of the job too.
+      slot.succeeded = succeeded && !slot.text.failed;
+      if (job_index == state.written_job_count) {
+         state.done_condition.notify_one();
+      }
+   }
+}
+
+std::size_t CAPT_RunOrdered(std::size_t const job_count, unsigned const thread_count,
+                            CAPT_OrderedJobFunction const function, void * const context,
+                            TXTW_Writer * const output) {
+   if (thread_count <= 1) {
+      TXTW_Writer text;
+      TXTW_InitGrowable(&text, nullptr, 0);
+      std::size_t job_index = 0;
+      for (; job_index < job_count; ++job_index) {
+         text.size = 0;
+         if (!function(context, job_index, &text) || text.failed) {
+            break;
+         }
+         TXTW_PutData(output, text.data, text.size);
+      }
+      TXTW_Destroy(&text);
+      return job_index;
+   }
+
+   auto const state = std::make_unique<CAPT_OrderedState>();
+   state->function = function;
+   state->context = context;
+   state->job_count = job_count;
+   state->slots.resize(std::size_t(CAPT_ORDERED_SLOTS_PER_THREAD) * thread_count);
+   for (CAPT_OrderedSlot & slot : state->slots) {
+      TXTW_InitGrowable(&slot.text, nullptr, 0);
+      slot.done = false;
+      slot.succeeded = false;
+   }
+   state->next_job_index = 0;
+   state->written_job_count = 0;
+   state->stopping = false;
+
+   std::vector<std::thread> threads;
+   threads.reserve(thread_count);
+   for (unsigned thread_index = 0; thread_index < thread_count; ++thread_index) {
+      threads.emplace_back(CAPT_RunOrderedWorker, std::ref(*state));
+   }
+
+   std::size_t const slot_count = state->slots.size();
+   std::size_t job_index = 0;
+   for (; job_index < job_count; ++job_index) {
+      CAPT_OrderedSlot & slot = state->slots[job_index % slot_count];
+      {
+         std::unique_lock<std::mutex> lock(state->mutex);
+         while (!slot.done) {
+            state->done_condition.wait(lock);
+         }
+      }
+      if (!slot.succeeded) {
+         break;
+      }
+      // The slot is not touched by the workers until it's freed.
+      TXTW_PutData(output, slot.text.data, slot.text.size);
+      {
+         std::lock_guard<std::mutex> lock(state->mutex);
+         slot.done = false;
+         ++state->written_job_count;
+      }
+      state->free_condition.notify_all();
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->stopping = true;
+   }
+   state->free_condition.notify_all();
+   for (std::thread & thread : threads) {
+      thread.join();
+   }
+   for (CAPT_OrderedSlot & slot : state->slots) {
+      TXTW_Destroy(&slot.text);
+   }
+   return job_index;
+}
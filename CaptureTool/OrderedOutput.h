@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../Catanalyst/TextWriter.h"
+
+#include <cstddef>
+
+// Running of jobs producing text on a pool of threads, with the text written in the order of the
+// jobs regardless of the order they finish in, so the output is the same as when running them
+// serially.
+
+// Renders the text of the job into the writer, which is growable and empty. Returns false if the
+// job has failed, which stops the output before its text.
+typedef bool (*CAPT_OrderedJobFunction)(void * context, std::size_t job_index,
+                                        TXTW_Writer * text);
+
+// Runs the jobs on the specified number of threads (serially on the calling thread if it's 1 or
+// less), writing their text to the output. Only a limited number of jobs is rendered ahead of the
+// output, so memory usage is bounded by the size of the text of the largest jobs. Returns the
+// index of the first failed job, or job_count if all of them have succeeded.
+std::size_t CAPT_RunOrdered(std::size_t job_count, unsigned thread_count,
+                            CAPT_OrderedJobFunction function, void * context,
+                            TXTW_Writer * output);
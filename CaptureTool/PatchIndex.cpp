@@ -0,0 +1,36 @@
+#include "PatchIndex.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+void CAPT_IndexPatches(KMTC_RenderView const & view, std::vector<PM4P_Patch> & patches) {
+   KMTC_Render const & render = *view.render;
+   if (render.node_ordinal == KMTC_NODE_ORDINAL_UNKNOWN) {
+      return;
+   }
+   std::size_t const patch_begin = patches.size();
+   uint32_t const dword_count = render.command_length / sizeof(uint32_t);
+   for (uint32_t patch_location_index = 0; patch_location_index < render.patch_location_count;
+        ++patch_location_index) {
+      KMTC_PatchLocation const & patch_location = view.patch_location_list[patch_location_index];
+      // Unsigned, so offsets before the submitted part wrap to the end.
+      uint32_t const offset =
+         (patch_location.patch_offset - render.command_offset) / sizeof(uint32_t);
+      if (offset >= dword_count || patch_location.allocation_index >= render.allocation_count) {
+         continue;
+      }
+      PM4P_Patch patch;
+      patch.offset = offset;
+      patch.allocation_index = patch_location.allocation_index;
+      patch.allocation = view.allocation_list[patch_location.allocation_index].allocation;
+      patch.allocation_offset = patch_location.allocation_offset;
+      patch.slot_id = patch_location.slot_id;
+      patch.patch_location_index = patch_location_index;
+      patches.push_back(patch);
+   }
+   // Stable, so the patches of the same dword are in the order of the list.
+   std::stable_sort(patches.begin() + std::ptrdiff_t(patch_begin), patches.end(),
+                    [](PM4P_Patch const & a, PM4P_Patch const & b) { return a.offset < b.offset; });
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../Catanalyst/Catanalyst.h"
+#include "../Catanalyst/KMTCapture.h"
+
+#include <vector>
+
+// Appends the patch locations of the submission that are in its command buffer, sorted by the
+// patched dword, for looking them up while going through the command buffer. The patch offsets
+// are relative to the whole command buffer rather than the submitted part, and the entries with
+// an allocation index out of the allocation list are skipped.
+void CAPT_IndexPatches(KMTC_RenderView const & view, std::vector<PM4P_Patch> & patches);
@@ -1,13 +1,469 @@
 #pragma once
 
+#include "TextWriter.h"
+
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void PM4P_Print(uint32_t const * pm4, uint32_t pm4_dword_count, bool is_r9xx);
+// Decoding of PM4 command buffers into packet descriptors that analyses can walk without
+// re-parsing the dwords, with printing being one of the consumers.
+
+// Header and the largest body (count + 1 dwords with the 14-bit count).
+#define PM4P_MAX_PACKET_DWORDS (1 + 0x3FFF + 1)
+
+typedef struct PM4P_Packet {
+   // The header followed by the body. Points into the decoded buffer, or into the stream decoder
+   // for packets split between chunks.
+   uint32_t const * dwords;
+   // Of the header, in dwords from the beginning of the buffer or the stream (wrapping after
+   // 4 Gi dwords).
+   uint32_t offset;
+   uint32_t header;
+   // Dwords following the header that belong to the packet and are available. 0 for type-1 and
+   // type-2 packets, and for type-3 NOPs containing other packets, which are decoded as separate
+   // packets.
+   uint32_t body_dword_count;
+   // For register-setting packets, the dword indices of the register block that the offset in the
+   // packet is relative to, and of the first register written. 0 for other packets, and the first
+   // register is 0 if the body is truncated before the offset.
+   uint32_t register_base;
+   uint32_t register_first;
+   // From the header, for convenience. The opcode is 0 for types other than 3.
+   uint16_t count;
+   uint8_t type;
+   uint8_t opcode;
+   // The buffer or the stream ended before the end of the body specified by the header.
+   bool truncated;
+} PM4P_Packet;
+
+typedef struct PM4P_Decoder {
+   uint32_t const * pm4;
+   uint32_t pm4_dword_count;
+   uint32_t dword_index;
+   bool follows_packet2;
+} PM4P_Decoder;
+
+void PM4P_DecoderInit(PM4P_Decoder * decoder, uint32_t const * pm4, uint32_t pm4_dword_count);
+// Decodes up to packet_capacity packets, continuing from the previous call. Returns the number of
+// packets written, 0 when the end of the buffer has been reached. A packet extending past the end
+// of the buffer is returned truncated.
+uint32_t PM4P_Decode(PM4P_Decoder * decoder, PM4P_Packet * packets, uint32_t packet_capacity);
+// Skips whole packets like PM4P_Decode without describing them, until at least min_dword_count
+// dwords have been passed or the end of the buffer has been reached, for finding packet boundaries
+// quickly. Returns the number of packets skipped.
+uint32_t PM4P_Skip(PM4P_Decoder * decoder, uint32_t min_dword_count);
+
+// Instruction sets that the decoders may use for scanning runs of type-2 filler in bulk. The
+// results are the same with all of them.
+typedef enum PM4P_SIMD {
+   PM4P_SIMD_SCALAR,
+   PM4P_SIMD_SSE2,
+   PM4P_SIMD_AVX2,
+} PM4P_SIMD;
+
+// The widest supported by the CPU, used by default.
+PM4P_SIMD PM4P_GetSupportedSIMD(void);
+// Limits the instruction sets used, for comparing them. Clamped to the supported ones.
+void PM4P_SetSIMD(PM4P_SIMD simd);
+// The instruction set used, the supported one unless limited.
+PM4P_SIMD PM4P_GetSIMD(void);
+
+// Decoding of a stream arriving in chunks of any size, such as from a pipe or a file read
+// piecewise. A packet split between chunks is copied to the decoder and returned once it's
+// complete, so the memory use is bounded by the largest packet.
+typedef struct PM4P_StreamDecoder {
+   uint32_t const * chunk;
+   uint32_t chunk_dword_count;
+   uint32_t chunk_dword_index;
+   // Stream offset of the beginning of the chunk.
+   uint32_t chunk_offset;
+   bool follows_packet2;
+   // The packet split between chunks, decoded from the header, with carry_dword_count of its
+   // carry_needed_dword_count dwords received.
+   PM4P_Packet carry_packet;
+   uint32_t carry_dword_count;
+   uint32_t carry_needed_dword_count;
+   uint32_t carry[PM4P_MAX_PACKET_DWORDS];
+} PM4P_StreamDecoder;
+
+void PM4P_StreamDecoderInit(PM4P_StreamDecoder * decoder);
+// Provides the next chunk, after PM4P_StreamDecode has returned 0 for the previous one. The chunk
+// must stay valid until then.
+void PM4P_StreamDecoderPush(PM4P_StreamDecoder * decoder, uint32_t const * dwords,
+                            uint32_t dword_count);
+// Decodes up to packet_capacity packets complete in the chunks pushed so far. Returns 0 when more
+// data is needed. The packets are valid until the next call to a function of the decoder.
+uint32_t PM4P_StreamDecode(PM4P_StreamDecoder * decoder, PM4P_Packet * packets,
+                           uint32_t packet_capacity);
+// At the end of the stream, after PM4P_StreamDecode has returned 0, returns the packet cut off
+// by the end, truncated. Returns whether there was one.
+bool PM4P_StreamDecoderFinish(PM4P_StreamDecoder * decoder, PM4P_Packet * packet);
+
+// The command buffer that a PKT3_INDIRECT_BUFFER or a PKT3_INDIRECT_BUFFER_MP packet makes the
+// command processor execute before continuing after the packet.
+typedef struct PM4P_IndirectBuffer {
+   // 40-bit GPU address, aligned to 4 bytes.
+   uint64_t address;
+   uint32_t dword_count;
+} PM4P_IndirectBuffer;
+
+// Returns false if the packet is not an indirect buffer packet or is truncated before the size.
+bool PM4P_GetIndirectBuffer(PM4P_Packet const * packet, PM4P_IndirectBuffer * indirect_buffer);
+
+// The packets writing the registers.
+typedef enum PM4P_RegisterBlock {
+   PM4P_REGISTER_BLOCK_CONFIG,
+   PM4P_REGISTER_BLOCK_CONTEXT,
+   PM4P_REGISTER_BLOCK_RESOURCE,
+   PM4P_REGISTER_BLOCK_SAMPLER,
+   PM4P_REGISTER_BLOCK_LOOP_CONST,
+   PM4P_REGISTER_BLOCK_CTL_CONST,
+   // Not written by the register-setting packets.
+   PM4P_REGISTER_BLOCK_OTHER,
+} PM4P_RegisterBlock;
+
+// The value of the field is (register value >> shift) & mask.
+typedef struct PM4P_RegisterField {
+   char const * name;
+   uint32_t mask;
+   uint32_t shift;
+} PM4P_RegisterField;
+
+typedef struct PM4P_Register {
+   // In dwords.
+   uint32_t index;
+   char const * name;
+   // From the lowest bits, shared between the registers with the same layout.
+   PM4P_RegisterField const * fields;
+   uint32_t field_count;
+   PM4P_RegisterBlock block;
+} PM4P_Register;
+
+// The register database is generated at compile time from the description in PM4Registers.inl.
+// Registers common to multiple families are stored once, and a family is a table of pointers to
+// them, so looking up in any family is the same search in a different table. The registers in the
+// blocks of the register-setting packets, where most of them are, are also indexed directly.
+typedef struct PM4P_Family {
+   char const * name;
+   // The indices of the registers, for searching without going through the pointers.
+   uint32_t const * register_indices;
+   // Sorted by the index, without duplicates.
+   PM4P_Register const * const * registers;
+   uint32_t register_count;
+   // By the shadow index (see PM4S_GetShadowIndex), the position of the register plus 1, or 0 if
+   // the family has no register there.
+   uint16_t const * shadow_positions;
+} PM4P_Family;
+
+typedef enum PM4P_FamilyId {
+   PM4P_FAMILY_R600,
+   PM4P_FAMILY_R700,
+   PM4P_FAMILY_EVERGREEN,
+   PM4P_FAMILY_CAYMAN,
+   PM4P_FAMILY_COUNT,
+} PM4P_FamilyId;
+
+PM4P_Family const * PM4P_GetFamily(PM4P_FamilyId family_id);
+// Returns NULL if the name is not r600, r700, evergreen or cayman.
+PM4P_Family const * PM4P_FindFamily(char const * name);
+// Returns the position of the first register of the family with an index not below the specified
+// one, or the register count, for walking the registers in order from there.
+uint32_t PM4P_FindRegisterLowerBound(PM4P_Family const * family, uint32_t index_dwords);
+// Returns NULL if the register is unknown in the family.
+PM4P_Register const * PM4P_FindRegister(PM4P_Family const * family, uint32_t index_dwords);
+// Returns NULL if the register is unknown in the family.
+char const * PM4P_GetRegisterName(uint32_t index_dwords, PM4P_Family const * family);
+
+// NULL if the opcode is unknown.
+char const * PM4P_GetPacket3OpcodeName(uint32_t opcode);
+
+// Shadow of the register state set by the register-setting packets, updated incrementally as the
+// packets are decoded, for telling what's bound at every draw and dispatch without going through
+// everything before it again.
+//
+// The registers of the blocks that the packets write are stored in a dense file, with the blocks
+// one after another, addressed by the shadow index. Writes outside the blocks are not tracked.
+
+// 0x8000-0xAFFF.
+#define PM4S_CONFIG_REGISTER_COUNT (0x3000 / 4)
+// 0x28000-0x28FFF.
+#define PM4S_CONTEXT_REGISTER_COUNT (0x1000 / 4)
+// 0x3CFF0-0x3DFFF.
+#define PM4S_CTL_CONST_REGISTER_COUNT (0x1010 / 4)
+#define PM4S_REGISTER_COUNT \
+   (PM4S_CONFIG_REGISTER_COUNT + PM4S_CONTEXT_REGISTER_COUNT + PM4S_CTL_CONST_REGISTER_COUNT)
+#define PM4S_BITSET_WORD_COUNT ((PM4S_REGISTER_COUNT + 63) / 64)
+
+typedef struct PM4S_State {
+   uint32_t values[PM4S_REGISTER_COUNT];
+   // Registers written at least once, the values of the rest are 0 and unknown.
+   uint64_t written[PM4S_BITSET_WORD_COUNT];
+} PM4S_State;
+
+typedef struct PM4S_Shadow {
+   PM4S_State state;
+   // Registers written since the last delta was taken, even if the value hasn't changed.
+   uint64_t dirty[PM4S_BITSET_WORD_COUNT];
+   uint32_t untracked_write_count;
+} PM4S_Shadow;
+
+typedef struct PM4S_RegisterWrite {
+   // Dword index of the register.
+   uint32_t index;
+   uint32_t value;
+} PM4S_RegisterWrite;
+
+// Returns PM4S_REGISTER_COUNT if the register is not in the tracked blocks.
+uint32_t PM4S_GetShadowIndex(uint32_t index_dwords);
+uint32_t PM4S_GetRegisterIndex(uint32_t shadow_index);
+// Whether the packet is a draw or a dispatch, using the registers at that point.
+bool PM4S_IsDrawOrDispatch(PM4P_Packet const * packet);
+
+// Returns the number of the values written by the packet to the registers in the tracked blocks,
+// with the shadow index of the first one written to first_shadow_index_out, or 0 if it's not a
+// register-setting packet.
+uint32_t PM4S_GetPacketShadowRange(PM4P_Packet const * packet, uint32_t * first_shadow_index_out);
+
+// Initially nothing is written or dirty.
+void PM4S_ShadowInit(PM4S_Shadow * shadow);
+// Applies the register writes of the packet if it's a register-setting packet.
+void PM4S_ShadowApply(PM4S_Shadow * shadow, PM4P_Packet const * packet);
+// Writes the registers written since the previous call in the order of the indices, up to
+// PM4S_REGISTER_COUNT, and clears the dirty state. Returns the number of writes.
+uint32_t PM4S_ShadowTakeDelta(PM4S_Shadow * shadow, PM4S_RegisterWrite * writes);
+
+// Detection of register writes that don't change the value, the same as the one already written
+// to the register, which the command processor has to go through for nothing.
+
+typedef struct PM4S_RedundancyCounts {
+   uint64_t packet_count;
+   // Packets writing only redundant values.
+   uint64_t redundant_packet_count;
+   uint64_t write_count;
+   uint64_t redundant_write_count;
+   // Dwords that could be removed: the redundant values, and also the header and the offset of
+   // the packets writing only redundant values.
+   uint64_t wasted_dword_count;
+} PM4S_RedundancyCounts;
+
+typedef struct PM4S_Redundancy {
+   PM4S_RedundancyCounts total;
+   PM4S_RedundancyCounts submission;
+   // By the shadow index.
+   uint64_t write_counts[PM4S_REGISTER_COUNT];
+   uint64_t redundant_write_counts[PM4S_REGISTER_COUNT];
+} PM4S_Redundancy;
+
+void PM4S_RedundancyInit(PM4S_Redundancy * redundancy);
+// Clears the counts of the submission.
+void PM4S_RedundancyBeginSubmission(PM4S_Redundancy * redundancy);
+// PM4S_ShadowApply also counting the writes of the values that the registers already have. If
+// redundant_indices is not NULL, it receives the dword indices of the registers written
+// redundantly by the packet, up to one for every dword of the body. Returns their number.
+uint32_t PM4S_ShadowApplyCountingRedundancy(PM4S_Shadow * shadow, PM4S_Redundancy * redundancy,
+                                            PM4P_Packet const * packet,
+                                            uint32_t * redundant_indices);
+
+// Counting of the packets by the type and the opcode, and of the writes by the register, for
+// profiling the contents of captures. Only sums up the decoded packets, for running at the speed of
+// the decoding.
+
+typedef struct PM4H_PacketCounts {
+   uint64_t packet_count;
+   // Including the headers.
+   uint64_t dword_count;
+} PM4H_PacketCounts;
+
+typedef struct PM4H_Histogram {
+   // By the PKT3 opcode.
+   PM4H_PacketCounts opcodes[0x100];
+   // By the type, including type 3.
+   PM4H_PacketCounts types[4];
+   // By the shadow index.
+   uint64_t register_write_counts[PM4S_REGISTER_COUNT];
+   uint64_t untracked_register_write_count;
+} PM4H_Histogram;
+
+void PM4H_HistogramInit(PM4H_Histogram * histogram);
+void PM4H_HistogramAdd(PM4H_Histogram * histogram, PM4P_Packet const * packets,
+                       uint32_t packet_count);
+// Decodes the buffer and adds its packets.
+void PM4H_HistogramAddBuffer(PM4H_Histogram * histogram, uint32_t const * pm4,
+                             uint32_t pm4_dword_count);
+// Adds the counts of one histogram to another, such as of a submission to the total.
+void PM4H_HistogramMerge(PM4H_Histogram * histogram, PM4H_Histogram const * source);
+
+// Selection of packets by their contents, evaluated on batches of decoded packets, so only the
+// matching ones need to be printed. A packet matches if it satisfies all the conditions enabled in
+// the query, and an empty query matches every packet.
+
+typedef struct PM4Q_Query {
+   // Bits by the PKT3 opcode.
+   uint64_t opcodes[4];
+   // Dword indices, inclusive. Register-setting packets writing any of them match.
+   uint32_t register_first;
+   uint32_t register_last;
+   // Register-setting packets writing a value with (value & value_mask) == value_expected match,
+   // only counting the registers in the range if has_registers.
+   uint32_t value_expected;
+   uint32_t value_mask;
+   bool has_opcodes;
+   bool has_registers;
+   bool has_value;
+} PM4Q_Query;
+
+// Initializes an empty query.
+void PM4Q_QueryInit(PM4Q_Query * query);
+void PM4Q_QueryAddOpcode(PM4Q_Query * query, uint32_t opcode);
+// Writes the indices of the matching packets to match_indices, which must have space for
+// packet_count of them. Returns the number of the matching packets.
+uint32_t PM4Q_Match(PM4Q_Query const * query, PM4P_Packet const * packets, uint32_t packet_count,
+                    uint32_t * match_indices);
+// Whether any of the values has (value & mask) == expected.
+bool PM4Q_FindMaskedValue(uint32_t const * values, uint32_t value_count, uint32_t expected,
+                          uint32_t mask);
+
+// Compression of PM4 command buffers for storing captures, modeling the packets rather than the
+// bytes, as the same packets are at different positions in every frame. The encoding is a stream
+// of bytes, with for every packet:
+// - The header as a token: 0 if it's the one that followed the previous header the last time, 1-15
+//   for the position among the recently used headers, or 16 followed by the 4 bytes of the header.
+// - For SET_CONFIG_REG, SET_CONTEXT_REG and SET_CTL_CONST, the offset, and the values as the
+//   zigzag-encoded differences from the previous values of the same registers.
+// - For other bodies, the first dwords as the differences from the same dwords of the previous
+//   packet with the same opcode (or of type 0), and the rest as they are.
+// All numbers are LEB128 varints. The state of the model carries over between the buffers, so the
+// buffers must be decoded in the order they were encoded in, starting with the same state.
+
+#define PM4Z_RECENT_HEADER_COUNT 15
+#define PM4Z_HEADER_CONTEXT_COUNT 4096
+#define PM4Z_BODY_HISTORY_DWORDS 8
+
+typedef struct PM4Z_Model {
+   // By the shadow index, with the last one shared by the registers outside the tracked blocks.
+   uint32_t registers[PM4S_REGISTER_COUNT + 1];
+   // The header that followed the previous one the last time, by the hash of the previous one.
+   uint32_t next_headers[PM4Z_HEADER_CONTEXT_COUNT];
+   // Most recently used first.
+   uint32_t recent_headers[PM4Z_RECENT_HEADER_COUNT];
+   uint32_t previous_header;
+   // The beginning of the body of the last packet by the opcode.
+   uint32_t bodies[0x100][PM4Z_BODY_HISTORY_DWORDS];
+} PM4Z_Model;
+
+void PM4Z_ModelInit(PM4Z_Model * model);
+// The largest size of the encoding of a buffer of the given size.
+size_t PM4Z_GetMaxEncodedSize(uint32_t pm4_dword_count);
+// Returns the size of the encoding written to the destination.
+size_t PM4Z_Encode(PM4Z_Model * model, uint32_t const * pm4, uint32_t pm4_dword_count,
+                   uint8_t * encoded);
+// Decodes a buffer of the given size. Returns false if the encoding is malformed or its size
+// doesn't match, leaving the model and the destination in an undefined state.
+bool PM4Z_Decode(PM4Z_Model * model, uint8_t const * encoded, size_t encoded_size, uint32_t * pm4,
+                 uint32_t pm4_dword_count);
+
+// Snapshots of the state at every draw and dispatch, stored as the deltas between them with a full
+// copy of the state at regular intervals, so a snapshot costs only its delta, and the state at any
+// of them is restored from the closest copy.
+#define PM4S_HISTORY_KEYFRAME_INTERVAL 64
+
+typedef struct PM4S_HistorySnapshot {
+   // Of the draw or dispatch packet, and the index of the submission assigned by the caller.
+   uint32_t offset;
+   uint32_t submission_index;
+   uint8_t opcode;
+   // In the writes of the history.
+   size_t write_index;
+   uint32_t write_count;
+} PM4S_HistorySnapshot;
+
+typedef struct PM4S_History {
+   PM4S_HistorySnapshot * snapshots;
+   size_t snapshot_count;
+   size_t snapshot_capacity;
+   PM4S_RegisterWrite * writes;
+   size_t write_count;
+   size_t write_capacity;
+   // The state at every PM4S_HISTORY_KEYFRAME_INTERVAL-th snapshot.
+   PM4S_State * keyframes;
+   size_t keyframe_capacity;
+   // Allocation has failed and the snapshots after the last one recorded are lost.
+   bool failed;
+} PM4S_History;
+
+void PM4S_HistoryInit(PM4S_History * history);
+void PM4S_HistoryDestroy(PM4S_History * history);
+// Takes the delta from the shadow and records it as the snapshot at the packet. Returns false if
+// the memory for it couldn't be allocated.
+bool PM4S_HistoryRecord(PM4S_History * history, PM4S_Shadow * shadow, PM4P_Packet const * packet,
+                        uint32_t submission_index);
+// Restores the state at the snapshot.
+void PM4S_HistoryGetState(PM4S_History const * history, size_t snapshot_index,
+                          PM4S_State * state);
+
+// A dword of the command buffer that is patched with the address of an allocation when it's
+// submitted, for annotating the printed packets.
+typedef struct PM4P_Patch {
+   // In dwords from the beginning of the buffer.
+   uint32_t offset;
+   // Into the allocation list of the submission.
+   uint32_t allocation_index;
+   uint32_t allocation;
+   uint32_t allocation_offset;
+   uint32_t slot_id;
+   uint32_t patch_location_index;
+} PM4P_Patch;
+
+// Walks the patches, sorted by the offset, along with the printed dwords, so looking up every dword
+// is constant-time as long as the offsets are increasing.
+typedef struct PM4P_PatchCursor {
+   PM4P_Patch const * patches;
+   uint32_t patch_count;
+   uint32_t patch_index;
+} PM4P_PatchCursor;
+
+// Positions the cursor at the first patch not before the offset in dwords, with a binary search.
+void PM4P_PatchCursorInit(PM4P_PatchCursor * cursor, PM4P_Patch const * patches,
+                          uint32_t patch_count, uint32_t offset_dwords);
+
+// Selection of the register values to decode the bit fields of when printing, as a comment line
+// after the value. The fields are decoded only for the registers in the blocks tracked by the
+// shadow, and the values not selected cost a bit test.
+typedef struct PM4P_FieldDecoder {
+   // By the shadow index, the registers to decode every value of.
+   uint64_t requested[PM4S_BITSET_WORD_COUNT];
+   // Whether to also decode the values different from the last one written to the register, or
+   // written to it for the first time.
+   bool decode_changed;
+   // The values written before, tracked only if decode_changed, so the packets must be printed in
+   // the order they are executed in.
+   PM4S_State state;
+} PM4P_FieldDecoder;
+
+// Initially nothing is requested or written.
+void PM4P_FieldDecoderInit(PM4P_FieldDecoder * field_decoder, bool decode_changed);
+// Returns false if the register is not in the tracked blocks.
+bool PM4P_FieldDecoderRequest(PM4P_FieldDecoder * field_decoder, uint32_t index_dwords);
+void PM4P_FieldDecoderRequestAll(PM4P_FieldDecoder * field_decoder);
+
+// Prints the packets decoded from the buffer.
+void PM4P_PrintPackets(TXTW_Writer * text, PM4P_Packet const * packets, uint32_t packet_count,
+                       PM4P_Family const * family);
+// Same with a comment after every patched dword describing the patch, and the decoded fields of the
+// register values selected by the field decoder. The packets must follow the position of the
+// cursor. The cursor and the field decoder may be null.
+void PM4P_PrintPatchedPackets(TXTW_Writer * text, PM4P_Packet const * packets,
+                              uint32_t packet_count, PM4P_PatchCursor * patch_cursor,
+                              PM4P_Family const * family, PM4P_FieldDecoder * field_decoder);
+void PM4P_Write(TXTW_Writer * text, uint32_t const * pm4, uint32_t pm4_dword_count,
+                PM4P_Family const * family);
+// To stdout, flushed before returning so it can be mixed with other stdio output.
+void PM4P_Print(uint32_t const * pm4, uint32_t pm4_dword_count, PM4P_Family const * family);
 
 #ifdef __cplusplus
 }
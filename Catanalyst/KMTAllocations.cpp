@@ -0,0 +1,158 @@
+#include "KMTAllocations.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+// A power of two, well above the number of threads submitting at the same time.
+static constexpr std::size_t KMTA_SHARD_COUNT = 64;
+// Private driver data of allocations is usually within a few hundred bytes, so blocks of this size
+// hold many records, and larger data gets a block of its own.
+static constexpr std::size_t KMTA_ARENA_BLOCK_SIZE = 64 * 1024;
+
+namespace {
+
+// Bump allocator freeing everything at once.
+struct KMTA_Arena {
+   // The last one is the current block.
+   std::vector<std::unique_ptr<uint8_t[]>> blocks;
+   std::vector<std::unique_ptr<uint8_t[]>> large_blocks;
+   std::size_t block_used = 0;
+};
+
+struct alignas(64) KMTA_Shard {
+   std::mutex mutex;
+   KMTA_Arena arena;
+   // The records are in the arena, so replacing one doesn't move the others.
+   std::unordered_map<uint32_t, KMTA_Allocation *> allocations;
+};
+
+} // namespace
+
+static std::atomic<uint32_t> kmta_locked_count;
+static KMTA_Shard kmta_shards[KMTA_SHARD_COUNT];
+
+static void * KMTA_ArenaAllocate(KMTA_Arena & arena, std::size_t const size,
+                                 std::size_t const alignment) {
+   if (size > KMTA_ARENA_BLOCK_SIZE / 4) {
+      // Not replacing the current block, which may still have space for small records.
+      arena.large_blocks.emplace_back(new uint8_t[size]);
+      return arena.large_blocks.back().get();
+   }
+   std::size_t offset = (arena.block_used + alignment - 1) & ~(alignment - 1);
+   if (arena.blocks.empty() || offset + size > KMTA_ARENA_BLOCK_SIZE) {
+      arena.blocks.emplace_back(new uint8_t[KMTA_ARENA_BLOCK_SIZE]);
+      offset = 0;
+   }
+   arena.block_used = offset + size;
+   return arena.blocks.back().get() + offset;
+}
+
+static KMTA_Shard & KMTA_GetShard(uint32_t const allocation) {
+   // The kernel handles have a few low bits that are always the same, and the index in the handle
+   // table above them.
+   return kmta_shards[(allocation ^ (allocation >> 6)) & (KMTA_SHARD_COUNT - 1)];
+}
+
+// Creates an empty record in the arena of the shard, replacing the current one if there is one.
+// The shard mutex must be locked.
+static KMTA_Allocation & KMTA_CreateRecord(KMTA_Shard & shard, uint32_t const allocation) {
+   KMTA_Allocation * const record =
+      new (KMTA_ArenaAllocate(shard.arena, sizeof(KMTA_Allocation), alignof(KMTA_Allocation)))
+         KMTA_Allocation();
+   record->allocation = allocation;
+   KMTA_Allocation * & slot = shard.allocations[allocation];
+   if (slot && slot->locked_data) {
+      kmta_locked_count.fetch_sub(1, std::memory_order_relaxed);
+   }
+   slot = record;
+   return *record;
+}
+
+void KMTA_AddAllocation(uint32_t const allocation, uint32_t const device, uint32_t const resource,
+                        uint32_t const flags, uint32_t const vidpn_source_id,
+                        void const * const private_driver_data,
+                        uint32_t const private_driver_data_size,
+                        uint64_t const creation_timestamp) {
+   KMTA_Shard & shard = KMTA_GetShard(allocation);
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   KMTA_Allocation & record = KMTA_CreateRecord(shard, allocation);
+   record.device = device;
+   record.resource = resource;
+   record.flags = flags;
+   record.vidpn_source_id = vidpn_source_id;
+   if (private_driver_data_size) {
+      void * const private_driver_data_copy =
+         KMTA_ArenaAllocate(shard.arena, private_driver_data_size, alignof(uint64_t));
+      std::memcpy(private_driver_data_copy, private_driver_data, private_driver_data_size);
+      record.private_driver_data = static_cast<uint8_t const *>(private_driver_data_copy);
+      record.private_driver_data_size = private_driver_data_size;
+   }
+   record.creation_timestamp = creation_timestamp;
+}
+
+void KMTA_SetLocked(uint32_t const allocation, void const * const data, uint64_t const size,
+                    uint64_t const gpu_virtual_address) {
+   KMTA_Shard & shard = KMTA_GetShard(allocation);
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   auto const record_iterator = shard.allocations.find(allocation);
+   KMTA_Allocation & record = record_iterator != shard.allocations.end()
+                                 ? *record_iterator->second
+                                 : KMTA_CreateRecord(shard, allocation);
+   if (!record.locked_data && data) {
+      kmta_locked_count.fetch_add(1, std::memory_order_relaxed);
+   } else if (record.locked_data && !data) {
+      kmta_locked_count.fetch_sub(1, std::memory_order_relaxed);
+   }
+   record.locked_data = data;
+   record.locked_size = data ? size : 0;
+   record.gpu_virtual_address = data ? gpu_virtual_address : 0;
+}
+
+void KMTA_SetUnlocked(uint32_t const allocation) {
+   KMTA_Shard & shard = KMTA_GetShard(allocation);
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   auto const record_iterator = shard.allocations.find(allocation);
+   if (record_iterator == shard.allocations.end()) {
+      return;
+   }
+   KMTA_Allocation & record = *record_iterator->second;
+   if (record.locked_data) {
+      kmta_locked_count.fetch_sub(1, std::memory_order_relaxed);
+   }
+   record.locked_data = nullptr;
+   record.locked_size = 0;
+   record.gpu_virtual_address = 0;
+}
+
+uint32_t KMTA_GetLockedCount() {
+   return kmta_locked_count.load(std::memory_order_relaxed);
+}
+
+bool KMTA_FindAllocation(uint32_t const allocation, KMTA_Allocation & record) {
+   KMTA_Shard & shard = KMTA_GetShard(allocation);
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   auto const record_iterator = shard.allocations.find(allocation);
+   if (record_iterator == shard.allocations.end()) {
+      return false;
+   }
+   record = *record_iterator->second;
+   return true;
+}
+
+void KMTA_End() {
+   for (KMTA_Shard & shard : kmta_shards) {
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      shard.allocations.clear();
+      shard.arena.blocks.clear();
+      shard.arena.large_blocks.clear();
+      shard.arena.block_used = 0;
+   }
+   kmta_locked_count.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+// Registry of the allocations seen by KMTI, for linking the handles in the allocation lists of the
+// submissions to how the allocations were created and where they're mapped.
+//
+// Records are created by D3DKMTCreateAllocation, or by the first D3DKMTLock of an allocation created
+// before the interception began, and replaced when the kernel reuses the handle. They're stored
+// with their private driver data in arenas that are only freed by KMTA_End, so the private driver
+// data of a record stays readable after the record is replaced.
+//
+// Lookups happen on the submitting threads for every indirect buffer. The records are split into
+// shards by the handle, each with its own lock and arena, so concurrent submissions rarely wait for
+// each other or for the creation of allocations.
+//
+// Doesn't depend on anything Windows-specific so it can be exercised by a synthetic producer.
+
+struct KMTA_Allocation {
+   uint32_t allocation;
+   uint32_t device;
+   uint32_t resource;
+   // D3DDDI_ALLOCATIONINFOFLAGS.
+   uint32_t flags;
+   uint32_t vidpn_source_id;
+   uint32_t private_driver_data_size;
+   // After the creation, in the arena, nullptr if the size is 0.
+   uint8_t const * private_driver_data;
+   // Timestamp of the KMTC_EVENT_CREATE_ALLOCATION, 0 if the creation hasn't been intercepted.
+   uint64_t creation_timestamp;
+   // Mapping of the last D3DKMTLock, nullptr if not locked. Must not be dereferenced without
+   // protection from the allocation being unlocked concurrently.
+   void const * locked_data;
+   // Bytes readable from locked_data, 0 if not locked.
+   uint64_t locked_size;
+   // Of the last D3DKMTLock, 0 if not locked or not provided by the kernel.
+   uint64_t gpu_virtual_address;
+};
+
+// Records a created allocation, replacing the record with the same handle if there is one. The
+// private driver data is copied to the arena.
+void KMTA_AddAllocation(uint32_t allocation, uint32_t device, uint32_t resource, uint32_t flags,
+                        uint32_t vidpn_source_id, void const * private_driver_data,
+                        uint32_t private_driver_data_size, uint64_t creation_timestamp);
+// Records the mapping of a successful lock, creating a record without the creation info if the
+// allocation is unknown.
+void KMTA_SetLocked(uint32_t allocation, void const * data, uint64_t size,
+                    uint64_t gpu_virtual_address);
+// Forgets the mapping, to be called before the allocation is actually unlocked.
+void KMTA_SetUnlocked(uint32_t allocation);
+// Number of the allocations currently locked, for skipping lookups that can't succeed.
+uint32_t KMTA_GetLockedCount();
+// Copies the record of the allocation, returning false if it's unknown.
+bool KMTA_FindAllocation(uint32_t allocation, KMTA_Allocation & record);
+// Forgets all the allocations and frees the arenas, invalidating the private driver data pointers.
+void KMTA_End();
@@ -0,0 +1,292 @@
+#include "KMTCapture.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static uint32_t KMTC_Align(uint32_t const size) {
+   return (size + (KMTC_ALIGNMENT - 1)) & ~(uint32_t)(KMTC_ALIGNMENT - 1);
+}
+
+uint32_t KMTC_GetEventSize(uint32_t const fixed_size, KMTC_Blob const * const blobs,
+                           uint32_t const blob_count) {
+   uint32_t size = (uint32_t)sizeof(KMTC_EventHeader) + KMTC_Align(fixed_size);
+   for (uint32_t blob_index = 0; blob_index < blob_count; ++blob_index) {
+      size += KMTC_Align(blobs[blob_index].size);
+   }
+   return size;
+}
+
+// XXH64 primes.
+#define KMTC_HASH_PRIME_1 UINT64_C(0x9E3779B185EBCA87)
+#define KMTC_HASH_PRIME_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define KMTC_HASH_PRIME_3 UINT64_C(0x165667B19E3779F9)
+#define KMTC_HASH_PRIME_4 UINT64_C(0x85EBCA77C2B2AE63)
+#define KMTC_HASH_PRIME_5 UINT64_C(0x27D4EB2F165667C5)
+
+static uint64_t KMTC_RotateLeft(uint64_t const value, unsigned const amount) {
+   return (value << amount) | (value >> (64 - amount));
+}
+
+static uint64_t KMTC_Load64(uint8_t const * const data) {
+   uint64_t value;
+   memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+static uint32_t KMTC_Load32(uint8_t const * const data) {
+   uint32_t value;
+   memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+static uint64_t KMTC_HashRound(uint64_t const accumulator, uint64_t const input) {
+   return KMTC_RotateLeft(accumulator + input * KMTC_HASH_PRIME_2, 31) * KMTC_HASH_PRIME_1;
+}
+
+static uint64_t KMTC_HashMergeRound(uint64_t const accumulator, uint64_t const lane) {
+   return (accumulator ^ KMTC_HashRound(0, lane)) * KMTC_HASH_PRIME_1 + KMTC_HASH_PRIME_4;
+}
+
+uint64_t KMTC_Hash(void const * const data, size_t const size) {
+   uint8_t const * position = (uint8_t const *)data;
+   uint8_t const * const end = position + size;
+   uint64_t hash;
+   if (size >= 32) {
+      // The lanes don't depend on each other, so their multiplications are pipelined.
+      uint64_t lane_0 = KMTC_HASH_PRIME_1 + KMTC_HASH_PRIME_2;
+      uint64_t lane_1 = KMTC_HASH_PRIME_2;
+      uint64_t lane_2 = 0;
+      uint64_t lane_3 = (uint64_t)0 - KMTC_HASH_PRIME_1;
+      uint8_t const * const lanes_end = end - 32;
+      do {
+         lane_0 = KMTC_HashRound(lane_0, KMTC_Load64(position));
+         lane_1 = KMTC_HashRound(lane_1, KMTC_Load64(position + 8));
+         lane_2 = KMTC_HashRound(lane_2, KMTC_Load64(position + 16));
+         lane_3 = KMTC_HashRound(lane_3, KMTC_Load64(position + 24));
+         position += 32;
+      } while (position <= lanes_end);
+      hash = KMTC_RotateLeft(lane_0, 1) + KMTC_RotateLeft(lane_1, 7) +
+             KMTC_RotateLeft(lane_2, 12) + KMTC_RotateLeft(lane_3, 18);
+      hash = KMTC_HashMergeRound(hash, lane_0);
+      hash = KMTC_HashMergeRound(hash, lane_1);
+      hash = KMTC_HashMergeRound(hash, lane_2);
+      hash = KMTC_HashMergeRound(hash, lane_3);
+   } else {
+      hash = KMTC_HASH_PRIME_5;
+   }
+   hash += (uint64_t)size;
+   for (; end - position >= 8; position += 8) {
+      hash ^= KMTC_HashRound(0, KMTC_Load64(position));
+      hash = KMTC_RotateLeft(hash, 27) * KMTC_HASH_PRIME_1 + KMTC_HASH_PRIME_4;
+   }
+   if (end - position >= 4) {
+      hash ^= (uint64_t)KMTC_Load32(position) * KMTC_HASH_PRIME_1;
+      hash = KMTC_RotateLeft(hash, 23) * KMTC_HASH_PRIME_2 + KMTC_HASH_PRIME_3;
+      position += 4;
+   }
+   for (; position < end; ++position) {
+      hash ^= *position * KMTC_HASH_PRIME_5;
+      hash = KMTC_RotateLeft(hash, 11) * KMTC_HASH_PRIME_1;
+   }
+   hash ^= hash >> 33;
+   hash *= KMTC_HASH_PRIME_2;
+   hash ^= hash >> 29;
+   hash *= KMTC_HASH_PRIME_3;
+   hash ^= hash >> 32;
+   return hash;
+}
+
+uint32_t KMTC_GetChunkCount(uint32_t const command_length, uint32_t const chunk_size) {
+   return command_length / chunk_size + (command_length % chunk_size != 0);
+}
+
+// Copies the data and zeroes the padding so captures are deterministic.
+static uint8_t * KMTC_SerializePadded(uint8_t * destination, void const * const data,
+                                      uint32_t const size) {
+   if (size != 0) {
+      memcpy(destination, data, size);
+   }
+   uint32_t const aligned_size = KMTC_Align(size);
+   memset(destination + size, 0, aligned_size - size);
+   return destination + aligned_size;
+}
+
+void KMTC_SerializeEvent(void * const destination, KMTC_EventHeader const * const header,
+                         void const * const fixed, uint32_t const fixed_size,
+                         KMTC_Blob const * const blobs, uint32_t const blob_count) {
+   KMTC_EventHeader sized_header = *header;
+   sized_header.size = KMTC_GetEventSize(fixed_size, blobs, blob_count);
+   uint8_t * position = (uint8_t *)destination;
+   memcpy(position, &sized_header, sizeof(sized_header));
+   position += sizeof(sized_header);
+   position = KMTC_SerializePadded(position, fixed, fixed_size);
+   for (uint32_t blob_index = 0; blob_index < blob_count; ++blob_index) {
+      position = KMTC_SerializePadded(position, blobs[blob_index].data, blobs[blob_index].size);
+   }
+}
+
+bool KMTC_ReaderInit(KMTC_Reader * const reader, void const * const data, size_t const size) {
+   reader->data = (uint8_t const *)data;
+   reader->size = size;
+   reader->offset = size;
+   reader->file_header = NULL;
+   // The fields added in version 3 may be missing.
+   if (size < offsetof(KMTC_FileHeader, command_encoding)) {
+      return false;
+   }
+   KMTC_FileHeader const * const file_header = (KMTC_FileHeader const *)data;
+   if (file_header->magic != KMTC_MAGIC || file_header->version > KMTC_VERSION ||
+       file_header->header_size < offsetof(KMTC_FileHeader, command_encoding) ||
+       file_header->header_size > size ||
+       (file_header->header_size % KMTC_ALIGNMENT) != 0 ||
+       (file_header->chunk_size % KMTC_ALIGNMENT) != 0) {
+      return false;
+   }
+   reader->offset = file_header->header_size;
+   reader->file_header = file_header;
+   return true;
+}
+
+uint32_t KMTC_GetCommandEncoding(KMTC_FileHeader const * const file_header) {
+   if (file_header->header_size <
+       offsetof(KMTC_FileHeader, command_encoding) + sizeof(file_header->command_encoding)) {
+      return KMTC_COMMAND_ENCODING_RAW;
+   }
+   return file_header->command_encoding;
+}
+
+KMTC_EventHeader const * KMTC_ReaderNext(KMTC_Reader * const reader) {
+   size_t const remaining = reader->size - reader->offset;
+   if (remaining < sizeof(KMTC_EventHeader)) {
+      return NULL;
+   }
+   KMTC_EventHeader const * const event =
+      (KMTC_EventHeader const *)(reader->data + reader->offset);
+   if (event->size < sizeof(KMTC_EventHeader) || event->size > remaining ||
+       (event->size % KMTC_ALIGNMENT) != 0) {
+      // Staying at the malformed data, so the capture is not considered read completely.
+      return NULL;
+   }
+   reader->offset += event->size;
+   return event;
+}
+
+bool KMTC_ReaderIsAtEnd(KMTC_Reader const * const reader) {
+   return reader->offset == reader->size;
+}
+
+void KMTC_EventCursorInit(KMTC_EventCursor * const cursor, KMTC_EventHeader const * const event) {
+   cursor->position = (uint8_t const *)event + sizeof(KMTC_EventHeader);
+   cursor->end = (uint8_t const *)event + event->size;
+}
+
+void const * KMTC_EventCursorTake(KMTC_EventCursor * const cursor, uint32_t const size) {
+   uint32_t const aligned_size = KMTC_Align(size);
+   if (aligned_size < size || (size_t)(cursor->end - cursor->position) < aligned_size) {
+      return NULL;
+   }
+   void const * const data = cursor->position;
+   cursor->position += aligned_size;
+   return data;
+}
+
+// With chunk_size 0 for captures that are not deduplicated.
+static bool KMTC_ParseRenderWithLayout(KMTC_EventHeader const * const event,
+                                       uint32_t const chunk_size, bool const is_encoded,
+                                       KMTC_RenderView * const view) {
+   if (event->type != KMTC_EVENT_RENDER) {
+      return false;
+   }
+   KMTC_EventCursor cursor;
+   KMTC_EventCursorInit(&cursor, event);
+   KMTC_Render const * const render =
+      (KMTC_Render const *)KMTC_EventCursorTake(&cursor, sizeof(KMTC_Render));
+   if (render == NULL ||
+       render->allocation_count > UINT32_MAX / sizeof(KMTC_AllocationListEntry) ||
+       render->patch_location_count > UINT32_MAX / sizeof(KMTC_PatchLocation) ||
+       render->broadcast_context_count > UINT32_MAX / sizeof(uint32_t)) {
+      return false;
+   }
+   bool const has_lists = render->node_ordinal != KMTC_NODE_ORDINAL_UNKNOWN;
+   view->render = render;
+   uint32_t command_blob_size = 0;
+   if (is_encoded) {
+      KMTC_EncodedCommands const * const encoded_commands =
+         (KMTC_EncodedCommands const *)KMTC_EventCursorTake(
+            &cursor, has_lists ? (uint32_t)sizeof(KMTC_EncodedCommands) : 0);
+      if (encoded_commands == NULL) {
+         return false;
+      }
+      command_blob_size = has_lists ? encoded_commands->encoded_size : 0;
+   } else if (has_lists) {
+      command_blob_size =
+         chunk_size != 0
+            ? KMTC_GetChunkCount(render->command_length, chunk_size) * (uint32_t)sizeof(uint32_t)
+            : render->command_length;
+   }
+   void const * const command_blob = KMTC_EventCursorTake(&cursor, command_blob_size);
+   bool const is_raw = chunk_size == 0 && !is_encoded;
+   view->command_buffer = is_raw ? (uint32_t const *)command_blob : NULL;
+   view->command_chunk_ids = chunk_size != 0 ? (uint32_t const *)command_blob : NULL;
+   view->command_encoded = is_encoded ? (uint8_t const *)command_blob : NULL;
+   view->command_encoded_size = command_blob_size;
+   view->allocation_list = (KMTC_AllocationListEntry const *)KMTC_EventCursorTake(
+      &cursor,
+      has_lists ? render->allocation_count * (uint32_t)sizeof(KMTC_AllocationListEntry) : 0);
+   view->patch_location_list = (KMTC_PatchLocation const *)KMTC_EventCursorTake(
+      &cursor,
+      has_lists ? render->patch_location_count * (uint32_t)sizeof(KMTC_PatchLocation) : 0);
+   view->broadcast_contexts = (uint32_t const *)KMTC_EventCursorTake(
+      &cursor, render->broadcast_context_count * (uint32_t)sizeof(uint32_t));
+   view->private_driver_data = KMTC_EventCursorTake(&cursor, render->private_driver_data_size);
+   return command_blob != NULL && view->allocation_list != NULL &&
+          view->patch_location_list != NULL && view->broadcast_contexts != NULL &&
+          view->private_driver_data != NULL;
+}
+
+bool KMTC_ParseRender(KMTC_EventHeader const * const event, KMTC_RenderView * const view) {
+   return KMTC_ParseRenderWithLayout(event, 0, false, view);
+}
+
+bool KMTC_ParseChunkedRender(KMTC_EventHeader const * const event, uint32_t const chunk_size,
+                             KMTC_RenderView * const view) {
+   return chunk_size != 0 && KMTC_ParseRenderWithLayout(event, chunk_size, false, view);
+}
+
+bool KMTC_ParseEncodedRender(KMTC_EventHeader const * const event, KMTC_RenderView * const view) {
+   return KMTC_ParseRenderWithLayout(event, 0, true, view);
+}
+
+bool KMTC_ParseChunk(KMTC_EventHeader const * const event, KMTC_Chunk const ** const chunk,
+                     void const ** const data) {
+   if (event->type != KMTC_EVENT_CHUNK) {
+      return false;
+   }
+   KMTC_EventCursor cursor;
+   KMTC_EventCursorInit(&cursor, event);
+   *chunk = (KMTC_Chunk const *)KMTC_EventCursorTake(&cursor, sizeof(KMTC_Chunk));
+   if (*chunk == NULL) {
+      return false;
+   }
+   *data = KMTC_EventCursorTake(&cursor, (*chunk)->size);
+   return *data != NULL;
+}
+
+bool KMTC_ParseAllocationData(KMTC_EventHeader const * const event,
+                              KMTC_AllocationData const ** const allocation_data,
+                              void const ** const data) {
+   if (event->type != KMTC_EVENT_ALLOCATION_DATA) {
+      return false;
+   }
+   KMTC_EventCursor cursor;
+   KMTC_EventCursorInit(&cursor, event);
+   *allocation_data =
+      (KMTC_AllocationData const *)KMTC_EventCursorTake(&cursor, sizeof(KMTC_AllocationData));
+   if (*allocation_data == NULL) {
+      return false;
+   }
+   *data = KMTC_EventCursorTake(&cursor, (*allocation_data)->size);
+   return *data != NULL;
+}
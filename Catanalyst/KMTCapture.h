@@ -0,0 +1,374 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary capture of the D3DKMT calls intercepted by KMTI, to be decoded offline.
+//
+// The file is a KMTC_FileHeader followed by a sequence of events. Each event is a KMTC_EventHeader,
+// the fixed part of the event (KMTC_Escape, KMTC_Render...), and then the variable-size blobs of
+// the event in the order listed in the comment of the fixed part. The fixed part and every blob
+// are padded to KMTC_ALIGNMENT bytes, so blob sizes are taken from the fixed part. Everything is
+// little-endian, and pointers of the captured process are stored as 64-bit integers.
+//
+// If KMTC_FileHeader::chunk_size is not 0, the command buffers of the submissions are
+// deduplicated: they're split into chunks of that size, every unique chunk is stored once as a
+// KMTC_EVENT_CHUNK, and the submissions contain the ids of their chunks instead of the data.
+//
+// If KMTC_FileHeader::command_encoding is not KMTC_COMMAND_ENCODING_RAW, the command buffers of the
+// submissions are compressed, with the state of the compression carried over between the
+// submissions of every context in the order of the file.
+//
+// Captures made in the flight recorder mode consist of dumps of the events recorded shortly before
+// the triggers, each beginning with a KMTC_EVENT_TRIGGER. The events between the dumps are missing,
+// so the creation of the devices, contexts and allocations used by the submissions may be too.
+
+#define KMTC_MAGIC 0x43544D4B // "KMTC".
+#define KMTC_VERSION 3
+#define KMTC_ALIGNMENT 8
+
+typedef struct KMTC_FileHeader {
+   uint32_t magic;
+   uint32_t version;
+   // For skipping fields appended in newer versions.
+   uint32_t header_size;
+   // Size of the chunks of the deduplicated command buffers, a multiple of KMTC_ALIGNMENT, or 0 if
+   // the submissions contain the command buffers. Always 0 in version 1.
+   uint32_t chunk_size;
+   // Ticks per second of KMTC_EventHeader::timestamp.
+   uint64_t timestamp_frequency;
+   // KMTC_CommandEncoding, added in version 3. Only in captures that are not deduplicated.
+   uint32_t command_encoding;
+   uint32_t reserved;
+} KMTC_FileHeader;
+
+typedef enum KMTC_CommandEncoding {
+   KMTC_COMMAND_ENCODING_RAW,
+   // PM4Z_Encode of the dwords, then the bytes of the incomplete dword at the end as they are.
+   KMTC_COMMAND_ENCODING_PM4Z,
+} KMTC_CommandEncoding;
+
+typedef enum KMTC_EventType {
+   KMTC_EVENT_ESCAPE = 1,
+   KMTC_EVENT_QUERY_ADAPTER_INFO,
+   KMTC_EVENT_CREATE_DEVICE,
+   KMTC_EVENT_CREATE_SYNCHRONIZATION_OBJECT,
+   KMTC_EVENT_CREATE_ALLOCATION,
+   KMTC_EVENT_LOCK,
+   KMTC_EVENT_CREATE_CONTEXT,
+   KMTC_EVENT_SET_CONTEXT_SCHEDULING_PRIORITY,
+   KMTC_EVENT_RENDER,
+   KMTC_EVENT_CHUNK,
+   KMTC_EVENT_UNLOCK,
+   KMTC_EVENT_ALLOCATION_DATA,
+   KMTC_EVENT_TRIGGER,
+} KMTC_EventType;
+
+typedef struct KMTC_EventHeader {
+   uint32_t type;
+   // Including the header, a multiple of KMTC_ALIGNMENT.
+   uint32_t size;
+   uint32_t thread_id;
+   // NTSTATUS returned by the real function.
+   int32_t status;
+   uint64_t timestamp;
+} KMTC_EventHeader;
+
+// Blobs: private driver data before the call, private driver data after the call.
+typedef struct KMTC_Escape {
+   uint32_t adapter;
+   uint32_t device;
+   uint32_t type;
+   uint32_t flags;
+   uint32_t context;
+   uint32_t private_driver_data_size;
+} KMTC_Escape;
+
+// Blobs: private driver data before the call, private driver data after the call (both
+// private_driver_data_size_in bytes, as the driver writes to the same buffer).
+typedef struct KMTC_QueryAdapterInfo {
+   uint32_t adapter;
+   uint32_t type;
+   uint32_t private_driver_data_size_in;
+   uint32_t private_driver_data_size_out;
+} KMTC_QueryAdapterInfo;
+
+// No blobs.
+typedef struct KMTC_CreateDevice {
+   uint32_t adapter;
+   // D3DKMT_CREATEDEVICEFLAGS.
+   uint32_t flags;
+   uint32_t device;
+   uint32_t command_buffer_size;
+   uint32_t allocation_list_size;
+   uint32_t patch_location_list_size;
+   uint64_t command_buffer;
+   uint64_t allocation_list;
+   uint64_t patch_location_list;
+} KMTC_CreateDevice;
+
+// No blobs.
+typedef struct KMTC_CreateSynchronizationObject {
+   uint32_t device;
+   uint32_t type_in;
+   uint32_t type_out;
+   uint32_t synchronization_object;
+} KMTC_CreateSynchronizationObject;
+
+typedef struct KMTC_AllocationInfo {
+   uint32_t allocation;
+   uint32_t private_driver_data_size;
+   uint32_t vidpn_source_id;
+   // D3DDDI_ALLOCATIONINFOFLAGS.
+   uint32_t flags;
+   uint64_t section;
+} KMTC_AllocationInfo;
+
+// Blobs: private runtime data, private driver data, KMTC_AllocationInfo[allocation_count] (with
+// hAllocation returned by the call), then for each allocation, its private driver data before the
+// call and after the call.
+typedef struct KMTC_CreateAllocation {
+   uint32_t device;
+   uint32_t resource_in;
+   uint32_t resource_out;
+   uint32_t global_share;
+   uint32_t private_runtime_data_size;
+   uint32_t private_driver_data_size;
+   uint32_t allocation_count;
+   // D3DKMT_CREATEALLOCATIONFLAGS.
+   uint32_t flags;
+   uint64_t private_runtime_resource_handle_in;
+   uint64_t private_runtime_resource_handle_out;
+} KMTC_CreateAllocation;
+
+// Blobs: uint32_t pages[page_count].
+typedef struct KMTC_Lock {
+   uint32_t device;
+   uint32_t allocation;
+   uint32_t private_driver_data;
+   uint32_t page_count;
+   // D3DDDICB_LOCKFLAGS.
+   uint32_t flags;
+   uint32_t reserved;
+   uint64_t data;
+   uint64_t gpu_virtual_address;
+} KMTC_Lock;
+
+// Blobs: uint32_t allocations[allocation_count].
+typedef struct KMTC_Unlock {
+   uint32_t device;
+   uint32_t allocation_count;
+} KMTC_Unlock;
+
+// Blobs: private driver data before the call.
+typedef struct KMTC_CreateContext {
+   uint32_t device;
+   uint32_t node_ordinal;
+   uint32_t engine_affinity;
+   // D3DDDI_CREATECONTEXTFLAGS.
+   uint32_t flags;
+   uint32_t private_driver_data_size;
+   uint32_t client_hint;
+   uint32_t context;
+   uint32_t command_buffer_size;
+   uint32_t allocation_list_size;
+   uint32_t patch_location_list_size;
+   uint64_t command_buffer_pointer;
+   uint64_t allocation_list;
+   uint64_t patch_location_list;
+   uint64_t command_buffer;
+} KMTC_CreateContext;
+
+// No blobs.
+typedef struct KMTC_SetContextSchedulingPriority {
+   uint32_t context;
+   int32_t priority;
+} KMTC_SetContextSchedulingPriority;
+
+// Same layout as D3DDDI_ALLOCATIONLIST.
+typedef struct KMTC_AllocationListEntry {
+   uint32_t allocation;
+   uint32_t flags;
+} KMTC_AllocationListEntry;
+
+// Same layout as D3DDDI_PATCHLOCATIONLIST.
+typedef struct KMTC_PatchLocation {
+   uint32_t allocation_index;
+   uint32_t slot_id;
+   uint32_t driver_id;
+   uint32_t allocation_offset;
+   uint32_t patch_offset;
+   uint32_t split_offset;
+} KMTC_PatchLocation;
+
+#define KMTC_NODE_ORDINAL_UNKNOWN UINT32_MAX
+
+// Blobs: the command buffer from CommandOffset (command_length bytes), or the ids of its chunks
+// (uint32_t[KMTC_GetChunkCount(command_length, chunk_size)]) if the capture is deduplicated, or
+// KMTC_EncodedCommands followed by a blob of the encoded data if the capture is compressed,
+// KMTC_AllocationListEntry[allocation_count], KMTC_PatchLocation[patch_location_count], then
+// uint32_t broadcast_contexts[broadcast_context_count], private driver data. The first three are
+// empty if node_ordinal is KMTC_NODE_ORDINAL_UNKNOWN, as the lists of unknown contexts can't be
+// located.
+typedef struct KMTC_Render {
+   uint32_t context;
+   // Of the context at the time of the submission, or KMTC_NODE_ORDINAL_UNKNOWN.
+   uint32_t node_ordinal;
+   uint32_t command_offset;
+   uint32_t command_length;
+   uint32_t allocation_count;
+   uint32_t patch_location_count;
+   uint32_t new_command_buffer_size_in;
+   uint32_t new_allocation_list_size_in;
+   uint32_t new_patch_location_list_size_in;
+   // D3DKMT_RENDERFLAGS.
+   uint32_t flags;
+   uint64_t present_history_token;
+   uint32_t broadcast_context_count;
+   uint32_t private_driver_data_size;
+   uint32_t new_command_buffer_size_out;
+   uint32_t new_allocation_list_size_out;
+   uint32_t new_patch_location_list_size_out;
+   uint32_t queued_buffer_count;
+   uint64_t new_command_buffer_pointer;
+   uint64_t new_allocation_list;
+   uint64_t new_patch_location_list;
+   uint64_t new_command_buffer;
+} KMTC_Render;
+
+// Blobs: the data of the chunk (size bytes, chunk_size except for the last chunk of a command
+// buffer).
+// A unique piece of the command buffers of a deduplicated capture, written before the first
+// submission containing it on the same thread. Submissions on other threads may precede it in the
+// file, as the events of the threads are interleaved in the order they're written out, so readers
+// need to find all the chunks before reading the command buffers.
+typedef struct KMTC_Chunk {
+   // Sequential from 0 in the order the chunks are first seen.
+   uint32_t id;
+   uint32_t size;
+   // KMTC_Hash of the data.
+   uint64_t hash;
+} KMTC_Chunk;
+
+// Blobs: the data (size bytes).
+// Contents of a locked allocation targeted by an indirect buffer packet of the next submission on
+// the same thread, read from the mapping when the submission is made. Written only when the
+// contents differ from the last ones written for the same range, so readers keep the latest
+// contents of every range in the order of the file.
+typedef struct KMTC_AllocationData {
+   uint32_t allocation;
+   // In bytes from the beginning of the allocation.
+   uint32_t offset;
+   uint32_t size;
+   uint32_t reserved;
+   // Of the data, or 0 if the allocation has no GPU virtual address.
+   uint64_t gpu_virtual_address;
+   // KMTC_Hash of the data.
+   uint64_t hash;
+} KMTC_AllocationData;
+
+typedef enum KMTC_TriggerReason {
+   KMTC_TRIGGER_HOTKEY,
+   KMTC_TRIGGER_NAMED_EVENT,
+   KMTC_TRIGGER_FRAME_TIME,
+   KMTC_TRIGGER_RENDER_STALL,
+} KMTC_TriggerReason;
+
+// Beginning of a dump of the flight recorder, with the timestamp of the trigger. Followed by the
+// events recorded before the trigger that still fit in the memory of the flight recorder.
+typedef struct KMTC_Trigger {
+   // KMTC_TriggerReason.
+   uint32_t reason;
+   uint32_t reserved;
+   // Of the events discarded for not fitting since the previous dump, including the headers.
+   uint64_t discarded_size;
+} KMTC_Trigger;
+
+// XXH64 with the seed 0, for identifying the chunks. Runs 4 independent lanes over 32 bytes at a
+// time, so it's fast enough to hash every submission on the thread submitting it.
+uint64_t KMTC_Hash(void const * data, size_t size);
+uint32_t KMTC_GetChunkCount(uint32_t command_length, uint32_t chunk_size);
+
+typedef struct KMTC_EncodedCommands {
+   uint32_t encoded_size;
+   uint32_t reserved;
+} KMTC_EncodedCommands;
+
+typedef struct KMTC_Blob {
+   void const * data;
+   uint32_t size;
+} KMTC_Blob;
+
+// Size of an event with the given fixed part and blobs, including the header and padding.
+uint32_t KMTC_GetEventSize(uint32_t fixed_size, KMTC_Blob const * blobs, uint32_t blob_count);
+// Writes KMTC_GetEventSize bytes to the destination. header->size is written by this function.
+void KMTC_SerializeEvent(void * destination, KMTC_EventHeader const * header, void const * fixed,
+                         uint32_t fixed_size, KMTC_Blob const * blobs, uint32_t blob_count);
+
+typedef struct KMTC_Reader {
+   uint8_t const * data;
+   size_t size;
+   size_t offset;
+   KMTC_FileHeader const * file_header;
+} KMTC_Reader;
+
+// KMTC_COMMAND_ENCODING_RAW for the versions before the field.
+uint32_t KMTC_GetCommandEncoding(KMTC_FileHeader const * file_header);
+
+// The data must stay accessible while the reader and the events from it are used, and must be
+// aligned to KMTC_ALIGNMENT. Returns false if the data doesn't start with a supported header.
+bool KMTC_ReaderInit(KMTC_Reader * reader, void const * data, size_t size);
+// Returns NULL at the end of the capture or if the remaining data is truncated or malformed, in
+// which case the offset stays at the beginning of that data. The capture has been read completely
+// only if the offset has reached the size.
+KMTC_EventHeader const * KMTC_ReaderNext(KMTC_Reader * reader);
+// Whether all the events have been read without encountering truncated or malformed data.
+bool KMTC_ReaderIsAtEnd(KMTC_Reader const * reader);
+
+// Sequential access to the fixed part and the blobs of an event with bounds checking.
+typedef struct KMTC_EventCursor {
+   uint8_t const * position;
+   uint8_t const * end;
+} KMTC_EventCursor;
+
+void KMTC_EventCursorInit(KMTC_EventCursor * cursor, KMTC_EventHeader const * event);
+// Returns NULL if the event doesn't contain the requested number of bytes.
+void const * KMTC_EventCursorTake(KMTC_EventCursor * cursor, uint32_t size);
+
+typedef struct KMTC_RenderView {
+   KMTC_Render const * render;
+   // NULL in deduplicated captures.
+   uint32_t const * command_buffer;
+   // Only in deduplicated captures, NULL otherwise.
+   uint32_t const * command_chunk_ids;
+   // Only in compressed captures, NULL otherwise.
+   uint8_t const * command_encoded;
+   uint32_t command_encoded_size;
+   KMTC_AllocationListEntry const * allocation_list;
+   KMTC_PatchLocation const * patch_location_list;
+   uint32_t const * broadcast_contexts;
+   void const * private_driver_data;
+} KMTC_RenderView;
+
+// Returns false if the event is not a well-formed KMTC_EVENT_RENDER.
+bool KMTC_ParseRender(KMTC_EventHeader const * event, KMTC_RenderView * view);
+// Same for a deduplicated capture with the chunk size from its file header.
+bool KMTC_ParseChunkedRender(KMTC_EventHeader const * event, uint32_t chunk_size,
+                             KMTC_RenderView * view);
+// Same for a compressed capture.
+bool KMTC_ParseEncodedRender(KMTC_EventHeader const * event, KMTC_RenderView * view);
+// Returns false if the event is not a well-formed KMTC_EVENT_CHUNK.
+bool KMTC_ParseChunk(KMTC_EventHeader const * event, KMTC_Chunk const ** chunk,
+                     void const ** data);
+// Returns false if the event is not a well-formed KMTC_EVENT_ALLOCATION_DATA.
+bool KMTC_ParseAllocationData(KMTC_EventHeader const * event,
+                              KMTC_AllocationData const ** allocation_data, void const ** data);
+
+#ifdef __cplusplus
+}
+#endif
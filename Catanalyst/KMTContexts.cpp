@@ -0,0 +1,104 @@
+#include "KMTContexts.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A power of two, far above the number of contexts applications create, so probes stay short.
+static constexpr std::size_t KMTX_SLOT_COUNT = 1024;
+
+namespace {
+
+struct alignas(64) KMTX_Slot {
+   // 0 if free. Claimed once and never released until KMTX_End.
+   std::atomic<uint32_t> context;
+   // Set after the rest of the record is written for the first time.
+   std::atomic<bool> published;
+   std::atomic<uint32_t> node_ordinal;
+   std::atomic<void *> command_buffer;
+   std::atomic<void *> allocation_list;
+   std::atomic<void *> patch_location_list;
+};
+
+} // namespace
+
+static KMTX_Slot kmtx_slots[KMTX_SLOT_COUNT];
+
+static std::size_t KMTX_GetFirstSlot(uint32_t const context) {
+   // The low bits of the kernel handles are the same for all of them, so they're mixed.
+   return std::size_t((context * UINT32_C(0x9E3779B1)) >> 22) & (KMTX_SLOT_COUNT - 1);
+}
+
+// Returns the slot of the context, or nullptr if it has no slot.
+static KMTX_Slot * KMTX_FindSlot(uint32_t const context) {
+   if (!context) {
+      return nullptr;
+   }
+   std::size_t slot_index = KMTX_GetFirstSlot(context);
+   for (std::size_t probe = 0; probe < KMTX_SLOT_COUNT; ++probe) {
+      KMTX_Slot & slot = kmtx_slots[slot_index];
+      uint32_t const slot_context = slot.context.load(std::memory_order_acquire);
+      if (slot_context == context) {
+         return &slot;
+      }
+      // Slots are claimed in the order of probing, so the context can't be after a free one.
+      if (!slot_context) {
+         return nullptr;
+      }
+      slot_index = (slot_index + 1) & (KMTX_SLOT_COUNT - 1);
+   }
+   return nullptr;
+}
+
+bool KMTX_AddContext(uint32_t const context, KMTX_Context const & info) {
+   if (!context) {
+      return false;
+   }
+   std::size_t slot_index = KMTX_GetFirstSlot(context);
+   for (std::size_t probe = 0; probe < KMTX_SLOT_COUNT; ++probe) {
+      KMTX_Slot & slot = kmtx_slots[slot_index];
+      uint32_t slot_context = 0;
+      if (slot.context.compare_exchange_strong(slot_context, context,
+                                               std::memory_order_acq_rel) ||
+          slot_context == context) {
+         slot.node_ordinal.store(info.node_ordinal, std::memory_order_relaxed);
+         slot.command_buffer.store(info.command_buffer, std::memory_order_relaxed);
+         slot.allocation_list.store(info.allocation_list, std::memory_order_relaxed);
+         slot.patch_location_list.store(info.patch_location_list, std::memory_order_relaxed);
+         slot.published.store(true, std::memory_order_release);
+         return true;
+      }
+      slot_index = (slot_index + 1) & (KMTX_SLOT_COUNT - 1);
+   }
+   return false;
+}
+
+bool KMTX_FindContext(uint32_t const context, KMTX_Context & info) {
+   KMTX_Slot const * const slot = KMTX_FindSlot(context);
+   if (!slot || !slot->published.load(std::memory_order_acquire)) {
+      return false;
+   }
+   info.node_ordinal = slot->node_ordinal.load(std::memory_order_relaxed);
+   info.command_buffer = slot->command_buffer.load(std::memory_order_acquire);
+   info.allocation_list = slot->allocation_list.load(std::memory_order_acquire);
+   info.patch_location_list = slot->patch_location_list.load(std::memory_order_acquire);
+   return true;
+}
+
+void KMTX_SetBuffers(uint32_t const context, void * const command_buffer,
+                     void * const allocation_list, void * const patch_location_list) {
+   KMTX_Slot * const slot = KMTX_FindSlot(context);
+   if (!slot || !slot->published.load(std::memory_order_acquire)) {
+      return;
+   }
+   slot->command_buffer.store(command_buffer, std::memory_order_release);
+   slot->allocation_list.store(allocation_list, std::memory_order_release);
+   slot->patch_location_list.store(patch_location_list, std::memory_order_release);
+}
+
+void KMTX_End() {
+   for (KMTX_Slot & slot : kmtx_slots) {
+      slot.published.store(false, std::memory_order_relaxed);
+      slot.context.store(0, std::memory_order_relaxed);
+   }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// Table of the contexts created while KMTI is intercepting, for finding the buffers that the
+// submissions refer to by offsets.
+//
+// Every D3DKMTRender looks its context up and then replaces the buffer pointers with the ones the
+// kernel returns. The contexts are stored in an open-addressing table of fixed capacity, and a
+// context is never removed, so a slot, once claimed for a handle, stays with it. Looking a context
+// up is a probe of atomic loads, and the buffer pointers of every context are in its own cache line,
+// so threads submitting to different contexts never wait for each other or share cache lines.
+//
+// A context may be submitted to by one thread at a time, which the buffer pointers rely on: the
+// pointers are read and updated without being kept consistent with each other, so they're only
+// consistent for the thread that has submitted to the context last.
+//
+// Doesn't depend on anything Windows-specific so it can be exercised by a synthetic producer.
+
+struct KMTX_Context {
+   uint32_t node_ordinal;
+   void * command_buffer;
+   void * allocation_list;
+   void * patch_location_list;
+};
+
+// Records a created context, replacing the one with the same handle if there is one. Returns false
+// if the context handle is 0 or the table is full, in which case the submissions to it are captured
+// without the buffers.
+bool KMTX_AddContext(uint32_t context, KMTX_Context const & info);
+// Copies the context, returning false if it's unknown.
+bool KMTX_FindContext(uint32_t context, KMTX_Context & info);
+// Replaces the buffers of a known context after a submission.
+void KMTX_SetBuffers(uint32_t context, void * command_buffer, void * allocation_list,
+                     void * patch_location_list);
+// Forgets all the contexts. Must not be called while other threads may use the table.
+void KMTX_End();
@@ -0,0 +1,67 @@
+#include "KMTDedup.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+// A power of two, well above the number of threads submitting at the same time.
+static constexpr std::size_t KMTD_SHARD_COUNT = 64;
+
+namespace {
+
+struct KMTD_ChunkKey {
+   uint64_t hash;
+   uint32_t size;
+
+   bool operator==(KMTD_ChunkKey const & other) const {
+      return hash == other.hash && size == other.size;
+   }
+};
+
+struct KMTD_ChunkKeyHasher {
+   std::size_t operator()(KMTD_ChunkKey const & key) const {
+      // The low bits select the shard, so the bucket is chosen by the high ones.
+      return std::size_t(key.hash >> 32) ^ std::size_t(key.hash >> 8);
+   }
+};
+
+struct alignas(64) KMTD_Shard {
+   std::mutex mutex;
+   std::unordered_map<KMTD_ChunkKey, uint32_t, KMTD_ChunkKeyHasher> chunk_ids;
+};
+
+} // namespace
+
+static std::atomic<uint32_t> kmtd_chunk_size;
+static std::atomic<uint32_t> kmtd_next_chunk_id;
+static KMTD_Shard kmtd_shards[KMTD_SHARD_COUNT];
+
+void KMTD_Begin(uint32_t const chunk_size) {
+   kmtd_next_chunk_id.store(0, std::memory_order_relaxed);
+   kmtd_chunk_size.store(chunk_size, std::memory_order_release);
+}
+
+void KMTD_End() {
+   kmtd_chunk_size.store(0, std::memory_order_release);
+   for (KMTD_Shard & shard : kmtd_shards) {
+      std::lock_guard<std::mutex> shard_lock(shard.mutex);
+      shard.chunk_ids.clear();
+   }
+}
+
+uint32_t KMTD_GetChunkSize() {
+   return kmtd_chunk_size.load(std::memory_order_acquire);
+}
+
+uint32_t KMTD_AddChunk(uint64_t const hash, uint32_t const size, bool & is_new) {
+   KMTD_Shard & shard = kmtd_shards[hash & (KMTD_SHARD_COUNT - 1)];
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   auto const insertion = shard.chunk_ids.emplace(KMTD_ChunkKey{hash, size}, 0);
+   is_new = insertion.second;
+   if (is_new) {
+      insertion.first->second = kmtd_next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+   }
+   return insertion.first->second;
+}
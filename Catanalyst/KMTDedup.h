@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Deduplication of the command buffers of the submissions recorded by KMTI.
+//
+// The command buffers are split into chunks of a fixed size, identified by the hash and the size of
+// their data, and each unique chunk is written to the capture once, as a KMTC_EVENT_CHUNK, with the
+// submissions only containing the ids of their chunks. Games build nearly identical command
+// buffers every frame, so after the first frames most of the chunks are already known.
+//
+// Chunks are looked up on the submitting threads. The known chunks are split into shards by the
+// hash, each with its own lock, so concurrent submissions rarely wait for each other.
+//
+// Doesn't depend on anything Windows-specific so it can be exercised by a synthetic producer.
+
+// chunk_size must be a multiple of KMTC_ALIGNMENT, 0 to disable the deduplication.
+void KMTD_Begin(uint32_t chunk_size);
+// Forgets all the chunks.
+void KMTD_End();
+// 0 if the command buffers are not deduplicated.
+uint32_t KMTD_GetChunkSize();
+
+// Returns the id of the chunk with the hash and the size, assigning a new one if the chunk hasn't
+// been seen yet, in which case is_new is set and the caller must write the chunk to the capture.
+// Chunks are considered the same if both the 64-bit hash and the size are equal, without comparing
+// the data.
+uint32_t KMTD_AddChunk(uint64_t hash, uint32_t size, bool & is_new);
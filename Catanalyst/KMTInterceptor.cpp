@@ -1,4 +1,9 @@
 #include "Catanalyst.h"
+#include "KMTAllocations.h"
+#include "KMTCapture.h"
+#include "KMTContexts.h"
+#include "KMTDedup.h"
+#include "KMTRing.h"
 
 #include <Windows.h>
 
@@ -6,38 +11,319 @@
 
 #include "../Detours/src/detours.h"
 
-#include <cinttypes>
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
 #include <optional>
-#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
-static void KMTI_PrintArray(char const * const name, void const * const data,
-                            std::size_t const size) {
-   printf("  %s = 0x%p:", name, data);
-   for (size_t byte_index = 0; byte_index < size; ++byte_index) {
-      if ((byte_index & 0xF) == 0) {
-         fputs("\n  ", stdout);
+// A power of two, well above the number of threads submitting at the same time.
+static constexpr std::size_t KMTI_ALLOCATION_DATA_SHARD_COUNT = 64;
+
+namespace {
+
+// The ranges are split into shards by the allocation like the records of KMTA, so concurrent
+// submissions rarely wait for each other.
+struct alignas(64) KMTI_AllocationDataShard {
+   std::mutex mutex;
+   // KMTC_Hash of the last contents written for every range, by the allocation in the high and the
+   // offset in the low 32 bits.
+   std::unordered_map<uint64_t, uint64_t> hashes;
+};
+
+} // namespace
+
+static KMTI_AllocationDataShard kmti_allocation_data_shards[KMTI_ALLOCATION_DATA_SHARD_COUNT];
+// False with the flight recorder, which forgets events, including the contents that later ones
+// would be compared with, so all the contents are written.
+static bool kmti_is_allocation_data_deduplicated;
+
+static_assert(sizeof(KMTC_AllocationListEntry) == sizeof(D3DDDI_ALLOCATIONLIST),
+              "The captured allocation list must be copyable as a whole.");
+static_assert(sizeof(KMTC_PatchLocation) == sizeof(D3DDDI_PATCHLOCATIONLIST),
+              "The captured patch location list must be copyable as a whole.");
+
+// Capture output
+
+static std::FILE * kmti_capture_file;
+
+template <typename Flags>
+static uint32_t KMTI_FlagsToUint32(Flags const & flags) {
+   static_assert(sizeof(Flags) == sizeof(uint32_t), "Flags must be 32-bit.");
+   uint32_t value;
+   std::memcpy(&value, &flags, sizeof(value));
+   return value;
+}
+
+static uint64_t KMTI_PointerToUint64(void const * const pointer) {
+   return uint64_t(reinterpret_cast<uintptr_t>(pointer));
+}
+
+static uint64_t KMTI_GetTimestamp() {
+   LARGE_INTEGER counter;
+   QueryPerformanceCounter(&counter);
+   return uint64_t(counter.QuadPart);
+}
+
+static KMTC_EventHeader KMTI_MakeEventHeader(KMTC_EventType const type, uint64_t const timestamp,
+                                             NTSTATUS const status) {
+   KMTC_EventHeader header = {};
+   header.type = type;
+   header.thread_id = GetCurrentThreadId();
+   header.status = int32_t(status);
+   header.timestamp = timestamp;
+   return header;
+}
+
+static void KMTI_WriteEvent(KMTC_EventHeader const & header, void const * const fixed,
+                            uint32_t const fixed_size, KMTC_Blob const * const blobs,
+                            uint32_t const blob_count) {
+   void * const event = KMTR_Reserve(KMTC_GetEventSize(fixed_size, blobs, blob_count));
+   if (!event) {
+      return;
+   }
+   KMTC_SerializeEvent(event, &header, fixed, fixed_size, blobs, blob_count);
+   KMTR_Commit();
+}
+
+template <typename Fixed, std::size_t BlobCount>
+static void KMTI_WriteEvent(KMTC_EventHeader const & header, Fixed const & fixed,
+                            KMTC_Blob const (&blobs)[BlobCount]) {
+   KMTI_WriteEvent(header, &fixed, uint32_t(sizeof(fixed)), blobs, uint32_t(BlobCount));
+}
+
+template <typename Fixed>
+static void KMTI_WriteEvent(KMTC_EventHeader const & header, Fixed const & fixed) {
+   KMTI_WriteEvent(header, &fixed, uint32_t(sizeof(fixed)), nullptr, 0);
+}
+
+// Copy of data that the real function may overwrite, for capturing its state before the call.
+static std::vector<uint8_t> KMTI_CopyBlob(void const * const data, UINT const size) {
+   if (!size) {
+      return std::vector<uint8_t>();
+   }
+   return std::vector<uint8_t>(static_cast<uint8_t const *>(data),
+                               static_cast<uint8_t const *>(data) + size);
+}
+
+// Writes the chunks of a command buffer not written yet, storing the ids of all its chunks.
+static void KMTI_WriteChunks(void const * const command_buffer, uint32_t const command_length,
+                             uint32_t const chunk_size, uint64_t const timestamp,
+                             std::vector<uint32_t> & chunk_ids) {
+   chunk_ids.resize(KMTC_GetChunkCount(command_length, chunk_size));
+   for (uint32_t chunk_index = 0; chunk_index < chunk_ids.size(); ++chunk_index) {
+      uint32_t const chunk_offset = chunk_size * chunk_index;
+      void const * const data = static_cast<char const *>(command_buffer) + chunk_offset;
+      KMTC_Chunk chunk = {};
+      chunk.size = std::min(chunk_size, command_length - chunk_offset);
+      chunk.hash = KMTC_Hash(data, chunk.size);
+      bool is_new;
+      chunk.id = KMTD_AddChunk(chunk.hash, chunk.size, is_new);
+      if (is_new) {
+         KMTC_Blob const blobs[] = {
+            {data, chunk.size},
+         };
+         KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_CHUNK, timestamp, 0), chunk, blobs);
       }
-      if ((byte_index & 0x3) == 0) {
-         putchar(' ');
+      chunk_ids[chunk_index] = chunk.id;
+   }
+}
+
+// Copies memory of the application that may have been unmapped, returning false in this case.
+static bool KMTI_TryCopy(void * const destination, void const * const source,
+                         std::size_t const size) {
+   __try {
+      std::memcpy(destination, source, size);
+   } __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION ? EXCEPTION_EXECUTE_HANDLER
+                                                                : EXCEPTION_CONTINUE_SEARCH) {
+      return false;
+   }
+   return true;
+}
+
+// Whether the contents of the range are different from the ones last written for it, remembering
+// the new hash if they are. Always true if the contents are not deduplicated.
+static bool KMTI_IsAllocationDataChanged(uint32_t const allocation, uint32_t const offset,
+                                         uint64_t const hash) {
+   if (!kmti_is_allocation_data_deduplicated) {
+      return true;
+   }
+   KMTI_AllocationDataShard & shard =
+      kmti_allocation_data_shards[(allocation ^ (allocation >> 6)) &
+                                  (KMTI_ALLOCATION_DATA_SHARD_COUNT - 1)];
+   std::lock_guard<std::mutex> shard_lock(shard.mutex);
+   uint64_t & last_hash = shard.hashes[(uint64_t(allocation) << 32) | offset];
+   if (last_hash == hash) {
+      return false;
+   }
+   last_hash = hash;
+   return true;
+}
+
+// Returns the patch locations ordered by PatchOffset, keeping the order of the ones with the same
+// offset: the list itself if the driver has ordered it, as usual, or a copy in the storage.
+static D3DDDI_PATCHLOCATIONLIST const * KMTI_SortPatchLocations(
+   D3DDDI_PATCHLOCATIONLIST const * const patch_location_list,
+   uint32_t const patch_location_count, std::vector<D3DDDI_PATCHLOCATIONLIST> & storage) {
+   auto const is_before = [](D3DDDI_PATCHLOCATIONLIST const & a,
+                             D3DDDI_PATCHLOCATIONLIST const & b) {
+      return a.PatchOffset < b.PatchOffset;
+   };
+   if (std::is_sorted(patch_location_list, patch_location_list + patch_location_count,
+                      is_before)) {
+      return patch_location_list;
+   }
+   storage.assign(patch_location_list, patch_location_list + patch_location_count);
+   std::stable_sort(storage.begin(), storage.end(), is_before);
+   return storage.data();
+}
+
+// Writes the contents of the locked allocations that the indirect buffer packets of a graphics
+// command buffer point to, if they changed since they were last written. The addresses of the
+// indirect buffers are resolved through the patch locations of the submission, which are ordered
+// once the first indirect buffer is found.
+static void KMTI_WriteIndirectBufferData(uint32_t const * const command_buffer,
+                                         uint32_t const command_offset,
+                                         uint32_t const command_length,
+                                         D3DDDI_ALLOCATIONLIST const * const allocation_list,
+                                         uint32_t const allocation_count,
+                                         D3DDDI_PATCHLOCATIONLIST const * const patch_location_list,
+                                         uint32_t const patch_location_count,
+                                         uint64_t const timestamp) {
+   if (!KMTA_GetLockedCount() || !patch_location_count) {
+      return;
+   }
+   // Kept allocated for the next submissions of the thread.
+   static thread_local std::vector<D3DDDI_PATCHLOCATIONLIST> sorted_patch_location_storage;
+   static thread_local std::vector<uint8_t> data;
+   D3DDDI_PATCHLOCATIONLIST const * sorted_patch_locations = nullptr;
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, command_buffer, command_length / sizeof(uint32_t));
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+         PM4P_IndirectBuffer indirect_buffer;
+         if (!PM4P_GetIndirectBuffer(&packets[packet_index], &indirect_buffer) ||
+             !indirect_buffer.dword_count) {
+            continue;
+         }
+         // The patch location of IB_BASE_LO, relative to the whole command buffer.
+         uint32_t const patch_offset =
+            command_offset + sizeof(uint32_t) * (packets[packet_index].offset + 1);
+         if (!sorted_patch_locations) {
+            sorted_patch_locations = KMTI_SortPatchLocations(
+               patch_location_list, patch_location_count, sorted_patch_location_storage);
+         }
+         D3DDDI_PATCHLOCATIONLIST const * const patch_location = std::lower_bound(
+            sorted_patch_locations, sorted_patch_locations + patch_location_count, patch_offset,
+            [](D3DDDI_PATCHLOCATIONLIST const & patch_location, uint32_t const offset) {
+               return patch_location.PatchOffset < offset;
+            });
+         if (patch_location == sorted_patch_locations + patch_location_count ||
+             patch_location->PatchOffset != patch_offset ||
+             patch_location->AllocationIndex >= allocation_count) {
+            continue;
+         }
+         KMTC_AllocationData allocation_data = {};
+         allocation_data.allocation = allocation_list[patch_location->AllocationIndex].hAllocation;
+         allocation_data.offset = patch_location->AllocationOffset;
+         allocation_data.size = uint32_t(sizeof(uint32_t) * indirect_buffer.dword_count);
+         KMTA_Allocation allocation;
+         if (!KMTA_FindAllocation(allocation_data.allocation, allocation) ||
+             !allocation.locked_data || allocation_data.offset >= allocation.locked_size) {
+            continue;
+         }
+         // Not reading past the mapping if the size in the packet is wrong.
+         allocation_data.size = uint32_t(std::min(uint64_t(allocation_data.size),
+                                                  allocation.locked_size - allocation_data.offset));
+         data.resize(allocation_data.size);
+         if (!KMTI_TryCopy(data.data(),
+                           static_cast<uint8_t const *>(allocation.locked_data) +
+                              allocation_data.offset,
+                           allocation_data.size)) {
+            continue;
+         }
+         allocation_data.gpu_virtual_address =
+            allocation.gpu_virtual_address
+               ? allocation.gpu_virtual_address + allocation_data.offset
+               : 0;
+         allocation_data.hash = KMTC_Hash(data.data(), allocation_data.size);
+         if (!KMTI_IsAllocationDataChanged(allocation_data.allocation, allocation_data.offset,
+                                           allocation_data.hash)) {
+            continue;
+         }
+         KMTC_Blob const blobs[] = {
+            {data.data(), allocation_data.size},
+         };
+         KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_ALLOCATION_DATA, timestamp, 0),
+                         allocation_data, blobs);
       }
-      printf(" %02X,", static_cast<unsigned char const *>(data)[byte_index]);
    }
-   putchar('\n');
 }
 
-struct KMTI_Context {
-   UINT32 node_ordinal;
-   void * command_buffer;
-   D3DDDI_ALLOCATIONLIST * allocation_list;
-   D3DDDI_PATCHLOCATIONLIST * patch_location_list;
-};
+// Flight recorder triggers
+
+// In ticks of KMTI_GetTimestamp, 0 if disabled.
+static uint64_t kmti_frame_time_trigger;
+static uint64_t kmti_render_stall_trigger;
+static std::atomic<uint64_t> kmti_last_frame_timestamp;
+
+static void KMTI_Trigger(KMTC_TriggerReason const reason, uint64_t const timestamp) {
+   KMTR_Trigger(reason, GetCurrentThreadId(), timestamp);
+}
+
+// Called for every presentation, triggering if the frame took too long.
+static void KMTI_EndFrame(uint64_t const timestamp) {
+   if (!kmti_frame_time_trigger) {
+      return;
+   }
+   uint64_t const last_frame_timestamp =
+      kmti_last_frame_timestamp.exchange(timestamp, std::memory_order_relaxed);
+   // Presentations on different threads may be timed in a different order.
+   if (last_frame_timestamp && timestamp > last_frame_timestamp &&
+       timestamp - last_frame_timestamp > kmti_frame_time_trigger) {
+      KMTI_Trigger(KMTC_TRIGGER_FRAME_TIME, timestamp);
+   }
+}
 
-static std::shared_mutex kmti_context_mutex;
-static std::unordered_map<D3DKMT_HANDLE, KMTI_Context> kmti_contexts;
+// Waits for the hotkey and the named event, forever.
+static void KMTI_TriggerThread(HANDLE const named_event) {
+   // The hotkey messages are posted to the thread registering it.
+   if (!RegisterHotKey(nullptr, 1, MOD_CONTROL | MOD_SHIFT | MOD_NOREPEAT, VK_F11)) {
+      std::fprintf(stderr, "Failed to register the flight recorder hotkey Ctrl+Shift+F11.\n");
+   }
+   DWORD const handle_count = named_event ? 1 : 0;
+   for (;;) {
+      DWORD const wait_result =
+         MsgWaitForMultipleObjects(handle_count, &named_event, FALSE, INFINITE, QS_HOTKEY);
+      if (handle_count && wait_result == WAIT_OBJECT_0) {
+         KMTI_Trigger(KMTC_TRIGGER_NAMED_EVENT, KMTI_GetTimestamp());
+      }
+      MSG message;
+      while (PeekMessage(&message, nullptr, WM_HOTKEY, WM_HOTKEY, PM_REMOVE)) {
+         KMTI_Trigger(KMTC_TRIGGER_HOTKEY, KMTI_GetTimestamp());
+      }
+   }
+}
+
+// Threshold in milliseconds from the environment variable, in ticks of KMTI_GetTimestamp.
+static uint64_t KMTI_GetTriggerThreshold(char const * const variable_name,
+                                         uint64_t const timestamp_frequency) {
+   char const * const variable = std::getenv(variable_name);
+   if (!variable) {
+      return 0;
+   }
+   return timestamp_frequency * uint64_t(std::strtoull(variable, nullptr, 0)) / 1000;
+}
 
 // D3DKMTEscape
 
@@ -45,20 +331,22 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDIEscape)(D3DKMT_ESCAPE *);
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDIEscape(D3DKMT_ESCAPE * const escape_data)
 {
-   printf("NtGdiDdDDIEscape @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hAdapter = 0x%X\n", escape_data->hAdapter);
-   printf("  > hDevice = 0x%X\n", escape_data->hDevice);
-   printf("  > Type = %u\n", escape_data->Type);
-   printf("  > Flags = 0x%08X\n", escape_data->Flags.Value);
-   KMTI_PrintArray("> pPrivateDriverData", escape_data->pPrivateDriverData,
-                   escape_data->PrivateDriverDataSize);
-   printf("  > PrivateDriverDataSize = 0x%X\n", escape_data->PrivateDriverDataSize);
-   printf("  > hContext = 0x%X\n", escape_data->hContext);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_Escape escape = {};
+   escape.adapter = escape_data->hAdapter;
+   escape.device = escape_data->hDevice;
+   escape.type = escape_data->Type;
+   escape.flags = escape_data->Flags.Value;
+   escape.context = escape_data->hContext;
+   escape.private_driver_data_size = escape_data->PrivateDriverDataSize;
+   std::vector<uint8_t> const private_driver_data_in =
+      KMTI_CopyBlob(escape_data->pPrivateDriverData, escape_data->PrivateDriverDataSize);
    NTSTATUS const status = Real_NtGdiDdDDIEscape(escape_data);
-   printf("    Status = 0x%08lX\n", status);
-   KMTI_PrintArray("< pPrivateDriverData", escape_data->pPrivateDriverData,
-                   escape_data->PrivateDriverDataSize);
-   putchar('\n');
+   KMTC_Blob const blobs[] = {
+      {private_driver_data_in.data(), escape.private_driver_data_size},
+      {escape_data->pPrivateDriverData, escape.private_driver_data_size},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_ESCAPE, timestamp, status), escape, blobs);
    return status;
 }
 
@@ -69,18 +357,25 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDIQueryAdapterInfo)(D3DKMT_QUERYADAPTER
 static NTSTATUS APIENTRY Catch_NtGdiDdDDIQueryAdapterInfo(
    D3DKMT_QUERYADAPTERINFO * const query_adapter_info_data)
 {
-   printf("NtGdiDdDDIQueryAdapterInfo @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hAdapter = 0x%X\n", query_adapter_info_data->hAdapter);
-   printf("  > Type = %u\n", query_adapter_info_data->Type);
-   KMTI_PrintArray("> pPrivateDriverData", query_adapter_info_data->pPrivateDriverData,
-                   query_adapter_info_data->PrivateDriverDataSize);
-   printf("  > PrivateDriverDataSize = 0x%X\n", query_adapter_info_data->PrivateDriverDataSize);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_QueryAdapterInfo query_adapter_info = {};
+   query_adapter_info.adapter = query_adapter_info_data->hAdapter;
+   query_adapter_info.type = query_adapter_info_data->Type;
+   query_adapter_info.private_driver_data_size_in =
+      query_adapter_info_data->PrivateDriverDataSize;
+   std::vector<uint8_t> const private_driver_data_in =
+      KMTI_CopyBlob(query_adapter_info_data->pPrivateDriverData,
+                    query_adapter_info_data->PrivateDriverDataSize);
    NTSTATUS const status = Real_NtGdiDdDDIQueryAdapterInfo(query_adapter_info_data);
-   printf("    Status = 0x%08lX\n", status);
-   KMTI_PrintArray("< pPrivateDriverData", query_adapter_info_data->pPrivateDriverData,
-                   query_adapter_info_data->PrivateDriverDataSize);
-   printf("  < PrivateDriverDataSize = 0x%X\n", query_adapter_info_data->PrivateDriverDataSize);
-   putchar('\n');
+   query_adapter_info.private_driver_data_size_out =
+      query_adapter_info_data->PrivateDriverDataSize;
+   KMTC_Blob const blobs[] = {
+      {private_driver_data_in.data(), query_adapter_info.private_driver_data_size_in},
+      {query_adapter_info_data->pPrivateDriverData,
+       query_adapter_info.private_driver_data_size_in},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_QUERY_ADAPTER_INFO, timestamp, status),
+                   query_adapter_info, blobs);
    return status;
 }
 
@@ -90,21 +385,21 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDICreateDevice)(D3DKMT_CREATEDEVICE *);
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDICreateDevice(
    D3DKMT_CREATEDEVICE * const create_device_data) {
-   printf("NtGdiDdDDICreateDevice @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hAdapter = 0x%X\n", create_device_data->hAdapter);
-   printf("  > Flags.LegacyMode = %u\n", create_device_data->Flags.LegacyMode);
-   printf("  > Flags.RequestVSync = %u\n", create_device_data->Flags.RequestVSync);
-   printf("  > Flags.DisableGpuTimeout = %u\n", create_device_data->Flags.DisableGpuTimeout);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_CreateDevice create_device = {};
+   create_device.adapter = create_device_data->hAdapter;
+   create_device.flags = KMTI_FlagsToUint32(create_device_data->Flags);
    NTSTATUS const status = Real_NtGdiDdDDICreateDevice(create_device_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < hDevice = 0x%X\n", create_device_data->hDevice);
-   printf("  < pCommandBuffer = 0x%p\n", create_device_data->pCommandBuffer);
-   printf("  < CommandBufferSize = 0x%X\n", create_device_data->CommandBufferSize);
-   printf("  < pAllocationList = 0x%p\n", create_device_data->pAllocationList);
-   printf("  < AllocationListSize = 0x%X\n", create_device_data->AllocationListSize);
-   printf("  < pPatchLocationList = 0x%p\n", create_device_data->pPatchLocationList);
-   printf("  < PatchLocationListSize = 0x%X\n", create_device_data->PatchLocationListSize);
-   putchar('\n');
+   create_device.device = create_device_data->hDevice;
+   create_device.command_buffer_size = create_device_data->CommandBufferSize;
+   create_device.allocation_list_size = create_device_data->AllocationListSize;
+   create_device.patch_location_list_size = create_device_data->PatchLocationListSize;
+   create_device.command_buffer = KMTI_PointerToUint64(create_device_data->pCommandBuffer);
+   create_device.allocation_list = KMTI_PointerToUint64(create_device_data->pAllocationList);
+   create_device.patch_location_list =
+      KMTI_PointerToUint64(create_device_data->pPatchLocationList);
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_CREATE_DEVICE, timestamp, status),
+                   create_device);
    return status;
 }
 
@@ -115,15 +410,18 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDICreateSynchronizationObject)(
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDICreateSynchronizationObject(
    D3DKMT_CREATESYNCHRONIZATIONOBJECT2 * const create_synchronization_object_data) {
-   printf("NtGdiDdDDICreateSynchronizationObject @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hDevice = 0x%X\n", create_synchronization_object_data->hDevice);
-   printf("  > Info.Type = %u\n", create_synchronization_object_data->Info.Type);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_CreateSynchronizationObject create_synchronization_object = {};
+   create_synchronization_object.device = create_synchronization_object_data->hDevice;
+   create_synchronization_object.type_in = create_synchronization_object_data->Info.Type;
    NTSTATUS const status =
       Real_NtGdiDdDDICreateSynchronizationObject(create_synchronization_object_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < Info.Type = %u\n", create_synchronization_object_data->Info.Type);
-   printf("  < hSyncObject = 0x%X\n", create_synchronization_object_data->hSyncObject);
-   putchar('\n');
+   create_synchronization_object.type_out = create_synchronization_object_data->Info.Type;
+   create_synchronization_object.synchronization_object =
+      create_synchronization_object_data->hSyncObject;
+   KMTI_WriteEvent(
+      KMTI_MakeEventHeader(KMTC_EVENT_CREATE_SYNCHRONIZATION_OBJECT, timestamp, status),
+      create_synchronization_object);
    return status;
 }
 
@@ -133,68 +431,68 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDICreateAllocation)(D3DKMT_CREATEALLOCA
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDICreateAllocation(
    D3DKMT_CREATEALLOCATION * const create_allocation_data) {
-   printf("NtGdiDdDDICreateAllocation @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hDevice = 0x%X\n", create_allocation_data->hDevice);
-   printf("  > hResource = 0x%X\n", create_allocation_data->hResource);
-   KMTI_PrintArray("> pPrivateRuntimeData", create_allocation_data->pPrivateRuntimeData,
-                   create_allocation_data->PrivateRuntimeDataSize);
-   printf("  > PrivateRuntimeDataSize = 0x%X\n", create_allocation_data->PrivateRuntimeDataSize);
-   KMTI_PrintArray("> pPrivateDriverData", create_allocation_data->pPrivateDriverData,
-                   create_allocation_data->PrivateDriverDataSize);
-   printf("  > PrivateDriverDataSize = 0x%X\n", create_allocation_data->PrivateDriverDataSize);
-   printf("  > NumAllocations = %u\n", create_allocation_data->NumAllocations);
-   puts("  > pAllocationInfo2:");
-   for (UINT allocation_index = 0; allocation_index < create_allocation_data->NumAllocations;
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_CreateAllocation create_allocation = {};
+   create_allocation.device = create_allocation_data->hDevice;
+   create_allocation.resource_in = create_allocation_data->hResource;
+   create_allocation.private_runtime_data_size = create_allocation_data->PrivateRuntimeDataSize;
+   create_allocation.private_driver_data_size = create_allocation_data->PrivateDriverDataSize;
+   create_allocation.allocation_count = create_allocation_data->NumAllocations;
+   create_allocation.flags = KMTI_FlagsToUint32(create_allocation_data->Flags);
+   create_allocation.private_runtime_resource_handle_in =
+      KMTI_PointerToUint64(create_allocation_data->hPrivateRuntimeResourceHandle);
+   std::vector<std::vector<uint8_t>> allocation_private_driver_data_in;
+   allocation_private_driver_data_in.reserve(create_allocation.allocation_count);
+   for (UINT allocation_index = 0; allocation_index < create_allocation.allocation_count;
         ++allocation_index) {
-      printf("    [%u]:\n", allocation_index);
-      D3DDDI_ALLOCATIONINFO2 const * const allocation_info =
-         &create_allocation_data->pAllocationInfo2[allocation_index];
-      printf("      hSection = 0x%p\n", allocation_info->hSection);
-      KMTI_PrintArray("    pPrivateDriverData", allocation_info->pPrivateDriverData,
-                      allocation_info->PrivateDriverDataSize);
-      printf("      PrivateDriverDataSize = 0x%X\n", allocation_info->PrivateDriverDataSize);
-      printf("      VidPnSourceId = 0x%X\n", allocation_info->VidPnSourceId);
-      printf("      Flags.Primary = %u\n", allocation_info->Flags.Primary);
-      printf("      Flags.Stereo = %u\n", allocation_info->Flags.Stereo);
+      D3DDDI_ALLOCATIONINFO2 const & allocation_info =
+         create_allocation_data->pAllocationInfo2[allocation_index];
+      allocation_private_driver_data_in.push_back(KMTI_CopyBlob(
+         allocation_info.pPrivateDriverData, allocation_info.PrivateDriverDataSize));
    }
-   printf("  > Flags.CreateResource = %u\n", create_allocation_data->Flags.CreateResource);
-   printf("  > Flags.CreateShared = %u\n", create_allocation_data->Flags.CreateShared);
-   printf("  > Flags.NonSecure = %u\n", create_allocation_data->Flags.NonSecure);
-   printf("  > Flags.CreateProtected (KM) = %u\n", create_allocation_data->Flags.CreateProtected);
-   printf("  > Flags.RestrictSharedAccess = %u\n",
-          create_allocation_data->Flags.RestrictSharedAccess);
-   printf("  > Flags.ExistingSysMem (KM) = %u\n", create_allocation_data->Flags.ExistingSysMem);
-   printf("  > Flags.NtSecuritySharing = %u\n", create_allocation_data->Flags.NtSecuritySharing);
-   printf("  > Flags.ReadOnly = %u\n", create_allocation_data->Flags.ReadOnly);
-   printf("  > Flags.CreateWriteCombined (KM) = %u\n",
-          create_allocation_data->Flags.CreateWriteCombined);
-   printf("  > Flags.CreateCached (KM) = %u\n", create_allocation_data->Flags.CreateCached);
-   printf("  > Flags.SwapChainBackBuffer = %u\n",
-          create_allocation_data->Flags.SwapChainBackBuffer);
-   printf("  > Flags.CrossAdapter = %u\n", create_allocation_data->Flags.CrossAdapter);
-   printf("  > Flags.OpenCrossAdapter (KM) = %u\n", create_allocation_data->Flags.OpenCrossAdapter);
-   printf("  > Flags.PartialSharedCreation = %u\n",
-          create_allocation_data->Flags.PartialSharedCreation);
-   printf("  > Flags.WriteWatch = %u\n", create_allocation_data->Flags.WriteWatch);
-   printf("  > hPrivateRuntimeResourceHandle = 0x%p\n",
-          create_allocation_data->hPrivateRuntimeResourceHandle);
    NTSTATUS const status = Real_NtGdiDdDDICreateAllocation(create_allocation_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < hResource = 0x%X\n", create_allocation_data->hResource);
-   printf("  < hGlobalShare = 0x%X\n", create_allocation_data->hGlobalShare);
-   puts("  < pAllocationInfo2:");
-   for (UINT allocation_index = 0; allocation_index < create_allocation_data->NumAllocations;
+   create_allocation.resource_out = create_allocation_data->hResource;
+   create_allocation.global_share = create_allocation_data->hGlobalShare;
+   create_allocation.private_runtime_resource_handle_out =
+      KMTI_PointerToUint64(create_allocation_data->hPrivateRuntimeResourceHandle);
+   std::vector<KMTC_AllocationInfo> allocation_infos(create_allocation.allocation_count);
+   std::vector<KMTC_Blob> blobs;
+   blobs.reserve(3 + 2 * std::size_t(create_allocation.allocation_count));
+   blobs.push_back({create_allocation_data->pPrivateRuntimeData,
+                    create_allocation.private_runtime_data_size});
+   blobs.push_back({create_allocation_data->pPrivateDriverData,
+                    create_allocation.private_driver_data_size});
+   blobs.push_back({allocation_infos.data(),
+                    uint32_t(sizeof(KMTC_AllocationInfo) * allocation_infos.size())});
+   for (UINT allocation_index = 0; allocation_index < create_allocation.allocation_count;
         ++allocation_index) {
-      printf("    [%u]:\n", allocation_index);
-      D3DDDI_ALLOCATIONINFO2 const * const allocation_info =
-         &create_allocation_data->pAllocationInfo2[allocation_index];
-      printf("      hAllocation = 0x%X\n", allocation_info->hAllocation);
-      KMTI_PrintArray("    pPrivateDriverData", allocation_info->pPrivateDriverData,
-                      allocation_info->PrivateDriverDataSize);
+      D3DDDI_ALLOCATIONINFO2 const & allocation_info =
+         create_allocation_data->pAllocationInfo2[allocation_index];
+      KMTC_AllocationInfo & captured_allocation_info = allocation_infos[allocation_index];
+      captured_allocation_info.allocation = allocation_info.hAllocation;
+      captured_allocation_info.private_driver_data_size = allocation_info.PrivateDriverDataSize;
+      captured_allocation_info.vidpn_source_id = allocation_info.VidPnSourceId;
+      captured_allocation_info.flags = KMTI_FlagsToUint32(allocation_info.Flags);
+      captured_allocation_info.section = KMTI_PointerToUint64(allocation_info.hSection);
+      blobs.push_back({allocation_private_driver_data_in[allocation_index].data(),
+                       allocation_info.PrivateDriverDataSize});
+      blobs.push_back(
+         {allocation_info.pPrivateDriverData, allocation_info.PrivateDriverDataSize});
+   }
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_CREATE_ALLOCATION, timestamp, status),
+                   &create_allocation, uint32_t(sizeof(create_allocation)), blobs.data(),
+                   uint32_t(blobs.size()));
+   if (status == 0) {
+      for (UINT allocation_index = 0; allocation_index < create_allocation.allocation_count;
+           ++allocation_index) {
+         KMTC_AllocationInfo const & allocation_info = allocation_infos[allocation_index];
+         KMTA_AddAllocation(
+            allocation_info.allocation, create_allocation.device, create_allocation.resource_out,
+            allocation_info.flags, allocation_info.vidpn_source_id,
+            create_allocation_data->pAllocationInfo2[allocation_index].pPrivateDriverData,
+            allocation_info.private_driver_data_size, timestamp);
+      }
    }
-   printf("  < hPrivateRuntimeResourceHandle = 0x%p\n",
-          create_allocation_data->hPrivateRuntimeResourceHandle);
-   putchar('\n');
    return status;
 }
 
@@ -202,31 +500,60 @@ static NTSTATUS APIENTRY Catch_NtGdiDdDDICreateAllocation(
 
 static NTSTATUS (APIENTRY * Real_NtGdiDdDDILock)(D3DKMT_LOCK *);
 
-static NTSTATUS APIENTRY Catch_NtGdiDdDDILock(D3DKMT_LOCK * const lock_data) {
-   printf("NtGdiDdDDILock @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hDevice = 0x%X\n", lock_data->hDevice);
-   printf("  > hAllocation = 0x%X\n", lock_data->hAllocation);
-   printf("  > PrivateDriverData = 0x%X\n", lock_data->PrivateDriverData);
-   printf("  > NumPages = %u\n", lock_data->NumPages);
-   for (UINT page_index = 0; page_index < lock_data->NumPages; ++page_index) {
-      printf("    [0x%X] = 0x%X\n", page_index, lock_data->pPages[page_index]);
+// The kernel doesn't return the size of the locked allocation, so it's the size of the pages
+// mapped from the data with the same attributes, which can only be smaller.
+static uint64_t KMTI_GetMappedSize(void const * const data) {
+   MEMORY_BASIC_INFORMATION information;
+   if (!data || !VirtualQuery(data, &information, sizeof(information)) ||
+       information.State != MEM_COMMIT) {
+      return 0;
    }
-   printf("  > Flags.ReadOnly = %u\n", lock_data->Flags.ReadOnly);
-   printf("  > Flags.WriteOnly = %u\n", lock_data->Flags.WriteOnly);
-   printf("  > Flags.DonotWait = %u\n", lock_data->Flags.DonotWait);
-   printf("  > Flags.IgnoreSync = %u\n", lock_data->Flags.IgnoreSync);
-   printf("  > Flags.LockEntire = %u\n", lock_data->Flags.LockEntire);
-   printf("  > Flags.DonotEvict = %u\n", lock_data->Flags.DonotEvict);
-   printf("  > Flags.AcquireAperture = %u\n", lock_data->Flags.AcquireAperture);
-   printf("  > Flags.Discard = %u\n", lock_data->Flags.Discard);
-   printf("  > Flags.NoExistingReference = %u\n", lock_data->Flags.NoExistingReference);
-   printf("  > Flags.UseAlternateVA = %u\n", lock_data->Flags.UseAlternateVA);
-   printf("  > Flags.IgnoreReadSync = %u\n", lock_data->Flags.IgnoreReadSync);
+   return uint64_t(information.RegionSize) -
+          (reinterpret_cast<uintptr_t>(data) -
+           reinterpret_cast<uintptr_t>(information.BaseAddress));
+}
+
+static NTSTATUS APIENTRY Catch_NtGdiDdDDILock(D3DKMT_LOCK * const lock_data) {
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_Lock lock = {};
+   lock.device = lock_data->hDevice;
+   lock.allocation = lock_data->hAllocation;
+   lock.private_driver_data = lock_data->PrivateDriverData;
+   lock.page_count = lock_data->NumPages;
+   lock.flags = lock_data->Flags.Value;
    NTSTATUS const status = Real_NtGdiDdDDILock(lock_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < pData = 0x%p\n", lock_data->pData);
-   printf("  < GpuVirtualAddress = 0x%llX\n", lock_data->GpuVirtualAddress);
-   putchar('\n');
+   lock.data = KMTI_PointerToUint64(lock_data->pData);
+   lock.gpu_virtual_address = lock_data->GpuVirtualAddress;
+   KMTC_Blob const blobs[] = {
+      {lock_data->pPages, uint32_t(sizeof(UINT) * lock.page_count)},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_LOCK, timestamp, status), lock, blobs);
+   if (status == 0) {
+      KMTA_SetLocked(lock_data->hAllocation, lock_data->pData,
+                     KMTI_GetMappedSize(lock_data->pData), lock_data->GpuVirtualAddress);
+   }
+   return status;
+}
+
+// D3DKMTUnlock
+
+static NTSTATUS (APIENTRY * Real_NtGdiDdDDIUnlock)(D3DKMT_UNLOCK const *);
+
+static NTSTATUS APIENTRY Catch_NtGdiDdDDIUnlock(D3DKMT_UNLOCK const * const unlock_data) {
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_Unlock unlock = {};
+   unlock.device = unlock_data->hDevice;
+   unlock.allocation_count = unlock_data->NumAllocations;
+   // The mappings stop being read before they may become invalid.
+   for (uint32_t allocation_index = 0; allocation_index < unlock.allocation_count;
+        ++allocation_index) {
+      KMTA_SetUnlocked(unlock_data->phAllocations[allocation_index]);
+   }
+   NTSTATUS const status = Real_NtGdiDdDDIUnlock(unlock_data);
+   KMTC_Blob const blobs[] = {
+      {unlock_data->phAllocations, uint32_t(sizeof(D3DKMT_HANDLE) * unlock.allocation_count)},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_UNLOCK, timestamp, status), unlock, blobs);
    return status;
 }
 
@@ -248,38 +575,47 @@ struct KMTI_ContextPrivateDriverData {
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDICreateContext(
    D3DKMT_CREATECONTEXT * const create_context_data) {
-   printf("NtGdiDdDDICreateContext @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hDevice = 0x%X\n", create_context_data->hDevice);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_CreateContext create_context = {};
+   create_context.device = create_context_data->hDevice;
    // 0 - GFX?
    // 1 - SDMA?
-   printf("  > NodeOrdinal = %u\n", create_context_data->NodeOrdinal);
+   create_context.node_ordinal = create_context_data->NodeOrdinal;
    // 0x1.
-   printf("  > EngineAffinity = 0x%X\n", create_context_data->EngineAffinity);
-   printf("  > Flags = 0x%X\n", create_context_data->Flags.Value);
-   KMTI_PrintArray("> pPrivateDriverData", create_context_data->pPrivateDriverData,
-                   create_context_data->PrivateDriverDataSize);
-   printf("  > PrivateDriverDataSize = 0x%X\n", create_context_data->PrivateDriverDataSize);
+   create_context.engine_affinity = create_context_data->EngineAffinity;
+   create_context.flags = create_context_data->Flags.Value;
+   create_context.private_driver_data_size = create_context_data->PrivateDriverDataSize;
    // The Direct3D 11 driver passes 10 (Direct3D 10).
-   printf("  > ClientHint = %u\n", create_context_data->ClientHint);
+   create_context.client_hint = create_context_data->ClientHint;
+   std::vector<uint8_t> const private_driver_data_in =
+      KMTI_CopyBlob(create_context_data->pPrivateDriverData,
+                    create_context_data->PrivateDriverDataSize);
    NTSTATUS const status = Real_NtGdiDdDDICreateContext(create_context_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < hContext = 0x%X\n", create_context_data->hContext);
-   printf("  < pCommandBuffer = 0x%p\n", create_context_data->pCommandBuffer);
-   printf("  < CommandBufferSize = 0x%X\n", create_context_data->CommandBufferSize);
-   printf("  < pAllocationList = 0x%p\n", create_context_data->pAllocationList);
-   printf("  < AllocationListSize = 0x%X\n", create_context_data->AllocationListSize);
-   printf("  < pPatchLocationList = 0x%p\n", create_context_data->pPatchLocationList);
-   printf("  < PatchLocationListSize = 0x%X\n", create_context_data->PatchLocationListSize);
-   printf("  < CommandBuffer = 0x%llX\n", create_context_data->CommandBuffer);
-   putchar('\n');
+   create_context.context = create_context_data->hContext;
+   create_context.command_buffer_size = create_context_data->CommandBufferSize;
+   create_context.allocation_list_size = create_context_data->AllocationListSize;
+   create_context.patch_location_list_size = create_context_data->PatchLocationListSize;
+   create_context.command_buffer_pointer =
+      KMTI_PointerToUint64(create_context_data->pCommandBuffer);
+   create_context.allocation_list = KMTI_PointerToUint64(create_context_data->pAllocationList);
+   create_context.patch_location_list =
+      KMTI_PointerToUint64(create_context_data->pPatchLocationList);
+   create_context.command_buffer = create_context_data->CommandBuffer;
+   KMTC_Blob const blobs[] = {
+      {private_driver_data_in.data(), create_context.private_driver_data_size},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_CREATE_CONTEXT, timestamp, status),
+                   create_context, blobs);
    if (status == 0) {
-      std::unique_lock<std::shared_mutex> context_lock(kmti_context_mutex);
-      KMTI_Context & context =
-         kmti_contexts.emplace(create_context_data->hContext, KMTI_Context()).first->second;
+      KMTX_Context context;
       context.node_ordinal = create_context_data->NodeOrdinal;
       context.command_buffer = create_context_data->pCommandBuffer;
       context.allocation_list = create_context_data->pAllocationList;
       context.patch_location_list = create_context_data->pPatchLocationList;
+      if (!KMTX_AddContext(create_context_data->hContext, context)) {
+         std::fprintf(stderr, "Too many contexts, submissions to %u will lack the buffers.\n",
+                      unsigned(create_context_data->hContext));
+      }
    }
    return status;
 }
@@ -292,13 +628,15 @@ static NTSTATUS (APIENTRY * Real_NtGdiDdDDISetContextSchedulingPriority)(
 static NTSTATUS APIENTRY Catch_NtGdiDdDDISetContextSchedulingPriority(
    D3DKMT_SETCONTEXTSCHEDULINGPRIORITY const * const set_scheduling_priority_data)
 {
-   printf("NtGdiDdDDISetContextSchedulingPriority @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hContext = 0x%X\n", set_scheduling_priority_data->hContext);
-   printf("  > Priority = %d\n", set_scheduling_priority_data->Priority);
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   KMTC_SetContextSchedulingPriority set_scheduling_priority = {};
+   set_scheduling_priority.context = set_scheduling_priority_data->hContext;
+   set_scheduling_priority.priority = set_scheduling_priority_data->Priority;
    NTSTATUS const status =
       Real_NtGdiDdDDISetContextSchedulingPriority(set_scheduling_priority_data);
-   printf("    Status = 0x%08lX\n", status);
-   putchar('\n');
+   KMTI_WriteEvent(
+      KMTI_MakeEventHeader(KMTC_EVENT_SET_CONTEXT_SCHEDULING_PRIORITY, timestamp, status),
+      set_scheduling_priority);
    return status;
 }
 
@@ -307,96 +645,173 @@ static NTSTATUS APIENTRY Catch_NtGdiDdDDISetContextSchedulingPriority(
 static NTSTATUS (APIENTRY * Real_NtGdiDdDDIRender)(D3DKMT_RENDER *);
 
 static NTSTATUS APIENTRY Catch_NtGdiDdDDIRender(D3DKMT_RENDER * const render_data) {
-   std::optional<KMTI_Context> context;
+   uint64_t const timestamp = KMTI_GetTimestamp();
+   std::optional<KMTX_Context> context;
    {
-      std::shared_lock<std::shared_mutex> context_lock(kmti_context_mutex);
-      auto const context_iterator = kmti_contexts.find(render_data->hContext);
-      if (context_iterator != kmti_contexts.end()) {
-         context = context_iterator->second;
+      KMTX_Context found_context;
+      if (KMTX_FindContext(render_data->hContext, found_context)) {
+         context = found_context;
       }
    }
-   printf("NtGdiDdDDIRender @ %" PRIu32 ":\n", GetThreadId(GetCurrentThread()));
-   printf("  > hContext = 0x%X\n", render_data->hContext);
-   printf("  > CommandOffset = 0x%X\n", render_data->CommandOffset);
-   printf("  > CommandLength = 0x%X\n", render_data->CommandLength);
-   if (context) {
-      void const * const command =
-         static_cast<char const *>(context->command_buffer) + render_data->CommandOffset;
-      KMTI_PrintArray("> pCommandBuffer", command, render_data->CommandLength);
-      if (context->node_ordinal == 0) {
-         PM4P_Print(static_cast<uint32_t const *>(command),
-                    render_data->CommandLength / sizeof(uint32_t), false);
-      }
+   KMTC_Render render = {};
+   render.context = render_data->hContext;
+   render.node_ordinal = context ? context->node_ordinal : KMTC_NODE_ORDINAL_UNKNOWN;
+   render.command_offset = render_data->CommandOffset;
+   render.command_length = render_data->CommandLength;
+   render.allocation_count = render_data->AllocationCount;
+   render.patch_location_count = render_data->PatchLocationCount;
+   render.new_command_buffer_size_in = render_data->NewCommandBufferSize;
+   render.new_allocation_list_size_in = render_data->NewAllocationListSize;
+   render.new_patch_location_list_size_in = render_data->NewPatchLocationListSize;
+   render.flags = KMTI_FlagsToUint32(render_data->Flags);
+   render.present_history_token = render_data->PresentHistoryToken;
+   render.broadcast_context_count =
+      std::min(uint32_t(render_data->BroadcastContextCount),
+               uint32_t(sizeof(render_data->BroadcastContext) /
+                        sizeof(render_data->BroadcastContext[0])));
+   render.private_driver_data_size = render_data->PrivateDriverDataSize;
+   // The submitted buffers are not modified by the call, so they're captured after it together
+   // with the results.
+   if (render_data->Flags.PresentRedirected) {
+      KMTI_EndFrame(timestamp);
    }
-   printf("  > AllocationCount = %u\n", render_data->AllocationCount);
-   if (context) {
-      for (UINT allocation_index = 0; allocation_index < render_data->AllocationCount;
-           ++allocation_index) {
-         D3DDDI_ALLOCATIONLIST const & allocation = context->allocation_list[allocation_index];
-         printf("    [%u] = 0x%X, flags %X\n", allocation_index, allocation.hAllocation,
-                allocation.Value);
-      }
+   NTSTATUS const status = Real_NtGdiDdDDIRender(render_data);
+   bool const is_stall =
+      kmti_render_stall_trigger && KMTI_GetTimestamp() - timestamp > kmti_render_stall_trigger;
+   render.new_command_buffer_size_out = render_data->NewCommandBufferSize;
+   render.new_allocation_list_size_out = render_data->NewAllocationListSize;
+   render.new_patch_location_list_size_out = render_data->NewPatchLocationListSize;
+   render.queued_buffer_count = render_data->QueuedBufferCount;
+   render.new_command_buffer_pointer = KMTI_PointerToUint64(render_data->pNewCommandBuffer);
+   render.new_allocation_list = KMTI_PointerToUint64(render_data->pNewAllocationList);
+   render.new_patch_location_list = KMTI_PointerToUint64(render_data->pNewPatchLocationList);
+   render.new_command_buffer = render_data->NewCommandBuffer;
+   char const * const command_buffer =
+      context ? static_cast<char const *>(context->command_buffer) + render.command_offset
+              : nullptr;
+   uint32_t const chunk_size = KMTD_GetChunkSize();
+   // Kept allocated for the next submissions of the thread.
+   static thread_local std::vector<uint32_t> chunk_ids;
+   chunk_ids.clear();
+   if (context && chunk_size) {
+      KMTI_WriteChunks(command_buffer, render.command_length, chunk_size, timestamp, chunk_ids);
    }
-   printf("  > PatchLocationCount = %u\n", render_data->PatchLocationCount);
-   if (context) {
-      for (UINT patch_location_index = 0; patch_location_index < render_data->PatchLocationCount;
-           ++patch_location_index) {
-         D3DDDI_PATCHLOCATIONLIST const & patch_location =
-            context->patch_location_list[patch_location_index];
-         printf(
-            "    [%u] = allocation %u, slot 0x%X << 10 | 0x%X (0x%X), driver ID 0x%X, allocation "
-            "offset 0x%X, patch offset 0x%X, split offset 0x%X\n",
-            patch_location_index, patch_location.AllocationIndex, patch_location.SlotId >> 10,
-            patch_location.SlotId & ((UINT(1) << 10) - 1), patch_location.SlotId,
-            patch_location.DriverId, patch_location.AllocationOffset, patch_location.PatchOffset,
-            patch_location.SplitOffset);
-      }
+   if (context && context->node_ordinal == 0) {
+      KMTI_WriteIndirectBufferData(reinterpret_cast<uint32_t const *>(command_buffer),
+                                   render.command_offset, render.command_length,
+                                   static_cast<D3DDDI_ALLOCATIONLIST const *>(
+                                      context->allocation_list),
+                                   render.allocation_count,
+                                   static_cast<D3DDDI_PATCHLOCATIONLIST const *>(
+                                      context->patch_location_list),
+                                   render.patch_location_count,
+                                   timestamp);
    }
-   printf("  > NewCommandBufferSize = 0x%X\n", render_data->NewCommandBufferSize);
-   printf("  > NewAllocationListSize = 0x%X\n", render_data->NewAllocationListSize);
-   printf("  > NewPatchLocationListSize = 0x%X\n", render_data->NewPatchLocationListSize);
-   printf("  > Flags.ResizeCommandBuffer = %u\n", render_data->Flags.ResizeCommandBuffer);
-   printf("  > Flags.ResizeAllocationList = %u\n", render_data->Flags.ResizeAllocationList);
-   printf("  > Flags.ResizePatchLocationList = %u\n", render_data->Flags.ResizePatchLocationList);
-   printf("  > Flags.NullRendering = %u\n", render_data->Flags.NullRendering);
-   printf("  > Flags.PresentRedirected = %u\n", render_data->Flags.PresentRedirected);
-   printf("  > Flags.RenderKm = %u\n", render_data->Flags.RenderKm);
-   printf("  > Flags.RenderKmReadback = %u\n", render_data->Flags.RenderKmReadback);
-   printf("  > PresentHistoryToken = 0x%llX\n", render_data->PresentHistoryToken);
-   printf("  > BroadcastContextCount = %lu\n", render_data->BroadcastContextCount);
-   for (ULONG broadcast_context_index = 0;
-        broadcast_context_index < render_data->BroadcastContextCount; ++broadcast_context_index) {
-      printf("  > BroadcastContext[%lu] = 0x%X\n", broadcast_context_index,
-             render_data->BroadcastContext[broadcast_context_index]);
+   KMTC_Blob const blobs[] = {
+      chunk_size ? KMTC_Blob{chunk_ids.data(), uint32_t(sizeof(uint32_t) * chunk_ids.size())}
+                 : KMTC_Blob{command_buffer, context ? render.command_length : 0},
+      {context ? context->allocation_list : nullptr,
+       context ? uint32_t(sizeof(D3DDDI_ALLOCATIONLIST) * render.allocation_count) : 0},
+      {context ? context->patch_location_list : nullptr,
+       context ? uint32_t(sizeof(D3DDDI_PATCHLOCATIONLIST) * render.patch_location_count) : 0},
+      {render_data->BroadcastContext,
+       uint32_t(sizeof(D3DKMT_HANDLE) * render.broadcast_context_count)},
+      {render_data->pPrivateDriverData, render.private_driver_data_size},
+   };
+   KMTI_WriteEvent(KMTI_MakeEventHeader(KMTC_EVENT_RENDER, timestamp, status), render, blobs);
+   if (status == 0 && context) {
+      KMTX_SetBuffers(render_data->hContext, render_data->pNewCommandBuffer,
+                      render_data->pNewAllocationList, render_data->pNewPatchLocationList);
    }
-   KMTI_PrintArray("> pPrivateDriverData", render_data->pPrivateDriverData,
-                   render_data->PrivateDriverDataSize);
-   printf("  > PrivateDriverDataSize = 0x%X\n", render_data->PrivateDriverDataSize);
-   NTSTATUS const status = Real_NtGdiDdDDIRender(render_data);
-   printf("    Status = 0x%08lX\n", status);
-   printf("  < pNewCommandBuffer = 0x%p\n", render_data->pNewCommandBuffer);
-   printf("  < NewCommandBufferSize = 0x%X\n", render_data->NewCommandBufferSize);
-   printf("  < pNewAllocationList = 0x%p\n", render_data->pNewAllocationList);
-   printf("  < NewAllocationListSize = 0x%X\n", render_data->NewAllocationListSize);
-   printf("  < pNewPatchLocationList = 0x%p\n", render_data->pNewPatchLocationList);
-   printf("  < NewPatchLocationListSize = 0x%X\n", render_data->NewPatchLocationListSize);
-   printf("  < QueuedBufferCount = %lu\n", render_data->QueuedBufferCount);
-   printf("  < NewCommandBuffer = 0x%llX\n", render_data->NewCommandBuffer);
-   putchar('\n');
-   if (status == 0) {
-      std::unique_lock<std::shared_mutex> context_lock(kmti_context_mutex);
-      auto const context_iterator = kmti_contexts.find(render_data->hContext);
-      if (context_iterator != kmti_contexts.end()) {
-         KMTI_Context & update_context = context_iterator->second;
-         update_context.command_buffer = render_data->pNewCommandBuffer;
-         update_context.allocation_list = render_data->pNewAllocationList;
-         update_context.patch_location_list = render_data->pNewPatchLocationList;
-      }
+   // After writing the event so the dump includes the stalled submission.
+   if (is_stall) {
+      KMTI_Trigger(KMTC_TRIGGER_RENDER_STALL, timestamp);
    }
    return status;
 }
 
+// D3DKMTPresent
+
+static NTSTATUS (APIENTRY * Real_NtGdiDdDDIPresent)(D3DKMT_PRESENT *);
+
+// Not captured, only timed for the flight recorder.
+static NTSTATUS APIENTRY Catch_NtGdiDdDDIPresent(D3DKMT_PRESENT * const present_data) {
+   KMTI_EndFrame(KMTI_GetTimestamp());
+   return Real_NtGdiDdDDIPresent(present_data);
+}
+
+static void KMTI_End() {
+   KMTR_End();
+   KMTX_End();
+   KMTD_End();
+   KMTA_End();
+   if (kmti_capture_file) {
+      std::fclose(kmti_capture_file);
+      kmti_capture_file = nullptr;
+   }
+}
+
 void KMTI_Begin() {
+   char const * capture_path = std::getenv("CATANALYST_CAPTURE");
+   if (!capture_path) {
+      capture_path = "Catanalyst.kmtc";
+   }
+   kmti_capture_file = std::fopen(capture_path, "wb");
+   if (!kmti_capture_file) {
+      std::fprintf(stderr, "Failed to open the capture file %s.\n", capture_path);
+   } else {
+      LARGE_INTEGER frequency;
+      QueryPerformanceFrequency(&frequency);
+      KMTC_FileHeader file_header = {};
+      file_header.magic = KMTC_MAGIC;
+      file_header.version = KMTC_VERSION;
+      file_header.header_size = sizeof(file_header);
+      // Nonzero to keep this many bytes of the latest events in memory and write them only when
+      // triggered instead of capturing continuously.
+      std::size_t flight_size = 0;
+      if (char const * const flight_size_variable = std::getenv("CATANALYST_FLIGHT_SIZE")) {
+         flight_size = std::size_t(std::strtoull(flight_size_variable, nullptr, 0));
+      }
+      // Deduplicated in chunks of 4 KB by default, 0 stores the command buffers in the submissions.
+      // The flight recorder forgets events, including the chunks that later submissions may refer
+      // to, so it always stores the command buffers in the submissions.
+      uint32_t chunk_size = 4096;
+      if (char const * const chunk_size_variable = std::getenv("CATANALYST_CHUNK_SIZE")) {
+         chunk_size = uint32_t(std::strtoul(chunk_size_variable, nullptr, 0));
+      }
+      if (flight_size) {
+         chunk_size = 0;
+      }
+      kmti_is_allocation_data_deduplicated = !flight_size;
+      file_header.chunk_size = chunk_size & ~uint32_t(KMTC_ALIGNMENT - 1);
+      file_header.timestamp_frequency = uint64_t(frequency.QuadPart);
+      std::fwrite(&file_header, sizeof(file_header), 1, kmti_capture_file);
+      std::size_t ring_size = std::size_t(16) << 20;
+      if (char const * const ring_size_variable = std::getenv("CATANALYST_RING_SIZE")) {
+         ring_size = std::size_t(std::strtoull(ring_size_variable, nullptr, 0));
+      }
+      KMTD_Begin(file_header.chunk_size);
+      KMTR_Begin(kmti_capture_file, ring_size, flight_size);
+      std::atexit(KMTI_End);
+      if (flight_size) {
+         kmti_frame_time_trigger = KMTI_GetTriggerThreshold("CATANALYST_TRIGGER_FRAME_MS",
+                                                            file_header.timestamp_frequency);
+         kmti_render_stall_trigger = KMTI_GetTriggerThreshold("CATANALYST_TRIGGER_STALL_MS",
+                                                              file_header.timestamp_frequency);
+         char const * trigger_event_name = std::getenv("CATANALYST_TRIGGER_EVENT");
+         if (!trigger_event_name) {
+            trigger_event_name = "Local\\CatanalystTrigger";
+         }
+         // Auto-reset, for triggering again with another SetEvent.
+         HANDLE const trigger_event = CreateEventA(nullptr, FALSE, FALSE, trigger_event_name);
+         if (!trigger_event) {
+            std::fprintf(stderr, "Failed to create the flight recorder trigger event %s.\n",
+                         trigger_event_name);
+         }
+         std::thread(KMTI_TriggerThread, trigger_event).detach();
+      }
+   }
+
    DetourTransactionBegin();
    DetourUpdateThread(GetCurrentThread());
 #define KMTI_ATTACH(name) \
@@ -408,8 +823,10 @@ void KMTI_Begin() {
    KMTI_ATTACH(NtGdiDdDDICreateSynchronizationObject)
    KMTI_ATTACH(NtGdiDdDDIEscape)
    KMTI_ATTACH(NtGdiDdDDILock)
+   KMTI_ATTACH(NtGdiDdDDIPresent)
    KMTI_ATTACH(NtGdiDdDDIQueryAdapterInfo)
    KMTI_ATTACH(NtGdiDdDDIRender)
    KMTI_ATTACH(NtGdiDdDDISetContextSchedulingPriority)
+   KMTI_ATTACH(NtGdiDdDDIUnlock)
    DetourTransactionCommit();
 }
@@ -0,0 +1,361 @@
+#include "KMTRing.h"
+#include "KMTCapture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Event type of the filler at the end of the ring when the next event doesn't fit before the wrap.
+// Not a valid KMTC_EventType, never written to the file.
+#define KMTR_EVENT_PADDING 0
+
+struct KMTR_Ring {
+   explicit KMTR_Ring(std::size_t const size) : data(new uint8_t[size]), mask(size - 1) {}
+
+   std::unique_ptr<uint8_t[]> const data;
+   std::size_t const mask;
+   // Positions are byte counts since the creation of the ring, wrapped only when accessing data.
+   // The region between the tail and the head is owned by the writer, the rest by the producer.
+   alignas(64) std::atomic<uint64_t> head{0};
+   alignas(64) std::atomic<uint64_t> tail{0};
+   // Set when the producer thread exits, so the writer can free the ring once it's drained.
+   std::atomic<bool> retired{false};
+
+   // Producer-only state of the pending KMTR_Reserve.
+   alignas(64) uint64_t reserved_head = 0;
+   // Events not fitting in the ring are written directly.
+   bool reserved_oversized = false;
+   std::vector<uint8_t> oversized;
+};
+
+static std::size_t kmtr_ring_size;
+static std::atomic<bool> kmtr_running;
+
+static std::mutex kmtr_rings_mutex;
+static std::vector<KMTR_Ring *> kmtr_rings;
+
+// Shared by the writer thread and oversized events, also protecting the history.
+static std::mutex kmtr_file_mutex;
+static std::FILE * kmtr_file;
+
+// Events of the flight recorder mode, wrapping at any byte. Positions are byte counts since the
+// beginning, like in the rings. Empty if writing continuously.
+static std::unique_ptr<uint8_t[]> kmtr_history;
+static std::size_t kmtr_history_size;
+static uint64_t kmtr_history_head;
+static uint64_t kmtr_history_tail;
+static uint64_t kmtr_history_discarded_size;
+
+static std::mutex kmtr_trigger_mutex;
+static bool kmtr_trigger_pending;
+static KMTC_EventHeader kmtr_trigger_header;
+static KMTC_Trigger kmtr_trigger;
+
+static std::thread kmtr_writer;
+static std::atomic<bool> kmtr_writer_stop;
+static std::mutex kmtr_writer_wake_mutex;
+static std::condition_variable kmtr_writer_wake;
+
+struct KMTR_RingOwner {
+   ~KMTR_RingOwner() {
+      if (ring) {
+         ring->retired.store(true, std::memory_order_release);
+      }
+   }
+
+   KMTR_Ring * ring = nullptr;
+};
+
+static thread_local KMTR_RingOwner kmtr_ring_owner;
+
+static void KMTR_WakeWriter() {
+   kmtr_writer_wake.notify_one();
+}
+
+static void KMTR_CopyToHistory(uint64_t const position, void const * const data,
+                               std::size_t const size) {
+   std::size_t const offset = std::size_t(position % kmtr_history_size);
+   std::size_t const first_size = std::min(size, kmtr_history_size - offset);
+   std::memcpy(kmtr_history.get() + offset, data, first_size);
+   std::memcpy(kmtr_history.get(), static_cast<uint8_t const *>(data) + first_size,
+               size - first_size);
+}
+
+static void KMTR_CopyFromHistory(void * const data, uint64_t const position,
+                                 std::size_t const size) {
+   std::size_t const offset = std::size_t(position % kmtr_history_size);
+   std::size_t const first_size = std::min(size, kmtr_history_size - offset);
+   std::memcpy(data, kmtr_history.get() + offset, first_size);
+   std::memcpy(static_cast<uint8_t *>(data) + first_size, kmtr_history.get(),
+               size - first_size);
+}
+
+// Appends an event to the history, discarding the oldest events to make space for it. The file
+// mutex must be locked.
+static void KMTR_RememberEvent(void const * const event, uint32_t const size) {
+   if (size > kmtr_history_size) {
+      kmtr_history_discarded_size += (kmtr_history_head - kmtr_history_tail) + size;
+      kmtr_history_tail = kmtr_history_head;
+      return;
+   }
+   while (kmtr_history_head + size - kmtr_history_tail > kmtr_history_size) {
+      uint32_t discarded_type_and_size[2];
+      KMTR_CopyFromHistory(discarded_type_and_size, kmtr_history_tail,
+                           sizeof(discarded_type_and_size));
+      kmtr_history_tail += discarded_type_and_size[1];
+      kmtr_history_discarded_size += discarded_type_and_size[1];
+   }
+   KMTR_CopyToHistory(kmtr_history_head, event, size);
+   kmtr_history_head += size;
+}
+
+// Writes whole events to the file, or to the history in the flight recorder mode. The file mutex
+// must be locked.
+static void KMTR_Output(uint8_t const * const events, std::size_t const size) {
+   if (!kmtr_history) {
+      std::fwrite(events, 1, size, kmtr_file);
+      return;
+   }
+   for (std::size_t offset = 0; offset < size;) {
+      uint32_t event_type_and_size[2];
+      std::memcpy(event_type_and_size, events + offset, sizeof(event_type_and_size));
+      KMTR_RememberEvent(events + offset, event_type_and_size[1]);
+      offset += event_type_and_size[1];
+   }
+}
+
+// Writes the pending trigger and the history to the file. The file mutex must be locked.
+static void KMTR_DumpHistory() {
+   KMTC_EventHeader header;
+   KMTC_Trigger trigger;
+   {
+      std::lock_guard<std::mutex> trigger_lock(kmtr_trigger_mutex);
+      kmtr_trigger_pending = false;
+      header = kmtr_trigger_header;
+      trigger = kmtr_trigger;
+   }
+   trigger.discarded_size = kmtr_history_discarded_size;
+   uint8_t trigger_event[sizeof(KMTC_EventHeader) + sizeof(KMTC_Trigger)];
+   KMTC_SerializeEvent(trigger_event, &header, &trigger, uint32_t(sizeof(trigger)), nullptr, 0);
+   std::fwrite(trigger_event, 1, sizeof(trigger_event), kmtr_file);
+   std::size_t const offset = std::size_t(kmtr_history_tail % kmtr_history_size);
+   std::size_t const size = std::size_t(kmtr_history_head - kmtr_history_tail);
+   std::size_t const first_size = std::min(size, kmtr_history_size - offset);
+   std::fwrite(kmtr_history.get() + offset, 1, first_size, kmtr_file);
+   std::fwrite(kmtr_history.get(), 1, size - first_size, kmtr_file);
+   std::fflush(kmtr_file);
+   kmtr_history_tail = kmtr_history_head;
+   kmtr_history_discarded_size = 0;
+}
+
+// Writes the events the producer has committed to the ring and frees the space taken by them.
+// Returns whether anything has been written. The file mutex must be locked.
+static bool KMTR_DrainRing(KMTR_Ring & ring) {
+   uint64_t const head = ring.head.load(std::memory_order_acquire);
+   uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+   if (tail == head) {
+      return false;
+   }
+   // Contiguous events are written with one call, which is broken only by wrapping.
+   uint8_t const * run = nullptr;
+   std::size_t run_size = 0;
+   while (tail != head) {
+      uint8_t const * const event = ring.data.get() + (tail & ring.mask);
+      uint32_t event_type_and_size[2];
+      std::memcpy(event_type_and_size, event, sizeof(event_type_and_size));
+      if (run_size && (event_type_and_size[0] == KMTR_EVENT_PADDING || run + run_size != event)) {
+         KMTR_Output(run, run_size);
+         run_size = 0;
+      }
+      if (event_type_and_size[0] != KMTR_EVENT_PADDING) {
+         if (!run_size) {
+            run = event;
+         }
+         run_size += event_type_and_size[1];
+      }
+      tail += event_type_and_size[1];
+   }
+   if (run_size) {
+      KMTR_Output(run, run_size);
+   }
+   ring.tail.store(tail, std::memory_order_release);
+   return true;
+}
+
+static void KMTR_WriterThread() {
+   for (;;) {
+      // Checked before draining so the last pass gets everything committed before KMTR_End.
+      bool const stop = kmtr_writer_stop.load(std::memory_order_acquire);
+      // Checked before draining too so the dump gets everything committed before KMTR_Trigger.
+      bool triggered;
+      {
+         std::lock_guard<std::mutex> trigger_lock(kmtr_trigger_mutex);
+         triggered = kmtr_trigger_pending;
+      }
+      bool written = false;
+      {
+         std::lock_guard<std::mutex> rings_lock(kmtr_rings_mutex);
+         std::lock_guard<std::mutex> file_lock(kmtr_file_mutex);
+         for (auto ring_iterator = kmtr_rings.begin(); ring_iterator != kmtr_rings.end();) {
+            KMTR_Ring * const ring = *ring_iterator;
+            // Checked before draining so nothing is committed between draining and freeing.
+            bool const retired = ring->retired.load(std::memory_order_acquire);
+            written |= KMTR_DrainRing(*ring);
+            if (retired) {
+               delete ring;
+               ring_iterator = kmtr_rings.erase(ring_iterator);
+            } else {
+               ++ring_iterator;
+            }
+         }
+         if (triggered) {
+            KMTR_DumpHistory();
+         }
+      }
+      if (stop) {
+         break;
+      }
+      if (!written) {
+         std::unique_lock<std::mutex> wake_lock(kmtr_writer_wake_mutex);
+         kmtr_writer_wake.wait_for(wake_lock, std::chrono::milliseconds(5));
+      }
+   }
+}
+
+bool KMTR_Begin(std::FILE * const file, std::size_t const ring_size,
+                std::size_t const history_size) {
+   if (kmtr_running.load(std::memory_order_acquire)) {
+      return false;
+   }
+   // A power of two for wrapping with a mask, with a lower bound to fit typical submissions.
+   std::size_t rounded_ring_size = std::size_t(1) << 16;
+   while (rounded_ring_size < ring_size && rounded_ring_size < (std::size_t(1) << 30)) {
+      rounded_ring_size <<= 1;
+   }
+   kmtr_ring_size = rounded_ring_size;
+   kmtr_file = file;
+   // Allocated upfront so recording doesn't fail when the memory of the process is short later.
+   kmtr_history.reset(history_size ? new uint8_t[history_size] : nullptr);
+   kmtr_history_size = history_size;
+   kmtr_history_head = 0;
+   kmtr_history_tail = 0;
+   kmtr_history_discarded_size = 0;
+   kmtr_trigger_pending = false;
+   kmtr_writer_stop.store(false, std::memory_order_relaxed);
+   kmtr_running.store(true, std::memory_order_release);
+   kmtr_writer = std::thread(KMTR_WriterThread);
+   return true;
+}
+
+void KMTR_End() {
+   if (!kmtr_running.exchange(false, std::memory_order_acq_rel)) {
+      return;
+   }
+   kmtr_writer_stop.store(true, std::memory_order_release);
+   KMTR_WakeWriter();
+   kmtr_writer.join();
+   std::lock_guard<std::mutex> file_lock(kmtr_file_mutex);
+   std::fflush(kmtr_file);
+   kmtr_file = nullptr;
+   // Events not triggered are not written.
+   kmtr_history.reset();
+   // The rings are not freed as the producers may still be using them.
+}
+
+void * KMTR_Reserve(uint32_t const size) {
+   if (!kmtr_running.load(std::memory_order_acquire)) {
+      return nullptr;
+   }
+   KMTR_Ring * ring = kmtr_ring_owner.ring;
+   if (!ring) {
+      ring = new KMTR_Ring(kmtr_ring_size);
+      {
+         std::lock_guard<std::mutex> rings_lock(kmtr_rings_mutex);
+         kmtr_rings.push_back(ring);
+      }
+      kmtr_ring_owner.ring = ring;
+   }
+   std::size_t const capacity = ring->mask + 1;
+   if (size > capacity / 2) {
+      ring->reserved_oversized = true;
+      ring->oversized.resize(size);
+      return ring->oversized.data();
+   }
+   uint64_t const head = ring->head.load(std::memory_order_relaxed);
+   std::size_t const offset = std::size_t(head & ring->mask);
+   std::size_t const padding = size <= capacity - offset ? 0 : capacity - offset;
+   uint64_t const reserved_head = head + padding + size;
+   while (reserved_head - ring->tail.load(std::memory_order_acquire) > capacity) {
+      if (!kmtr_running.load(std::memory_order_acquire)) {
+         return nullptr;
+      }
+      KMTR_WakeWriter();
+      std::this_thread::yield();
+   }
+   if (padding) {
+      uint32_t const padding_type_and_size[] = {KMTR_EVENT_PADDING, uint32_t(padding)};
+      std::memcpy(ring->data.get() + offset, padding_type_and_size,
+                  sizeof(padding_type_and_size));
+   }
+   ring->reserved_oversized = false;
+   ring->reserved_head = reserved_head;
+   return ring->data.get() + std::size_t((head + padding) & ring->mask);
+}
+
+void KMTR_Commit() {
+   KMTR_Ring * const ring = kmtr_ring_owner.ring;
+   if (!ring) {
+      return;
+   }
+   if (ring->reserved_oversized) {
+      ring->reserved_oversized = false;
+      // Keep the order of the events of the thread.
+      while (ring->tail.load(std::memory_order_acquire) !=
+             ring->head.load(std::memory_order_relaxed)) {
+         if (!kmtr_running.load(std::memory_order_acquire)) {
+            return;
+         }
+         KMTR_WakeWriter();
+         std::this_thread::yield();
+      }
+      std::lock_guard<std::mutex> file_lock(kmtr_file_mutex);
+      if (kmtr_file) {
+         KMTR_Output(ring->oversized.data(), ring->oversized.size());
+      }
+      return;
+   }
+   ring->head.store(ring->reserved_head, std::memory_order_release);
+   // The writer polls periodically, only hurry it up if the ring is filling up.
+   if (ring->reserved_head - ring->tail.load(std::memory_order_relaxed) > (ring->mask + 1) / 2) {
+      KMTR_WakeWriter();
+   }
+}
+
+void KMTR_Trigger(uint32_t const reason, uint32_t const thread_id, uint64_t const timestamp) {
+   if (!kmtr_running.load(std::memory_order_acquire) || !kmtr_history_size) {
+      return;
+   }
+   {
+      std::lock_guard<std::mutex> trigger_lock(kmtr_trigger_mutex);
+      if (kmtr_trigger_pending) {
+         return;
+      }
+      kmtr_trigger_pending = true;
+      kmtr_trigger_header = KMTC_EventHeader();
+      kmtr_trigger_header.type = KMTC_EVENT_TRIGGER;
+      kmtr_trigger_header.thread_id = thread_id;
+      kmtr_trigger_header.timestamp = timestamp;
+      kmtr_trigger = KMTC_Trigger();
+      kmtr_trigger.reason = reason;
+   }
+   KMTR_WakeWriter();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Transfer of KMTC events from the intercepted threads to the capture file.
+//
+// Every thread appends events to its own single-producer ring buffer, so recording an event is a
+// copy to the ring and an atomic publish, and a writer thread drains the rings to the file in the
+// background. Events of one thread are written in the order of recording, but events of different
+// threads are interleaved in the order they're drained, so tools that need the global order must
+// use KMTC_EventHeader::timestamp.
+//
+// In the flight recorder mode, the writer keeps the drained events in memory instead, discarding
+// the oldest ones when the memory is full, and writes them to the file only when triggered. The
+// producers do the same work in both modes.
+//
+// Doesn't depend on anything Windows-specific so it can be exercised by a synthetic producer.
+
+// ring_size is per thread, rounded up to a power of two. history_size is the memory of the flight
+// recorder, or 0 to write the events continuously. The file must stay open until KMTR_End.
+bool KMTR_Begin(std::FILE * file, std::size_t ring_size, std::size_t history_size);
+// Writes everything committed so far and stops the writer thread. Events reserved after this are
+// dropped.
+void KMTR_End();
+
+// In the flight recorder mode, makes the writer write a KMTC_EVENT_TRIGGER with the reason
+// (KMTC_TriggerReason), followed by the events remembered, including the ones committed before this
+// call, and forget them. Triggers before the writer gets to the previous one are merged into it.
+void KMTR_Trigger(uint32_t reason, uint32_t thread_id, uint64_t timestamp);
+
+// Returns space for a KMTC event of the given size (a multiple of KMTC_ALIGNMENT, beginning with
+// the KMTC_EventHeader) for the calling thread, waiting for the writer if the ring is full, or
+// nullptr if the writer is not running. Must be followed by KMTR_Commit on the same thread before
+// reserving again.
+void * KMTR_Reserve(uint32_t size);
+// Publishes the event from the last KMTR_Reserve of the calling thread to the writer.
+void KMTR_Commit();
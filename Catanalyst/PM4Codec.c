@@ -0,0 +1,235 @@
+#include "Catanalyst.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Token of a header stored as is.
+#define PM4Z_LITERAL_HEADER_TOKEN (1 + PM4Z_RECENT_HEADER_COUNT)
+
+void PM4Z_ModelInit(PM4Z_Model * const model) {
+   memset(model, 0, sizeof(*model));
+}
+
+size_t PM4Z_GetMaxEncodedSize(uint32_t const pm4_dword_count) {
+   // A literal header is a token and 4 bytes, and a varint of a dword is up to 5 bytes.
+   return (size_t)5 * pm4_dword_count;
+}
+
+static uint32_t PM4Z_GetHeaderContext(uint32_t const previous_header) {
+   return (previous_header * UINT32_C(0x9E3779B1)) >> 20;
+}
+
+// Returns the number of dwords of the packet including the header, with the same rules as
+// PM4P_Decode, before limiting it to the end of the buffer.
+static uint32_t PM4Z_GetPacketDwordCount(uint32_t const header, bool const follows_packet2) {
+   uint32_t const packet_type = header >> 30;
+   if (packet_type == 0 ||
+       (packet_type == 3 && (((header >> 8) & 0xFF) != 0x10 || !follows_packet2))) {
+      return 2 + ((header >> 16) & 0x3FFF);
+   }
+   return 1;
+}
+
+// Returns the first register of the block written by the packet, or 0 if it doesn't set registers.
+static uint32_t PM4Z_GetRegisterBase(uint32_t const header) {
+   if ((header >> 30) != 3) {
+      return 0;
+   }
+   switch ((header >> 8) & 0xFF) {
+   case 0x68: // PKT3_SET_CONFIG_REG
+      return 0x8000 / sizeof(uint32_t);
+   case 0x69: // PKT3_SET_CONTEXT_REG
+      return 0x28000 / sizeof(uint32_t);
+   case 0x6F: // PKT3_SET_CTL_CONST
+      return 0x3CFF0 / sizeof(uint32_t);
+   }
+   return 0;
+}
+
+// The body history of the packet, shared by the packets of type 0.
+static uint32_t * PM4Z_GetBodyHistory(PM4Z_Model * const model, uint32_t const header) {
+   return model->bodies[(header >> 30) == 3 ? (header >> 8) & 0xFF : 0];
+}
+
+// Makes the header the most recently used one, moving it from the position where it was found, or
+// dropping the least recently used one if it wasn't found.
+static void PM4Z_UseHeader(PM4Z_Model * const model, uint32_t const header,
+                           uint32_t const recent_index) {
+   uint32_t const moved_count =
+      recent_index < PM4Z_RECENT_HEADER_COUNT ? recent_index : PM4Z_RECENT_HEADER_COUNT - 1;
+   memmove(model->recent_headers + 1, model->recent_headers, sizeof(uint32_t) * moved_count);
+   model->recent_headers[0] = header;
+   model->next_headers[PM4Z_GetHeaderContext(model->previous_header)] = header;
+   model->previous_header = header;
+}
+
+static uint32_t PM4Z_ZigZag(uint32_t const difference) {
+   return (difference << 1) ^ ((uint32_t)0 - (difference >> 31));
+}
+
+static uint32_t PM4Z_UnZigZag(uint32_t const value) {
+   return (value >> 1) ^ ((uint32_t)0 - (value & 1));
+}
+
+static uint8_t * PM4Z_PutVarint(uint8_t * encoded, uint32_t value) {
+   while (value >= 0x80) {
+      *(encoded++) = (uint8_t)(value | 0x80);
+      value >>= 7;
+   }
+   *(encoded++) = (uint8_t)value;
+   return encoded;
+}
+
+// Returns NULL if the varint is truncated or longer than a dword.
+static uint8_t const * PM4Z_GetVarint(uint8_t const * encoded, uint8_t const * const end,
+                                      uint32_t * const value) {
+   uint32_t result = 0;
+   for (uint32_t shift = 0; shift < 35; shift += 7) {
+      if (encoded == end) {
+         return NULL;
+      }
+      uint8_t const byte = *(encoded++);
+      result |= (uint32_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+         *value = result;
+         return encoded;
+      }
+   }
+   return NULL;
+}
+
+size_t PM4Z_Encode(PM4Z_Model * const model, uint32_t const * const pm4,
+                   uint32_t const pm4_dword_count, uint8_t * const encoded) {
+   uint8_t * position = encoded;
+   uint32_t dword_index = 0;
+   bool follows_packet2 = false;
+   while (dword_index < pm4_dword_count) {
+      uint32_t const header = pm4[dword_index];
+      uint32_t recent_index = 0;
+      while (recent_index < PM4Z_RECENT_HEADER_COUNT &&
+             model->recent_headers[recent_index] != header) {
+         ++recent_index;
+      }
+      if (model->next_headers[PM4Z_GetHeaderContext(model->previous_header)] == header) {
+         *(position++) = 0;
+      } else if (recent_index < PM4Z_RECENT_HEADER_COUNT) {
+         *(position++) = (uint8_t)(1 + recent_index);
+      } else {
+         *(position++) = PM4Z_LITERAL_HEADER_TOKEN;
+         memcpy(position, &header, sizeof(header));
+         position += sizeof(header);
+      }
+      PM4Z_UseHeader(model, header, recent_index);
+
+      uint32_t packet_dword_count = PM4Z_GetPacketDwordCount(header, follows_packet2);
+      if (packet_dword_count > pm4_dword_count - dword_index) {
+         packet_dword_count = pm4_dword_count - dword_index;
+      }
+      uint32_t const * const body = pm4 + dword_index + 1;
+      uint32_t const body_dword_count = packet_dword_count - 1;
+      uint32_t const register_base = PM4Z_GetRegisterBase(header);
+      if (register_base != 0 && body_dword_count != 0) {
+         uint32_t const first_register = register_base + body[0];
+         position = PM4Z_PutVarint(position, body[0]);
+         for (uint32_t value_index = 1; value_index < body_dword_count; ++value_index) {
+            // PM4S_REGISTER_COUNT for untracked registers, which share the last entry.
+            uint32_t * const previous_value =
+               &model->registers[PM4S_GetShadowIndex(first_register + (value_index - 1))];
+            position = PM4Z_PutVarint(position, PM4Z_ZigZag(body[value_index] - *previous_value));
+            *previous_value = body[value_index];
+         }
+      } else {
+         uint32_t * const history = PM4Z_GetBodyHistory(model, header);
+         for (uint32_t body_index = 0; body_index < body_dword_count; ++body_index) {
+            if (body_index < PM4Z_BODY_HISTORY_DWORDS) {
+               position =
+                  PM4Z_PutVarint(position, PM4Z_ZigZag(body[body_index] - history[body_index]));
+               history[body_index] = body[body_index];
+            } else {
+               position = PM4Z_PutVarint(position, body[body_index]);
+            }
+         }
+      }
+      follows_packet2 = (header >> 30) == 2;
+      dword_index += packet_dword_count;
+   }
+   return (size_t)(position - encoded);
+}
+
+bool PM4Z_Decode(PM4Z_Model * const model, uint8_t const * const encoded,
+                 size_t const encoded_size, uint32_t * const pm4, uint32_t const pm4_dword_count) {
+   uint8_t const * position = encoded;
+   uint8_t const * const end = encoded + encoded_size;
+   uint32_t dword_index = 0;
+   bool follows_packet2 = false;
+   while (dword_index < pm4_dword_count) {
+      if (position == end) {
+         return false;
+      }
+      uint32_t const token = *(position++);
+      uint32_t header;
+      uint32_t recent_index = PM4Z_RECENT_HEADER_COUNT;
+      if (token == 0) {
+         header = model->next_headers[PM4Z_GetHeaderContext(model->previous_header)];
+      } else if (token < PM4Z_LITERAL_HEADER_TOKEN) {
+         recent_index = token - 1;
+         header = model->recent_headers[recent_index];
+      } else if (token == PM4Z_LITERAL_HEADER_TOKEN && (size_t)(end - position) >= sizeof(header)) {
+         memcpy(&header, position, sizeof(header));
+         position += sizeof(header);
+      } else {
+         return false;
+      }
+      if (token == 0) {
+         recent_index = 0;
+         while (recent_index < PM4Z_RECENT_HEADER_COUNT &&
+                model->recent_headers[recent_index] != header) {
+            ++recent_index;
+         }
+      }
+      PM4Z_UseHeader(model, header, recent_index);
+      pm4[dword_index] = header;
+
+      uint32_t packet_dword_count = PM4Z_GetPacketDwordCount(header, follows_packet2);
+      if (packet_dword_count > pm4_dword_count - dword_index) {
+         packet_dword_count = pm4_dword_count - dword_index;
+      }
+      uint32_t * const body = pm4 + dword_index + 1;
+      uint32_t const body_dword_count = packet_dword_count - 1;
+      uint32_t const register_base = PM4Z_GetRegisterBase(header);
+      uint32_t value;
+      if (register_base != 0 && body_dword_count != 0) {
+         if ((position = PM4Z_GetVarint(position, end, &value)) == NULL) {
+            return false;
+         }
+         body[0] = value;
+         uint32_t const first_register = register_base + value;
+         for (uint32_t value_index = 1; value_index < body_dword_count; ++value_index) {
+            if ((position = PM4Z_GetVarint(position, end, &value)) == NULL) {
+               return false;
+            }
+            uint32_t * const previous_value =
+               &model->registers[PM4S_GetShadowIndex(first_register + (value_index - 1))];
+            *previous_value += PM4Z_UnZigZag(value);
+            body[value_index] = *previous_value;
+         }
+      } else {
+         uint32_t * const history = PM4Z_GetBodyHistory(model, header);
+         for (uint32_t body_index = 0; body_index < body_dword_count; ++body_index) {
+            if ((position = PM4Z_GetVarint(position, end, &value)) == NULL) {
+               return false;
+            }
+            if (body_index < PM4Z_BODY_HISTORY_DWORDS) {
+               history[body_index] += PM4Z_UnZigZag(value);
+               value = history[body_index];
+            }
+            body[body_index] = value;
+         }
+      }
+      follows_packet2 = (header >> 30) == 2;
+      dword_index += packet_dword_count;
+   }
+   return position == end;
+}
@@ -0,0 +1,392 @@
+#include "Catanalyst.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PM4P_X86_64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PM4P_X86_64) && defined(__GNUC__)
+// Compiled for AVX2 regardless of the target of the build, and only called if it's supported.
+#define PM4P_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PM4P_TARGET_AVX2
+#endif
+
+// Decodes the fields that depend only on the header. Returns the number of dwords in the packet
+// including the header as specified by it.
+static uint32_t PM4P_DecodeHeader(PM4P_Packet * const packet, uint32_t const header,
+                                  bool const follows_packet2) {
+   uint32_t const packet_type = header >> 30;
+   packet->header = header;
+   packet->body_dword_count = 0;
+   packet->register_base = 0;
+   packet->register_first = 0;
+   packet->count = (uint16_t)((header >> 16) & 0x3FFF);
+   packet->type = (uint8_t)packet_type;
+   packet->opcode = 0;
+   packet->truncated = false;
+
+   if (packet_type == 0) {
+      packet->body_dword_count = 1 + (uint32_t)packet->count;
+   } else if (packet_type == 3) {
+      uint32_t const packet3_opcode = (header >> 8) & 0xFF;
+      packet->opcode = (uint8_t)packet3_opcode;
+      packet->body_dword_count = 1 + (uint32_t)packet->count;
+      switch (packet3_opcode) {
+      case 0x10: // PKT3_NOP
+         // Some type-3 packets are contained in a nop type-3 packet preceded by a type-2 packet
+         // that has a slot 0x5400 patch location, parse them.
+         if (follows_packet2) {
+            packet->body_dword_count = 0;
+         }
+         break;
+      case 0x68: // PKT3_SET_CONFIG_REG
+         packet->register_base = 0x8000 / sizeof(uint32_t);
+         break;
+      case 0x69: // PKT3_SET_CONTEXT_REG
+         packet->register_base = 0x28000 / sizeof(uint32_t);
+         break;
+      case 0x6F: // PKT3_SET_CTL_CONST
+         packet->register_base = 0x3CFF0 / sizeof(uint32_t);
+         break;
+      }
+   }
+   return 1 + packet->body_dword_count;
+}
+
+// Sets the location of the packet and the fields depending on the body, of which
+// available_dword_count dwords including the header are present.
+static void PM4P_DecodeBody(PM4P_Packet * const packet, uint32_t const * const dwords,
+                            uint32_t const offset, uint32_t const available_dword_count) {
+   packet->dwords = dwords;
+   packet->offset = offset;
+   if (available_dword_count < 1 + packet->body_dword_count) {
+      packet->body_dword_count = available_dword_count - 1;
+      packet->truncated = true;
+   }
+   if (packet->register_base != 0 && packet->body_dword_count != 0) {
+      packet->register_first = packet->register_base + dwords[1];
+   }
+}
+
+// Type-2 packets are single-dword filler, and long runs of them are scanned in bulk, with the
+// instruction set selected at runtime. The end of the run is the first dword of a different type.
+
+// -1 until selected, a PM4P_SIMD otherwise.
+static int pm4p_simd = -1;
+
+PM4P_SIMD PM4P_GetSupportedSIMD(void) {
+#ifdef PM4P_X86_64
+#ifdef _MSC_VER
+   int cpu_info[4];
+   __cpuid(cpu_info, 0);
+   if (cpu_info[0] >= 7) {
+      // AVX2 needs the OS to preserve the YMM registers, and AVX to be reported as well.
+      __cpuid(cpu_info, 1);
+      uint32_t const avx_and_osxsave = ((uint32_t)1 << 28) | ((uint32_t)1 << 27);
+      if (((uint32_t)cpu_info[2] & avx_and_osxsave) == avx_and_osxsave &&
+          (_xgetbv(0) & 0x6) == 0x6) {
+         __cpuidex(cpu_info, 7, 0);
+         if ((uint32_t)cpu_info[1] & ((uint32_t)1 << 5)) {
+            return PM4P_SIMD_AVX2;
+         }
+      }
+   }
+#else
+   if (__builtin_cpu_supports("avx2")) {
+      return PM4P_SIMD_AVX2;
+   }
+#endif
+   // Part of x86-64 itself.
+   return PM4P_SIMD_SSE2;
+#else
+   return PM4P_SIMD_SCALAR;
+#endif
+}
+
+void PM4P_SetSIMD(PM4P_SIMD const simd) {
+   PM4P_SIMD const supported_simd = PM4P_GetSupportedSIMD();
+   pm4p_simd = (int)(simd < supported_simd ? simd : supported_simd);
+}
+
+PM4P_SIMD PM4P_GetSIMD(void) {
+   if (pm4p_simd < 0) {
+      PM4P_SetSIMD(PM4P_SIMD_AVX2);
+   }
+   return (PM4P_SIMD)pm4p_simd;
+}
+
+static uint32_t PM4P_FindFillerEndScalar(uint32_t const * const pm4, uint32_t dword_index,
+                                         uint32_t const dword_end) {
+   while (dword_index < dword_end && (pm4[dword_index] >> 30) == 2) {
+      ++dword_index;
+   }
+   return dword_index;
+}
+
+#ifdef PM4P_X86_64
+
+static uint32_t PM4P_CountTrailingZeros(uint32_t const value) {
+#ifdef _MSC_VER
+   unsigned long bit_index;
+   _BitScanForward(&bit_index, value);
+   return (uint32_t)bit_index;
+#else
+   return (uint32_t)__builtin_ctz(value);
+#endif
+}
+
+static uint32_t PM4P_FindFillerEndSSE2(uint32_t const * const pm4, uint32_t dword_index,
+                                       uint32_t const dword_end) {
+   __m128i const type_mask = _mm_set1_epi32((int)0xC0000000);
+   __m128i const type2 = _mm_set1_epi32((int)0x80000000);
+   while (dword_end - dword_index >= 4) {
+      __m128i const dwords = _mm_loadu_si128((__m128i const *)(pm4 + dword_index));
+      __m128i const are_filler = _mm_cmpeq_epi32(_mm_and_si128(dwords, type_mask), type2);
+      uint32_t const filler_mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(are_filler));
+      if (filler_mask != 0xF) {
+         return dword_index + PM4P_CountTrailingZeros(~filler_mask);
+      }
+      dword_index += 4;
+   }
+   return PM4P_FindFillerEndScalar(pm4, dword_index, dword_end);
+}
+
+PM4P_TARGET_AVX2
+static uint32_t PM4P_FindFillerEndAVX2(uint32_t const * const pm4, uint32_t dword_index,
+                                       uint32_t const dword_end) {
+   __m256i const type_mask = _mm256_set1_epi32((int)0xC0000000);
+   __m256i const type2 = _mm256_set1_epi32((int)0x80000000);
+   while (dword_end - dword_index >= 8) {
+      __m256i const dwords = _mm256_loadu_si256((__m256i const *)(pm4 + dword_index));
+      __m256i const are_filler = _mm256_cmpeq_epi32(_mm256_and_si256(dwords, type_mask), type2);
+      uint32_t const filler_mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(are_filler));
+      if (filler_mask != 0xFF) {
+         return dword_index + PM4P_CountTrailingZeros(~filler_mask);
+      }
+      dword_index += 8;
+   }
+   return PM4P_FindFillerEndScalar(pm4, dword_index, dword_end);
+}
+
+#endif
+
+static uint32_t PM4P_FindFillerEnd(uint32_t const * const pm4, uint32_t const dword_index,
+                                   uint32_t const dword_end) {
+   switch (PM4P_GetSIMD()) {
+#ifdef PM4P_X86_64
+   case PM4P_SIMD_AVX2:
+      return PM4P_FindFillerEndAVX2(pm4, dword_index, dword_end);
+   case PM4P_SIMD_SSE2:
+      return PM4P_FindFillerEndSSE2(pm4, dword_index, dword_end);
+#endif
+   default:
+      return PM4P_FindFillerEndScalar(pm4, dword_index, dword_end);
+   }
+}
+
+// The same as PM4P_DecodeHeader and PM4P_DecodeBody for a type-2 packet.
+static void PM4P_DecodeFiller(PM4P_Packet * const packet, uint32_t const * const dwords,
+                              uint32_t const offset) {
+   uint32_t const header = dwords[0];
+   packet->dwords = dwords;
+   packet->offset = offset;
+   packet->header = header;
+   packet->body_dword_count = 0;
+   packet->register_base = 0;
+   packet->register_first = 0;
+   packet->count = (uint16_t)((header >> 16) & 0x3FFF);
+   packet->type = 2;
+   packet->opcode = 0;
+   packet->truncated = false;
+}
+
+void PM4P_DecoderInit(PM4P_Decoder * const decoder, uint32_t const * const pm4,
+                      uint32_t const pm4_dword_count) {
+   decoder->pm4 = pm4;
+   decoder->pm4_dword_count = pm4_dword_count;
+   decoder->dword_index = 0;
+   decoder->follows_packet2 = false;
+}
+
+uint32_t PM4P_Decode(PM4P_Decoder * const decoder, PM4P_Packet * const packets,
+                     uint32_t const packet_capacity) {
+   uint32_t const * const pm4 = decoder->pm4;
+   uint32_t const pm4_dword_count = decoder->pm4_dword_count;
+   uint32_t pm4_dword_index = decoder->dword_index;
+   bool follows_packet2 = decoder->follows_packet2;
+   uint32_t packet_count = 0;
+   while (packet_count < packet_capacity && pm4_dword_index < pm4_dword_count) {
+      uint32_t const header = pm4[pm4_dword_index];
+      if ((header >> 30) == 2) {
+         uint32_t const run_end_limit =
+            pm4_dword_count - pm4_dword_index > packet_capacity - packet_count
+               ? pm4_dword_index + (packet_capacity - packet_count)
+               : pm4_dword_count;
+         uint32_t const run_end = PM4P_FindFillerEnd(pm4, pm4_dword_index + 1, run_end_limit);
+         for (; pm4_dword_index < run_end; ++pm4_dword_index) {
+            PM4P_DecodeFiller(&packets[packet_count++], pm4 + pm4_dword_index, pm4_dword_index);
+         }
+         follows_packet2 = true;
+         continue;
+      }
+      PM4P_Packet * const packet = &packets[packet_count++];
+      uint32_t const packet_dword_count = PM4P_DecodeHeader(packet, header, follows_packet2);
+      follows_packet2 = packet->type == 2;
+      uint32_t const available_dword_count = pm4_dword_count - pm4_dword_index;
+      PM4P_DecodeBody(packet, pm4 + pm4_dword_index, pm4_dword_index, available_dword_count);
+      pm4_dword_index += packet_dword_count <= available_dword_count ? packet_dword_count
+                                                                     : available_dword_count;
+   }
+   decoder->dword_index = pm4_dword_index;
+   decoder->follows_packet2 = follows_packet2;
+   return packet_count;
+}
+
+uint32_t PM4P_Skip(PM4P_Decoder * const decoder, uint32_t const min_dword_count) {
+   uint32_t const * const pm4 = decoder->pm4;
+   uint32_t const pm4_dword_count = decoder->pm4_dword_count;
+   uint32_t pm4_dword_index = decoder->dword_index;
+   bool follows_packet2 = decoder->follows_packet2;
+   uint32_t const target_dword_index = pm4_dword_count - pm4_dword_index > min_dword_count
+                                          ? pm4_dword_index + min_dword_count
+                                          : pm4_dword_count;
+   uint32_t packet_count = 0;
+   while (pm4_dword_index < target_dword_index) {
+      uint32_t const header = pm4[pm4_dword_index];
+      if ((header >> 30) == 2) {
+         // The whole run, possibly past the target.
+         uint32_t const run_end = PM4P_FindFillerEnd(pm4, pm4_dword_index + 1, pm4_dword_count);
+         packet_count += run_end - pm4_dword_index;
+         pm4_dword_index = run_end;
+         follows_packet2 = true;
+         continue;
+      }
+      PM4P_Packet packet;
+      uint32_t const packet_dword_count = PM4P_DecodeHeader(&packet, header, follows_packet2);
+      follows_packet2 = false;
+      uint32_t const available_dword_count = pm4_dword_count - pm4_dword_index;
+      pm4_dword_index += packet_dword_count <= available_dword_count ? packet_dword_count
+                                                                     : available_dword_count;
+      ++packet_count;
+   }
+   decoder->dword_index = pm4_dword_index;
+   decoder->follows_packet2 = follows_packet2;
+   return packet_count;
+}
+
+void PM4P_StreamDecoderInit(PM4P_StreamDecoder * const decoder) {
+   decoder->chunk = NULL;
+   decoder->chunk_dword_count = 0;
+   decoder->chunk_dword_index = 0;
+   decoder->chunk_offset = 0;
+   decoder->follows_packet2 = false;
+   decoder->carry_dword_count = 0;
+   decoder->carry_needed_dword_count = 0;
+}
+
+void PM4P_StreamDecoderPush(PM4P_StreamDecoder * const decoder, uint32_t const * const dwords,
+                            uint32_t const dword_count) {
+   decoder->chunk_offset += decoder->chunk_dword_count;
+   decoder->chunk = dwords;
+   decoder->chunk_dword_count = dword_count;
+   decoder->chunk_dword_index = 0;
+}
+
+uint32_t PM4P_StreamDecode(PM4P_StreamDecoder * const decoder, PM4P_Packet * const packets,
+                           uint32_t const packet_capacity) {
+   uint32_t packet_count = 0;
+   if (packet_capacity == 0) {
+      return 0;
+   }
+   // The carry buffer must not be overwritten while a packet returned from it is in use.
+   bool carry_in_use = false;
+
+   // Complete the packet split between the chunks first.
+   if (decoder->carry_dword_count != 0) {
+      uint32_t const chunk_remaining_dword_count =
+         decoder->chunk_dword_count - decoder->chunk_dword_index;
+      uint32_t copy_dword_count = decoder->carry_needed_dword_count - decoder->carry_dword_count;
+      if (copy_dword_count > chunk_remaining_dword_count) {
+         copy_dword_count = chunk_remaining_dword_count;
+      }
+      memcpy(decoder->carry + decoder->carry_dword_count,
+             decoder->chunk + decoder->chunk_dword_index, sizeof(uint32_t) * copy_dword_count);
+      decoder->carry_dword_count += copy_dword_count;
+      decoder->chunk_dword_index += copy_dword_count;
+      if (decoder->carry_dword_count < decoder->carry_needed_dword_count) {
+         return 0;
+      }
+      PM4P_Packet * const packet = &packets[packet_count++];
+      *packet = decoder->carry_packet;
+      PM4P_DecodeBody(packet, decoder->carry, packet->offset, decoder->carry_dword_count);
+      decoder->carry_dword_count = 0;
+      carry_in_use = true;
+   }
+
+   uint32_t const * const chunk = decoder->chunk;
+   uint32_t const chunk_dword_count = decoder->chunk_dword_count;
+   uint32_t chunk_dword_index = decoder->chunk_dword_index;
+   bool follows_packet2 = decoder->follows_packet2;
+   while (packet_count < packet_capacity && chunk_dword_index < chunk_dword_count) {
+      PM4P_Packet * const packet = &packets[packet_count];
+      uint32_t const packet_dword_count =
+         PM4P_DecodeHeader(packet, chunk[chunk_dword_index], follows_packet2);
+      uint32_t const available_dword_count = chunk_dword_count - chunk_dword_index;
+      uint32_t const offset = decoder->chunk_offset + chunk_dword_index;
+      if (packet_dword_count > available_dword_count && carry_in_use) {
+         // Decoded again in the next call.
+         break;
+      }
+      follows_packet2 = packet->type == 2;
+      if (packet_dword_count > available_dword_count) {
+         // Continue in the next chunk.
+         decoder->carry_packet = *packet;
+         decoder->carry_packet.offset = offset;
+         decoder->carry_needed_dword_count = packet_dword_count;
+         decoder->carry_dword_count = available_dword_count;
+         memcpy(decoder->carry, chunk + chunk_dword_index,
+                sizeof(uint32_t) * available_dword_count);
+         chunk_dword_index = chunk_dword_count;
+         break;
+      }
+      PM4P_DecodeBody(packet, chunk + chunk_dword_index, offset, packet_dword_count);
+      chunk_dword_index += packet_dword_count;
+      ++packet_count;
+   }
+   decoder->chunk_dword_index = chunk_dword_index;
+   decoder->follows_packet2 = follows_packet2;
+   return packet_count;
+}
+
+bool PM4P_StreamDecoderFinish(PM4P_StreamDecoder * const decoder, PM4P_Packet * const packet) {
+   if (decoder->carry_dword_count == 0) {
+      return false;
+   }
+   *packet = decoder->carry_packet;
+   PM4P_DecodeBody(packet, decoder->carry, packet->offset, decoder->carry_dword_count);
+   decoder->carry_dword_count = 0;
+   return true;
+}
+
+bool PM4P_GetIndirectBuffer(PM4P_Packet const * const packet,
+                            PM4P_IndirectBuffer * const indirect_buffer) {
+   // PKT3_INDIRECT_BUFFER, PKT3_INDIRECT_BUFFER_MP.
+   if (packet->type != 3 || (packet->opcode != 0x32 && packet->opcode != 0x38) ||
+       packet->body_dword_count < 3) {
+      return false;
+   }
+   // IB_BASE_LO, IB_BASE_HI, IB_SIZE.
+   indirect_buffer->address = (packet->dwords[1] & ~(uint32_t)3) |
+                              ((uint64_t)(packet->dwords[2] & 0xFF) << 32);
+   indirect_buffer->dword_count = packet->dwords[3] & 0xFFFFF;
+   return true;
+}
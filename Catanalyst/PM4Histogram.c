@@ -0,0 +1,140 @@
+#include "Catanalyst.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+void PM4H_HistogramInit(PM4H_Histogram * const histogram) {
+   memset(histogram, 0, sizeof(*histogram));
+}
+
+void PM4H_HistogramAdd(PM4H_Histogram * const histogram, PM4P_Packet const * const packets,
+                       uint32_t const packet_count) {
+   for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+      PM4P_Packet const * const packet = &packets[packet_index];
+      uint32_t const dword_count = 1 + packet->body_dword_count;
+      PM4H_PacketCounts * const type_counts = &histogram->types[packet->type];
+      ++type_counts->packet_count;
+      type_counts->dword_count += dword_count;
+      if (packet->type != 3) {
+         continue;
+      }
+      PM4H_PacketCounts * const opcode_counts = &histogram->opcodes[packet->opcode];
+      ++opcode_counts->packet_count;
+      opcode_counts->dword_count += dword_count;
+      if (packet->register_base == 0 || packet->body_dword_count < 2) {
+         continue;
+      }
+      uint32_t first_shadow_index = 0;
+      uint32_t const tracked_count = PM4S_GetPacketShadowRange(packet, &first_shadow_index);
+      uint64_t * const write_counts = histogram->register_write_counts + first_shadow_index;
+      for (uint32_t value_index = 0; value_index < tracked_count; ++value_index) {
+         ++write_counts[value_index];
+      }
+      histogram->untracked_register_write_count += packet->body_dword_count - 1 - tracked_count;
+   }
+}
+
+// Walks the headers directly instead of going through PM4P_Decode, with the same rules for the
+// sizes of the packets, as describing every packet would take several times longer than counting.
+// The mix of the packet types and opcodes is hard to predict, so the sizes and the counters are
+// selected without branches where possible.
+void PM4H_HistogramAddBuffer(PM4H_Histogram * const histogram, uint32_t const * const pm4,
+                             uint32_t const pm4_dword_count) {
+   // The opcodes of the register-setting packets, with the blocks they write.
+   struct {
+      uint32_t opcode;
+      uint32_t base;
+      uint32_t register_count;
+   } const register_packets[] = {
+      {0x68, 0x8000 / sizeof(uint32_t), PM4S_CONFIG_REGISTER_COUNT}, // PKT3_SET_CONFIG_REG
+      {0x69, 0x28000 / sizeof(uint32_t), PM4S_CONTEXT_REGISTER_COUNT}, // PKT3_SET_CONTEXT_REG
+      {0x6F, 0x3CFF0 / sizeof(uint32_t), PM4S_CTL_CONST_REGISTER_COUNT}, // PKT3_SET_CTL_CONST
+   };
+   uint32_t block_shadow_indices[0x100];
+   // 0 for other opcodes.
+   uint32_t block_register_counts[0x100] = {0};
+   for (uint32_t register_packet_index = 0;
+        register_packet_index < sizeof(register_packets) / sizeof(register_packets[0]);
+        ++register_packet_index) {
+      uint32_t const opcode = register_packets[register_packet_index].opcode;
+      block_shadow_indices[opcode] =
+         PM4S_GetShadowIndex(register_packets[register_packet_index].base);
+      block_register_counts[opcode] = register_packets[register_packet_index].register_count;
+   }
+
+   // By the opcode for type 3, and 0x100 + the type for the others.
+   PM4H_PacketCounts counts[0x100 + 3] = {{0, 0}};
+   uint32_t pm4_dword_index = 0;
+   bool follows_packet2 = false;
+   while (pm4_dword_index < pm4_dword_count) {
+      uint32_t const header = pm4[pm4_dword_index];
+      uint32_t const packet_type = header >> 30;
+      uint32_t const packet3_opcode = (header >> 8) & 0xFF;
+      // Types 0 and 3 have bodies, except for a NOP containing packets.
+      bool const has_body = packet_type == 0 ||
+                            (packet_type == 3 && (packet3_opcode != 0x10 || !follows_packet2));
+      uint32_t const available_dword_count = pm4_dword_count - pm4_dword_index;
+      uint32_t packet_dword_count = has_body ? 2 + ((header >> 16) & 0x3FFF) : 1;
+      packet_dword_count =
+         packet_dword_count <= available_dword_count ? packet_dword_count : available_dword_count;
+      PM4H_PacketCounts * const packet_counts =
+         &counts[packet_type == 3 ? packet3_opcode : 0x100 + packet_type];
+      ++packet_counts->packet_count;
+      packet_counts->dword_count += packet_dword_count;
+
+      uint32_t const block_register_count =
+         packet_type == 3 ? block_register_counts[packet3_opcode] : 0;
+      if (block_register_count != 0 && packet_dword_count > 2) {
+         uint32_t const value_count = packet_dword_count - 2;
+         uint32_t const first_offset = pm4[pm4_dword_index + 1];
+         uint32_t tracked_count = 0;
+         if (first_offset < block_register_count) {
+            tracked_count = block_register_count - first_offset < value_count
+                               ? block_register_count - first_offset
+                               : value_count;
+            uint64_t * const write_counts = histogram->register_write_counts +
+                                            block_shadow_indices[packet3_opcode] + first_offset;
+            for (uint32_t value_index = 0; value_index < tracked_count; ++value_index) {
+               ++write_counts[value_index];
+            }
+         }
+         histogram->untracked_register_write_count += value_count - tracked_count;
+      }
+      follows_packet2 = packet_type == 2;
+      pm4_dword_index += packet_dword_count;
+   }
+
+   for (uint32_t opcode = 0; opcode < 0x100; ++opcode) {
+      histogram->opcodes[opcode].packet_count += counts[opcode].packet_count;
+      histogram->opcodes[opcode].dword_count += counts[opcode].dword_count;
+      histogram->types[3].packet_count += counts[opcode].packet_count;
+      histogram->types[3].dword_count += counts[opcode].dword_count;
+   }
+   for (uint32_t packet_type = 0; packet_type < 3; ++packet_type) {
+      histogram->types[packet_type].packet_count += counts[0x100 + packet_type].packet_count;
+      histogram->types[packet_type].dword_count += counts[0x100 + packet_type].dword_count;
+   }
+}
+
+static void PM4H_MergePacketCounts(PM4H_PacketCounts * const counts,
+                                   PM4H_PacketCounts const * const source,
+                                   uint32_t const count) {
+   for (uint32_t index = 0; index < count; ++index) {
+      counts[index].packet_count += source[index].packet_count;
+      counts[index].dword_count += source[index].dword_count;
+   }
+}
+
+void PM4H_HistogramMerge(PM4H_Histogram * const histogram, PM4H_Histogram const * const source) {
+   PM4H_MergePacketCounts(histogram->opcodes, source->opcodes,
+                          sizeof(histogram->opcodes) / sizeof(histogram->opcodes[0]));
+   PM4H_MergePacketCounts(histogram->types, source->types,
+                          sizeof(histogram->types) / sizeof(histogram->types[0]));
+   for (uint32_t shadow_index = 0; shadow_index < PM4S_REGISTER_COUNT; ++shadow_index) {
+      histogram->register_write_counts[shadow_index] +=
+         source->register_write_counts[shadow_index];
+   }
+   histogram->untracked_register_write_count += source->untracked_register_write_count;
+}
@@ -1,10 +1,11 @@
 #include "Catanalyst.h"
+#include "TextWriter.h"
 
-#include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 static char const * const pm4p_packet3_opcode_names[0x100] = {
    // Replace:
@@ -61,823 +62,365 @@ static char const * const pm4p_packet3_opcode_names[0x100] = {
    [0x75] = "PKT3_SET_APPEND_CNT",
 };
 
-// Remove:
-// ^#define[ \t]+(?!R_|EG_R_|CM_R_)[^\n]*
-// ^(?!#define)[^\n]*\n*
-//
-// Separate into R8xx and R9xx by removing:
-// ^#define[ \t]+(?!R_|EG_R)[^\n]*\n?
-// or:
-// ^#define[ \t]+(?!CM_R)[^\n]*\n?
-//
-// Then replace:
-// #define[ \t]+([0-9A-Z_]+)[ \t]+(0[Xx][0-9A-Fa-f]+)[^\n]*
-// with:
-//    [\2 / 4] = "\1",
+// For looking up registers in increasing order by walking the table of the family rather than
+// searching every time, as register-setting packets write consecutive registers.
+typedef struct PM4P_RegisterCursor {
+   PM4P_Family const * family;
+   uint32_t position;
+} PM4P_RegisterCursor;
 
-static char const * const pm4p_register_names[] = {
-   [0x0084FC / 4] = "R_0084FC_CP_STRMOUT_CNTL",
-   [0x028B94 / 4] = "R_028B94_VGT_STRMOUT_CONFIG",
-   [0x028B98 / 4] = "R_028B98_VGT_STRMOUT_BUFFER_CONFIG",
-   [0x028A4C / 4] = "EG_R_028A4C_PA_SC_MODE_CNTL_1",
-   [0x008960 / 4] = "R_008960_VGT_STRMOUT_BUFFER_FILLED_SIZE_0",
-   [0x008964 / 4] = "R_008964_VGT_STRMOUT_BUFFER_FILLED_SIZE_1",
-   [0x008968 / 4] = "R_008968_VGT_STRMOUT_BUFFER_FILLED_SIZE_2",
-   [0x00896C / 4] = "R_00896C_VGT_STRMOUT_BUFFER_FILLED_SIZE_3",
-   [0x00008C00 / 4] = "R_008C00_SQ_CONFIG",
-   [0x00008C04 / 4] = "R_008C04_SQ_GPR_RESOURCE_MGMT_1",
-   [0x00008C08 / 4] = "R_008C08_SQ_GPR_RESOURCE_MGMT_2",
-   [0x00008C0C / 4] = "R_008C0C_SQ_GPR_RESOURCE_MGMT_3",
-   [0x00008C10 / 4] = "R_008C10_SQ_GLOBAL_GPR_RESOURCE_MGMT_1",
-   [0x00008C14 / 4] = "R_008C14_SQ_GLOBAL_GPR_RESOURCE_MGMT_2",
-   [0x00008C18 / 4] = "R_008C18_SQ_THREAD_RESOURCE_MGMT_1",
-   [0x00008C1C / 4] = "R_008C1C_SQ_THREAD_RESOURCE_MGMT_2",
-   [0x00008C20 / 4] = "R_008C20_SQ_STACK_RESOURCE_MGMT_1",
-   [0x00008C24 / 4] = "R_008C24_SQ_STACK_RESOURCE_MGMT_2",
-   [0x00008C28 / 4] = "R_008C28_SQ_STACK_RESOURCE_MGMT_3",
-   [0x00008E2C / 4] = "R_008E2C_SQ_LDS_RESOURCE_MGMT",
-   [0x00008C40 / 4] = "R_008C40_SQ_ESGS_RING_BASE",
-   [0x00008C44 / 4] = "R_008C44_SQ_ESGS_RING_SIZE",
-   [0x00008C48 / 4] = "R_008C48_SQ_GSVS_RING_BASE",
-   [0x00008C4C / 4] = "R_008C4C_SQ_GSVS_RING_SIZE",
-   [0x00008CF0 / 4] = "R_008CF0_SQ_MS_FIFO_SIZES",
-   [0x8E20 / 4] = "R_008E20_SQ_STATIC_THREAD_MGMT1",
-   [0x8E24 / 4] = "R_008E24_SQ_STATIC_THREAD_MGMT2",
-   [0x8E28 / 4] = "R_008E28_SQ_STATIC_THREAD_MGMT3",
-   [0x00009100 / 4] = "R_009100_SPI_CONFIG_CNTL",
-   [0x0000913C / 4] = "R_00913C_SPI_CONFIG_CNTL_1",
-   [0x028C64 / 4] = "R_028C64_CB_COLOR0_PITCH",
-   [0x028C68 / 4] = "R_028C68_CB_COLOR0_SLICE",
-   [0x028C70 / 4] = "R_028C70_CB_COLOR0_INFO",
-   [0x028C74 / 4] = "R_028C74_CB_COLOR0_ATTRIB",
-   [0x028C78 / 4] = "R_028C78_CB_COLOR0_DIM",
-   [0x028410 / 4] = "R_028410_SX_ALPHA_TEST_CONTROL",
-   [0x0286EC / 4] = "R_0286EC_SPI_COMPUTE_NUM_THREAD_X",
-   [0x0286F0 / 4] = "R_0286F0_SPI_COMPUTE_NUM_THREAD_Y",
-   [0x0286F4 / 4] = "R_0286F4_SPI_COMPUTE_NUM_THREAD_Z",
-   [0x028B6C / 4] = "R_028B6C_VGT_TF_PARAM",
-   [0x028B74 / 4] = "R_028B74_VGT_DISPATCH_INITIATOR",
-   [0x028800 / 4] = "R_028800_DB_DEPTH_CONTROL",
-   [0x028808 / 4] = "R_028808_CB_COLOR_CONTROL",
-   [0x028810 / 4] = "R_028810_PA_CL_CLIP_CNTL",
-   [0x028040 / 4] = "R_028040_DB_Z_INFO",
-   [0x028044 / 4] = "R_028044_DB_STENCIL_INFO",
-   [0x028058 / 4] = "R_028058_DB_DEPTH_SIZE",
-   [0x02805C / 4] = "R_02805C_DB_DEPTH_SLICE",
-   [0x028430 / 4] = "R_028430_DB_STENCILREFMASK",
-   [0x028434 / 4] = "R_028434_DB_STENCILREFMASK_BF",
-   [0x028780 / 4] = "R_028780_CB_BLEND0_CONTROL",
-   [0x028814 / 4] = "R_028814_PA_SU_SC_MODE_CNTL",
-   [0x028ABC / 4] = "R_028ABC_DB_HTILE_SURFACE",
-   [0x02880C / 4] = "R_02880C_DB_SHADER_CONTROL",
-   [0x028A00 / 4] = "R_028A00_PA_SU_POINT_SIZE",
-   [0x028A0C / 4] = "R_028A0C_PA_SC_LINE_STIPPLE",
-   [0x028A40 / 4] = "R_028A40_VGT_GS_MODE",
-   [0x028A6C / 4] = "R_028A6C_VGT_GS_OUT_PRIM_TYPE",
-   [0x008040 / 4] = "R_008040_WAIT_UNTIL",
-   [0x0286CC / 4] = "R_0286CC_SPI_PS_IN_CONTROL_0",
-   [0x0286D0 / 4] = "R_0286D0_SPI_PS_IN_CONTROL_1",
-   [0x0286C4 / 4] = "R_0286C4_SPI_VS_OUT_CONFIG",
-   [0x0286E0 / 4] = "R_0286E0_SPI_BARYC_CNTL",
-   [0x028250 / 4] = "R_028250_PA_SC_VPORT_SCISSOR_0_TL",
-   [0x028254 / 4] = "R_028254_PA_SC_VPORT_SCISSOR_0_BR",
-   [0x028240 / 4] = "R_028240_PA_SC_GENERIC_SCISSOR_TL",
-   [0x028244 / 4] = "R_028244_PA_SC_GENERIC_SCISSOR_BR",
-   [0x028030 / 4] = "R_028030_PA_SC_SCREEN_SCISSOR_TL",
-   [0x028034 / 4] = "R_028034_PA_SC_SCREEN_SCISSOR_BR",
-   [0x028204 / 4] = "R_028204_PA_SC_WINDOW_SCISSOR_TL",
-   [0x028208 / 4] = "R_028208_PA_SC_WINDOW_SCISSOR_BR",
-   [0x028A78 / 4] = "R_028A78_VGT_DMA_MAX_SIZE",
-   [0x028A7C / 4] = "R_028A7C_VGT_DMA_INDEX_TYPE",
-   [0x028A88 / 4] = "R_028A88_VGT_NUM_INSTANCES",
-   [0x0287E4 / 4] = "R_0287E4_VGT_DMA_BASE_HI",
-   [0x0287E8 / 4] = "R_0287E8_VGT_DMA_BASE",
-   [0x0287F0 / 4] = "R_0287F0_VGT_DRAW_INITIATOR",
-   [0x030000 / 4] = "R_030000_SQ_TEX_RESOURCE_WORD0_0",
-   [0x030004 / 4] = "R_030004_SQ_TEX_RESOURCE_WORD1_0",
-   [0x030008 / 4] = "R_030008_SQ_TEX_RESOURCE_WORD2_0",
-   [0x03000C / 4] = "R_03000C_SQ_TEX_RESOURCE_WORD3_0",
-   [0x030010 / 4] = "R_030010_SQ_TEX_RESOURCE_WORD4_0",
-   [0x030014 / 4] = "R_030014_SQ_TEX_RESOURCE_WORD5_0",
-   [0x030018 / 4] = "R_030018_SQ_TEX_RESOURCE_WORD6_0",
-   [0x03001C / 4] = "R_03001C_SQ_TEX_RESOURCE_WORD7_0",
-   [0x030008 / 4] = "R_030008_SQ_VTX_CONSTANT_WORD2_0",
-   [0x03000C / 4] = "R_03000C_SQ_VTX_CONSTANT_WORD3_0",
-   [0x03FF04 / 4] = "R_03FF04_SQ_TEX_RESOURCE_CLEAR",
-   [0x00A400 / 4] = "R_00A400_TD_PS_SAMPLER0_BORDER_INDEX",
-   [0x00A404 / 4] = "R_00A404_TD_PS_SAMPLER0_BORDER_RED",
-   [0x00A408 / 4] = "R_00A408_TD_PS_SAMPLER0_BORDER_GREEN",
-   [0x00A40C / 4] = "R_00A40C_TD_PS_SAMPLER0_BORDER_BLUE",
-   [0x00A410 / 4] = "R_00A410_TD_PS_SAMPLER0_BORDER_ALPHA",
-   [0x00A414 / 4] = "R_00A414_TD_VS_SAMPLER0_BORDER_INDEX",
-   [0x00A418 / 4] = "R_00A418_TD_VS_SAMPLER0_BORDER_RED",
-   [0x00A41C / 4] = "R_00A41C_TD_VS_SAMPLER0_BORDER_GREEN",
-   [0x00A420 / 4] = "R_00A420_TD_VS_SAMPLER0_BORDER_BLUE",
-   [0x00A424 / 4] = "R_00A424_TD_VS_SAMPLER0_BORDER_ALPHA",
-   [0x00A428 / 4] = "R_00A428_TD_GS_SAMPLER0_BORDER_INDEX",
-   [0x00A42C / 4] = "R_00A42C_TD_GS_SAMPLER0_BORDER_RED",
-   [0x00A430 / 4] = "R_00A430_TD_GS_SAMPLER0_BORDER_GREEN",
-   [0x00A434 / 4] = "R_00A434_TD_GS_SAMPLER0_BORDER_BLUE",
-   [0x00A438 / 4] = "R_00A438_TD_GS_SAMPLER0_BORDER_ALPHA",
-   [0x00A43C / 4] = "R_00A43C_TD_HS_SAMPLER0_BORDER_COLOR_INDEX",
-   [0x00A440 / 4] = "R_00A440_TD_HS_SAMPLER0_BORDER_COLOR_RED",
-   [0x00A444 / 4] = "R_00A444_TD_HS_SAMPLER0_BORDER_COLOR_GREEN",
-   [0x00A448 / 4] = "R_00A448_TD_HS_SAMPLER0_BORDER_COLOR_BLUE",
-   [0x00A44C / 4] = "R_00A44C_TD_HS_SAMPLER0_BORDER_COLOR_ALPHA",
-   [0x00A450 / 4] = "R_00A450_TD_LS_SAMPLER0_BORDER_COLOR_INDEX",
-   [0x00A454 / 4] = "R_00A454_TD_LS_SAMPLER0_BORDER_COLOR_RED",
-   [0x00A458 / 4] = "R_00A458_TD_LS_SAMPLER0_BORDER_COLOR_GREEN",
-   [0x00A45C / 4] = "R_00A45C_TD_LS_SAMPLER0_BORDER_COLOR_BLUE",
-   [0x00A460 / 4] = "R_00A460_TD_LS_SAMPLER0_BORDER_COLOR_ALPHA",
-   [0x00A464 / 4] = "R_00A464_TD_CS_SAMPLER0_BORDER_INDEX",
-   [0x00A468 / 4] = "R_00A468_TD_CS_SAMPLER0_BORDER_RED",
-   [0x00A46C / 4] = "R_00A46C_TD_CS_SAMPLER0_BORDER_GREEN",
-   [0x00A470 / 4] = "R_00A470_TD_CS_SAMPLER0_BORDER_BLUE",
-   [0x00A474 / 4] = "R_00A474_TD_CS_SAMPLER0_BORDER_ALPHA",
-   [0x03C000 / 4] = "R_03C000_SQ_TEX_SAMPLER_WORD0_0",
-   [0x03C004 / 4] = "R_03C004_SQ_TEX_SAMPLER_WORD1_0",
-   [0x03C008 / 4] = "R_03C008_SQ_TEX_SAMPLER_WORD2_0",
-   [0x008958 / 4] = "R_008958_VGT_PRIMITIVE_TYPE",
-   [0x02881C / 4] = "R_02881C_PA_CL_VS_OUT_CNTL",
-   [0x028860 / 4] = "R_028860_SQ_PGM_RESOURCES_VS",
-   [0x028878 / 4] = "R_028878_SQ_PGM_RESOURCES_GS",
-   [0x02887C / 4] = "R_02887C_SQ_PGM_RESOURCES_2_GS",
-   [0x028890 / 4] = "R_028890_SQ_PGM_RESOURCES_ES",
-   [0x028894 / 4] = "R_028894_SQ_PGM_RESOURCES_2_ES",
-   [0x028864 / 4] = "R_028864_SQ_PGM_RESOURCES_2_VS",
-   [0x028844 / 4] = "R_028844_SQ_PGM_RESOURCES_PS",
-   [0x028848 / 4] = "R_028848_SQ_PGM_RESOURCES_2_PS",
-   [0x0288BC / 4] = "R_0288BC_SQ_PGM_RESOURCES_HS",
-   [0x0288c0 / 4] = "R_0288C0_SQ_PGM_RESOURCES_2_HS",
-   [0x0288d4 / 4] = "R_0288D4_SQ_PGM_RESOURCES_LS",
-   [0x0288d8 / 4] = "R_0288D8_SQ_PGM_RESOURCES_2_LS",
-   [0x028644 / 4] = "R_028644_SPI_PS_INPUT_CNTL_0",
-   [0x0286D4 / 4] = "R_0286D4_SPI_INTERP_CONTROL_0",
-   [0x00008A14 / 4] = "R_008A14_PA_CL_ENHANCE",
-   [0x00008D8C / 4] = "R_008D8C_SQ_DYN_GPR_CNTL_PS_FLUSH_REQ",
-   [0x00028000 / 4] = "R_028000_DB_RENDER_CONTROL",
-   [0x00028004 / 4] = "R_028004_DB_COUNT_CONTROL",
-   [0x00028008 / 4] = "R_028008_DB_DEPTH_VIEW",
-   [0x0002800C / 4] = "R_02800C_DB_RENDER_OVERRIDE",
-   [0x00028010 / 4] = "R_028010_DB_RENDER_OVERRIDE2",
-   [0x00028014 / 4] = "R_028014_DB_HTILE_DATA_BASE",
-   [0x00028028 / 4] = "R_028028_DB_STENCIL_CLEAR",
-   [0x0002802C / 4] = "R_02802C_DB_DEPTH_CLEAR",
-   [0x00028048 / 4] = "R_028048_DB_Z_READ_BASE",
-   [0x0002804C / 4] = "R_02804C_DB_STENCIL_READ_BASE",
-   [0x00028050 / 4] = "R_028050_DB_Z_WRITE_BASE",
-   [0x00028054 / 4] = "R_028054_DB_STENCIL_WRITE_BASE",
-   [0x00028140 / 4] = "R_028140_ALU_CONST_BUFFER_SIZE_PS_0",
-   [0x00028144 / 4] = "R_028144_ALU_CONST_BUFFER_SIZE_PS_1",
-   [0x00028180 / 4] = "R_028180_ALU_CONST_BUFFER_SIZE_VS_0",
-   [0x00028184 / 4] = "R_028184_ALU_CONST_BUFFER_SIZE_VS_1",
-   [0x000281C0 / 4] = "R_0281C0_ALU_CONST_BUFFER_SIZE_GS_0",
-   [0x00028F80 / 4] = "R_028F80_ALU_CONST_BUFFER_SIZE_HS_0",
-   [0x00028FC0 / 4] = "R_028FC0_ALU_CONST_BUFFER_SIZE_LS_0",
-   [0x00028200 / 4] = "R_028200_PA_SC_WINDOW_OFFSET",
-   [0x0002820C / 4] = "R_02820C_PA_SC_CLIPRECT_RULE",
-   [0x00028210 / 4] = "R_028210_PA_SC_CLIPRECT_0_TL",
-   [0x00028214 / 4] = "R_028214_PA_SC_CLIPRECT_0_BR",
-   [0x00028218 / 4] = "R_028218_PA_SC_CLIPRECT_1_TL",
-   [0x0002821C / 4] = "R_02821C_PA_SC_CLIPRECT_1_BR",
-   [0x00028220 / 4] = "R_028220_PA_SC_CLIPRECT_2_TL",
-   [0x00028224 / 4] = "R_028224_PA_SC_CLIPRECT_2_BR",
-   [0x00028228 / 4] = "R_028228_PA_SC_CLIPRECT_3_TL",
-   [0x0002822C / 4] = "R_02822C_PA_SC_CLIPRECT_3_BR",
-   [0x00028230 / 4] = "R_028230_PA_SC_EDGERULE",
-   [0x00028234 / 4] = "R_028234_PA_SU_HARDWARE_SCREEN_OFFSET",
-   [0x00028238 / 4] = "R_028238_CB_TARGET_MASK",
-   [0x0002823C / 4] = "R_02823C_CB_SHADER_MASK",
-   [0x00028350 / 4] = "R_028350_SX_MISC",
-   [0x00028354 / 4] = "R_028354_SX_SURFACE_SYNC",
-   [0x00028380 / 4] = "R_028380_SQ_VTX_SEMANTIC_0",
-   [0x00028384 / 4] = "R_028384_SQ_VTX_SEMANTIC_1",
-   [0x00028388 / 4] = "R_028388_SQ_VTX_SEMANTIC_2",
-   [0x0002838C / 4] = "R_02838C_SQ_VTX_SEMANTIC_3",
-   [0x00028390 / 4] = "R_028390_SQ_VTX_SEMANTIC_4",
-   [0x00028394 / 4] = "R_028394_SQ_VTX_SEMANTIC_5",
-   [0x00028398 / 4] = "R_028398_SQ_VTX_SEMANTIC_6",
-   [0x0002839C / 4] = "R_02839C_SQ_VTX_SEMANTIC_7",
-   [0x000283A0 / 4] = "R_0283A0_SQ_VTX_SEMANTIC_8",
-   [0x000283A4 / 4] = "R_0283A4_SQ_VTX_SEMANTIC_9",
-   [0x000283A8 / 4] = "R_0283A8_SQ_VTX_SEMANTIC_10",
-   [0x000283AC / 4] = "R_0283AC_SQ_VTX_SEMANTIC_11",
-   [0x000283B0 / 4] = "R_0283B0_SQ_VTX_SEMANTIC_12",
-   [0x000283B4 / 4] = "R_0283B4_SQ_VTX_SEMANTIC_13",
-   [0x000283B8 / 4] = "R_0283B8_SQ_VTX_SEMANTIC_14",
-   [0x000283BC / 4] = "R_0283BC_SQ_VTX_SEMANTIC_15",
-   [0x000283C0 / 4] = "R_0283C0_SQ_VTX_SEMANTIC_16",
-   [0x000283C4 / 4] = "R_0283C4_SQ_VTX_SEMANTIC_17",
-   [0x000283C8 / 4] = "R_0283C8_SQ_VTX_SEMANTIC_18",
-   [0x000283CC / 4] = "R_0283CC_SQ_VTX_SEMANTIC_19",
-   [0x000283D0 / 4] = "R_0283D0_SQ_VTX_SEMANTIC_20",
-   [0x000283D4 / 4] = "R_0283D4_SQ_VTX_SEMANTIC_21",
-   [0x000283D8 / 4] = "R_0283D8_SQ_VTX_SEMANTIC_22",
-   [0x000283DC / 4] = "R_0283DC_SQ_VTX_SEMANTIC_23",
-   [0x000283E0 / 4] = "R_0283E0_SQ_VTX_SEMANTIC_24",
-   [0x000283E4 / 4] = "R_0283E4_SQ_VTX_SEMANTIC_25",
-   [0x000283E8 / 4] = "R_0283E8_SQ_VTX_SEMANTIC_26",
-   [0x000283EC / 4] = "R_0283EC_SQ_VTX_SEMANTIC_27",
-   [0x000283F0 / 4] = "R_0283F0_SQ_VTX_SEMANTIC_28",
-   [0x000283F4 / 4] = "R_0283F4_SQ_VTX_SEMANTIC_29",
-   [0x000283F8 / 4] = "R_0283F8_SQ_VTX_SEMANTIC_30",
-   [0x000283FC / 4] = "R_0283FC_SQ_VTX_SEMANTIC_31",
-   [0x000288F0 / 4] = "R_0288F0_SQ_VTX_SEMANTIC_CLEAR",
-   [0x0282D0 / 4] = "R_0282D0_PA_SC_VPORT_ZMIN_0",
-   [0x0282D4 / 4] = "R_0282D4_PA_SC_VPORT_ZMAX_0",
-   [0x00028400 / 4] = "R_028400_VGT_MAX_VTX_INDX",
-   [0x00028404 / 4] = "R_028404_VGT_MIN_VTX_INDX",
-   [0x00028408 / 4] = "R_028408_VGT_INDX_OFFSET",
-   [0x0002840C / 4] = "R_02840C_VGT_MULTI_PRIM_IB_RESET_INDX",
-   [0x00028414 / 4] = "R_028414_CB_BLEND_RED",
-   [0x00028418 / 4] = "R_028418_CB_BLEND_GREEN",
-   [0x0002841C / 4] = "R_02841C_CB_BLEND_BLUE",
-   [0x00028420 / 4] = "R_028420_CB_BLEND_ALPHA",
-   [0x00028438 / 4] = "R_028438_SX_ALPHA_REF",
-   [0x0002843C / 4] = "R_02843C_PA_CL_VPORT_XSCALE_0",
-   [0x00028440 / 4] = "R_028440_PA_CL_VPORT_XOFFSET_0",
-   [0x00028444 / 4] = "R_028444_PA_CL_VPORT_YSCALE_0",
-   [0x00028448 / 4] = "R_028448_PA_CL_VPORT_YOFFSET_0",
-   [0x0002844C / 4] = "R_02844C_PA_CL_VPORT_ZSCALE_0",
-   [0x00028450 / 4] = "R_028450_PA_CL_VPORT_ZOFFSET_0",
-   [0x000285BC / 4] = "R_0285BC_PA_CL_UCP0_X",
-   [0x000285C0 / 4] = "R_0285C0_PA_CL_UCP0_Y",
-   [0x000285C4 / 4] = "R_0285C4_PA_CL_UCP0_Z",
-   [0x000285C8 / 4] = "R_0285C8_PA_CL_UCP0_W",
-   [0x000285CC / 4] = "R_0285CC_PA_CL_UCP1_X",
-   [0x000285D0 / 4] = "R_0285D0_PA_CL_UCP1_Y",
-   [0x000285D4 / 4] = "R_0285D4_PA_CL_UCP1_Z",
-   [0x000285D8 / 4] = "R_0285D8_PA_CL_UCP1_W",
-   [0x000285DC / 4] = "R_0285DC_PA_CL_UCP2_X",
-   [0x000285E0 / 4] = "R_0285E0_PA_CL_UCP2_Y",
-   [0x000285E4 / 4] = "R_0285E4_PA_CL_UCP2_Z",
-   [0x000285E8 / 4] = "R_0285E8_PA_CL_UCP2_W",
-   [0x000285EC / 4] = "R_0285EC_PA_CL_UCP3_X",
-   [0x000285F0 / 4] = "R_0285F0_PA_CL_UCP3_Y",
-   [0x000285F4 / 4] = "R_0285F4_PA_CL_UCP3_Z",
-   [0x000285F8 / 4] = "R_0285F8_PA_CL_UCP3_W",
-   [0x000285FC / 4] = "R_0285FC_PA_CL_UCP4_X",
-   [0x00028600 / 4] = "R_028600_PA_CL_UCP4_Y",
-   [0x00028604 / 4] = "R_028604_PA_CL_UCP4_Z",
-   [0x00028608 / 4] = "R_028608_PA_CL_UCP4_W",
-   [0x0002860C / 4] = "R_02860C_PA_CL_UCP5_X",
-   [0x00028610 / 4] = "R_028610_PA_CL_UCP5_Y",
-   [0x00028614 / 4] = "R_028614_PA_CL_UCP5_Z",
-   [0x00028618 / 4] = "R_028618_PA_CL_UCP5_W",
-   [0x0002861C / 4] = "R_02861C_SPI_VS_OUT_ID_0",
-   [0x00028620 / 4] = "R_028620_SPI_VS_OUT_ID_1",
-   [0x00028624 / 4] = "R_028624_SPI_VS_OUT_ID_2",
-   [0x00028628 / 4] = "R_028628_SPI_VS_OUT_ID_3",
-   [0x0002862C / 4] = "R_02862C_SPI_VS_OUT_ID_4",
-   [0x00028630 / 4] = "R_028630_SPI_VS_OUT_ID_5",
-   [0x00028634 / 4] = "R_028634_SPI_VS_OUT_ID_6",
-   [0x00028638 / 4] = "R_028638_SPI_VS_OUT_ID_7",
-   [0x0002863C / 4] = "R_02863C_SPI_VS_OUT_ID_8",
-   [0x00028640 / 4] = "R_028640_SPI_VS_OUT_ID_9",
-   [0x00028648 / 4] = "R_028648_SPI_PS_INPUT_CNTL_1",
-   [0x0002864C / 4] = "R_02864C_SPI_PS_INPUT_CNTL_2",
-   [0x00028650 / 4] = "R_028650_SPI_PS_INPUT_CNTL_3",
-   [0x00028654 / 4] = "R_028654_SPI_PS_INPUT_CNTL_4",
-   [0x00028658 / 4] = "R_028658_SPI_PS_INPUT_CNTL_5",
-   [0x0002865C / 4] = "R_02865C_SPI_PS_INPUT_CNTL_6",
-   [0x00028660 / 4] = "R_028660_SPI_PS_INPUT_CNTL_7",
-   [0x00028664 / 4] = "R_028664_SPI_PS_INPUT_CNTL_8",
-   [0x00028668 / 4] = "R_028668_SPI_PS_INPUT_CNTL_9",
-   [0x0002866C / 4] = "R_02866C_SPI_PS_INPUT_CNTL_10",
-   [0x00028670 / 4] = "R_028670_SPI_PS_INPUT_CNTL_11",
-   [0x00028674 / 4] = "R_028674_SPI_PS_INPUT_CNTL_12",
-   [0x00028678 / 4] = "R_028678_SPI_PS_INPUT_CNTL_13",
-   [0x0002867C / 4] = "R_02867C_SPI_PS_INPUT_CNTL_14",
-   [0x00028680 / 4] = "R_028680_SPI_PS_INPUT_CNTL_15",
-   [0x00028684 / 4] = "R_028684_SPI_PS_INPUT_CNTL_16",
-   [0x00028688 / 4] = "R_028688_SPI_PS_INPUT_CNTL_17",
-   [0x0002868C / 4] = "R_02868C_SPI_PS_INPUT_CNTL_18",
-   [0x00028690 / 4] = "R_028690_SPI_PS_INPUT_CNTL_19",
-   [0x00028694 / 4] = "R_028694_SPI_PS_INPUT_CNTL_20",
-   [0x00028698 / 4] = "R_028698_SPI_PS_INPUT_CNTL_21",
-   [0x0002869C / 4] = "R_02869C_SPI_PS_INPUT_CNTL_22",
-   [0x000286A0 / 4] = "R_0286A0_SPI_PS_INPUT_CNTL_23",
-   [0x000286A4 / 4] = "R_0286A4_SPI_PS_INPUT_CNTL_24",
-   [0x000286A8 / 4] = "R_0286A8_SPI_PS_INPUT_CNTL_25",
-   [0x000286AC / 4] = "R_0286AC_SPI_PS_INPUT_CNTL_26",
-   [0x000286B0 / 4] = "R_0286B0_SPI_PS_INPUT_CNTL_27",
-   [0x000286B4 / 4] = "R_0286B4_SPI_PS_INPUT_CNTL_28",
-   [0x000286B8 / 4] = "R_0286B8_SPI_PS_INPUT_CNTL_29",
-   [0x000286BC / 4] = "R_0286BC_SPI_PS_INPUT_CNTL_30",
-   [0x000286C0 / 4] = "R_0286C0_SPI_PS_INPUT_CNTL_31",
-   [0x000286C8 / 4] = "R_0286C8_SPI_THREAD_GROUPING",
-   [0x000286D8 / 4] = "R_0286D8_SPI_INPUT_Z",
-   [0x000286DC / 4] = "R_0286DC_SPI_FOG_CNTL",
-   [0x000286E4 / 4] = "R_0286E4_SPI_PS_IN_CONTROL_2",
-   [0x000286E8 / 4] = "R_0286E8_SPI_COMPUTE_INPUT_CNTL",
-   [0x00028720 / 4] = "R_028720_GDS_ADDR_BASE",
-   [0x00028724 / 4] = "R_028724_GDS_ADDR_SIZE",
-   [0x00028728 / 4] = "R_028728_GDS_ORDERED_WAVE_PER_SE",
-   [0x0002872C / 4] = "R_02872C_GDS_APPEND_COUNT_0",
-   [0x00028730 / 4] = "R_028730_GDS_APPEND_COUNT_1",
-   [0x00028734 / 4] = "R_028734_GDS_APPEND_COUNT_2",
-   [0x00028738 / 4] = "R_028738_GDS_APPEND_COUNT_3",
-   [0x0002873C / 4] = "R_02873C_GDS_APPEND_COUNT_4",
-   [0x00028740 / 4] = "R_028740_GDS_APPEND_COUNT_5",
-   [0x00028744 / 4] = "R_028748_GDS_APPEND_COUNT_6",
-   [0x00028748 / 4] = "R_028744_GDS_APPEND_COUNT_7",
-   [0x0002874C / 4] = "R_028744_GDS_APPEND_COUNT_8",
-   [0x00028750 / 4] = "R_028744_GDS_APPEND_COUNT_9",
-   [0x00028754 / 4] = "R_028744_GDS_APPEND_COUNT_10",
-   [0x00028758 / 4] = "R_028744_GDS_APPEND_COUNT_11",
-   [0x00028784 / 4] = "R_028784_CB_BLEND1_CONTROL",
-   [0x00028788 / 4] = "R_028788_CB_BLEND2_CONTROL",
-   [0x0002878C / 4] = "R_02878C_CB_BLEND3_CONTROL",
-   [0x00028790 / 4] = "R_028790_CB_BLEND4_CONTROL",
-   [0x00028794 / 4] = "R_028794_CB_BLEND5_CONTROL",
-   [0x00028798 / 4] = "R_028798_CB_BLEND6_CONTROL",
-   [0x0002879C / 4] = "R_02879C_CB_BLEND7_CONTROL",
-   [0x00028818 / 4] = "R_028818_PA_CL_VTE_CNTL",
-   [0x00028820 / 4] = "R_028820_PA_CL_NANINF_CNTL",
-   [0x00028830 / 4] = "R_028830_SQ_LSTMP_RING_ITEMSIZE",
-   [0x00028838 / 4] = "R_028838_SQ_DYN_GPR_RESOURCE_LIMIT_1",
-   [0x00028840 / 4] = "R_028840_SQ_PGM_START_PS",
-   [0x0002884C / 4] = "R_02884C_SQ_PGM_EXPORTS_PS",
-   [0x0002885C / 4] = "R_02885C_SQ_PGM_START_VS",
-   [0x00028874 / 4] = "R_028874_SQ_PGM_START_GS",
-   [0x0002888C / 4] = "R_02888C_SQ_PGM_START_ES",
-   [0x000288A4 / 4] = "R_0288A4_SQ_PGM_START_FS",
-   [0x000288B8 / 4] = "R_0288B8_SQ_PGM_START_HS",
-   [0x000288D0 / 4] = "R_0288D0_SQ_PGM_START_LS",
-   [0x000288A8 / 4] = "R_0288A8_SQ_PGM_RESOURCES_FS",
-   [0x000288E8 / 4] = "R_0288E8_SQ_LDS_ALLOC",
-   [0x000288EC / 4] = "R_0288EC_SQ_LDS_ALLOC_PS",
-   [0x00028900 / 4] = "R_028900_SQ_ESGS_RING_ITEMSIZE",
-   [0x00028904 / 4] = "R_028904_SQ_GSVS_RING_ITEMSIZE",
-   [0x00008C50 / 4] = "R_008C50_SQ_ESTMP_RING_BASE",
-   [0x00028908 / 4] = "R_028908_SQ_ESTMP_RING_ITEMSIZE",
-   [0x00008C54 / 4] = "R_008C54_SQ_ESTMP_RING_SIZE",
-   [0x00008C58 / 4] = "R_008C58_SQ_GSTMP_RING_BASE",
-   [0x0002890C / 4] = "R_02890C_SQ_GSTMP_RING_ITEMSIZE",
-   [0x00008C5C / 4] = "R_008C5C_SQ_GSTMP_RING_SIZE",
-   [0x00008C60 / 4] = "R_008C60_SQ_VSTMP_RING_BASE",
-   [0x00028910 / 4] = "R_028910_SQ_VSTMP_RING_ITEMSIZE",
-   [0x00008C64 / 4] = "R_008C64_SQ_VSTMP_RING_SIZE",
-   [0x00008C68 / 4] = "R_008C68_SQ_PSTMP_RING_BASE",
-   [0x00028914 / 4] = "R_028914_SQ_PSTMP_RING_ITEMSIZE",
-   [0x00008C6C / 4] = "R_008C6C_SQ_PSTMP_RING_SIZE",
-   [0x00008E10 / 4] = "R_008E10_SQ_LSTMP_RING_BASE",
-   [0x00028830 / 4] = "R_028830_SQ_LSTMP_RING_ITEMSIZE",
-   [0x00008E14 / 4] = "R_008E14_SQ_LSTMP_RING_SIZE",
-   [0x00008E18 / 4] = "R_008E18_SQ_HSTMP_RING_BASE",
-   [0x00028834 / 4] = "R_028834_SQ_HSTMP_RING_ITEMSIZE",
-   [0x00008E1C / 4] = "R_008E1C_SQ_HSTMP_RING_SIZE",
-   [0x0002891C / 4] = "R_02891C_SQ_GS_VERT_ITEMSIZE",
-   [0x00028920 / 4] = "R_028920_SQ_GS_VERT_ITEMSIZE_1",
-   [0x00028924 / 4] = "R_028924_SQ_GS_VERT_ITEMSIZE_2",
-   [0x00028928 / 4] = "R_028928_SQ_GS_VERT_ITEMSIZE_3",
-   [0x0002892C / 4] = "R_02892C_SQ_GSVS_RING_OFFSET_1",
-   [0x00028930 / 4] = "R_028930_SQ_GSVS_RING_OFFSET_2",
-   [0x00028934 / 4] = "R_028934_SQ_GSVS_RING_OFFSET_3",
-   [0x00028940 / 4] = "R_028940_ALU_CONST_CACHE_PS_0",
-   [0x00028944 / 4] = "R_028944_ALU_CONST_CACHE_PS_1",
-   [0x00028980 / 4] = "R_028980_ALU_CONST_CACHE_VS_0",
-   [0x00028984 / 4] = "R_028984_ALU_CONST_CACHE_VS_1",
-   [0x000289C0 / 4] = "R_0289C0_ALU_CONST_CACHE_GS_0",
-   [0x00028F00 / 4] = "R_028F00_ALU_CONST_CACHE_HS_0",
-   [0x00028F40 / 4] = "R_028F40_ALU_CONST_CACHE_LS_0",
-   [0x00028A04 / 4] = "R_028A04_PA_SU_POINT_MINMAX",
-   [0x00028A08 / 4] = "R_028A08_PA_SU_LINE_CNTL",
-   [0x00028A10 / 4] = "R_028A10_VGT_OUTPUT_PATH_CNTL",
-   [0x00028A14 / 4] = "R_028A14_VGT_HOS_CNTL",
-   [0x00028A18 / 4] = "R_028A18_VGT_HOS_MAX_TESS_LEVEL",
-   [0x00028A1C / 4] = "R_028A1C_VGT_HOS_MIN_TESS_LEVEL",
-   [0x00028A20 / 4] = "R_028A20_VGT_HOS_REUSE_DEPTH",
-   [0x00028A24 / 4] = "R_028A24_VGT_GROUP_PRIM_TYPE",
-   [0x00028A28 / 4] = "R_028A28_VGT_GROUP_FIRST_DECR",
-   [0x00028A2C / 4] = "R_028A2C_VGT_GROUP_DECR",
-   [0x00028A30 / 4] = "R_028A30_VGT_GROUP_VECT_0_CNTL",
-   [0x00028A34 / 4] = "R_028A34_VGT_GROUP_VECT_1_CNTL",
-   [0x00028A38 / 4] = "R_028A38_VGT_GROUP_VECT_0_FMT_CNTL",
-   [0x00028A3C / 4] = "R_028A3C_VGT_GROUP_VECT_1_FMT_CNTL",
-   [0x00028A48 / 4] = "R_028A48_PA_SC_MODE_CNTL_0",
-   [0x00028A4C / 4] = "R_028A4C_PA_SC_MODE_CNTL_1",
-   [0x00028A54 / 4] = "R_028A54_GS_PER_ES",
-   [0x00028A58 / 4] = "R_028A58_ES_PER_GS",
-   [0x00028A5C / 4] = "R_028A5C_GS_PER_VS",
-   [0x028A84 / 4] = "R_028A84_VGT_PRIMITIVEID_EN",
-   [0x00028A94 / 4] = "R_028A94_VGT_MULTI_PRIM_IB_RESET_EN",
-   [0x00028AB4 / 4] = "R_028AB4_VGT_REUSE_OFF",
-   [0x00028AB8 / 4] = "R_028AB8_VGT_VTX_CNT_EN",
-   [0x00028AC0 / 4] = "R_028AC0_DB_SRESULTS_COMPARE_STATE0",
-   [0x00028AC4 / 4] = "R_028AC4_DB_SRESULTS_COMPARE_STATE1",
-   [0x00028AC8 / 4] = "R_028AC8_DB_PRELOAD_CONTROL",
-   [0x028AD0 / 4] = "R_028AD0_VGT_STRMOUT_BUFFER_SIZE_0",
-   [0x028AD4 / 4] = "R_028AD4_VGT_STRMOUT_VTX_STRIDE_0",
-   [0x028AD8 / 4] = "R_028AD8_VGT_STRMOUT_BUFFER_BASE_0",
-   [0x028ADC / 4] = "R_028ADC_VGT_STRMOUT_BUFFER_OFFSET_0",
-   [0x028AE0 / 4] = "R_028AE0_VGT_STRMOUT_BUFFER_SIZE_1",
-   [0x028AE4 / 4] = "R_028AE4_VGT_STRMOUT_VTX_STRIDE_1",
-   [0x028AE8 / 4] = "R_028AE8_VGT_STRMOUT_BUFFER_BASE_1",
-   [0x028AEC / 4] = "R_028AEC_VGT_STRMOUT_BUFFER_OFFSET_1",
-   [0x028AF0 / 4] = "R_028AF0_VGT_STRMOUT_BUFFER_SIZE_2",
-   [0x028AF4 / 4] = "R_028AF4_VGT_STRMOUT_VTX_STRIDE_2",
-   [0x028AF8 / 4] = "R_028AF8_VGT_STRMOUT_BUFFER_BASE_2",
-   [0x028AFC / 4] = "R_028AFC_VGT_STRMOUT_BUFFER_OFFSET_2",
-   [0x028B00 / 4] = "R_028B00_VGT_STRMOUT_BUFFER_SIZE_3",
-   [0x028B04 / 4] = "R_028B04_VGT_STRMOUT_VTX_STRIDE_3",
-   [0x028B08 / 4] = "R_028B08_VGT_STRMOUT_BUFFER_BASE_3",
-   [0x028B0C / 4] = "R_028B0C_VGT_STRMOUT_BUFFER_OFFSET_3",
-   [0x028B10 / 4] = "R_028B10_VGT_STRMOUT_BASE_OFFSET_0",
-   [0x028B14 / 4] = "R_028B14_VGT_STRMOUT_BASE_OFFSET_1",
-   [0x028B18 / 4] = "R_028B18_VGT_STRMOUT_BASE_OFFSET_2",
-   [0x028B1C / 4] = "R_028B1C_VGT_STRMOUT_BASE_OFFSET_3",
-   [0x028B28 / 4] = "R_028B28_VGT_STRMOUT_DRAW_OPAQUE_OFFSET",
-   [0x028B2C / 4] = "R_028B2C_VGT_STRMOUT_DRAW_OPAQUE_BUFFER_FILLED_SIZE",
-   [0x028B30 / 4] = "R_028B30_VGT_STRMOUT_DRAW_OPAQUE_VERTEX_STRIDE",
-   [0x028B38 / 4] = "R_028B38_VGT_GS_MAX_VERT_OUT",
-   [0x028B44 / 4] = "R_028B44_VGT_STRMOUT_BASE_OFFSET_HI_0",
-   [0x028B48 / 4] = "R_028B48_VGT_STRMOUT_BASE_OFFSET_HI_1",
-   [0x028B4C / 4] = "R_028B4C_VGT_STRMOUT_BASE_OFFSET_HI_2",
-   [0x028B50 / 4] = "R_028B50_VGT_STRMOUT_BASE_OFFSET_HI_3",
-   [0x00028B54 / 4] = "R_028B54_VGT_SHADER_STAGES_EN",
-   [0x00028B58 / 4] = "R_028B58_VGT_LS_HS_CONFIG",
-   [0x00028B5C / 4] = "R_028B5C_VGT_LS_SIZE",
-   [0x00028B60 / 4] = "R_028B60_VGT_HS_SIZE",
-   [0x00028B64 / 4] = "R_028B64_VGT_LS_HS_ALLOC",
-   [0x00028B68 / 4] = "R_028B68_VGT_HS_PATCH_CONST",
-   [0x00028B70 / 4] = "R_028B70_DB_ALPHA_TO_MASK",
-   [0x00028B78 / 4] = "R_028B78_PA_SU_POLY_OFFSET_DB_FMT_CNTL",
-   [0x00028B7C / 4] = "R_028B7C_PA_SU_POLY_OFFSET_CLAMP",
-   [0x00028B80 / 4] = "R_028B80_PA_SU_POLY_OFFSET_FRONT_SCALE",
-   [0x00028B84 / 4] = "R_028B84_PA_SU_POLY_OFFSET_FRONT_OFFSET",
-   [0x00028B88 / 4] = "R_028B88_PA_SU_POLY_OFFSET_BACK_SCALE",
-   [0x00028B8C / 4] = "R_028B8C_PA_SU_POLY_OFFSET_BACK_OFFSET",
-   [0x00028B90 / 4] = "R_028B90_VGT_GS_INSTANCE_CNT",
-   [0x028B98 / 4] = "R_028B98_VGT_STRMOUT_BUFFER_CONFIG",
-   [0x00028B9C / 4] = "R_028B9C_CB_IMMED0_BASE",
-   [0x00028BA0 / 4] = "R_028BA0_CB_IMMED1_BASE",
-   [0x00028BA4 / 4] = "R_028BA4_CB_IMMED2_BASE",
-   [0x00028BA8 / 4] = "R_028BA4_CB_IMMED3_BASE",
-   [0x00028BAC / 4] = "R_028BA4_CB_IMMED4_BASE",
-   [0x00028BB0 / 4] = "R_028BA4_CB_IMMED5_BASE",
-   [0x00028BB4 / 4] = "R_028BA4_CB_IMMED6_BASE",
-   [0x00028BB8 / 4] = "R_028BA4_CB_IMMED7_BASE",
-   [0x00028BBC / 4] = "R_028BA4_CB_IMMED8_BASE",
-   [0x00028BC0 / 4] = "R_028BA4_CB_IMMED9_BASE",
-   [0x00028BC4 / 4] = "R_028BA4_CB_IMMED10_BASE",
-   [0x00028BC8 / 4] = "R_028BA4_CB_IMMED11_BASE",
-   [0x00028C00 / 4] = "R_028C00_PA_SC_LINE_CNTL",
-   [0x00028C04 / 4] = "R_028C04_PA_SC_AA_CONFIG",
-   [0x00028C08 / 4] = "R_028C08_PA_SU_VTX_CNTL",
-   [0x00028C0C / 4] = "R_028C0C_PA_CL_GB_VERT_CLIP_ADJ",
-   [0x00028C10 / 4] = "R_028C10_PA_CL_GB_VERT_DISC_ADJ",
-   [0x00028C14 / 4] = "R_028C14_PA_CL_GB_HORZ_CLIP_ADJ",
-   [0x00028C18 / 4] = "R_028C18_PA_CL_GB_HORZ_DISC_ADJ",
-   [0x00028C1C / 4] = "R_028C1C_PA_SC_AA_SAMPLE_LOCS_0",
-   [0x00028C20 / 4] = "R_028C20_PA_SC_AA_SAMPLE_LOCS_1",
-   [0x00028C24 / 4] = "R_028C24_PA_SC_AA_SAMPLE_LOCS_2",
-   [0x00028C28 / 4] = "R_028C28_PA_SC_AA_SAMPLE_LOCS_3",
-   [0x00028C2C / 4] = "R_028C2C_PA_SC_AA_SAMPLE_LOCS_4",
-   [0x00028C30 / 4] = "R_028C30_PA_SC_AA_SAMPLE_LOCS_5",
-   [0x00028C34 / 4] = "R_028C34_PA_SC_AA_SAMPLE_LOCS_6",
-   [0x00028C38 / 4] = "R_028C38_PA_SC_AA_SAMPLE_LOCS_7",
-   [0x00028C3C / 4] = "R_028C3C_PA_SC_AA_MASK",
-   [0x00028C60 / 4] = "R_028C60_CB_COLOR0_BASE",
-   [0x00028C6C / 4] = "R_028C6C_CB_COLOR0_VIEW",
-   [0x028C7C / 4] = "R_028C7C_CB_COLOR0_CMASK",
-   [0x028C80 / 4] = "R_028C80_CB_COLOR0_CMASK_SLICE",
-   [0x028C84 / 4] = "R_028C84_CB_COLOR0_FMASK",
-   [0x028C88 / 4] = "R_028C88_CB_COLOR0_FMASK_SLICE",
-   [0x028C8C / 4] = "R_028C8C_CB_COLOR0_CLEAR_WORD0",
-   [0x028C90 / 4] = "R_028C90_CB_COLOR0_CLEAR_WORD1",
-   [0x028C94 / 4] = "R_028C94_CB_COLOR0_CLEAR_WORD2",
-   [0x028C98 / 4] = "R_028C98_CB_COLOR0_CLEAR_WORD3",
-   [0x00028C9C / 4] = "R_028C9C_CB_COLOR1_BASE",
-   [0x00028CA0 / 4] = "R_028CA0_CB_COLOR1_PITCH",
-   [0x00028CA4 / 4] = "R_028CA4_CB_COLOR1_SLICE",
-   [0x00028CA8 / 4] = "R_028CA8_CB_COLOR1_VIEW",
-   [0x00028CAC / 4] = "R_028CAC_CB_COLOR1_INFO",
-   [0x00028CB0 / 4] = "R_028CB0_CB_COLOR1_ATTRIB",
-   [0x00028CB4 / 4] = "R_028CB4_CB_COLOR1_DIM",
-   [0x028CB8 / 4] = "R_028CB8_CB_COLOR1_CMASK",
-   [0x028CBC / 4] = "R_028CBC_CB_COLOR1_CMASK_SLICE",
-   [0x028CC0 / 4] = "R_028CC0_CB_COLOR1_FMASK",
-   [0x028CC4 / 4] = "R_028CC4_CB_COLOR1_FMASK_SLICE",
-   [0x028CC8 / 4] = "R_028CC8_CB_COLOR1_CLEAR_WORD0",
-   [0x028CCC / 4] = "R_028CCC_CB_COLOR1_CLEAR_WORD1",
-   [0x028CD0 / 4] = "R_028CD0_CB_COLOR1_CLEAR_WORD2",
-   [0x028CD4 / 4] = "R_028CD4_CB_COLOR1_CLEAR_WORD3",
-   [0x00028CD8 / 4] = "R_028CD8_CB_COLOR2_BASE",
-   [0x00028CDC / 4] = "R_028CDC_CB_COLOR2_PITCH",
-   [0x00028CE0 / 4] = "R_028CE0_CB_COLOR2_SLICE",
-   [0x00028CE4 / 4] = "R_028CE4_CB_COLOR2_VIEW",
-   [0x00028CE8 / 4] = "R_028CE8_CB_COLOR2_INFO",
-   [0x00028CEC / 4] = "R_028CEC_CB_COLOR2_ATTRIB",
-   [0x00028CF0 / 4] = "R_028CF0_CB_COLOR2_DIM",
-   [0x028CF4 / 4] = "R_028CF4_CB_COLOR2_CMASK",
-   [0x028CF8 / 4] = "R_028CF8_CB_COLOR2_CMASK_SLICE",
-   [0x028CFC / 4] = "R_028CFC_CB_COLOR2_FMASK",
-   [0x028D00 / 4] = "R_028D00_CB_COLOR2_FMASK_SLICE",
-   [0x028D04 / 4] = "R_028D04_CB_COLOR2_CLEAR_WORD0",
-   [0x028D08 / 4] = "R_028D08_CB_COLOR2_CLEAR_WORD1",
-   [0x028D0C / 4] = "R_028D0C_CB_COLOR2_CLEAR_WORD2",
-   [0x028D10 / 4] = "R_028D10_CB_COLOR2_CLEAR_WORD3",
-   [0x00028D14 / 4] = "R_028D14_CB_COLOR3_BASE",
-   [0x00028D18 / 4] = "R_028D18_CB_COLOR3_PITCH",
-   [0x00028D1C / 4] = "R_028D1C_CB_COLOR3_SLICE",
-   [0x00028D20 / 4] = "R_028D20_CB_COLOR3_VIEW",
-   [0x00028D24 / 4] = "R_028D24_CB_COLOR3_INFO",
-   [0x00028D28 / 4] = "R_028D28_CB_COLOR3_ATTRIB",
-   [0x00028D2C / 4] = "R_028D2C_CB_COLOR3_DIM",
-   [0x028D30 / 4] = "R_028D30_CB_COLOR3_CMASK",
-   [0x028D34 / 4] = "R_028D34_CB_COLOR3_CMASK_SLICE",
-   [0x028D38 / 4] = "R_028D38_CB_COLOR3_FMASK",
-   [0x028D3C / 4] = "R_028D3C_CB_COLOR3_FMASK_SLICE",
-   [0x028D40 / 4] = "R_028D40_CB_COLOR3_CLEAR_WORD0",
-   [0x028D44 / 4] = "R_028D44_CB_COLOR3_CLEAR_WORD1",
-   [0x028D48 / 4] = "R_028D48_CB_COLOR3_CLEAR_WORD2",
-   [0x028D4C / 4] = "R_028D4C_CB_COLOR3_CLEAR_WORD3",
-   [0x00028D50 / 4] = "R_028D50_CB_COLOR4_BASE",
-   [0x00028D54 / 4] = "R_028D54_CB_COLOR4_PITCH",
-   [0x00028D58 / 4] = "R_028D58_CB_COLOR4_SLICE",
-   [0x00028D5C / 4] = "R_028D5C_CB_COLOR4_VIEW",
-   [0x00028D60 / 4] = "R_028D60_CB_COLOR4_INFO",
-   [0x00028D64 / 4] = "R_028D64_CB_COLOR4_ATTRIB",
-   [0x00028D68 / 4] = "R_028D68_CB_COLOR4_DIM",
-   [0x028D6C / 4] = "R_028D6C_CB_COLOR4_CMASK",
-   [0x028D70 / 4] = "R_028D70_CB_COLOR4_CMASK_SLICE",
-   [0x028D74 / 4] = "R_028D74_CB_COLOR4_FMASK",
-   [0x028D78 / 4] = "R_028D78_CB_COLOR4_FMASK_SLICE",
-   [0x028D7C / 4] = "R_028D7C_CB_COLOR4_CLEAR_WORD0",
-   [0x028D80 / 4] = "R_028D80_CB_COLOR4_CLEAR_WORD1",
-   [0x028D84 / 4] = "R_028D84_CB_COLOR4_CLEAR_WORD2",
-   [0x028D88 / 4] = "R_028D88_CB_COLOR4_CLEAR_WORD3",
-   [0x00028D8C / 4] = "R_028D8C_CB_COLOR5_BASE",
-   [0x00028D90 / 4] = "R_028D90_CB_COLOR5_PITCH",
-   [0x00028D94 / 4] = "R_028D94_CB_COLOR5_SLICE",
-   [0x00028D98 / 4] = "R_028D98_CB_COLOR5_VIEW",
-   [0x00028D9C / 4] = "R_028D9C_CB_COLOR5_INFO",
-   [0x00028DA0 / 4] = "R_028DA0_CB_COLOR5_ATTRIB",
-   [0x00028DA4 / 4] = "R_028DA4_CB_COLOR5_DIM",
-   [0x028DA8 / 4] = "R_028DA8_CB_COLOR5_CMASK",
-   [0x028DAC / 4] = "R_028DAC_CB_COLOR5_CMASK_SLICE",
-   [0x028DB0 / 4] = "R_028DB0_CB_COLOR5_FMASK",
-   [0x028DB4 / 4] = "R_028DB4_CB_COLOR5_FMASK_SLICE",
-   [0x028DB8 / 4] = "R_028DB8_CB_COLOR5_CLEAR_WORD0",
-   [0x028DBC / 4] = "R_028DBC_CB_COLOR5_CLEAR_WORD1",
-   [0x028DC0 / 4] = "R_028DC0_CB_COLOR5_CLEAR_WORD2",
-   [0x028DC4 / 4] = "R_028DC4_CB_COLOR5_CLEAR_WORD3",
-   [0x00028DC8 / 4] = "R_028DC8_CB_COLOR6_BASE",
-   [0x00028DCC / 4] = "R_028DCC_CB_COLOR6_PITCH",
-   [0x00028DD0 / 4] = "R_028DD0_CB_COLOR6_SLICE",
-   [0x00028DD4 / 4] = "R_028DD4_CB_COLOR6_VIEW",
-   [0x00028DD8 / 4] = "R_028DD8_CB_COLOR6_INFO",
-   [0x00028DDC / 4] = "R_028DDC_CB_COLOR6_ATTRIB",
-   [0x00028DE0 / 4] = "R_028DE0_CB_COLOR6_DIM",
-   [0x028DE4 / 4] = "R_028DE4_CB_COLOR6_CMASK",
-   [0x028DE8 / 4] = "R_028DE8_CB_COLOR6_CMASK_SLICE",
-   [0x028DEC / 4] = "R_028DEC_CB_COLOR6_FMASK",
-   [0x028DF0 / 4] = "R_028DF0_CB_COLOR6_FMASK_SLICE",
-   [0x028DF4 / 4] = "R_028DF4_CB_COLOR6_CLEAR_WORD0",
-   [0x028DF8 / 4] = "R_028DF8_CB_COLOR6_CLEAR_WORD1",
-   [0x028DFC / 4] = "R_028DFC_CB_COLOR6_CLEAR_WORD2",
-   [0x028E00 / 4] = "R_028E00_CB_COLOR6_CLEAR_WORD3",
-   [0x00028E04 / 4] = "R_028E04_CB_COLOR7_BASE",
-   [0x00028E08 / 4] = "R_028E08_CB_COLOR7_PITCH",
-   [0x00028E0C / 4] = "R_028E0C_CB_COLOR7_SLICE",
-   [0x00028E10 / 4] = "R_028E10_CB_COLOR7_VIEW",
-   [0x00028E14 / 4] = "R_028E14_CB_COLOR7_INFO",
-   [0x00028E18 / 4] = "R_028E18_CB_COLOR7_ATTRIB",
-   [0x00028E1C / 4] = "R_028E1C_CB_COLOR7_DIM",
-   [0x028E20 / 4] = "R_028E20_CB_COLOR7_CMASK",
-   [0x028E24 / 4] = "R_028E24_CB_COLOR7_CMASK_SLICE",
-   [0x028E28 / 4] = "R_028E28_CB_COLOR7_FMASK",
-   [0x028E2C / 4] = "R_028E2C_CB_COLOR7_FMASK_SLICE",
-   [0x028E30 / 4] = "R_028E30_CB_COLOR7_CLEAR_WORD0",
-   [0x028E34 / 4] = "R_028E34_CB_COLOR7_CLEAR_WORD1",
-   [0x028E38 / 4] = "R_028E38_CB_COLOR7_CLEAR_WORD2",
-   [0x028E3C / 4] = "R_028E3C_CB_COLOR7_CLEAR_WORD3",
-   [0x00028E40 / 4] = "R_028E40_CB_COLOR8_BASE",
-   [0x00028E44 / 4] = "R_028E44_CB_COLOR8_PITCH",
-   [0x00028E48 / 4] = "R_028E48_CB_COLOR8_SLICE",
-   [0x00028E4C / 4] = "R_028E4C_CB_COLOR8_VIEW",
-   [0x00028E50 / 4] = "R_028E50_CB_COLOR8_INFO",
-   [0x00028E54 / 4] = "R_028E54_CB_COLOR8_ATTRIB",
-   [0x00028E58 / 4] = "R_028E58_CB_COLOR8_DIM",
-   [0x00028E5C / 4] = "R_028E5C_CB_COLOR9_BASE",
-   [0x00028E60 / 4] = "R_028E60_CB_COLOR9_PITCH",
-   [0x00028E64 / 4] = "R_028E64_CB_COLOR9_SLICE",
-   [0x00028E68 / 4] = "R_028E68_CB_COLOR9_VIEW",
-   [0x00028E6C / 4] = "R_028E6C_CB_COLOR9_INFO",
-   [0x00028E70 / 4] = "R_028E70_CB_COLOR9_ATTRIB",
-   [0x00028E74 / 4] = "R_028E74_CB_COLOR9_DIM",
-   [0x00028E78 / 4] = "R_028E78_CB_COLOR10_BASE",
-   [0x00028E7C / 4] = "R_028E7C_CB_COLOR10_PITCH",
-   [0x00028E80 / 4] = "R_028E80_CB_COLOR10_SLICE",
-   [0x00028E84 / 4] = "R_028E84_CB_COLOR10_VIEW",
-   [0x00028E88 / 4] = "R_028E88_CB_COLOR10_INFO",
-   [0x00028E8C / 4] = "R_028E8C_CB_COLOR10_ATTRIB",
-   [0x00028E90 / 4] = "R_028E90_CB_COLOR10_DIM",
-   [0x00028E94 / 4] = "R_028E94_CB_COLOR11_BASE",
-   [0x00028E98 / 4] = "R_028E98_CB_COLOR11_PITCH",
-   [0x00028E9C / 4] = "R_028E9C_CB_COLOR11_SLICE",
-   [0x00028EA0 / 4] = "R_028EA0_CB_COLOR11_VIEW",
-   [0x00028EA4 / 4] = "R_028EA4_CB_COLOR11_INFO",
-   [0x00028EA8 / 4] = "R_028EA8_CB_COLOR11_ATTRIB",
-   [0x00028EAC / 4] = "R_028EAC_CB_COLOR11_DIM",
-   [0x00030000 / 4] = "R_030000_RESOURCE0_WORD0",
-   [0x00030004 / 4] = "R_030004_RESOURCE0_WORD1",
-   [0x00030008 / 4] = "R_030008_RESOURCE0_WORD2",
-   [0x0003000C / 4] = "R_03000C_RESOURCE0_WORD3",
-   [0x00030010 / 4] = "R_030010_RESOURCE0_WORD4",
-   [0x00030014 / 4] = "R_030014_RESOURCE0_WORD5",
-   [0x00030018 / 4] = "R_030018_RESOURCE0_WORD6",
-   [0x0003001C / 4] = "R_03001C_RESOURCE0_WORD7",
-   [0x0085F0 / 4] = "R_0085F0_CP_COHER_CNTL",
-   [0x0085F4 / 4] = "R_0085F4_CP_COHER_SIZE",
-   [0x0085F8 / 4] = "R_0085F8_CP_COHER_BASE",
-   [0x008970 / 4] = "R_008970_VGT_NUM_INDICES",
-   [0x03CFF0 / 4] = "R_03CFF0_SQ_VTX_BASE_VTX_LOC",
-   [0x03CFF4 / 4] = "R_03CFF4_SQ_VTX_START_INST_LOC",
-   [0x3A200 / 4] = "R_03A200_SQ_LOOP_CONST_0",
-};
+static void PM4P_RegisterCursorInit(PM4P_RegisterCursor * const cursor,
+                                    PM4P_Family const * const family,
+                                    uint32_t const first_index_dwords) {
+   cursor->family = family;
+   cursor->position = PM4P_FindRegisterLowerBound(family, first_index_dwords);
+}
 
-static char const * const pm4p_register_names_r9xx[] = {
-   [0x00028804 / 4] = "CM_R_028804_DB_EQAA",
-   [0x28bdc / 4] = "CM_R_028BDC_PA_SC_LINE_CNTL",
-   [0x28be0 / 4] = "CM_R_028BE0_PA_SC_AA_CONFIG",
-   [0x28bf8 / 4] = "CM_R_028BF8_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_0",
-   [0x28c08 / 4] = "CM_R_028C08_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_0",
-   [0x28c18 / 4] = "CM_R_028C18_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_0",
-   [0x28c28 / 4] = "CM_R_028C28_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_0",
-   [0x286f8 / 4] = "CM_R_0286F8_SPI_GPR_MGMT",
-   [0x286fc / 4] = "CM_R_0286FC_SPI_LDS_MGMT",
-   [0x28700 / 4] = "CM_R_028700_SPI_STACK_MGMT",
-   [0x28704 / 4] = "CM_R_028704_SPI_WAVE_MGMT_1",
-   [0x28708 / 4] = "CM_R_028708_SPI_WAVE_MGMT_2",
-   [0x00028804 / 4] = "CM_R_028804_DB_EQAA",
-   [0x00028BD4 / 4] = "CM_R_028BD4_PA_SC_CENTROID_PRIORITY_0",
-   [0x00028BD8 / 4] = "CM_R_028BD8_PA_SC_CENTROID_PRIORITY_1",
-   [0x28bdc / 4] = "CM_R_028BDC_PA_SC_LINE_CNTL",
-   [0x28be0 / 4] = "CM_R_028BE0_PA_SC_AA_CONFIG",
-   [0x28be4 / 4] = "CM_R_028BE4_PA_SU_VTX_CNTL",
-   [0x28be8 / 4] = "CM_R_028BE8_PA_CL_GB_VERT_CLIP_ADJ",
-   [0x28bec / 4] = "CM_R_028BEC_PA_CL_GB_VERT_DISC_ADJ",
-   [0x28bf0 / 4] = "CM_R_028BF0_PA_CL_GB_HORZ_CLIP_ADJ",
-   [0x28bf4 / 4] = "CM_R_028BF4_PA_CL_GB_HORZ_DISC_ADJ",
-   [0x28bf8 / 4] = "CM_R_028BF8_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_0",
-   [0x28bfc / 4] = "CM_R_028BFC_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_1",
-   [0x28c00 / 4] = "CM_R_028C00_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_2",
-   [0x28c04 / 4] = "CM_R_028C04_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_3",
-   [0x28c08 / 4] = "CM_R_028C08_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_0",
-   [0x28c0c / 4] = "CM_R_028C0C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_1",
-   [0x28c10 / 4] = "CM_R_028C10_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_2",
-   [0x28c14 / 4] = "CM_R_028C14_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_3",
-   [0x28c18 / 4] = "CM_R_028C18_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_0",
-   [0x28c1c / 4] = "CM_R_028C1C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_1",
-   [0x28c20 / 4] = "CM_R_028C20_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_2",
-   [0x28c24 / 4] = "CM_R_028C24_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_3",
-   [0x28c28 / 4] = "CM_R_028C28_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_0",
-   [0x28c2c / 4] = "CM_R_028C2C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_1",
-   [0x28c30 / 4] = "CM_R_028C30_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_2",
-   [0x28c34 / 4] = "CM_R_028C34_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_3",
-   [0x28c38 / 4] = "CM_R_028C38_PA_SC_AA_MASK_X0Y0_X1Y0",
-   [0x28c3c / 4] = "CM_R_028C3C_PA_SC_AA_MASK_X0Y1_X1Y1",
-   [0x028AA8 / 4] = "CM_R_028AA8_IA_MULTI_VGT_PARAM",
-};
+// The indices must not be decreasing between the calls.
+static PM4P_Register const * PM4P_RegisterCursorFind(PM4P_RegisterCursor * const cursor,
+                                                     uint32_t const index_dwords) {
+   PM4P_Family const * const family = cursor->family;
+   while (cursor->position != family->register_count &&
+          family->register_indices[cursor->position] < index_dwords) {
+      ++cursor->position;
+   }
+   if (cursor->position != family->register_count &&
+       family->register_indices[cursor->position] == index_dwords) {
+      return family->registers[cursor->position];
+   }
+   return NULL;
+}
+
+char const * PM4P_GetPacket3OpcodeName(uint32_t const opcode) {
+   return opcode < 0x100 ? pm4p_packet3_opcode_names[opcode] : NULL;
+}
 
-static void PM4P_PrintRegisterName(uint32_t const index_dwords, bool const is_r9xx) {
-   char const * name = NULL;
-   if (is_r9xx &&
-       index_dwords < sizeof(pm4p_register_names_r9xx) / sizeof(pm4p_register_names_r9xx[0])) {
-      name = pm4p_register_names_r9xx[index_dwords];
+// "/* @ 0x%X */ " with the byte offset, up to 19 characters.
+static char * PM4P_FormatOffset(char * destination, uint32_t const offset_dwords) {
+   destination = TXTW_FORMAT_LITERAL(destination, "/* @ 0x");
+   destination = TXTW_FormatHex(destination, (uint32_t)(sizeof(uint32_t) * offset_dwords), 1);
+   return TXTW_FORMAT_LITERAL(destination, " */ ");
+}
+
+static void PM4P_PrintOffset(TXTW_Writer * const text, uint32_t const offset_dwords) {
+   char * const destination = TXTW_Reserve(text, 19);
+   if (destination != NULL) {
+      TXTW_Commit(text, PM4P_FormatOffset(destination, offset_dwords));
    }
-   if (name == NULL &&
-       index_dwords < sizeof(pm4p_register_names) / sizeof(pm4p_register_names[0])) {
-      name = pm4p_register_names[index_dwords];
+}
+
+void PM4P_PatchCursorInit(PM4P_PatchCursor * const cursor, PM4P_Patch const * const patches,
+                          uint32_t const patch_count, uint32_t const offset_dwords) {
+   uint32_t begin = 0;
+   uint32_t end = patch_count;
+   while (begin < end) {
+      uint32_t const middle = begin + (end - begin) / 2;
+      if (patches[middle].offset < offset_dwords) {
+         begin = middle + 1;
+      } else {
+         end = middle;
+      }
    }
-   if (name != NULL) {
-      fputs(name, stdout);
+   cursor->patches = patches;
+   cursor->patch_count = patch_count;
+   cursor->patch_index = begin;
+}
+
+// After the line of the dword, "// Patched with allocation %u (0x%X) + 0x%X, slot 0x%X << 10 |
+// 0x%X, patch location %u\n" for every patch of it. The cursor may be null.
+static void PM4P_PrintPatches(TXTW_Writer * const text, PM4P_PatchCursor * const cursor,
+                              uint32_t const offset_dwords) {
+   if (cursor == NULL) {
       return;
    }
-   printf("0x%06" PRIX32, (uint32_t)(sizeof(uint32_t) * index_dwords));
+   // Patches of dwords not printed, such as past the end of a truncated packet, are skipped.
+   while (cursor->patch_index < cursor->patch_count &&
+          cursor->patches[cursor->patch_index].offset < offset_dwords) {
+      ++cursor->patch_index;
+   }
+   while (cursor->patch_index < cursor->patch_count &&
+          cursor->patches[cursor->patch_index].offset == offset_dwords) {
+      PM4P_Patch const * const patch = &cursor->patches[cursor->patch_index++];
+      TXTW_PUT_LITERAL(text, "// Patched with allocation ");
+      TXTW_PutDecimal(text, patch->allocation_index);
+      TXTW_PUT_LITERAL(text, " (0x");
+      TXTW_PutHex(text, patch->allocation, 1);
+      TXTW_PUT_LITERAL(text, ") + 0x");
+      TXTW_PutHex(text, patch->allocation_offset, 1);
+      TXTW_PUT_LITERAL(text, ", slot 0x");
+      TXTW_PutHex(text, (patch->slot_id & 0xFFFFFF) >> 10, 1);
+      TXTW_PUT_LITERAL(text, " << 10 | 0x");
+      TXTW_PutHex(text, patch->slot_id & (((uint32_t)1 << 10) - 1), 1);
+      TXTW_PUT_LITERAL(text, ", patch location ");
+      TXTW_PutDecimal(text, patch->patch_location_index);
+      TXTW_PutChar(text, '\n');
+   }
 }
 
-static void PM4P_PrintSetRegisters(uint32_t const * const pm4, uint32_t const header_offset_dwords,
-                                   uint32_t const register_base_dwords, bool const is_r9xx) {
-   uint32_t const count = (pm4[header_offset_dwords] >> 16) & 0x3FFF;
-   printf("/* @ 0x%" PRIX32 " */ ", (uint32_t)(sizeof(uint32_t) * (header_offset_dwords + 1)));
-   uint32_t const first_register_index = register_base_dwords + pm4[header_offset_dwords + 1];
-   PM4P_PrintRegisterName(first_register_index, is_r9xx);
-   printf(" / 4 - 0x%" PRIX32 ",\n", register_base_dwords);
-   for (uint32_t index = 0; index < count; ++index) {
-      uint32_t const value_offset = header_offset_dwords + 2 + index;
-      printf("/* @ 0x%" PRIX32 " */ 0x%08" PRIX32 ",", (uint32_t)(sizeof(uint32_t) * value_offset),
-             pm4[value_offset]);
-      if (count > 1) {
-         fputs(" // ", stdout);
-         PM4P_PrintRegisterName(first_register_index + index, is_r9xx);
-      }
-      putchar('\n');
+void PM4P_FieldDecoderInit(PM4P_FieldDecoder * const field_decoder, bool const decode_changed) {
+   memset(field_decoder->requested, 0, sizeof(field_decoder->requested));
+   field_decoder->decode_changed = decode_changed;
+   memset(&field_decoder->state, 0, sizeof(field_decoder->state));
+}
+
+bool PM4P_FieldDecoderRequest(PM4P_FieldDecoder * const field_decoder,
+                              uint32_t const index_dwords) {
+   uint32_t const shadow_index = PM4S_GetShadowIndex(index_dwords);
+   if (shadow_index >= PM4S_REGISTER_COUNT) {
+      return false;
    }
+   field_decoder->requested[shadow_index >> 6] |= (uint64_t)1 << (shadow_index & 63);
+   return true;
 }
 
-void PM4P_Print(uint32_t const * const pm4, uint32_t const pm4_dword_count, bool const is_r9xx) {
-   bool current_is_packet2 = false;
-   for (uint32_t pm4_dword_index = 0; pm4_dword_index < pm4_dword_count;) {
-      printf("/* @ 0x%" PRIX32 " */ ", (uint32_t)(sizeof(uint32_t) * pm4_dword_index));
-      uint32_t const header = pm4[pm4_dword_index++];
-      uint32_t const packet_type = header >> 30;
-      uint32_t const packet_count = (header >> 16) & 0x3FFF;
+void PM4P_FieldDecoderRequestAll(PM4P_FieldDecoder * const field_decoder) {
+   memset(field_decoder->requested, 0xFF, sizeof(field_decoder->requested));
+}
 
-      bool const follows_packet2 = current_is_packet2;
-      current_is_packet2 = packet_type == 2;
+// Whether to decode the value written to the register at the shadow index, updating the last value
+// written if changed values are decoded.
+static bool PM4P_FieldDecoderSelect(PM4P_FieldDecoder * const field_decoder,
+                                    uint32_t const shadow_index, uint32_t const value) {
+   uint64_t const bit = (uint64_t)1 << (shadow_index & 63);
+   bool decode = (field_decoder->requested[shadow_index >> 6] & bit) != 0;
+   if (field_decoder->decode_changed) {
+      PM4S_State * const state = &field_decoder->state;
+      decode |= !(state->written[shadow_index >> 6] & bit) || state->values[shadow_index] != value;
+      state->written[shadow_index >> 6] |= bit;
+      state->values[shadow_index] = value;
+   }
+   return decode;
+}
 
-      if (packet_type == 0) {
-         // Likely unused, so not going into the details.
-         printf("PKT0(0x%" PRIX32 ", %" PRIu32 "),\n", header & 0xFFFF, packet_count);
-         // 1 + count dwords.
-         for (uint32_t packet0_index = 0; packet0_index <= packet_count; ++packet0_index) {
-            printf("/* @ 0x%X */ 0x%X\n,", (uint32_t)(sizeof(uint32_t) * pm4_dword_index),
-                   pm4[pm4_dword_index]);
-            ++pm4_dword_index;
+// "// FIELD = %u, FIELD = %u\n" after the line of the value, shifting and masking it as described
+// by the layout of the register.
+static void PM4P_PrintFields(TXTW_Writer * const text, PM4P_Register const * const register_record,
+                             uint32_t const value) {
+   TXTW_PUT_LITERAL(text, "// ");
+   for (uint32_t field_index = 0; field_index < register_record->field_count; ++field_index) {
+      PM4P_RegisterField const * const field = &register_record->fields[field_index];
+      if (field_index != 0) {
+         TXTW_PUT_LITERAL(text, ", ");
+      }
+      TXTW_PutString(text, field->name);
+      TXTW_PUT_LITERAL(text, " = ");
+      TXTW_PutDecimal(text, (value >> field->shift) & field->mask);
+   }
+   TXTW_PutChar(text, '\n');
+}
+
+static void PM4P_PrintRegisterName(TXTW_Writer * const text, uint32_t const index_dwords,
+                                   PM4P_RegisterCursor * const register_cursor) {
+   PM4P_Register const * const register_record =
+      PM4P_RegisterCursorFind(register_cursor, index_dwords);
+   if (register_record != NULL) {
+      TXTW_PutString(text, register_record->name);
+      return;
+   }
+   TXTW_PUT_LITERAL(text, "0x");
+   TXTW_PutHex(text, (uint32_t)(sizeof(uint32_t) * index_dwords), 6);
+}
+
+static void PM4P_PrintSetRegisters(TXTW_Writer * const text, PM4P_Packet const * const packet,
+                                   uint32_t const register_base_dwords,
+                                   uint32_t const first_register_index,
+                                   PM4P_PatchCursor * const patch_cursor,
+                                   PM4P_Family const * const family,
+                                   PM4P_FieldDecoder * const field_decoder) {
+   // Only the values present if the packet is truncated.
+   uint32_t const count = packet->count;
+   uint32_t const value_count =
+      count < packet->body_dword_count - 1 ? count : packet->body_dword_count - 1;
+   // Fields are decoded only for the values in the blocks tracked by the shadow, not for NOPs.
+   uint32_t first_shadow_index = 0;
+   uint32_t const decodable_count =
+      field_decoder != NULL ? PM4S_GetPacketShadowRange(packet, &first_shadow_index) : 0;
+   PM4P_RegisterCursor register_cursor;
+   PM4P_RegisterCursorInit(&register_cursor, family, first_register_index);
+   PM4P_PrintOffset(text, packet->offset + 1);
+   PM4P_PrintRegisterName(text, first_register_index, &register_cursor);
+   TXTW_PUT_LITERAL(text, " / 4 - 0x");
+   TXTW_PutHex(text, register_base_dwords, 1);
+   TXTW_PUT_LITERAL(text, ",\n");
+   PM4P_PrintPatches(text, patch_cursor, packet->offset + 1);
+   for (uint32_t index = 0; index < value_count; ++index) {
+      // The line up to the register name, formatted at once.
+      char * line = TXTW_Reserve(text, 36);
+      if (line == NULL) {
+         return;
+      }
+      line = PM4P_FormatOffset(line, packet->offset + 2 + index);
+      uint32_t const value = packet->dwords[2 + index];
+      line = TXTW_FORMAT_LITERAL(line, "0x");
+      line = TXTW_FormatHex(line, value, 8);
+      if (count > 1) {
+         TXTW_Commit(text, TXTW_FORMAT_LITERAL(line, ", // "));
+         PM4P_PrintRegisterName(text, first_register_index + index, &register_cursor);
+         TXTW_PutChar(text, '\n');
+      } else {
+         TXTW_Commit(text, TXTW_FORMAT_LITERAL(line, ",\n"));
+      }
+      if (index < decodable_count &&
+          PM4P_FieldDecoderSelect(field_decoder, first_shadow_index + index, value)) {
+         PM4P_Register const * const register_record =
+            PM4P_RegisterCursorFind(&register_cursor, first_register_index + index);
+         if (register_record != NULL && register_record->field_count != 0) {
+            PM4P_PrintFields(text, register_record, value);
          }
-         continue;
       }
+      PM4P_PrintPatches(text, patch_cursor, packet->offset + 2 + index);
+   }
+}
 
-      if (packet_type != 3) {
-         printf("PKT_TYPE_S(%" PRIu32 ") | 0x%" PRIX32 ",\n", packet_type,
-                header & ~((uint32_t)0x3 << 30));
-         continue;
+// "/* @ 0x%X */ 0x%X,\n" for every dword.
+static void PM4P_PrintDwords(TXTW_Writer * const text, uint32_t const * const dwords,
+                             uint32_t const offset_dwords, uint32_t const dword_count,
+                             PM4P_PatchCursor * const patch_cursor) {
+   for (uint32_t dword_index = 0; dword_index < dword_count; ++dword_index) {
+      char * line = TXTW_Reserve(text, 31);
+      if (line == NULL) {
+         return;
       }
+      line = PM4P_FormatOffset(line, offset_dwords + dword_index);
+      line = TXTW_FORMAT_LITERAL(line, "0x");
+      line = TXTW_FormatHex(line, dwords[dword_index], 1);
+      TXTW_Commit(text, TXTW_FORMAT_LITERAL(line, ",\n"));
+      PM4P_PrintPatches(text, patch_cursor, offset_dwords + dword_index);
+   }
+}
 
-      fputs("PKT3(", stdout);
-      uint32_t const packet3_opcode = (header >> 8) & 0xFF;
-      const char * const packet3_opcode_name = pm4p_packet3_opcode_names[packet3_opcode];
-      if (packet3_opcode_name != NULL) {
-         fputs(packet3_opcode_name, stdout);
-      } else {
-         printf("0x%02" PRIX32, packet3_opcode);
+static void PM4P_PrintPacket(TXTW_Writer * const text, PM4P_Packet const * const packet,
+                             PM4P_PatchCursor * const patch_cursor,
+                             PM4P_Family const * const family,
+                             PM4P_FieldDecoder * const field_decoder) {
+   PM4P_PrintOffset(text, packet->offset);
+   uint32_t const header = packet->header;
+   uint32_t const packet_count = packet->count;
+   uint32_t const * const body = packet->dwords + 1;
+   uint32_t const body_offset = packet->offset + 1;
+
+   if (packet->type == 0) {
+      // Likely unused, so not going into the details.
+      TXTW_PUT_LITERAL(text, "PKT0(0x");
+      TXTW_PutHex(text, header & 0xFFFF, 1);
+      TXTW_PUT_LITERAL(text, ", ");
+      TXTW_PutDecimal(text, packet_count);
+      TXTW_PUT_LITERAL(text, "),\n");
+      for (uint32_t packet0_index = 0; packet0_index < packet->body_dword_count;
+           ++packet0_index) {
+         PM4P_PrintOffset(text, body_offset + packet0_index);
+         TXTW_PUT_LITERAL(text, "0x");
+         TXTW_PutHex(text, body[packet0_index], 1);
+         TXTW_PUT_LITERAL(text, "\n,");
+         PM4P_PrintPatches(text, patch_cursor, body_offset + packet0_index);
       }
-      printf(", %u, %u)", packet_count, header & 1);
-      if (header & ((uint32_t)1 << 1)) {
-         fputs(" | ((uint32_t)1 << 1)", stdout);
+      return;
+   }
+
+   if (packet->type != 3) {
+      TXTW_PUT_LITERAL(text, "PKT_TYPE_S(");
+      TXTW_PutDecimal(text, packet->type);
+      TXTW_PUT_LITERAL(text, ") | 0x");
+      TXTW_PutHex(text, header & ~((uint32_t)0x3 << 30), 1);
+      TXTW_PUT_LITERAL(text, ",\n");
+      return;
+   }
+
+   TXTW_PUT_LITERAL(text, "PKT3(");
+   uint32_t const packet3_opcode = packet->opcode;
+   const char * const packet3_opcode_name = pm4p_packet3_opcode_names[packet3_opcode];
+   if (packet3_opcode_name != NULL) {
+      TXTW_PutString(text, packet3_opcode_name);
+   } else {
+      TXTW_PUT_LITERAL(text, "0x");
+      TXTW_PutHex(text, packet3_opcode, 2);
+   }
+   TXTW_PUT_LITERAL(text, ", ");
+   TXTW_PutDecimal(text, packet_count);
+   TXTW_PUT_LITERAL(text, ", ");
+   TXTW_PutDecimal(text, header & 1);
+   TXTW_PutChar(text, ')');
+   if (header & ((uint32_t)1 << 1)) {
+      TXTW_PUT_LITERAL(text, " | ((uint32_t)1 << 1)");
+   }
+   TXTW_PUT_LITERAL(text, ",\n");
+   PM4P_PrintPatches(text, patch_cursor, packet->offset);
+
+   // Nothing to print from the body if it's not present at all.
+   if (packet->body_dword_count == 0) {
+      return;
+   }
+   switch (packet3_opcode) {
+   case 0x10: // PKT3_NOP
+      // A NOP containing packets has no body, and they are printed separately.
+      PM4P_PrintSetRegisters(text, packet, 0x8000 / sizeof(uint32_t),
+                             0x8000 / sizeof(uint32_t) + body[0], patch_cursor, family,
+                             field_decoder);
+      break;
+   case 0x68: // PKT3_SET_CONFIG_REG
+   case 0x69: // PKT3_SET_CONTEXT_REG
+   case 0x6F: // PKT3_SET_CTL_CONST
+      PM4P_PrintSetRegisters(text, packet, packet->register_base, packet->register_first,
+                             patch_cursor, family, field_decoder);
+      break;
+   case 0x6D: // PKT3_SET_RESOURCE
+   case 0x6E: { // PKT3_SET_SAMPLER
+      // The first dword is the slot of the resource or the sampler, in the units of their sizes.
+      uint32_t const slot_size = packet3_opcode == 0x6D ? 8 : 3;
+      uint32_t const slot_address = body[0];
+      PM4P_PrintOffset(text, body_offset);
+      TXTW_PutDecimal(text, slot_address / slot_size);
+      if ((slot_address % slot_size) != 0) {
+         TXTW_PUT_LITERAL(text, " + ");
+         TXTW_PutDecimal(text, slot_address % slot_size);
       }
-      puts(",");
+      TXTW_PUT_LITERAL(text, ",\n");
+      PM4P_PrintPatches(text, patch_cursor, body_offset);
+      PM4P_PrintDwords(text, body + 1, body_offset + 1, packet->body_dword_count - 1,
+                       patch_cursor);
+   } break;
+   default:
+      PM4P_PrintDwords(text, body, body_offset, packet->body_dword_count, patch_cursor);
+      break;
+   }
+}
 
-      switch (packet3_opcode) {
-      case 0x10: // PKT3_NOP
-         // Some type-3 packets are contained in a nop type-3 packet preceded by a type-2 packet
-         // that has a slot 0x5400 patch location, parse them.
-         if (follows_packet2) {
-            continue;
-         }
-      case 0x68: // PKT3_SET_CONFIG_REG
-         PM4P_PrintSetRegisters(pm4, pm4_dword_index - 1, 0x8000 / sizeof(uint32_t), is_r9xx);
-         break;
-      case 0x69: // PKT3_SET_CONTEXT_REG
-         PM4P_PrintSetRegisters(pm4, pm4_dword_index - 1, 0x28000 / sizeof(uint32_t), is_r9xx);
-         break;
-      case 0x6F: // PKT3_SET_CTL_CONST
-         PM4P_PrintSetRegisters(pm4, pm4_dword_index - 1, 0x3CFF0 / sizeof(uint32_t), is_r9xx);
-         break;
-      case 0x6D: { // PKT3_SET_RESOURCE
-         uint32_t const resource_address = pm4[pm4_dword_index];
-         printf("/* @ 0x%" PRIX32 " */ %" PRIu32, (uint32_t)(sizeof(uint32_t) * pm4_dword_index),
-                resource_address / 8);
-         if ((resource_address % 8) != 0) {
-            printf(" + %" PRIu32, resource_address % 8);
-         }
-         puts(",");
-         for (uint32_t packet3_body_index = 1; packet3_body_index <= packet_count;
-              ++packet3_body_index) {
-            uint32_t const packet3_body_offset = pm4_dword_index + packet3_body_index;
-            printf("/* @ 0x%" PRIX32 " */ 0x%" PRIX32 ",\n",
-                   (uint32_t)(sizeof(uint32_t) * packet3_body_offset), pm4[packet3_body_offset]);
-         }
-      } break;
-      case 0x6E: { // PKT3_SET_SAMPLER
-         uint32_t const sampler_address = pm4[pm4_dword_index];
-         printf("/* @ 0x%" PRIX32 " */ %" PRIu32, (uint32_t)(sizeof(uint32_t) * pm4_dword_index),
-                sampler_address / 3);
-         if ((sampler_address % 3) != 0) {
-            printf(" + %" PRIu32, sampler_address % 3);
-         }
-         puts(",");
-         for (uint32_t packet3_body_index = 1; packet3_body_index <= packet_count;
-              ++packet3_body_index) {
-            uint32_t const packet3_body_offset = pm4_dword_index + packet3_body_index;
-            printf("/* @ 0x%" PRIX32 " */ 0x%" PRIX32 ",\n",
-                   (uint32_t)(sizeof(uint32_t) * packet3_body_offset), pm4[packet3_body_offset]);
-         }
-      } break;
-      default: {
-         // 1 + count dwords.
-         for (uint32_t packet3_body_index = 0; packet3_body_index <= packet_count;
-              ++packet3_body_index) {
-            uint32_t const packet3_body_offset = pm4_dword_index + packet3_body_index;
-            printf("/* @ 0x%" PRIX32 " */ 0x%" PRIX32 ",\n",
-                   (uint32_t)(sizeof(uint32_t) * packet3_body_offset), pm4[packet3_body_offset]);
-         }
-      } break;
+void PM4P_PrintPackets(TXTW_Writer * const text, PM4P_Packet const * const packets,
+                       uint32_t const packet_count, PM4P_Family const * const family) {
+   PM4P_PrintPatchedPackets(text, packets, packet_count, NULL, family, NULL);
+}
+
+void PM4P_PrintPatchedPackets(TXTW_Writer * const text, PM4P_Packet const * const packets,
+                              uint32_t const packet_count, PM4P_PatchCursor * const patch_cursor,
+                              PM4P_Family const * const family,
+                              PM4P_FieldDecoder * const field_decoder) {
+   for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+      PM4P_Packet const * const packet = &packets[packet_index];
+      PM4P_PrintPacket(text, packet, patch_cursor, family, field_decoder);
+      if (packet->truncated) {
+         TXTW_PUT_LITERAL(text, "// Truncated, ");
+         TXTW_PutDecimal(text, 1 + (uint32_t)packet->count - packet->body_dword_count);
+         TXTW_PUT_LITERAL(text, " dwords missing\n");
       }
+   }
+}
 
-      pm4_dword_index += 1 + packet_count;
+void PM4P_Write(TXTW_Writer * const text, uint32_t const * const pm4,
+                uint32_t const pm4_dword_count, PM4P_Family const * const family) {
+   PM4P_Decoder decoder;
+   PM4P_DecoderInit(&decoder, pm4, pm4_dword_count);
+   PM4P_Packet packets[256];
+   uint32_t packet_count;
+   while ((packet_count = PM4P_Decode(&decoder, packets, sizeof(packets) / sizeof(packets[0]))) !=
+          0) {
+      PM4P_PrintPackets(text, packets, packet_count, family);
    }
 }
+
+void PM4P_Print(uint32_t const * const pm4, uint32_t const pm4_dword_count,
+                PM4P_Family const * const family) {
+   TXTW_Writer text;
+   TXTW_InitFile(&text, stdout, NULL, 0);
+   PM4P_Write(&text, pm4, pm4_dword_count, family);
+   TXTW_Destroy(&text);
+}
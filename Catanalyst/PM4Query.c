@@ -0,0 +1,68 @@
+#include "Catanalyst.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+void PM4Q_QueryInit(PM4Q_Query * const query) {
+   memset(query, 0, sizeof(*query));
+}
+
+void PM4Q_QueryAddOpcode(PM4Q_Query * const query, uint32_t const opcode) {
+   query->opcodes[(opcode >> 6) & 3] |= (uint64_t)1 << (opcode & 63);
+   query->has_opcodes = true;
+}
+
+bool PM4Q_FindMaskedValue(uint32_t const * const values, uint32_t const value_count,
+                          uint32_t const expected, uint32_t const mask) {
+   for (uint32_t value_index = 0; value_index < value_count; ++value_index) {
+      if ((values[value_index] & mask) == expected) {
+         return true;
+      }
+   }
+   return false;
+}
+
+// Whether the register writes of the packet satisfy the register and the value conditions.
+static bool PM4Q_MatchRegisters(PM4Q_Query const * const query, PM4P_Packet const * const packet) {
+   if (packet->register_base == 0 || packet->body_dword_count < 2) {
+      return false;
+   }
+   uint32_t first = packet->register_first;
+   uint32_t last = packet->register_first + (packet->body_dword_count - 2);
+   if (query->has_registers) {
+      first = first > query->register_first ? first : query->register_first;
+      last = last < query->register_last ? last : query->register_last;
+      if (first > last) {
+         return false;
+      }
+   }
+   if (!query->has_value) {
+      return true;
+   }
+   // Skipping the header and the register offset.
+   return PM4Q_FindMaskedValue(packet->dwords + 2 + (first - packet->register_first),
+                               last - first + 1, query->value_expected, query->value_mask);
+}
+
+// The conditions on the header are checked for every packet and the indices are appended without
+// branches, as most packets usually don't match and the outcome is unpredictable. Only the packets
+// passing them have their register values scanned.
+uint32_t PM4Q_Match(PM4Q_Query const * const query, PM4P_Packet const * const packets,
+                    uint32_t const packet_count, uint32_t * const match_indices) {
+   bool const checks_registers = query->has_registers || query->has_value;
+   uint32_t match_count = 0;
+   for (uint32_t packet_index = 0; packet_index < packet_count; ++packet_index) {
+      PM4P_Packet const * const packet = &packets[packet_index];
+      uint32_t const opcode = packet->opcode;
+      uint32_t const opcode_bit = (uint32_t)(query->opcodes[opcode >> 6] >> (opcode & 63)) & 1;
+      bool matches = !query->has_opcodes || ((packet->type == 3) & opcode_bit);
+      if (matches && checks_registers) {
+         matches = PM4Q_MatchRegisters(query, packet);
+      }
+      match_indices[match_count] = packet_index;
+      match_count += (uint32_t)matches;
+   }
+   return match_count;
+}
@@ -0,0 +1,296 @@
+#include "Catanalyst.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// The register database, generated by the preprocessor from the description in PM4Registers.inl:
+// the field layouts, the records of all the registers, and for every family, the sorted indices of
+// its registers, the pointers to their records, and their positions by the shadow index.
+
+// Whether a register is present in R6xx, R7xx, Evergreen and Cayman, for the family spans in the
+// description.
+#define PM4P_FAMILIES_R6 (1, 0, 0, 0)
+#define PM4P_FAMILIES_R6_R7 (1, 1, 0, 0)
+#define PM4P_FAMILIES_R6_EG (1, 1, 1, 0)
+#define PM4P_FAMILIES_R6_CM (1, 1, 1, 1)
+#define PM4P_FAMILIES_R7_CM (0, 1, 1, 1)
+#define PM4P_FAMILIES_EG (0, 0, 1, 0)
+#define PM4P_FAMILIES_EG_CM (0, 0, 1, 1)
+#define PM4P_FAMILIES_CM (0, 0, 0, 1)
+
+#define PM4P_IN_R600(r600, r700, evergreen, cayman) r600
+#define PM4P_IN_R700(r600, r700, evergreen, cayman) r700
+#define PM4P_IN_EVERGREEN(r600, r700, evergreen, cayman) evergreen
+#define PM4P_IN_CAYMAN(r600, r700, evergreen, cayman) cayman
+
+// The element, followed by a comma, if the register is in the family. The extra level of expansion
+// turns the family flag selector applied to the flags into 0 or 1 before it's pasted.
+#define PM4P_SELECT_0(element)
+#define PM4P_SELECT_1(element) element,
+#define PM4P_SELECT_PASTE(in_family, element) PM4P_SELECT_##in_family(element)
+#define PM4P_SELECT_EXPAND(in_family, element) PM4P_SELECT_PASTE(in_family, element)
+#define PM4P_SELECT(in_family, element) PM4P_SELECT_EXPAND(in_family, element)
+
+// PM4S_GetShadowIndex as a constant expression, for the initializers of the position tables.
+#define PM4P_SHADOW_INDEX(index_dwords) \
+   ((uint32_t)(index_dwords) - 0x8000 / 4 < PM4S_CONFIG_REGISTER_COUNT \
+       ? (uint32_t)(index_dwords) - 0x8000 / 4 \
+    : (uint32_t)(index_dwords) - 0x28000 / 4 < PM4S_CONTEXT_REGISTER_COUNT \
+       ? PM4S_CONFIG_REGISTER_COUNT + ((uint32_t)(index_dwords) - 0x28000 / 4) \
+    : (uint32_t)(index_dwords) - 0x3CFF0 / 4 < PM4S_CTL_CONST_REGISTER_COUNT \
+       ? PM4S_CONFIG_REGISTER_COUNT + PM4S_CONTEXT_REGISTER_COUNT + \
+            ((uint32_t)(index_dwords) - 0x3CFF0 / 4) \
+       : PM4S_REGISTER_COUNT)
+
+// Whether the registers of the block are in the blocks addressed by the shadow index, which their
+// addresses must match.
+#define PM4P_IN_SHADOW_CONFIG 1
+#define PM4P_IN_SHADOW_CONTEXT 1
+#define PM4P_IN_SHADOW_RESOURCE 0
+#define PM4P_IN_SHADOW_SAMPLER 0
+#define PM4P_IN_SHADOW_LOOP_CONST 0
+#define PM4P_IN_SHADOW_CTL_CONST 1
+#define PM4P_IN_SHADOW_OTHER 0
+
+// 1 if both flags are 1, for selecting the registers of a family in the shadow blocks.
+#define PM4P_AND_00 0
+#define PM4P_AND_01 0
+#define PM4P_AND_10 0
+#define PM4P_AND_11 1
+#define PM4P_AND_PASTE(a, b) PM4P_AND_##a##b
+#define PM4P_AND(a, b) PM4P_AND_PASTE(a, b)
+
+// The positions of the registers of a family are the values of an enumeration with an entry only
+// for the registers in the family, stored plus 1 so the unset elements are 0.
+#define PM4P_SHADOW_POSITION(in_family, family, name, address, block) \
+   PM4P_SELECT(PM4P_AND(in_family, PM4P_IN_SHADOW_##block), \
+               [PM4P_SHADOW_INDEX((address) / 4)] = PM4P_POSITION_##family##_##name + 1)
+
+#define PM4P_FIELD(name, shift, width) {#name, ((uint32_t)1 << ((width) - 1) << 1) - 1, (shift)}
+
+#define PM4P_FIELDS(layout, ...) \
+   static PM4P_RegisterField const pm4p_fields_##layout[] = {__VA_ARGS__}; \
+   enum { PM4P_FIELD_COUNT_##layout = sizeof(pm4p_fields_##layout) / sizeof(PM4P_RegisterField) };
+#define PM4P_REGISTER(name, address, families, block, layout)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+#undef PM4P_FIELDS
+
+// For the registers without fields.
+#define pm4p_fields_NONE NULL
+enum { PM4P_FIELD_COUNT_NONE = 0 };
+
+#define PM4P_FIELDS(layout, ...)
+
+enum {
+#define PM4P_REGISTER(name, address, families, block, layout) PM4P_REGISTER_ID_##name,
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+   PM4P_REGISTER_ID_COUNT,
+};
+
+static PM4P_Register const pm4p_registers[PM4P_REGISTER_ID_COUNT] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   {(address) / 4, #name, pm4p_fields_##layout, PM4P_FIELD_COUNT_##layout, \
+    PM4P_REGISTER_BLOCK_##block},
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+// Before the registers of every family, looked up instead of the absent ones in the position tables
+// so the record is loaded without a branch.
+static PM4P_Register const pm4p_register_unknown = {0, NULL, NULL, 0, PM4P_REGISTER_BLOCK_OTHER};
+
+static uint32_t const pm4p_register_indices_r600[] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R600 PM4P_FAMILIES_##families, (address) / 4)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static PM4P_Register const * const pm4p_registers_r600[] = {
+   &pm4p_register_unknown,
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R600 PM4P_FAMILIES_##families, \
+               &pm4p_registers[PM4P_REGISTER_ID_##name])
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+enum {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R600 PM4P_FAMILIES_##families, PM4P_POSITION_r600_##name)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint16_t const pm4p_shadow_positions_r600[PM4S_REGISTER_COUNT] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SHADOW_POSITION(PM4P_IN_R600 PM4P_FAMILIES_##families, r600, name, address, block)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint32_t const pm4p_register_indices_r700[] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R700 PM4P_FAMILIES_##families, (address) / 4)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static PM4P_Register const * const pm4p_registers_r700[] = {
+   &pm4p_register_unknown,
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R700 PM4P_FAMILIES_##families, \
+               &pm4p_registers[PM4P_REGISTER_ID_##name])
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+enum {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_R700 PM4P_FAMILIES_##families, PM4P_POSITION_r700_##name)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint16_t const pm4p_shadow_positions_r700[PM4S_REGISTER_COUNT] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SHADOW_POSITION(PM4P_IN_R700 PM4P_FAMILIES_##families, r700, name, address, block)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint32_t const pm4p_register_indices_evergreen[] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_EVERGREEN PM4P_FAMILIES_##families, (address) / 4)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static PM4P_Register const * const pm4p_registers_evergreen[] = {
+   &pm4p_register_unknown,
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_EVERGREEN PM4P_FAMILIES_##families, \
+               &pm4p_registers[PM4P_REGISTER_ID_##name])
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+enum {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_EVERGREEN PM4P_FAMILIES_##families, PM4P_POSITION_evergreen_##name)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint16_t const pm4p_shadow_positions_evergreen[PM4S_REGISTER_COUNT] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SHADOW_POSITION(PM4P_IN_EVERGREEN PM4P_FAMILIES_##families, evergreen, name, address, \
+                        block)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint32_t const pm4p_register_indices_cayman[] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_CAYMAN PM4P_FAMILIES_##families, (address) / 4)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static PM4P_Register const * const pm4p_registers_cayman[] = {
+   &pm4p_register_unknown,
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_CAYMAN PM4P_FAMILIES_##families, \
+               &pm4p_registers[PM4P_REGISTER_ID_##name])
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+enum {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SELECT(PM4P_IN_CAYMAN PM4P_FAMILIES_##families, PM4P_POSITION_cayman_##name)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+static uint16_t const pm4p_shadow_positions_cayman[PM4S_REGISTER_COUNT] = {
+#define PM4P_REGISTER(name, address, families, block, layout) \
+   PM4P_SHADOW_POSITION(PM4P_IN_CAYMAN PM4P_FAMILIES_##families, cayman, name, address, block)
+#include "PM4Registers.inl"
+#undef PM4P_REGISTER
+};
+
+#undef PM4P_FIELDS
+
+#define PM4P_FAMILY(id, name) \
+   [PM4P_FAMILY_##id] = {#name, pm4p_register_indices_##name, pm4p_registers_##name + 1, \
+                         sizeof(pm4p_registers_##name) / sizeof(pm4p_registers_##name[0]) - 1, \
+                         pm4p_shadow_positions_##name}
+
+static PM4P_Family const pm4p_families[PM4P_FAMILY_COUNT] = {
+   PM4P_FAMILY(R600, r600),
+   PM4P_FAMILY(R700, r700),
+   PM4P_FAMILY(EVERGREEN, evergreen),
+   PM4P_FAMILY(CAYMAN, cayman),
+};
+
+#undef PM4P_FAMILY
+
+PM4P_Family const * PM4P_GetFamily(PM4P_FamilyId const family_id) {
+   return &pm4p_families[family_id];
+}
+
+PM4P_Family const * PM4P_FindFamily(char const * const name) {
+   for (uint32_t family_index = 0; family_index < PM4P_FAMILY_COUNT; ++family_index) {
+      if (!strcmp(pm4p_families[family_index].name, name)) {
+         return &pm4p_families[family_index];
+      }
+   }
+   return NULL;
+}
+
+uint32_t PM4P_FindRegisterLowerBound(PM4P_Family const * const family,
+                                     uint32_t const index_dwords) {
+   // Fixed number of steps for a table size, written so the comparison selects the next base
+   // without a branch as the outcome is unpredictable.
+   uint32_t const * const indices = family->register_indices;
+   if (family->register_count == 0) {
+      return 0;
+   }
+   uint32_t base = 0;
+   uint32_t count = family->register_count;
+   while (count > 1) {
+      uint32_t const half = count / 2;
+      base = indices[base + half] < index_dwords ? base + half : base;
+      count -= half;
+   }
+   // base is now the last entry below the index, or the first entry.
+   return base + (indices[base] < index_dwords);
+}
+
+// Returns pm4p_register_unknown if the register is unknown in the family.
+static PM4P_Register const * PM4P_FindRegisterRecord(PM4P_Family const * const family,
+                                                     uint32_t const index_dwords) {
+   uint32_t const shadow_index = PM4P_SHADOW_INDEX(index_dwords);
+   if (shadow_index != PM4S_REGISTER_COUNT) {
+      return family->registers[(ptrdiff_t)family->shadow_positions[shadow_index] - 1];
+   }
+   uint32_t const position = PM4P_FindRegisterLowerBound(family, index_dwords);
+   if (position != family->register_count && family->register_indices[position] == index_dwords) {
+      return family->registers[position];
+   }
+   return &pm4p_register_unknown;
+}
+
+PM4P_Register const * PM4P_FindRegister(PM4P_Family const * const family,
+                                        uint32_t const index_dwords) {
+   PM4P_Register const * const register_record = PM4P_FindRegisterRecord(family, index_dwords);
+   return register_record != &pm4p_register_unknown ? register_record : NULL;
+}
+
+char const * PM4P_GetRegisterName(uint32_t const index_dwords, PM4P_Family const * const family) {
+   return PM4P_FindRegisterRecord(family, index_dwords)->name;
+}
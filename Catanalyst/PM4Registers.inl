@@ -0,0 +1,890 @@
+// The registers of the R6xx to Cayman GPU families, expanded into the register database in
+// PM4Registers.c, which defines the two macros before including this file. Not a header, and
+// included multiple times.
+//
+// PM4P_FIELDS(layout, PM4P_FIELD(name, shift, width)...) - the bit fields of a register value,
+// shared by all the registers with the layout.
+//
+// PM4P_REGISTER(name, byte address, families, block, layout or NONE) - the families are the span
+// from the first to the last family having the register: R6 for R6xx, R7 for R7xx, EG for
+// Evergreen, and CM for Cayman, a single one if the register is specific to it. Every family must
+// have at most one register at an address. The entries must be sorted by the address, so the
+// tables of the families are generated already sorted for the binary search.
+//
+// The registers before Cayman and the Cayman-specific ones were converted from the R_ and CM_R_
+// definitions in the r600 and Evergreen headers with:
+// #define[ \t]+([0-9A-Z_]+)[ \t]+(0[Xx][0-9A-Fa-f]+)[^\n]*
+// replaced with:
+// PM4P_REGISTER(\1, \2, <families>, <block>, NONE)
+
+PM4P_FIELDS(VGT_PRIMITIVE_TYPE,
+            PM4P_FIELD(PRIM_TYPE, 0, 6))
+PM4P_FIELDS(DB_DEPTH_INFO,
+            PM4P_FIELD(FORMAT, 0, 3),
+            PM4P_FIELD(READ_SIZE, 3, 1),
+            PM4P_FIELD(ARRAY_MODE, 15, 4),
+            PM4P_FIELD(TILE_SURFACE_ENABLE, 25, 1),
+            PM4P_FIELD(TILE_COMPACT, 26, 1),
+            PM4P_FIELD(ZRANGE_PRECISION, 31, 1))
+PM4P_FIELDS(DB_Z_INFO,
+            PM4P_FIELD(FORMAT, 0, 2),
+            PM4P_FIELD(ARRAY_MODE, 4, 4),
+            PM4P_FIELD(TILE_SPLIT, 8, 3),
+            PM4P_FIELD(NUM_BANKS, 12, 2),
+            PM4P_FIELD(BANK_WIDTH, 16, 2),
+            PM4P_FIELD(BANK_HEIGHT, 20, 2),
+            PM4P_FIELD(MACRO_TILE_ASPECT, 24, 2),
+            PM4P_FIELD(READ_SIZE, 28, 1),
+            PM4P_FIELD(TILE_SURFACE_ENABLE, 29, 1),
+            PM4P_FIELD(ZRANGE_PRECISION, 31, 1))
+PM4P_FIELDS(CB_TARGET_MASK,
+            PM4P_FIELD(TARGET0_ENABLE, 0, 4),
+            PM4P_FIELD(TARGET1_ENABLE, 4, 4),
+            PM4P_FIELD(TARGET2_ENABLE, 8, 4),
+            PM4P_FIELD(TARGET3_ENABLE, 12, 4),
+            PM4P_FIELD(TARGET4_ENABLE, 16, 4),
+            PM4P_FIELD(TARGET5_ENABLE, 20, 4),
+            PM4P_FIELD(TARGET6_ENABLE, 24, 4),
+            PM4P_FIELD(TARGET7_ENABLE, 28, 4))
+PM4P_FIELDS(CB_SHADER_MASK,
+            PM4P_FIELD(OUTPUT0_ENABLE, 0, 4),
+            PM4P_FIELD(OUTPUT1_ENABLE, 4, 4),
+            PM4P_FIELD(OUTPUT2_ENABLE, 8, 4),
+            PM4P_FIELD(OUTPUT3_ENABLE, 12, 4),
+            PM4P_FIELD(OUTPUT4_ENABLE, 16, 4),
+            PM4P_FIELD(OUTPUT5_ENABLE, 20, 4),
+            PM4P_FIELD(OUTPUT6_ENABLE, 24, 4),
+            PM4P_FIELD(OUTPUT7_ENABLE, 28, 4))
+PM4P_FIELDS(SX_ALPHA_TEST_CONTROL,
+            PM4P_FIELD(ALPHA_FUNC, 0, 3),
+            PM4P_FIELD(ALPHA_TEST_ENABLE, 3, 1),
+            PM4P_FIELD(ALPHA_TEST_BYPASS, 8, 1))
+PM4P_FIELDS(DB_DEPTH_CONTROL,
+            PM4P_FIELD(STENCIL_ENABLE, 0, 1),
+            PM4P_FIELD(Z_ENABLE, 1, 1),
+            PM4P_FIELD(Z_WRITE_ENABLE, 2, 1),
+            PM4P_FIELD(ZFUNC, 4, 3),
+            PM4P_FIELD(BACKFACE_ENABLE, 7, 1),
+            PM4P_FIELD(STENCILFUNC, 8, 3),
+            PM4P_FIELD(STENCILFAIL, 11, 3),
+            PM4P_FIELD(STENCILZPASS, 14, 3),
+            PM4P_FIELD(STENCILZFAIL, 17, 3),
+            PM4P_FIELD(STENCILFUNC_BF, 20, 3),
+            PM4P_FIELD(STENCILFAIL_BF, 23, 3),
+            PM4P_FIELD(STENCILZPASS_BF, 26, 3),
+            PM4P_FIELD(STENCILZFAIL_BF, 29, 3))
+PM4P_FIELDS(CB_COLOR_INFO,
+            PM4P_FIELD(ENDIAN, 0, 2),
+            PM4P_FIELD(FORMAT, 2, 6),
+            PM4P_FIELD(ARRAY_MODE, 8, 4),
+            PM4P_FIELD(NUMBER_TYPE, 12, 3),
+            PM4P_FIELD(READ_SIZE, 15, 1),
+            PM4P_FIELD(COMP_SWAP, 16, 2),
+            PM4P_FIELD(TILE_MODE, 18, 2),
+            PM4P_FIELD(BLEND_CLAMP, 20, 1),
+            PM4P_FIELD(CLEAR_COLOR, 21, 1),
+            PM4P_FIELD(BLEND_BYPASS, 22, 1),
+            PM4P_FIELD(BLEND_FLOAT32, 23, 1),
+            PM4P_FIELD(SIMPLE_FLOAT, 24, 1),
+            PM4P_FIELD(ROUND_MODE, 25, 1),
+            PM4P_FIELD(TILE_COMPACT, 26, 1),
+            PM4P_FIELD(SOURCE_FORMAT, 27, 1))
+PM4P_FIELDS(EG_CB_COLOR_INFO,
+            PM4P_FIELD(ENDIAN, 0, 2),
+            PM4P_FIELD(FORMAT, 2, 6),
+            PM4P_FIELD(ARRAY_MODE, 8, 4),
+            PM4P_FIELD(NUMBER_TYPE, 12, 3),
+            PM4P_FIELD(COMP_SWAP, 15, 2),
+            PM4P_FIELD(FAST_CLEAR, 17, 1),
+            PM4P_FIELD(COMPRESSION, 18, 1),
+            PM4P_FIELD(BLEND_CLAMP, 19, 1),
+            PM4P_FIELD(BLEND_BYPASS, 20, 1),
+            PM4P_FIELD(SIMPLE_FLOAT, 21, 1),
+            PM4P_FIELD(ROUND_MODE, 22, 1),
+            PM4P_FIELD(TILE_COMPACT, 23, 1),
+            PM4P_FIELD(SOURCE_FORMAT, 24, 2),
+            PM4P_FIELD(RAT, 26, 1),
+            PM4P_FIELD(RESOURCE_TYPE, 27, 3))
+PM4P_FIELDS(PA_CL_CLIP_CNTL,
+            PM4P_FIELD(UCP_ENA_0, 0, 1),
+            PM4P_FIELD(UCP_ENA_1, 1, 1),
+            PM4P_FIELD(UCP_ENA_2, 2, 1),
+            PM4P_FIELD(UCP_ENA_3, 3, 1),
+            PM4P_FIELD(UCP_ENA_4, 4, 1),
+            PM4P_FIELD(UCP_ENA_5, 5, 1),
+            PM4P_FIELD(PS_UCP_Y_SCALE_NEG, 13, 1),
+            PM4P_FIELD(PS_UCP_MODE, 14, 2),
+            PM4P_FIELD(CLIP_DISABLE, 16, 1),
+            PM4P_FIELD(UCP_CULL_ONLY_ENA, 17, 1),
+            PM4P_FIELD(BOUNDARY_EDGE_FLAG_ENA, 18, 1),
+            PM4P_FIELD(DX_CLIP_SPACE_DEF, 19, 1),
+            PM4P_FIELD(DIS_CLIP_ERR_DETECT, 20, 1),
+            PM4P_FIELD(VTX_KILL_OR, 21, 1),
+            PM4P_FIELD(DX_RASTERIZATION_KILL, 22, 1),
+            PM4P_FIELD(DX_LINEAR_ATTR_CLIP_ENA, 24, 1),
+            PM4P_FIELD(VTE_VPORT_PROVOKE_DISABLE, 25, 1),
+            PM4P_FIELD(ZCLIP_NEAR_DISABLE, 26, 1),
+            PM4P_FIELD(ZCLIP_FAR_DISABLE, 27, 1))
+PM4P_FIELDS(PA_SU_SC_MODE_CNTL,
+            PM4P_FIELD(CULL_FRONT, 0, 1),
+            PM4P_FIELD(CULL_BACK, 1, 1),
+            PM4P_FIELD(FACE, 2, 1),
+            PM4P_FIELD(POLY_MODE, 3, 2),
+            PM4P_FIELD(POLYMODE_FRONT_PTYPE, 5, 3),
+            PM4P_FIELD(POLYMODE_BACK_PTYPE, 8, 3),
+            PM4P_FIELD(POLY_OFFSET_FRONT_ENABLE, 11, 1),
+            PM4P_FIELD(POLY_OFFSET_BACK_ENABLE, 12, 1),
+            PM4P_FIELD(POLY_OFFSET_PARA_ENABLE, 13, 1),
+            PM4P_FIELD(VTX_WINDOW_OFFSET_ENABLE, 16, 1),
+            PM4P_FIELD(PROVOKING_VTX_LAST, 19, 1),
+            PM4P_FIELD(PERSP_CORR_DIS, 20, 1),
+            PM4P_FIELD(MULTI_PRIM_IB_ENA, 21, 1))
+PM4P_FIELDS(PA_SC_AA_CONFIG,
+            PM4P_FIELD(MSAA_NUM_SAMPLES, 0, 2),
+            PM4P_FIELD(AA_MASK_CENTROID_DTMN, 4, 1),
+            PM4P_FIELD(MAX_SAMPLE_DIST, 13, 4))
+PM4P_FIELDS(CM_PA_SC_AA_CONFIG,
+            PM4P_FIELD(MSAA_NUM_SAMPLES, 0, 3),
+            PM4P_FIELD(AA_MASK_CENTROID_DTMN, 4, 1),
+            PM4P_FIELD(MAX_SAMPLE_DIST, 13, 4),
+            PM4P_FIELD(MSAA_EXPOSED_SAMPLES, 20, 3),
+            PM4P_FIELD(DETAIL_TO_EXPOSED_MODE, 24, 2))
+
+PM4P_REGISTER(R_008040_WAIT_UNTIL, 0x008040, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_0084FC_CP_STRMOUT_CNTL, 0x0084FC, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_0085F0_CP_COHER_CNTL, 0x0085F0, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_0085F4_CP_COHER_SIZE, 0x0085F4, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_0085F8_CP_COHER_BASE, 0x0085F8, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008958_VGT_PRIMITIVE_TYPE, 0x008958, R6_CM, CONFIG, VGT_PRIMITIVE_TYPE)
+PM4P_REGISTER(R_008960_VGT_STRMOUT_BUFFER_FILLED_SIZE_0, 0x008960, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008964_VGT_STRMOUT_BUFFER_FILLED_SIZE_1, 0x008964, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008968_VGT_STRMOUT_BUFFER_FILLED_SIZE_2, 0x008968, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00896C_VGT_STRMOUT_BUFFER_FILLED_SIZE_3, 0x00896C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008970_VGT_NUM_INDICES, 0x008970, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008A14_PA_CL_ENHANCE, 0x008A14, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C00_SQ_CONFIG, 0x008C00, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C04_SQ_GPR_RESOURCE_MGMT_1, 0x008C04, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C08_SQ_GPR_RESOURCE_MGMT_2, 0x008C08, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C0C_SQ_THREAD_RESOURCE_MGMT, 0x008C0C, R6_R7, CONFIG, NONE)
+PM4P_REGISTER(R_008C0C_SQ_GPR_RESOURCE_MGMT_3, 0x008C0C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C10_SQ_STACK_RESOURCE_MGMT_1, 0x008C10, R6_R7, CONFIG, NONE)
+PM4P_REGISTER(R_008C10_SQ_GLOBAL_GPR_RESOURCE_MGMT_1, 0x008C10, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C14_SQ_STACK_RESOURCE_MGMT_2, 0x008C14, R6_R7, CONFIG, NONE)
+PM4P_REGISTER(R_008C14_SQ_GLOBAL_GPR_RESOURCE_MGMT_2, 0x008C14, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C18_SQ_THREAD_RESOURCE_MGMT_1, 0x008C18, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C1C_SQ_THREAD_RESOURCE_MGMT_2, 0x008C1C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C20_SQ_STACK_RESOURCE_MGMT_1, 0x008C20, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C24_SQ_STACK_RESOURCE_MGMT_2, 0x008C24, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C28_SQ_STACK_RESOURCE_MGMT_3, 0x008C28, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C40_SQ_ESGS_RING_BASE, 0x008C40, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C44_SQ_ESGS_RING_SIZE, 0x008C44, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C48_SQ_GSVS_RING_BASE, 0x008C48, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C4C_SQ_GSVS_RING_SIZE, 0x008C4C, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C50_SQ_ESTMP_RING_BASE, 0x008C50, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C54_SQ_ESTMP_RING_SIZE, 0x008C54, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C58_SQ_GSTMP_RING_BASE, 0x008C58, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C5C_SQ_GSTMP_RING_SIZE, 0x008C5C, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C60_SQ_VSTMP_RING_BASE, 0x008C60, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C64_SQ_VSTMP_RING_SIZE, 0x008C64, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C68_SQ_PSTMP_RING_BASE, 0x008C68, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008C6C_SQ_PSTMP_RING_SIZE, 0x008C6C, R6_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008CF0_SQ_MS_FIFO_SIZES, 0x008CF0, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008D8C_SQ_DYN_GPR_CNTL_PS_FLUSH_REQ, 0x008D8C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E10_SQ_LSTMP_RING_BASE, 0x008E10, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E14_SQ_LSTMP_RING_SIZE, 0x008E14, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E18_SQ_HSTMP_RING_BASE, 0x008E18, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E1C_SQ_HSTMP_RING_SIZE, 0x008E1C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E20_SQ_STATIC_THREAD_MGMT1, 0x008E20, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E24_SQ_STATIC_THREAD_MGMT2, 0x008E24, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E28_SQ_STATIC_THREAD_MGMT3, 0x008E28, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_008E2C_SQ_LDS_RESOURCE_MGMT, 0x008E2C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_009100_SPI_CONFIG_CNTL, 0x009100, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00913C_SPI_CONFIG_CNTL_1, 0x00913C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A400_TD_PS_SAMPLER0_BORDER_INDEX, 0x00A400, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A404_TD_PS_SAMPLER0_BORDER_RED, 0x00A404, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A408_TD_PS_SAMPLER0_BORDER_GREEN, 0x00A408, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A40C_TD_PS_SAMPLER0_BORDER_BLUE, 0x00A40C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A410_TD_PS_SAMPLER0_BORDER_ALPHA, 0x00A410, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A414_TD_VS_SAMPLER0_BORDER_INDEX, 0x00A414, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A418_TD_VS_SAMPLER0_BORDER_RED, 0x00A418, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A41C_TD_VS_SAMPLER0_BORDER_GREEN, 0x00A41C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A420_TD_VS_SAMPLER0_BORDER_BLUE, 0x00A420, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A424_TD_VS_SAMPLER0_BORDER_ALPHA, 0x00A424, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A428_TD_GS_SAMPLER0_BORDER_INDEX, 0x00A428, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A42C_TD_GS_SAMPLER0_BORDER_RED, 0x00A42C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A430_TD_GS_SAMPLER0_BORDER_GREEN, 0x00A430, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A434_TD_GS_SAMPLER0_BORDER_BLUE, 0x00A434, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A438_TD_GS_SAMPLER0_BORDER_ALPHA, 0x00A438, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A43C_TD_HS_SAMPLER0_BORDER_COLOR_INDEX, 0x00A43C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A440_TD_HS_SAMPLER0_BORDER_COLOR_RED, 0x00A440, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A444_TD_HS_SAMPLER0_BORDER_COLOR_GREEN, 0x00A444, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A448_TD_HS_SAMPLER0_BORDER_COLOR_BLUE, 0x00A448, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A44C_TD_HS_SAMPLER0_BORDER_COLOR_ALPHA, 0x00A44C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A450_TD_LS_SAMPLER0_BORDER_COLOR_INDEX, 0x00A450, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A454_TD_LS_SAMPLER0_BORDER_COLOR_RED, 0x00A454, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A458_TD_LS_SAMPLER0_BORDER_COLOR_GREEN, 0x00A458, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A45C_TD_LS_SAMPLER0_BORDER_COLOR_BLUE, 0x00A45C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A460_TD_LS_SAMPLER0_BORDER_COLOR_ALPHA, 0x00A460, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A464_TD_CS_SAMPLER0_BORDER_INDEX, 0x00A464, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A468_TD_CS_SAMPLER0_BORDER_RED, 0x00A468, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A46C_TD_CS_SAMPLER0_BORDER_GREEN, 0x00A46C, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A470_TD_CS_SAMPLER0_BORDER_BLUE, 0x00A470, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_00A474_TD_CS_SAMPLER0_BORDER_ALPHA, 0x00A474, EG_CM, CONFIG, NONE)
+PM4P_REGISTER(R_028000_DB_DEPTH_SIZE, 0x028000, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028000_DB_RENDER_CONTROL, 0x028000, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028004_DB_DEPTH_VIEW, 0x028004, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028004_DB_COUNT_CONTROL, 0x028004, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028008_DB_DEPTH_VIEW, 0x028008, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02800C_DB_DEPTH_BASE, 0x02800C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02800C_DB_RENDER_OVERRIDE, 0x02800C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028010_DB_DEPTH_INFO, 0x028010, R6_R7, CONTEXT, DB_DEPTH_INFO)
+PM4P_REGISTER(R_028010_DB_RENDER_OVERRIDE2, 0x028010, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028014_DB_HTILE_DATA_BASE, 0x028014, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028028_DB_STENCIL_CLEAR, 0x028028, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02802C_DB_DEPTH_CLEAR, 0x02802C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028030_PA_SC_SCREEN_SCISSOR_TL, 0x028030, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028034_PA_SC_SCREEN_SCISSOR_BR, 0x028034, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028040_CB_COLOR0_BASE, 0x028040, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028040_DB_Z_INFO, 0x028040, EG_CM, CONTEXT, DB_Z_INFO)
+PM4P_REGISTER(R_028044_CB_COLOR1_BASE, 0x028044, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028044_DB_STENCIL_INFO, 0x028044, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028048_CB_COLOR2_BASE, 0x028048, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028048_DB_Z_READ_BASE, 0x028048, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02804C_CB_COLOR3_BASE, 0x02804C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02804C_DB_STENCIL_READ_BASE, 0x02804C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028050_CB_COLOR4_BASE, 0x028050, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028050_DB_Z_WRITE_BASE, 0x028050, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028054_CB_COLOR5_BASE, 0x028054, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028054_DB_STENCIL_WRITE_BASE, 0x028054, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028058_CB_COLOR6_BASE, 0x028058, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028058_DB_DEPTH_SIZE, 0x028058, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02805C_CB_COLOR7_BASE, 0x02805C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02805C_DB_DEPTH_SLICE, 0x02805C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028060_CB_COLOR0_SIZE, 0x028060, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028064_CB_COLOR1_SIZE, 0x028064, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028068_CB_COLOR2_SIZE, 0x028068, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02806C_CB_COLOR3_SIZE, 0x02806C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028070_CB_COLOR4_SIZE, 0x028070, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028074_CB_COLOR5_SIZE, 0x028074, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028078_CB_COLOR6_SIZE, 0x028078, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02807C_CB_COLOR7_SIZE, 0x02807C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028080_CB_COLOR0_VIEW, 0x028080, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028084_CB_COLOR1_VIEW, 0x028084, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028088_CB_COLOR2_VIEW, 0x028088, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02808C_CB_COLOR3_VIEW, 0x02808C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028090_CB_COLOR4_VIEW, 0x028090, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028094_CB_COLOR5_VIEW, 0x028094, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028098_CB_COLOR6_VIEW, 0x028098, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02809C_CB_COLOR7_VIEW, 0x02809C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280A0_CB_COLOR0_INFO, 0x0280A0, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280A4_CB_COLOR1_INFO, 0x0280A4, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280A8_CB_COLOR2_INFO, 0x0280A8, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280AC_CB_COLOR3_INFO, 0x0280AC, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280B0_CB_COLOR4_INFO, 0x0280B0, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280B4_CB_COLOR5_INFO, 0x0280B4, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280B8_CB_COLOR6_INFO, 0x0280B8, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280BC_CB_COLOR7_INFO, 0x0280BC, R6_R7, CONTEXT, CB_COLOR_INFO)
+PM4P_REGISTER(R_0280C0_CB_COLOR0_TILE, 0x0280C0, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280C4_CB_COLOR1_TILE, 0x0280C4, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280C8_CB_COLOR2_TILE, 0x0280C8, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280CC_CB_COLOR3_TILE, 0x0280CC, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280D0_CB_COLOR4_TILE, 0x0280D0, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280D4_CB_COLOR5_TILE, 0x0280D4, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280D8_CB_COLOR6_TILE, 0x0280D8, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280DC_CB_COLOR7_TILE, 0x0280DC, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280E0_CB_COLOR0_FRAG, 0x0280E0, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280E4_CB_COLOR1_FRAG, 0x0280E4, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280E8_CB_COLOR2_FRAG, 0x0280E8, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280EC_CB_COLOR3_FRAG, 0x0280EC, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280F0_CB_COLOR4_FRAG, 0x0280F0, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280F4_CB_COLOR5_FRAG, 0x0280F4, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280F8_CB_COLOR6_FRAG, 0x0280F8, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_0280FC_CB_COLOR7_FRAG, 0x0280FC, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028100_CB_COLOR0_MASK, 0x028100, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028104_CB_COLOR1_MASK, 0x028104, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028108_CB_COLOR2_MASK, 0x028108, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02810C_CB_COLOR3_MASK, 0x02810C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028110_CB_COLOR4_MASK, 0x028110, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028114_CB_COLOR5_MASK, 0x028114, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028118_CB_COLOR6_MASK, 0x028118, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02811C_CB_COLOR7_MASK, 0x02811C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028140_ALU_CONST_BUFFER_SIZE_PS_0, 0x028140, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028144_ALU_CONST_BUFFER_SIZE_PS_1, 0x028144, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028180_ALU_CONST_BUFFER_SIZE_VS_0, 0x028180, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028184_ALU_CONST_BUFFER_SIZE_VS_1, 0x028184, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0281C0_ALU_CONST_BUFFER_SIZE_GS_0, 0x0281C0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028200_PA_SC_WINDOW_OFFSET, 0x028200, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028204_PA_SC_WINDOW_SCISSOR_TL, 0x028204, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028208_PA_SC_WINDOW_SCISSOR_BR, 0x028208, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02820C_PA_SC_CLIPRECT_RULE, 0x02820C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028210_PA_SC_CLIPRECT_0_TL, 0x028210, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028214_PA_SC_CLIPRECT_0_BR, 0x028214, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028218_PA_SC_CLIPRECT_1_TL, 0x028218, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02821C_PA_SC_CLIPRECT_1_BR, 0x02821C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028220_PA_SC_CLIPRECT_2_TL, 0x028220, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028224_PA_SC_CLIPRECT_2_BR, 0x028224, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028228_PA_SC_CLIPRECT_3_TL, 0x028228, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02822C_PA_SC_CLIPRECT_3_BR, 0x02822C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028230_PA_SC_EDGERULE, 0x028230, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028234_PA_SU_HARDWARE_SCREEN_OFFSET, 0x028234, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028238_CB_TARGET_MASK, 0x028238, R6_CM, CONTEXT, CB_TARGET_MASK)
+PM4P_REGISTER(R_02823C_CB_SHADER_MASK, 0x02823C, R6_CM, CONTEXT, CB_SHADER_MASK)
+PM4P_REGISTER(R_028240_PA_SC_GENERIC_SCISSOR_TL, 0x028240, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028244_PA_SC_GENERIC_SCISSOR_BR, 0x028244, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028250_PA_SC_VPORT_SCISSOR_0_TL, 0x028250, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028254_PA_SC_VPORT_SCISSOR_0_BR, 0x028254, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0282D0_PA_SC_VPORT_ZMIN_0, 0x0282D0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0282D4_PA_SC_VPORT_ZMAX_0, 0x0282D4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028350_SX_MISC, 0x028350, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028354_SX_SURFACE_SYNC, 0x028354, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028380_SQ_VTX_SEMANTIC_0, 0x028380, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028384_SQ_VTX_SEMANTIC_1, 0x028384, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028388_SQ_VTX_SEMANTIC_2, 0x028388, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02838C_SQ_VTX_SEMANTIC_3, 0x02838C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028390_SQ_VTX_SEMANTIC_4, 0x028390, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028394_SQ_VTX_SEMANTIC_5, 0x028394, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028398_SQ_VTX_SEMANTIC_6, 0x028398, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02839C_SQ_VTX_SEMANTIC_7, 0x02839C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283A0_SQ_VTX_SEMANTIC_8, 0x0283A0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283A4_SQ_VTX_SEMANTIC_9, 0x0283A4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283A8_SQ_VTX_SEMANTIC_10, 0x0283A8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283AC_SQ_VTX_SEMANTIC_11, 0x0283AC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283B0_SQ_VTX_SEMANTIC_12, 0x0283B0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283B4_SQ_VTX_SEMANTIC_13, 0x0283B4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283B8_SQ_VTX_SEMANTIC_14, 0x0283B8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283BC_SQ_VTX_SEMANTIC_15, 0x0283BC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283C0_SQ_VTX_SEMANTIC_16, 0x0283C0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283C4_SQ_VTX_SEMANTIC_17, 0x0283C4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283C8_SQ_VTX_SEMANTIC_18, 0x0283C8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283CC_SQ_VTX_SEMANTIC_19, 0x0283CC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283D0_SQ_VTX_SEMANTIC_20, 0x0283D0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283D4_SQ_VTX_SEMANTIC_21, 0x0283D4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283D8_SQ_VTX_SEMANTIC_22, 0x0283D8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283DC_SQ_VTX_SEMANTIC_23, 0x0283DC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283E0_SQ_VTX_SEMANTIC_24, 0x0283E0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283E4_SQ_VTX_SEMANTIC_25, 0x0283E4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283E8_SQ_VTX_SEMANTIC_26, 0x0283E8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283EC_SQ_VTX_SEMANTIC_27, 0x0283EC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283F0_SQ_VTX_SEMANTIC_28, 0x0283F0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283F4_SQ_VTX_SEMANTIC_29, 0x0283F4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283F8_SQ_VTX_SEMANTIC_30, 0x0283F8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0283FC_SQ_VTX_SEMANTIC_31, 0x0283FC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028400_VGT_MAX_VTX_INDX, 0x028400, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028404_VGT_MIN_VTX_INDX, 0x028404, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028408_VGT_INDX_OFFSET, 0x028408, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02840C_VGT_MULTI_PRIM_IB_RESET_INDX, 0x02840C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028410_SX_ALPHA_TEST_CONTROL, 0x028410, R6_CM, CONTEXT, SX_ALPHA_TEST_CONTROL)
+PM4P_REGISTER(R_028414_CB_BLEND_RED, 0x028414, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028418_CB_BLEND_GREEN, 0x028418, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02841C_CB_BLEND_BLUE, 0x02841C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028420_CB_BLEND_ALPHA, 0x028420, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028430_DB_STENCILREFMASK, 0x028430, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028434_DB_STENCILREFMASK_BF, 0x028434, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028438_SX_ALPHA_REF, 0x028438, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02843C_PA_CL_VPORT_XSCALE_0, 0x02843C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028440_PA_CL_VPORT_XOFFSET_0, 0x028440, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028444_PA_CL_VPORT_YSCALE_0, 0x028444, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028448_PA_CL_VPORT_YOFFSET_0, 0x028448, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02844C_PA_CL_VPORT_ZSCALE_0, 0x02844C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028450_PA_CL_VPORT_ZOFFSET_0, 0x028450, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285BC_PA_CL_UCP0_X, 0x0285BC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285C0_PA_CL_UCP0_Y, 0x0285C0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285C4_PA_CL_UCP0_Z, 0x0285C4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285C8_PA_CL_UCP0_W, 0x0285C8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285CC_PA_CL_UCP1_X, 0x0285CC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285D0_PA_CL_UCP1_Y, 0x0285D0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285D4_PA_CL_UCP1_Z, 0x0285D4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285D8_PA_CL_UCP1_W, 0x0285D8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285DC_PA_CL_UCP2_X, 0x0285DC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285E0_PA_CL_UCP2_Y, 0x0285E0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285E4_PA_CL_UCP2_Z, 0x0285E4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285E8_PA_CL_UCP2_W, 0x0285E8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285EC_PA_CL_UCP3_X, 0x0285EC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285F0_PA_CL_UCP3_Y, 0x0285F0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285F4_PA_CL_UCP3_Z, 0x0285F4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285F8_PA_CL_UCP3_W, 0x0285F8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0285FC_PA_CL_UCP4_X, 0x0285FC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028600_PA_CL_UCP4_Y, 0x028600, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028604_PA_CL_UCP4_Z, 0x028604, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028608_PA_CL_UCP4_W, 0x028608, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02860C_PA_CL_UCP5_X, 0x02860C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028610_PA_CL_UCP5_Y, 0x028610, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028614_PA_CL_UCP5_Z, 0x028614, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028618_PA_CL_UCP5_W, 0x028618, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02861C_SPI_VS_OUT_ID_0, 0x02861C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028620_SPI_VS_OUT_ID_1, 0x028620, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028624_SPI_VS_OUT_ID_2, 0x028624, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028628_SPI_VS_OUT_ID_3, 0x028628, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02862C_SPI_VS_OUT_ID_4, 0x02862C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028630_SPI_VS_OUT_ID_5, 0x028630, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028634_SPI_VS_OUT_ID_6, 0x028634, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028638_SPI_VS_OUT_ID_7, 0x028638, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02863C_SPI_VS_OUT_ID_8, 0x02863C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028640_SPI_VS_OUT_ID_9, 0x028640, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028644_SPI_PS_INPUT_CNTL_0, 0x028644, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028648_SPI_PS_INPUT_CNTL_1, 0x028648, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02864C_SPI_PS_INPUT_CNTL_2, 0x02864C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028650_SPI_PS_INPUT_CNTL_3, 0x028650, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028654_SPI_PS_INPUT_CNTL_4, 0x028654, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028658_SPI_PS_INPUT_CNTL_5, 0x028658, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02865C_SPI_PS_INPUT_CNTL_6, 0x02865C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028660_SPI_PS_INPUT_CNTL_7, 0x028660, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028664_SPI_PS_INPUT_CNTL_8, 0x028664, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028668_SPI_PS_INPUT_CNTL_9, 0x028668, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02866C_SPI_PS_INPUT_CNTL_10, 0x02866C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028670_SPI_PS_INPUT_CNTL_11, 0x028670, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028674_SPI_PS_INPUT_CNTL_12, 0x028674, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028678_SPI_PS_INPUT_CNTL_13, 0x028678, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02867C_SPI_PS_INPUT_CNTL_14, 0x02867C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028680_SPI_PS_INPUT_CNTL_15, 0x028680, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028684_SPI_PS_INPUT_CNTL_16, 0x028684, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028688_SPI_PS_INPUT_CNTL_17, 0x028688, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02868C_SPI_PS_INPUT_CNTL_18, 0x02868C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028690_SPI_PS_INPUT_CNTL_19, 0x028690, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028694_SPI_PS_INPUT_CNTL_20, 0x028694, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028698_SPI_PS_INPUT_CNTL_21, 0x028698, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02869C_SPI_PS_INPUT_CNTL_22, 0x02869C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286A0_SPI_PS_INPUT_CNTL_23, 0x0286A0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286A4_SPI_PS_INPUT_CNTL_24, 0x0286A4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286A8_SPI_PS_INPUT_CNTL_25, 0x0286A8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286AC_SPI_PS_INPUT_CNTL_26, 0x0286AC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286B0_SPI_PS_INPUT_CNTL_27, 0x0286B0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286B4_SPI_PS_INPUT_CNTL_28, 0x0286B4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286B8_SPI_PS_INPUT_CNTL_29, 0x0286B8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286BC_SPI_PS_INPUT_CNTL_30, 0x0286BC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286C0_SPI_PS_INPUT_CNTL_31, 0x0286C0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286C4_SPI_VS_OUT_CONFIG, 0x0286C4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286C8_SPI_THREAD_GROUPING, 0x0286C8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286CC_SPI_PS_IN_CONTROL_0, 0x0286CC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286D0_SPI_PS_IN_CONTROL_1, 0x0286D0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286D4_SPI_INTERP_CONTROL_0, 0x0286D4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286D8_SPI_INPUT_Z, 0x0286D8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286DC_SPI_FOG_CNTL, 0x0286DC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286E0_SPI_BARYC_CNTL, 0x0286E0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286E4_SPI_PS_IN_CONTROL_2, 0x0286E4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286E8_SPI_COMPUTE_INPUT_CNTL, 0x0286E8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286EC_SPI_COMPUTE_NUM_THREAD_X, 0x0286EC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286F0_SPI_COMPUTE_NUM_THREAD_Y, 0x0286F0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0286F4_SPI_COMPUTE_NUM_THREAD_Z, 0x0286F4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_0286F8_SPI_GPR_MGMT, 0x0286F8, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_0286FC_SPI_LDS_MGMT, 0x0286FC, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028700_SPI_STACK_MGMT, 0x028700, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028704_SPI_WAVE_MGMT_1, 0x028704, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028708_SPI_WAVE_MGMT_2, 0x028708, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028720_GDS_ADDR_BASE, 0x028720, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028724_GDS_ADDR_SIZE, 0x028724, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028728_GDS_ORDERED_WAVE_PER_SE, 0x028728, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02872C_GDS_APPEND_COUNT_0, 0x02872C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028730_GDS_APPEND_COUNT_1, 0x028730, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028734_GDS_APPEND_COUNT_2, 0x028734, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028738_GDS_APPEND_COUNT_3, 0x028738, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02873C_GDS_APPEND_COUNT_4, 0x02873C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028740_GDS_APPEND_COUNT_5, 0x028740, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028748_GDS_APPEND_COUNT_6, 0x028744, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028744_GDS_APPEND_COUNT_7, 0x028748, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028744_GDS_APPEND_COUNT_8, 0x02874C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028744_GDS_APPEND_COUNT_9, 0x028750, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028744_GDS_APPEND_COUNT_10, 0x028754, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028744_GDS_APPEND_COUNT_11, 0x028758, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028780_CB_BLEND0_CONTROL, 0x028780, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028784_CB_BLEND1_CONTROL, 0x028784, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028788_CB_BLEND2_CONTROL, 0x028788, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02878C_CB_BLEND3_CONTROL, 0x02878C, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028790_CB_BLEND4_CONTROL, 0x028790, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028794_CB_BLEND5_CONTROL, 0x028794, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028798_CB_BLEND6_CONTROL, 0x028798, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02879C_CB_BLEND7_CONTROL, 0x02879C, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0287E4_VGT_DMA_BASE_HI, 0x0287E4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0287E8_VGT_DMA_BASE, 0x0287E8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0287F0_VGT_DRAW_INITIATOR, 0x0287F0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028800_DB_DEPTH_CONTROL, 0x028800, R6_CM, CONTEXT, DB_DEPTH_CONTROL)
+PM4P_REGISTER(R_028804_CB_BLEND_CONTROL, 0x028804, R6, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028804_DB_EQAA, 0x028804, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028808_CB_COLOR_CONTROL, 0x028808, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02880C_DB_SHADER_CONTROL, 0x02880C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028810_PA_CL_CLIP_CNTL, 0x028810, R6_CM, CONTEXT, PA_CL_CLIP_CNTL)
+PM4P_REGISTER(R_028814_PA_SU_SC_MODE_CNTL, 0x028814, R6_CM, CONTEXT, PA_SU_SC_MODE_CNTL)
+PM4P_REGISTER(R_028818_PA_CL_VTE_CNTL, 0x028818, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02881C_PA_CL_VS_OUT_CNTL, 0x02881C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028820_PA_CL_NANINF_CNTL, 0x028820, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028830_SQ_LSTMP_RING_ITEMSIZE, 0x028830, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028834_SQ_HSTMP_RING_ITEMSIZE, 0x028834, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028838_SQ_DYN_GPR_RESOURCE_LIMIT_1, 0x028838, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028840_SQ_PGM_START_PS, 0x028840, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028844_SQ_PGM_RESOURCES_PS, 0x028844, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028848_SQ_PGM_RESOURCES_2_PS, 0x028848, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02884C_SQ_PGM_EXPORTS_PS, 0x02884C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028850_SQ_PGM_RESOURCES_PS, 0x028850, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028854_SQ_PGM_EXPORTS_PS, 0x028854, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028858_SQ_PGM_START_VS, 0x028858, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_02885C_SQ_PGM_START_VS, 0x02885C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028860_SQ_PGM_RESOURCES_VS, 0x028860, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028864_SQ_PGM_RESOURCES_2_VS, 0x028864, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028868_SQ_PGM_RESOURCES_VS, 0x028868, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028874_SQ_PGM_START_GS, 0x028874, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028878_SQ_PGM_RESOURCES_GS, 0x028878, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02887C_SQ_PGM_RESOURCES_2_GS, 0x02887C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02888C_SQ_PGM_START_ES, 0x02888C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028890_SQ_PGM_RESOURCES_ES, 0x028890, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028894_SQ_PGM_RESOURCES_2_ES, 0x028894, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288A4_SQ_PGM_START_FS, 0x0288A4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288A8_SQ_PGM_RESOURCES_FS, 0x0288A8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288B8_SQ_PGM_START_HS, 0x0288B8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288BC_SQ_PGM_RESOURCES_HS, 0x0288BC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288C0_SQ_PGM_RESOURCES_2_HS, 0x0288C0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288D0_SQ_PGM_START_LS, 0x0288D0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288D4_SQ_PGM_RESOURCES_LS, 0x0288D4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288D8_SQ_PGM_RESOURCES_2_LS, 0x0288D8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288E8_SQ_LDS_ALLOC, 0x0288E8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288EC_SQ_LDS_ALLOC_PS, 0x0288EC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0288F0_SQ_VTX_SEMANTIC_CLEAR, 0x0288F0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028900_SQ_ESGS_RING_ITEMSIZE, 0x028900, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028904_SQ_GSVS_RING_ITEMSIZE, 0x028904, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028908_SQ_ESTMP_RING_ITEMSIZE, 0x028908, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02890C_SQ_GSTMP_RING_ITEMSIZE, 0x02890C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028910_SQ_VSTMP_RING_ITEMSIZE, 0x028910, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028914_SQ_PSTMP_RING_ITEMSIZE, 0x028914, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02891C_SQ_GS_VERT_ITEMSIZE, 0x02891C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028920_SQ_GS_VERT_ITEMSIZE_1, 0x028920, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028924_SQ_GS_VERT_ITEMSIZE_2, 0x028924, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028928_SQ_GS_VERT_ITEMSIZE_3, 0x028928, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_02892C_SQ_GSVS_RING_OFFSET_1, 0x02892C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028930_SQ_GSVS_RING_OFFSET_2, 0x028930, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028934_SQ_GSVS_RING_OFFSET_3, 0x028934, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028940_ALU_CONST_CACHE_PS_0, 0x028940, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028944_ALU_CONST_CACHE_PS_1, 0x028944, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028980_ALU_CONST_CACHE_VS_0, 0x028980, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028984_ALU_CONST_CACHE_VS_1, 0x028984, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_0289C0_ALU_CONST_CACHE_GS_0, 0x0289C0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A00_PA_SU_POINT_SIZE, 0x028A00, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A04_PA_SU_POINT_MINMAX, 0x028A04, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A08_PA_SU_LINE_CNTL, 0x028A08, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A0C_PA_SC_LINE_STIPPLE, 0x028A0C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A10_VGT_OUTPUT_PATH_CNTL, 0x028A10, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A14_VGT_HOS_CNTL, 0x028A14, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A18_VGT_HOS_MAX_TESS_LEVEL, 0x028A18, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A1C_VGT_HOS_MIN_TESS_LEVEL, 0x028A1C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A20_VGT_HOS_REUSE_DEPTH, 0x028A20, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A24_VGT_GROUP_PRIM_TYPE, 0x028A24, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A28_VGT_GROUP_FIRST_DECR, 0x028A28, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A2C_VGT_GROUP_DECR, 0x028A2C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A30_VGT_GROUP_VECT_0_CNTL, 0x028A30, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A34_VGT_GROUP_VECT_1_CNTL, 0x028A34, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A38_VGT_GROUP_VECT_0_FMT_CNTL, 0x028A38, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A3C_VGT_GROUP_VECT_1_FMT_CNTL, 0x028A3C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A40_VGT_GS_MODE, 0x028A40, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A48_PA_SC_MPASS_PS_CNTL, 0x028A48, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028A48_PA_SC_MODE_CNTL_0, 0x028A48, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A4C_PA_SC_MODE_CNTL, 0x028A4C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028A4C_PA_SC_MODE_CNTL_1, 0x028A4C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A54_GS_PER_ES, 0x028A54, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A58_ES_PER_GS, 0x028A58, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A5C_GS_PER_VS, 0x028A5C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A6C_VGT_GS_OUT_PRIM_TYPE, 0x028A6C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A78_VGT_DMA_MAX_SIZE, 0x028A78, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A7C_VGT_DMA_INDEX_TYPE, 0x028A7C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A84_VGT_PRIMITIVEID_EN, 0x028A84, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A88_VGT_NUM_INSTANCES, 0x028A88, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028A94_VGT_MULTI_PRIM_IB_RESET_EN, 0x028A94, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028AA8_IA_MULTI_VGT_PARAM, 0x028AA8, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AB4_VGT_REUSE_OFF, 0x028AB4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AB8_VGT_VTX_CNT_EN, 0x028AB8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028ABC_DB_HTILE_SURFACE, 0x028ABC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AC0_DB_SRESULTS_COMPARE_STATE0, 0x028AC0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AC4_DB_SRESULTS_COMPARE_STATE1, 0x028AC4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AC8_DB_PRELOAD_CONTROL, 0x028AC8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AD0_VGT_STRMOUT_BUFFER_SIZE_0, 0x028AD0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AD4_VGT_STRMOUT_VTX_STRIDE_0, 0x028AD4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AD8_VGT_STRMOUT_BUFFER_BASE_0, 0x028AD8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028ADC_VGT_STRMOUT_BUFFER_OFFSET_0, 0x028ADC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AE0_VGT_STRMOUT_BUFFER_SIZE_1, 0x028AE0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AE4_VGT_STRMOUT_VTX_STRIDE_1, 0x028AE4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AE8_VGT_STRMOUT_BUFFER_BASE_1, 0x028AE8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AEC_VGT_STRMOUT_BUFFER_OFFSET_1, 0x028AEC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AF0_VGT_STRMOUT_BUFFER_SIZE_2, 0x028AF0, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AF4_VGT_STRMOUT_VTX_STRIDE_2, 0x028AF4, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AF8_VGT_STRMOUT_BUFFER_BASE_2, 0x028AF8, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028AFC_VGT_STRMOUT_BUFFER_OFFSET_2, 0x028AFC, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B00_VGT_STRMOUT_BUFFER_SIZE_3, 0x028B00, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B04_VGT_STRMOUT_VTX_STRIDE_3, 0x028B04, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B08_VGT_STRMOUT_BUFFER_BASE_3, 0x028B08, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B0C_VGT_STRMOUT_BUFFER_OFFSET_3, 0x028B0C, R6_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B10_VGT_STRMOUT_BASE_OFFSET_0, 0x028B10, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B14_VGT_STRMOUT_BASE_OFFSET_1, 0x028B14, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B18_VGT_STRMOUT_BASE_OFFSET_2, 0x028B18, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B1C_VGT_STRMOUT_BASE_OFFSET_3, 0x028B1C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B28_VGT_STRMOUT_DRAW_OPAQUE_OFFSET, 0x028B28, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B2C_VGT_STRMOUT_DRAW_OPAQUE_BUFFER_FILLED_SIZE, 0x028B2C, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B30_VGT_STRMOUT_DRAW_OPAQUE_VERTEX_STRIDE, 0x028B30, R7_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B38_VGT_GS_MAX_VERT_OUT, 0x028B38, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B44_VGT_STRMOUT_BASE_OFFSET_HI_0, 0x028B44, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B48_VGT_STRMOUT_BASE_OFFSET_HI_1, 0x028B48, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B4C_VGT_STRMOUT_BASE_OFFSET_HI_2, 0x028B4C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B50_VGT_STRMOUT_BASE_OFFSET_HI_3, 0x028B50, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B54_VGT_SHADER_STAGES_EN, 0x028B54, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B58_VGT_LS_HS_CONFIG, 0x028B58, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B5C_VGT_LS_SIZE, 0x028B5C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B60_VGT_HS_SIZE, 0x028B60, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B64_VGT_LS_HS_ALLOC, 0x028B64, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B68_VGT_HS_PATCH_CONST, 0x028B68, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B6C_VGT_TF_PARAM, 0x028B6C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B70_DB_ALPHA_TO_MASK, 0x028B70, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B74_VGT_DISPATCH_INITIATOR, 0x028B74, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B78_PA_SU_POLY_OFFSET_DB_FMT_CNTL, 0x028B78, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B7C_PA_SU_POLY_OFFSET_CLAMP, 0x028B7C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B80_PA_SU_POLY_OFFSET_FRONT_SCALE, 0x028B80, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B84_PA_SU_POLY_OFFSET_FRONT_OFFSET, 0x028B84, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B88_PA_SU_POLY_OFFSET_BACK_SCALE, 0x028B88, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B8C_PA_SU_POLY_OFFSET_BACK_OFFSET, 0x028B8C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B90_VGT_GS_INSTANCE_CNT, 0x028B90, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B94_VGT_STRMOUT_CONFIG, 0x028B94, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B98_VGT_STRMOUT_BUFFER_CONFIG, 0x028B98, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028B9C_CB_IMMED0_BASE, 0x028B9C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA0_CB_IMMED1_BASE, 0x028BA0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED2_BASE, 0x028BA4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED3_BASE, 0x028BA8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED4_BASE, 0x028BAC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED5_BASE, 0x028BB0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED6_BASE, 0x028BB4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED7_BASE, 0x028BB8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED8_BASE, 0x028BBC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED9_BASE, 0x028BC0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED10_BASE, 0x028BC4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028BA4_CB_IMMED11_BASE, 0x028BC8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BD4_PA_SC_CENTROID_PRIORITY_0, 0x028BD4, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BD8_PA_SC_CENTROID_PRIORITY_1, 0x028BD8, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BDC_PA_SC_LINE_CNTL, 0x028BDC, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BE0_PA_SC_AA_CONFIG, 0x028BE0, CM, CONTEXT, CM_PA_SC_AA_CONFIG)
+PM4P_REGISTER(CM_R_028BE4_PA_SU_VTX_CNTL, 0x028BE4, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BE8_PA_CL_GB_VERT_CLIP_ADJ, 0x028BE8, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BEC_PA_CL_GB_VERT_DISC_ADJ, 0x028BEC, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BF0_PA_CL_GB_HORZ_CLIP_ADJ, 0x028BF0, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BF4_PA_CL_GB_HORZ_DISC_ADJ, 0x028BF4, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BF8_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_0, 0x028BF8, CM, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028BFC_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_1, 0x028BFC, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C00_PA_SC_LINE_CNTL, 0x028C00, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C00_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_2, 0x028C00, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C04_PA_SC_AA_CONFIG, 0x028C04, R6_EG, CONTEXT, PA_SC_AA_CONFIG)
+PM4P_REGISTER(CM_R_028C04_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y0_3, 0x028C04, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C08_PA_SU_VTX_CNTL, 0x028C08, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C08_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_0, 0x028C08, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C0C_PA_CL_GB_VERT_CLIP_ADJ, 0x028C0C, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C0C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_1, 0x028C0C, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C10_PA_CL_GB_VERT_DISC_ADJ, 0x028C10, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C10_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_2, 0x028C10, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C14_PA_CL_GB_HORZ_CLIP_ADJ, 0x028C14, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C14_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y0_3, 0x028C14, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C18_PA_CL_GB_HORZ_DISC_ADJ, 0x028C18, R6_EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C18_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_0, 0x028C18, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C1C_PA_SC_AA_SAMPLE_LOCS_MCTX, 0x028C1C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C1C_PA_SC_AA_SAMPLE_LOCS_0, 0x028C1C, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C1C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_1, 0x028C1C, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C20_PA_SC_AA_SAMPLE_LOCS_8S_WD1_MCTX, 0x028C20, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C20_PA_SC_AA_SAMPLE_LOCS_1, 0x028C20, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C20_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_2, 0x028C20, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C24_PA_SC_AA_SAMPLE_LOCS_2, 0x028C24, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C24_PA_SC_AA_SAMPLE_LOCS_PIXEL_X0Y1_3, 0x028C24, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C28_PA_SC_AA_SAMPLE_LOCS_3, 0x028C28, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C28_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_0, 0x028C28, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C2C_PA_SC_AA_SAMPLE_LOCS_4, 0x028C2C, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C2C_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_1, 0x028C2C, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C30_CB_CLRCMP_CONTROL, 0x028C30, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C30_PA_SC_AA_SAMPLE_LOCS_5, 0x028C30, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C30_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_2, 0x028C30, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C34_CB_CLRCMP_SRC, 0x028C34, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C34_PA_SC_AA_SAMPLE_LOCS_6, 0x028C34, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C34_PA_SC_AA_SAMPLE_LOCS_PIXEL_X1Y1_3, 0x028C34, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C38_CB_CLRCMP_DST, 0x028C38, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C38_PA_SC_AA_SAMPLE_LOCS_7, 0x028C38, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C38_PA_SC_AA_MASK_X0Y0_X1Y0, 0x028C38, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C3C_CB_CLRCMP_MSK, 0x028C3C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C3C_PA_SC_AA_MASK, 0x028C3C, EG, CONTEXT, NONE)
+PM4P_REGISTER(CM_R_028C3C_PA_SC_AA_MASK_X0Y1_X1Y1, 0x028C3C, CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C48_PA_SC_AA_MASK, 0x028C48, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028C60_CB_COLOR0_BASE, 0x028C60, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C64_CB_COLOR0_PITCH, 0x028C64, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C68_CB_COLOR0_SLICE, 0x028C68, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C6C_CB_COLOR0_VIEW, 0x028C6C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C70_CB_COLOR0_INFO, 0x028C70, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028C74_CB_COLOR0_ATTRIB, 0x028C74, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C78_CB_COLOR0_DIM, 0x028C78, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C7C_CB_COLOR0_CMASK, 0x028C7C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C80_CB_COLOR0_CMASK_SLICE, 0x028C80, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C84_CB_COLOR0_FMASK, 0x028C84, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C88_CB_COLOR0_FMASK_SLICE, 0x028C88, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C8C_CB_COLOR0_CLEAR_WORD0, 0x028C8C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C90_CB_COLOR0_CLEAR_WORD1, 0x028C90, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C94_CB_COLOR0_CLEAR_WORD2, 0x028C94, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C98_CB_COLOR0_CLEAR_WORD3, 0x028C98, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028C9C_CB_COLOR1_BASE, 0x028C9C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CA0_CB_COLOR1_PITCH, 0x028CA0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CA4_CB_COLOR1_SLICE, 0x028CA4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CA8_CB_COLOR1_VIEW, 0x028CA8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CAC_CB_COLOR1_INFO, 0x028CAC, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028CB0_CB_COLOR1_ATTRIB, 0x028CB0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CB4_CB_COLOR1_DIM, 0x028CB4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CB8_CB_COLOR1_CMASK, 0x028CB8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CBC_CB_COLOR1_CMASK_SLICE, 0x028CBC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CC0_CB_COLOR1_FMASK, 0x028CC0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CC4_CB_COLOR1_FMASK_SLICE, 0x028CC4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CC8_CB_COLOR1_CLEAR_WORD0, 0x028CC8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CCC_CB_COLOR1_CLEAR_WORD1, 0x028CCC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CD0_CB_COLOR1_CLEAR_WORD2, 0x028CD0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CD4_CB_COLOR1_CLEAR_WORD3, 0x028CD4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CD8_CB_COLOR2_BASE, 0x028CD8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CDC_CB_COLOR2_PITCH, 0x028CDC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CE0_CB_COLOR2_SLICE, 0x028CE0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CE4_CB_COLOR2_VIEW, 0x028CE4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CE8_CB_COLOR2_INFO, 0x028CE8, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028CEC_CB_COLOR2_ATTRIB, 0x028CEC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CF0_CB_COLOR2_DIM, 0x028CF0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CF4_CB_COLOR2_CMASK, 0x028CF4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CF8_CB_COLOR2_CMASK_SLICE, 0x028CF8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028CFC_CB_COLOR2_FMASK, 0x028CFC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D00_CB_COLOR2_FMASK_SLICE, 0x028D00, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D04_CB_COLOR2_CLEAR_WORD0, 0x028D04, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D08_CB_COLOR2_CLEAR_WORD1, 0x028D08, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D0C_DB_RENDER_CONTROL, 0x028D0C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D0C_CB_COLOR2_CLEAR_WORD2, 0x028D0C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D10_DB_RENDER_OVERRIDE, 0x028D10, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D10_CB_COLOR2_CLEAR_WORD3, 0x028D10, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D14_CB_COLOR3_BASE, 0x028D14, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D18_CB_COLOR3_PITCH, 0x028D18, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D1C_CB_COLOR3_SLICE, 0x028D1C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D20_CB_COLOR3_VIEW, 0x028D20, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D24_DB_HTILE_SURFACE, 0x028D24, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D24_CB_COLOR3_INFO, 0x028D24, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028D28_CB_COLOR3_ATTRIB, 0x028D28, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D2C_DB_SRESULTS_COMPARE_STATE1, 0x028D2C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D2C_CB_COLOR3_DIM, 0x028D2C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D30_DB_PRELOAD_CONTROL, 0x028D30, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D30_CB_COLOR3_CMASK, 0x028D30, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D34_CB_COLOR3_CMASK_SLICE, 0x028D34, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D38_CB_COLOR3_FMASK, 0x028D38, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D3C_CB_COLOR3_FMASK_SLICE, 0x028D3C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D40_CB_COLOR3_CLEAR_WORD0, 0x028D40, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D44_DB_ALPHA_TO_MASK, 0x028D44, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028D44_CB_COLOR3_CLEAR_WORD1, 0x028D44, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D48_CB_COLOR3_CLEAR_WORD2, 0x028D48, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D4C_CB_COLOR3_CLEAR_WORD3, 0x028D4C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D50_CB_COLOR4_BASE, 0x028D50, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D54_CB_COLOR4_PITCH, 0x028D54, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D58_CB_COLOR4_SLICE, 0x028D58, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D5C_CB_COLOR4_VIEW, 0x028D5C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D60_CB_COLOR4_INFO, 0x028D60, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028D64_CB_COLOR4_ATTRIB, 0x028D64, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D68_CB_COLOR4_DIM, 0x028D68, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D6C_CB_COLOR4_CMASK, 0x028D6C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D70_CB_COLOR4_CMASK_SLICE, 0x028D70, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D74_CB_COLOR4_FMASK, 0x028D74, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D78_CB_COLOR4_FMASK_SLICE, 0x028D78, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D7C_CB_COLOR4_CLEAR_WORD0, 0x028D7C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D80_CB_COLOR4_CLEAR_WORD1, 0x028D80, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D84_CB_COLOR4_CLEAR_WORD2, 0x028D84, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D88_CB_COLOR4_CLEAR_WORD3, 0x028D88, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D8C_CB_COLOR5_BASE, 0x028D8C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D90_CB_COLOR5_PITCH, 0x028D90, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D94_CB_COLOR5_SLICE, 0x028D94, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D98_CB_COLOR5_VIEW, 0x028D98, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028D9C_CB_COLOR5_INFO, 0x028D9C, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028DA0_CB_COLOR5_ATTRIB, 0x028DA0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DA4_CB_COLOR5_DIM, 0x028DA4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DA8_CB_COLOR5_CMASK, 0x028DA8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DAC_CB_COLOR5_CMASK_SLICE, 0x028DAC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DB0_CB_COLOR5_FMASK, 0x028DB0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DB4_CB_COLOR5_FMASK_SLICE, 0x028DB4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DB8_CB_COLOR5_CLEAR_WORD0, 0x028DB8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DBC_CB_COLOR5_CLEAR_WORD1, 0x028DBC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DC0_CB_COLOR5_CLEAR_WORD2, 0x028DC0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DC4_CB_COLOR5_CLEAR_WORD3, 0x028DC4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DC8_CB_COLOR6_BASE, 0x028DC8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DCC_CB_COLOR6_PITCH, 0x028DCC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DD0_CB_COLOR6_SLICE, 0x028DD0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DD4_CB_COLOR6_VIEW, 0x028DD4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DD8_CB_COLOR6_INFO, 0x028DD8, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028DDC_CB_COLOR6_ATTRIB, 0x028DDC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DE0_CB_COLOR6_DIM, 0x028DE0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DE4_CB_COLOR6_CMASK, 0x028DE4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DE8_CB_COLOR6_CMASK_SLICE, 0x028DE8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DEC_CB_COLOR6_FMASK, 0x028DEC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DF0_CB_COLOR6_FMASK_SLICE, 0x028DF0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DF4_CB_COLOR6_CLEAR_WORD0, 0x028DF4, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DF8_PA_SU_POLY_OFFSET_DB_FMT_CNTL, 0x028DF8, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028DF8_CB_COLOR6_CLEAR_WORD1, 0x028DF8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028DFC_PA_SU_POLY_OFFSET_CLAMP, 0x028DFC, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028DFC_CB_COLOR6_CLEAR_WORD2, 0x028DFC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E00_PA_SU_POLY_OFFSET_FRONT_SCALE, 0x028E00, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028E00_CB_COLOR6_CLEAR_WORD3, 0x028E00, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E04_PA_SU_POLY_OFFSET_FRONT_OFFSET, 0x028E04, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028E04_CB_COLOR7_BASE, 0x028E04, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E08_PA_SU_POLY_OFFSET_BACK_SCALE, 0x028E08, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028E08_CB_COLOR7_PITCH, 0x028E08, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E0C_PA_SU_POLY_OFFSET_BACK_OFFSET, 0x028E0C, R6_R7, CONTEXT, NONE)
+PM4P_REGISTER(R_028E0C_CB_COLOR7_SLICE, 0x028E0C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E10_CB_COLOR7_VIEW, 0x028E10, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E14_CB_COLOR7_INFO, 0x028E14, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028E18_CB_COLOR7_ATTRIB, 0x028E18, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E1C_CB_COLOR7_DIM, 0x028E1C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E20_CB_COLOR7_CMASK, 0x028E20, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E24_CB_COLOR7_CMASK_SLICE, 0x028E24, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E28_CB_COLOR7_FMASK, 0x028E28, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E2C_CB_COLOR7_FMASK_SLICE, 0x028E2C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E30_CB_COLOR7_CLEAR_WORD0, 0x028E30, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E34_CB_COLOR7_CLEAR_WORD1, 0x028E34, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E38_CB_COLOR7_CLEAR_WORD2, 0x028E38, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E3C_CB_COLOR7_CLEAR_WORD3, 0x028E3C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E40_CB_COLOR8_BASE, 0x028E40, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E44_CB_COLOR8_PITCH, 0x028E44, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E48_CB_COLOR8_SLICE, 0x028E48, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E4C_CB_COLOR8_VIEW, 0x028E4C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E50_CB_COLOR8_INFO, 0x028E50, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028E54_CB_COLOR8_ATTRIB, 0x028E54, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E58_CB_COLOR8_DIM, 0x028E58, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E5C_CB_COLOR9_BASE, 0x028E5C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E60_CB_COLOR9_PITCH, 0x028E60, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E64_CB_COLOR9_SLICE, 0x028E64, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E68_CB_COLOR9_VIEW, 0x028E68, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E6C_CB_COLOR9_INFO, 0x028E6C, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028E70_CB_COLOR9_ATTRIB, 0x028E70, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E74_CB_COLOR9_DIM, 0x028E74, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E78_CB_COLOR10_BASE, 0x028E78, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E7C_CB_COLOR10_PITCH, 0x028E7C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E80_CB_COLOR10_SLICE, 0x028E80, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E84_CB_COLOR10_VIEW, 0x028E84, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E88_CB_COLOR10_INFO, 0x028E88, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028E8C_CB_COLOR10_ATTRIB, 0x028E8C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E90_CB_COLOR10_DIM, 0x028E90, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E94_CB_COLOR11_BASE, 0x028E94, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E98_CB_COLOR11_PITCH, 0x028E98, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028E9C_CB_COLOR11_SLICE, 0x028E9C, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028EA0_CB_COLOR11_VIEW, 0x028EA0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028EA4_CB_COLOR11_INFO, 0x028EA4, EG_CM, CONTEXT, EG_CB_COLOR_INFO)
+PM4P_REGISTER(R_028EA8_CB_COLOR11_ATTRIB, 0x028EA8, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028EAC_CB_COLOR11_DIM, 0x028EAC, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028F00_ALU_CONST_CACHE_HS_0, 0x028F00, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028F40_ALU_CONST_CACHE_LS_0, 0x028F40, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028F80_ALU_CONST_BUFFER_SIZE_HS_0, 0x028F80, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_028FC0_ALU_CONST_BUFFER_SIZE_LS_0, 0x028FC0, EG_CM, CONTEXT, NONE)
+PM4P_REGISTER(R_030000_RESOURCE0_WORD0, 0x030000, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_030004_RESOURCE0_WORD1, 0x030004, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_030008_RESOURCE0_WORD2, 0x030008, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_03000C_RESOURCE0_WORD3, 0x03000C, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_030010_RESOURCE0_WORD4, 0x030010, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_030014_RESOURCE0_WORD5, 0x030014, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_030018_RESOURCE0_WORD6, 0x030018, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_03001C_RESOURCE0_WORD7, 0x03001C, EG_CM, RESOURCE, NONE)
+PM4P_REGISTER(R_038000_RESOURCE0_WORD0, 0x038000, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_038004_RESOURCE0_WORD1, 0x038004, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_038008_RESOURCE0_WORD2, 0x038008, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_03800C_RESOURCE0_WORD3, 0x03800C, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_038010_RESOURCE0_WORD4, 0x038010, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_038014_RESOURCE0_WORD5, 0x038014, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_038018_RESOURCE0_WORD6, 0x038018, R6_R7, RESOURCE, NONE)
+PM4P_REGISTER(R_03A200_SQ_LOOP_CONST_0, 0x03A200, EG_CM, LOOP_CONST, NONE)
+PM4P_REGISTER(R_03C000_SQ_TEX_SAMPLER_WORD0_0, 0x03C000, R6_CM, SAMPLER, NONE)
+PM4P_REGISTER(R_03C004_SQ_TEX_SAMPLER_WORD1_0, 0x03C004, R6_CM, SAMPLER, NONE)
+PM4P_REGISTER(R_03C008_SQ_TEX_SAMPLER_WORD2_0, 0x03C008, R6_CM, SAMPLER, NONE)
+PM4P_REGISTER(R_03CFF0_SQ_VTX_BASE_VTX_LOC, 0x03CFF0, R6_CM, CTL_CONST, NONE)
+PM4P_REGISTER(R_03CFF4_SQ_VTX_START_INST_LOC, 0x03CFF4, R6_CM, CTL_CONST, NONE)
+PM4P_REGISTER(R_03E200_SQ_LOOP_CONST_0, 0x03E200, R6_R7, LOOP_CONST, NONE)
+PM4P_REGISTER(R_03FF04_SQ_TEX_RESOURCE_CLEAR, 0x03FF04, EG_CM, OTHER, NONE)
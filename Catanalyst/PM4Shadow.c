@@ -0,0 +1,322 @@
+#include "Catanalyst.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef struct PM4S_Block {
+   // In dwords.
+   uint32_t base;
+   uint32_t register_count;
+   uint32_t shadow_index;
+} PM4S_Block;
+
+static PM4S_Block const pm4s_blocks[] = {
+   {0x8000 / sizeof(uint32_t), PM4S_CONFIG_REGISTER_COUNT, 0},
+   {0x28000 / sizeof(uint32_t), PM4S_CONTEXT_REGISTER_COUNT, PM4S_CONFIG_REGISTER_COUNT},
+   {0x3CFF0 / sizeof(uint32_t), PM4S_CTL_CONST_REGISTER_COUNT,
+    PM4S_CONFIG_REGISTER_COUNT + PM4S_CONTEXT_REGISTER_COUNT},
+};
+
+static uint32_t PM4S_CountTrailingZeros64(uint64_t const value) {
+#ifdef _MSC_VER
+   unsigned long bit_index;
+   _BitScanForward64(&bit_index, value);
+   return (uint32_t)bit_index;
+#else
+   return (uint32_t)__builtin_ctzll(value);
+#endif
+}
+
+// Sets count bits starting from first, a whole word at a time where possible.
+static void PM4S_SetBits(uint64_t * const bitset, uint32_t const first, uint32_t const count) {
+   uint32_t bit_index = first;
+   uint32_t const end = first + count;
+   while (bit_index < end) {
+      uint32_t const word_bit_index = bit_index & 63;
+      uint32_t const word_bit_count =
+         end - bit_index < 64 - word_bit_index ? end - bit_index : 64 - word_bit_index;
+      uint64_t const word_mask = word_bit_count == 64
+                                    ? ~(uint64_t)0
+                                    : (((uint64_t)1 << word_bit_count) - 1) << word_bit_index;
+      bitset[bit_index >> 6] |= word_mask;
+      bit_index += word_bit_count;
+   }
+}
+
+uint32_t PM4S_GetShadowIndex(uint32_t const index_dwords) {
+   for (uint32_t block_index = 0; block_index < sizeof(pm4s_blocks) / sizeof(pm4s_blocks[0]);
+        ++block_index) {
+      PM4S_Block const * const block = &pm4s_blocks[block_index];
+      if (index_dwords - block->base < block->register_count) {
+         return block->shadow_index + (index_dwords - block->base);
+      }
+   }
+   return PM4S_REGISTER_COUNT;
+}
+
+uint32_t PM4S_GetRegisterIndex(uint32_t const shadow_index) {
+   uint32_t block_index = sizeof(pm4s_blocks) / sizeof(pm4s_blocks[0]) - 1;
+   while (block_index != 0 && shadow_index < pm4s_blocks[block_index].shadow_index) {
+      --block_index;
+   }
+   PM4S_Block const * const block = &pm4s_blocks[block_index];
+   return block->base + (shadow_index - block->shadow_index);
+}
+
+bool PM4S_IsDrawOrDispatch(PM4P_Packet const * const packet) {
+   if (packet->type != 3) {
+      return false;
+   }
+   switch (packet->opcode) {
+   case 0x15: // PKT3_DISPATCH_DIRECT
+   case 0x16: // PKT3_DISPATCH_INDIRECT
+   case 0x24: // EG_PKT3_DRAW_INDIRECT
+   case 0x25: // EG_PKT3_DRAW_INDEX_INDIRECT
+   case 0x27: // PKT3_DRAW_INDEX_2
+   case 0x29: // EG_PKT3_DRAW_INDEX_OFFSET
+   case 0x2B: // PKT3_DRAW_INDEX
+   case 0x2D: // PKT3_DRAW_INDEX_AUTO
+   case 0x2E: // PKT3_DRAW_INDEX_IMMD
+      return true;
+   }
+   return false;
+}
+
+void PM4S_ShadowInit(PM4S_Shadow * const shadow) {
+   memset(shadow, 0, sizeof(*shadow));
+}
+
+// Returns the block written by the packet, or NULL if it's not a register-setting packet.
+static PM4S_Block const * PM4S_GetPacketBlock(PM4P_Packet const * const packet) {
+   // NOPs are printed like register writes, but they don't write anything.
+   if (packet->register_base == 0 || packet->body_dword_count < 2) {
+      return NULL;
+   }
+   for (uint32_t block_index = 0; block_index < sizeof(pm4s_blocks) / sizeof(pm4s_blocks[0]);
+        ++block_index) {
+      if (pm4s_blocks[block_index].base == packet->register_base) {
+         return &pm4s_blocks[block_index];
+      }
+   }
+   return NULL;
+}
+
+// Returns the number of values written by the packet that are in the block.
+static uint32_t PM4S_GetTrackedCount(PM4S_Block const * const block,
+                                     PM4P_Packet const * const packet) {
+   uint32_t const value_count = packet->body_dword_count - 1;
+   uint32_t const first_offset = packet->register_first - packet->register_base;
+   if (first_offset >= block->register_count) {
+      return 0;
+   }
+   return block->register_count - first_offset < value_count ? block->register_count - first_offset
+                                                             : value_count;
+}
+
+uint32_t PM4S_GetPacketShadowRange(PM4P_Packet const * const packet,
+                                   uint32_t * const first_shadow_index_out) {
+   PM4S_Block const * const block = PM4S_GetPacketBlock(packet);
+   if (block == NULL) {
+      return 0;
+   }
+   *first_shadow_index_out = block->shadow_index + (packet->register_first - packet->register_base);
+   return PM4S_GetTrackedCount(block, packet);
+}
+
+void PM4S_ShadowApply(PM4S_Shadow * const shadow, PM4P_Packet const * const packet) {
+   PM4S_Block const * const block = PM4S_GetPacketBlock(packet);
+   if (block == NULL) {
+      return;
+   }
+   uint32_t const tracked_count = PM4S_GetTrackedCount(block, packet);
+   if (tracked_count != 0) {
+      uint32_t const shadow_index =
+         block->shadow_index + (packet->register_first - packet->register_base);
+      memcpy(shadow->state.values + shadow_index, packet->dwords + 2,
+             sizeof(uint32_t) * tracked_count);
+      PM4S_SetBits(shadow->state.written, shadow_index, tracked_count);
+      PM4S_SetBits(shadow->dirty, shadow_index, tracked_count);
+   }
+   shadow->untracked_write_count += packet->body_dword_count - 1 - tracked_count;
+}
+
+void PM4S_RedundancyInit(PM4S_Redundancy * const redundancy) {
+   memset(redundancy, 0, sizeof(*redundancy));
+}
+
+void PM4S_RedundancyBeginSubmission(PM4S_Redundancy * const redundancy) {
+   memset(&redundancy->submission, 0, sizeof(redundancy->submission));
+}
+
+static void PM4S_AddRedundancyCounts(PM4S_RedundancyCounts * const counts,
+                                     uint32_t const write_count,
+                                     uint32_t const redundant_write_count,
+                                     uint32_t const wasted_dword_count) {
+   ++counts->packet_count;
+   counts->redundant_packet_count += redundant_write_count == write_count;
+   counts->write_count += write_count;
+   counts->redundant_write_count += redundant_write_count;
+   counts->wasted_dword_count += wasted_dword_count;
+}
+
+uint32_t PM4S_ShadowApplyCountingRedundancy(PM4S_Shadow * const shadow,
+                                            PM4S_Redundancy * const redundancy,
+                                            PM4P_Packet const * const packet,
+                                            uint32_t * const redundant_indices) {
+   PM4S_Block const * const block = PM4S_GetPacketBlock(packet);
+   if (block == NULL) {
+      return 0;
+   }
+   uint32_t const value_count = packet->body_dword_count - 1;
+   uint32_t const tracked_count = PM4S_GetTrackedCount(block, packet);
+   uint32_t const first_shadow_index =
+      block->shadow_index + (packet->register_first - packet->register_base);
+   uint32_t const * const values = packet->dwords + 2;
+   uint32_t redundant_count = 0;
+   for (uint32_t value_index = 0; value_index < tracked_count; ++value_index) {
+      uint32_t const shadow_index = first_shadow_index + value_index;
+      uint64_t const written_bit = (uint64_t)1 << (shadow_index & 63);
+      uint64_t * const written_word = &shadow->state.written[shadow_index >> 6];
+      uint32_t const value = values[value_index];
+      ++redundancy->write_counts[shadow_index];
+      // The initial values are unknown, so the first write is never redundant.
+      if ((*written_word & written_bit) != 0 && shadow->state.values[shadow_index] == value) {
+         ++redundancy->redundant_write_counts[shadow_index];
+         if (redundant_indices != NULL) {
+            redundant_indices[redundant_count] = packet->register_first + value_index;
+         }
+         ++redundant_count;
+      }
+      shadow->state.values[shadow_index] = value;
+      *written_word |= written_bit;
+      shadow->dirty[shadow_index >> 6] |= written_bit;
+   }
+   shadow->untracked_write_count += value_count - tracked_count;
+   // The untracked writes are unknown, so not redundant.
+   uint32_t const wasted_dword_count =
+      redundant_count == value_count ? 2 + value_count : redundant_count;
+   PM4S_AddRedundancyCounts(&redundancy->total, value_count, redundant_count, wasted_dword_count);
+   PM4S_AddRedundancyCounts(&redundancy->submission, value_count, redundant_count,
+                            wasted_dword_count);
+   return redundant_count;
+}
+
+uint32_t PM4S_ShadowTakeDelta(PM4S_Shadow * const shadow, PM4S_RegisterWrite * const writes) {
+   uint32_t write_count = 0;
+   for (uint32_t word_index = 0; word_index < PM4S_BITSET_WORD_COUNT; ++word_index) {
+      uint64_t dirty = shadow->dirty[word_index];
+      shadow->dirty[word_index] = 0;
+      while (dirty != 0) {
+         uint32_t const shadow_index = 64 * word_index + PM4S_CountTrailingZeros64(dirty);
+         dirty &= dirty - 1;
+         writes[write_count].index = PM4S_GetRegisterIndex(shadow_index);
+         writes[write_count].value = shadow->state.values[shadow_index];
+         ++write_count;
+      }
+   }
+   return write_count;
+}
+
+void PM4S_HistoryInit(PM4S_History * const history) {
+   memset(history, 0, sizeof(*history));
+}
+
+void PM4S_HistoryDestroy(PM4S_History * const history) {
+   free(history->snapshots);
+   free(history->writes);
+   free(history->keyframes);
+   memset(history, 0, sizeof(*history));
+}
+
+// Grows the array to at least the needed number of elements, doubling the capacity. Returns the
+// new array, or NULL if it couldn't be allocated, with the old one still valid.
+static void * PM4S_Grow(void * const array, size_t * const capacity, size_t const needed,
+                        size_t const element_size) {
+   if (needed <= *capacity) {
+      return array;
+   }
+   size_t new_capacity = *capacity != 0 ? *capacity : 16;
+   while (new_capacity < needed) {
+      if (new_capacity > SIZE_MAX / 2 / element_size) {
+         return NULL;
+      }
+      new_capacity *= 2;
+   }
+   void * const new_array = realloc(array, new_capacity * element_size);
+   if (new_array != NULL) {
+      *capacity = new_capacity;
+   }
+   return new_array;
+}
+
+bool PM4S_HistoryRecord(PM4S_History * const history, PM4S_Shadow * const shadow,
+                        PM4P_Packet const * const packet, uint32_t const submission_index) {
+   if (history->failed) {
+      return false;
+   }
+   size_t const snapshot_index = history->snapshot_count;
+   bool const is_keyframe = (snapshot_index % PM4S_HISTORY_KEYFRAME_INTERVAL) == 0;
+   size_t const keyframe_count = snapshot_index / PM4S_HISTORY_KEYFRAME_INTERVAL + 1;
+   PM4S_HistorySnapshot * const snapshots =
+      (PM4S_HistorySnapshot *)PM4S_Grow(history->snapshots, &history->snapshot_capacity,
+                                        snapshot_index + 1, sizeof(PM4S_HistorySnapshot));
+   if (snapshots != NULL) {
+      history->snapshots = snapshots;
+   }
+   // The delta can't be larger than the whole register file.
+   PM4S_RegisterWrite * const writes =
+      (PM4S_RegisterWrite *)PM4S_Grow(history->writes, &history->write_capacity,
+                                      history->write_count + PM4S_REGISTER_COUNT,
+                                      sizeof(PM4S_RegisterWrite));
+   if (writes != NULL) {
+      history->writes = writes;
+   }
+   PM4S_State * keyframes = history->keyframes;
+   if (is_keyframe) {
+      keyframes = (PM4S_State *)PM4S_Grow(history->keyframes, &history->keyframe_capacity,
+                                          keyframe_count, sizeof(PM4S_State));
+      if (keyframes != NULL) {
+         history->keyframes = keyframes;
+      }
+   }
+   if (snapshots == NULL || writes == NULL || (is_keyframe && keyframes == NULL)) {
+      history->failed = true;
+      return false;
+   }
+   PM4S_HistorySnapshot * const snapshot = &history->snapshots[snapshot_index];
+   snapshot->offset = packet->offset;
+   snapshot->submission_index = submission_index;
+   snapshot->opcode = packet->opcode;
+   snapshot->write_index = history->write_count;
+   snapshot->write_count = PM4S_ShadowTakeDelta(shadow, history->writes + history->write_count);
+   history->write_count += snapshot->write_count;
+   if (is_keyframe) {
+      history->keyframes[keyframe_count - 1] = shadow->state;
+   }
+   history->snapshot_count = snapshot_index + 1;
+   return true;
+}
+
+void PM4S_HistoryGetState(PM4S_History const * const history, size_t const snapshot_index,
+                          PM4S_State * const state) {
+   size_t const keyframe_index = snapshot_index / PM4S_HISTORY_KEYFRAME_INTERVAL;
+   *state = history->keyframes[keyframe_index];
+   for (size_t delta_index = keyframe_index * PM4S_HISTORY_KEYFRAME_INTERVAL + 1;
+        delta_index <= snapshot_index; ++delta_index) {
+      PM4S_HistorySnapshot const * const snapshot = &history->snapshots[delta_index];
+      for (uint32_t write_index = 0; write_index < snapshot->write_count; ++write_index) {
+         PM4S_RegisterWrite const * const write =
+            &history->writes[snapshot->write_index + write_index];
+         uint32_t const shadow_index = PM4S_GetShadowIndex(write->index);
+         state->values[shadow_index] = write->value;
+         state->written[shadow_index >> 6] |= (uint64_t)1 << (shadow_index & 63);
+      }
+   }
+}
@@ -0,0 +1,218 @@
+#include "TextWriter.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static void TXTW_Init(TXTW_Writer * const writer, FILE * const file, int const fd,
+                      char * const buffer, size_t const capacity) {
+   writer->size = 0;
+   writer->file = file;
+   writer->fd = fd;
+   writer->failed = false;
+   size_t const sized_capacity = capacity != 0 ? capacity : TXTW_DEFAULT_CAPACITY;
+   if (buffer != NULL && sized_capacity >= TXTW_MAX_RESERVE) {
+      writer->data = buffer;
+      writer->capacity = sized_capacity;
+      writer->owns_data = false;
+      return;
+   }
+   writer->capacity = sized_capacity >= TXTW_MAX_RESERVE ? sized_capacity : TXTW_MAX_RESERVE;
+   writer->data = (char *)malloc(writer->capacity);
+   writer->owns_data = true;
+   if (writer->data == NULL) {
+      writer->capacity = 0;
+      writer->failed = true;
+   }
+}
+
+void TXTW_InitFile(TXTW_Writer * const writer, FILE * const file, char * const buffer,
+                   size_t const capacity) {
+   TXTW_Init(writer, file, -1, buffer, capacity);
+}
+
+void TXTW_InitFD(TXTW_Writer * const writer, int const fd, char * const buffer,
+                 size_t const capacity) {
+   TXTW_Init(writer, NULL, fd, buffer, capacity);
+}
+
+void TXTW_InitGrowable(TXTW_Writer * const writer, char * const buffer, size_t const capacity) {
+   TXTW_Init(writer, NULL, -1, buffer, capacity);
+}
+
+static bool TXTW_IsGrowable(TXTW_Writer const * const writer) {
+   return writer->file == NULL && writer->fd < 0;
+}
+
+static bool TXTW_WriteToFD(int const fd, char const * data, size_t size) {
+   while (size != 0) {
+#ifdef _WIN32
+      unsigned const chunk_size = size < ((size_t)1 << 30) ? (unsigned)size : (1u << 30);
+      int const written = _write(fd, data, chunk_size);
+#else
+      ssize_t const written = write(fd, data, size);
+#endif
+      if (written < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         return false;
+      }
+      data += written;
+      size -= (size_t)written;
+   }
+   return true;
+}
+
+bool TXTW_Flush(TXTW_Writer * const writer) {
+   if (TXTW_IsGrowable(writer)) {
+      return !writer->failed;
+   }
+   if (writer->size != 0 && !writer->failed) {
+      if (writer->file != NULL) {
+         writer->failed = fwrite(writer->data, 1, writer->size, writer->file) != writer->size;
+      } else {
+         writer->failed = !TXTW_WriteToFD(writer->fd, writer->data, writer->size);
+      }
+   }
+   writer->size = 0;
+   return !writer->failed;
+}
+
+bool TXTW_Destroy(TXTW_Writer * const writer) {
+   bool const succeeded = TXTW_Flush(writer);
+   if (writer->owns_data) {
+      free(writer->data);
+   }
+   writer->data = NULL;
+   writer->size = 0;
+   writer->capacity = 0;
+   return succeeded;
+}
+
+bool TXTW_MakeSpace(TXTW_Writer * const writer, size_t const size) {
+   if (writer->capacity - writer->size >= size) {
+      return true;
+   }
+   if (writer->failed) {
+      // Keep accepting text to drop it.
+      writer->size = 0;
+      return false;
+   }
+   if (!TXTW_IsGrowable(writer)) {
+      return TXTW_Flush(writer) && writer->capacity >= size;
+   }
+   size_t new_capacity = writer->capacity;
+   while (new_capacity - writer->size < size) {
+      if (new_capacity > SIZE_MAX / 2) {
+         writer->failed = true;
+         return false;
+      }
+      new_capacity *= 2;
+   }
+   char * new_data;
+   if (writer->owns_data) {
+      new_data = (char *)realloc(writer->data, new_capacity);
+   } else {
+      new_data = (char *)malloc(new_capacity);
+      if (new_data != NULL) {
+         memcpy(new_data, writer->data, writer->size);
+      }
+   }
+   if (new_data == NULL) {
+      writer->failed = true;
+      return false;
+   }
+   writer->data = new_data;
+   writer->capacity = new_capacity;
+   writer->owns_data = true;
+   return true;
+}
+
+void TXTW_PutDataSlow(TXTW_Writer * const writer, void const * const data, size_t const size) {
+   if (writer->failed) {
+      writer->size = 0;
+      return;
+   }
+   if (TXTW_IsGrowable(writer)) {
+      if (TXTW_MakeSpace(writer, size)) {
+         memcpy(writer->data + writer->size, data, size);
+         writer->size += size;
+      }
+      return;
+   }
+   // Fill the buffer and flush it as long as the rest doesn't fit.
+   char const * position = (char const *)data;
+   size_t remaining_size = size;
+   while (writer->capacity - writer->size < remaining_size) {
+      size_t const piece_size = writer->capacity - writer->size;
+      memcpy(writer->data + writer->size, position, piece_size);
+      writer->size += piece_size;
+      position += piece_size;
+      remaining_size -= piece_size;
+      if (!TXTW_Flush(writer)) {
+         return;
+      }
+   }
+   memcpy(writer->data + writer->size, position, remaining_size);
+   writer->size += remaining_size;
+}
+
+void TXTW_Printf(TXTW_Writer * const writer, char const * const format, ...) {
+   va_list arguments;
+   va_start(arguments, format);
+   TXTW_VPrintf(writer, format, arguments);
+   va_end(arguments);
+}
+
+void TXTW_VPrintf(TXTW_Writer * const writer, char const * const format, va_list arguments) {
+   if (writer->failed) {
+      writer->size = 0;
+      return;
+   }
+   // Try formatting into the remaining space first, and format again if it's not enough.
+   va_list first_arguments;
+   va_copy(first_arguments, arguments);
+   size_t const remaining_size = writer->capacity - writer->size;
+   int const length =
+      vsnprintf(writer->data + writer->size, remaining_size, format, first_arguments);
+   va_end(first_arguments);
+   if (length < 0) {
+      writer->failed = true;
+      return;
+   }
+   if ((size_t)length < remaining_size) {
+      writer->size += (size_t)length;
+      return;
+   }
+   // With the terminator written by vsnprintf.
+   size_t const terminated_size = (size_t)length + 1;
+   if (TXTW_MakeSpace(writer, terminated_size)) {
+      vsnprintf(writer->data + writer->size, terminated_size, format, arguments);
+      writer->size += (size_t)length;
+      return;
+   }
+   if (writer->failed) {
+      return;
+   }
+   // Longer than the whole buffer of a file writer.
+   char * const text = (char *)malloc(terminated_size);
+   if (text == NULL) {
+      writer->failed = true;
+      return;
+   }
+   vsnprintf(text, terminated_size, format, arguments);
+   TXTW_PutDataSlow(writer, text, (size_t)length);
+   free(text);
+}
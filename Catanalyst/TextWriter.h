@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Formatting of text output into a buffer that is flushed in large blocks, for printing that
+// produces many short pieces of text, where calling stdio for every piece (locking the stream and
+// parsing the format every time) would dominate.
+//
+// The writer either flushes to a FILE * or a file descriptor when the buffer is full, or grows the
+// buffer to keep all the text in memory. Output errors are sticky and drop the text after them, so
+// the printing code doesn't need to check every call, only the result of TXTW_Flush.
+
+#define TXTW_DEFAULT_CAPACITY ((size_t)1 << 16)
+// The space that the Put functions may reserve at once, the minimum capacity of the buffer.
+#define TXTW_MAX_RESERVE ((size_t)64)
+
+typedef struct TXTW_Writer {
+   char * data;
+   size_t size;
+   size_t capacity;
+   FILE * file;
+   int fd;
+   bool owns_data;
+   bool failed;
+} TXTW_Writer;
+
+// If the buffer is NULL, it's allocated with the capacity, or TXTW_DEFAULT_CAPACITY if it's 0.
+void TXTW_InitFile(TXTW_Writer * writer, FILE * file, char * buffer, size_t capacity);
+void TXTW_InitFD(TXTW_Writer * writer, int fd, char * buffer, size_t capacity);
+// Keeps all the text in the buffer, which is reallocated when it's full, moving the text to an
+// allocated buffer if the initial one was provided by the caller.
+void TXTW_InitGrowable(TXTW_Writer * writer, char * buffer, size_t capacity);
+// Writes the buffered text to the file, or does nothing for growable writers. Returns false if
+// anything written to the writer so far has been lost.
+bool TXTW_Flush(TXTW_Writer * writer);
+// Flushes and frees the buffer if it has been allocated by the writer.
+bool TXTW_Destroy(TXTW_Writer * writer);
+
+// Makes at least the specified number of bytes (up to TXTW_MAX_RESERVE for file writers) available
+// past the size. Returns false if that isn't possible, with the writer failed.
+bool TXTW_MakeSpace(TXTW_Writer * writer, size_t size);
+// The path of TXTW_PutData for data not fitting in the remaining space, in pieces if needed.
+void TXTW_PutDataSlow(TXTW_Writer * writer, void const * data, size_t size);
+
+// With the printf format, for text that is not performance-critical.
+#if defined(__GNUC__)
+__attribute__((format(printf, 2, 3)))
+#endif
+void TXTW_Printf(TXTW_Writer * writer, char const * format, ...);
+void TXTW_VPrintf(TXTW_Writer * writer, char const * format, va_list arguments);
+
+static inline char * TXTW_Reserve(TXTW_Writer * const writer, size_t const size) {
+   if (writer->capacity - writer->size < size && !TXTW_MakeSpace(writer, size)) {
+      return NULL;
+   }
+   return writer->data + writer->size;
+}
+
+static inline void TXTW_PutData(TXTW_Writer * const writer, void const * const data,
+                                size_t const size) {
+   if (writer->capacity - writer->size < size) {
+      TXTW_PutDataSlow(writer, data, size);
+      return;
+   }
+   memcpy(writer->data + writer->size, data, size);
+   writer->size += size;
+}
+
+// For string literals, with the length known at compile time.
+#define TXTW_PUT_LITERAL(writer, literal) TXTW_PutData((writer), (literal), sizeof(literal) - 1)
+
+// Formatting directly into the space from TXTW_Reserve, for building whole lines with one check of
+// the remaining space. The Format functions return the end of the formatted text, and the size of
+// the writer is updated with TXTW_Commit at the end.
+
+static inline void TXTW_Commit(TXTW_Writer * const writer, char const * const end) {
+   writer->size = (size_t)(end - writer->data);
+}
+
+#define TXTW_FORMAT_LITERAL(destination, literal) \
+   ((char *)memcpy((destination), (literal), sizeof(literal) - 1) + (sizeof(literal) - 1))
+
+// Uppercase, without a prefix, padded with zeros to at least min_digits (up to 8), like %0*X.
+// Overwrites 8 bytes regardless of the number of digits.
+static inline char * TXTW_FormatHex(char * const destination, uint32_t const value,
+                                    uint32_t const min_digits) {
+   // All 8 digits are converted at once in the bytes of a 64-bit integer. First, every nibble is
+   // moved to its own byte, the most significant one to the lowest byte, so they end up in the
+   // order of the text when stored on a little-endian target.
+   uint64_t digits = (value >> 16) | ((uint64_t)(value & 0xFFFF) << 32);
+   digits = ((digits >> 8) & 0x000000FF000000FF) | ((digits & 0x000000FF000000FF) << 16);
+   digits = ((digits >> 4) & 0x000F000F000F000F) | ((digits & 0x000F000F000F000F) << 8);
+   // 0-9 to '0'-'9', 10-15 to 'A'-'F'.
+   uint64_t const letter_mask = ((digits + 0x0606060606060606) >> 4) & 0x0101010101010101;
+   digits += 0x3030303030303030 + 7 * letter_mask;
+   uint32_t const significant_digit_count = 1 + (value > 0xF) + (value > 0xFF) +
+                                            (value > 0xFFF) + (value > 0xFFFF) +
+                                            (value > 0xFFFFF) + (value > 0xFFFFFF) +
+                                            (value > 0xFFFFFFF);
+   uint32_t const digit_count =
+      significant_digit_count > min_digits ? significant_digit_count : min_digits;
+   // Skip the leading zeros, shifting zero bytes in after the digits.
+   digits >>= 8 * (8 - digit_count);
+   memcpy(destination, &digits, sizeof(digits));
+   return destination + digit_count;
+}
+
+// Like %u. Overwrites up to 10 bytes.
+static inline char * TXTW_FormatDecimal(char * const destination, uint32_t const value) {
+   // Written from the end, two digits at a time.
+   static char const digit_pairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+   char digits[10];
+   uint32_t digit_index = sizeof(digits);
+   uint32_t remaining_value = value;
+   while (remaining_value >= 100) {
+      uint32_t const pair = remaining_value % 100;
+      remaining_value /= 100;
+      digit_index -= 2;
+      digits[digit_index] = digit_pairs[2 * pair];
+      digits[digit_index + 1] = digit_pairs[2 * pair + 1];
+   }
+   if (remaining_value >= 10) {
+      digit_index -= 2;
+      digits[digit_index] = digit_pairs[2 * remaining_value];
+      digits[digit_index + 1] = digit_pairs[2 * remaining_value + 1];
+   } else {
+      digits[--digit_index] = (char)('0' + remaining_value);
+   }
+   memcpy(destination, digits + digit_index, sizeof(digits) - digit_index);
+   return destination + (sizeof(digits) - digit_index);
+}
+
+static inline void TXTW_PutChar(TXTW_Writer * const writer, char const character) {
+   char * const destination = TXTW_Reserve(writer, 1);
+   if (destination != NULL) {
+      *destination = character;
+      ++writer->size;
+   }
+}
+
+static inline void TXTW_PutString(TXTW_Writer * const writer, char const * const string) {
+   TXTW_PutData(writer, string, strlen(string));
+}
+
+static inline void TXTW_PutHex(TXTW_Writer * const writer, uint32_t const value,
+                               uint32_t const min_digits) {
+   char * const destination = TXTW_Reserve(writer, 8);
+   if (destination != NULL) {
+      TXTW_Commit(writer, TXTW_FormatHex(destination, value, min_digits));
+   }
+}
+
+static inline void TXTW_PutDecimal(TXTW_Writer * const writer, uint32_t const value) {
+   char * const destination = TXTW_Reserve(writer, 10);
+   if (destination != NULL) {
+      TXTW_Commit(writer, TXTW_FormatDecimal(destination, value));
+   }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,11 +4,20 @@ workspace("Catanalyst");
       "Debug",
       "Release",
    });
-   platforms({"Windows"});
+   platforms({
+      "Windows",
+      "Linux",
+   });
    systemversion("latest");
    characterset("Unicode");
    architecture("x86_64");
 
+filter("platforms:Windows");
+   system("windows");
+filter("platforms:Linux");
+   system("linux");
+filter({});
+
 filter("configurations:Debug");
    defines({"_DEBUG"});
    symbols("On");
@@ -18,6 +27,7 @@ filter("configurations:Release");
 filter({});
 
 project("Detours");
+   removeplatforms({"Linux"});
    kind("StaticLib");
    language("C++");
    defines({
@@ -41,6 +51,7 @@ project("Detours");
    });
 
 project("Catanalyst");
+   removeplatforms({"Linux"});
    kind("ConsoleApp");
    language("C++");
    cdialect("C99");
@@ -49,8 +60,79 @@ project("Catanalyst");
       "Catanalyst/**.c",
       "Catanalyst/**.cpp",
       "Catanalyst/**.h",
+      "Catanalyst/**.inl",
    });
    links({
       "d3dcompiler",
       "Detours",
    });
+
+-- Offline processing of captures, also buildable on Linux.
+project("CaptureTool");
+   kind("ConsoleApp");
+   language("C++");
+   cdialect("C99");
+   cppdialect("C++17");
+   files({
+      "Catanalyst/Catanalyst.h",
+      "Catanalyst/KMTCapture.c",
+      "Catanalyst/KMTCapture.h",
+      "Catanalyst/PM4Codec.c",
+      "Catanalyst/PM4Decoder.c",
+      "Catanalyst/PM4Histogram.c",
+      "Catanalyst/PM4Printer.c",
+      "Catanalyst/PM4Query.c",
+      "Catanalyst/PM4Registers.c",
+      "Catanalyst/PM4Registers.inl",
+      "Catanalyst/PM4Shadow.c",
+      "Catanalyst/TextWriter.c",
+      "Catanalyst/TextWriter.h",
+      "CaptureTool/**.cpp",
+      "CaptureTool/**.h",
+   });
+   filter("platforms:Linux");
+      links({"pthread"});
+   filter({});
+
+-- Microbenchmarks of the offline processing, run with the benchmark names to select.
+project("Benchmark");
+   kind("ConsoleApp");
+   language("C++");
+   cdialect("C99");
+   cppdialect("C++17");
+   files({
+      "Catanalyst/Catanalyst.h",
+      "Catanalyst/KMTAllocations.cpp",
+      "Catanalyst/KMTAllocations.h",
+      "Catanalyst/KMTCapture.c",
+      "Catanalyst/KMTCapture.h",
+      "Catanalyst/KMTContexts.cpp",
+      "Catanalyst/KMTContexts.h",
+      "Catanalyst/KMTDedup.cpp",
+      "Catanalyst/KMTDedup.h",
+      "Catanalyst/KMTRing.cpp",
+      "Catanalyst/KMTRing.h",
+      "Catanalyst/PM4Codec.c",
+      "Catanalyst/PM4Decoder.c",
+      "Catanalyst/PM4Histogram.c",
+      "Catanalyst/PM4Printer.c",
+      "Catanalyst/PM4Query.c",
+      "Catanalyst/PM4Registers.c",
+      "Catanalyst/PM4Registers.inl",
+      "Catanalyst/PM4Shadow.c",
+      "Catanalyst/TextWriter.c",
+      "Catanalyst/TextWriter.h",
+      "CaptureTool/CaptureCommands.cpp",
+      "CaptureTool/CaptureCommands.h",
+      "CaptureTool/CaptureDiff.cpp",
+      "CaptureTool/CaptureDiff.h",
+      "CaptureTool/CaptureIndex.cpp",
+      "CaptureTool/CaptureIndex.h",
+      "CaptureTool/MappedFile.cpp",
+      "CaptureTool/MappedFile.h",
+      "Benchmark/**.cpp",
+      "Benchmark/**.h",
+   });
+   filter("platforms:Linux");
+      links({"pthread"});
+   filter({});